@@ -0,0 +1,44 @@
+// Shared by the CUDA, HIP and host-emulation builds of the GPU backend.
+//
+// Device code is written once against MARAUDER_DEVICE: __device__ inline
+// under nvcc/hipcc and plain inline C++ otherwise, so the same kernels can
+// be compiled for the CPU and checked against the engine in the tests.
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define MARAUDER_DEVICE __device__ __forceinline__
+#define MARAUDER_CONSTANT __constant__
+#define MARAUDER_UNROLL _Pragma("unroll")
+#else
+#define MARAUDER_DEVICE inline
+#define MARAUDER_CONSTANT
+#define MARAUDER_UNROLL
+#endif
+
+// nvcc's device pass: the only place PTX inline assembly is available.
+#if defined(__CUDA_ARCH__)
+#define MARAUDER_PTX 1
+#else
+#define MARAUDER_PTX 0
+#endif
+
+namespace marauder_gpu {
+
+MARAUDER_DEVICE uint64_t mul_hi(uint64_t a, uint64_t b) {
+#if defined(__CUDACC__) || defined(__HIPCC__)
+    return __umul64hi(a, b);
+#else
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#endif
+}
+
+MARAUDER_DEVICE uint32_t rotr(uint32_t x, unsigned n) { return (x >> n) | (x << (32 - n)); }
+MARAUDER_DEVICE uint32_t rotl(uint32_t x, unsigned n) { return (x << n) | (x >> (32 - n)); }
+
+MARAUDER_DEVICE uint32_t bswap32(uint32_t x) {
+    return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+}
+
+}  // namespace marauder_gpu
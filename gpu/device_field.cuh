@@ -0,0 +1,214 @@
+// secp256k1 field arithmetic for the GPU backend.
+//
+// Same 4x64-bit little-endian limbs as the host Fe, but values are only
+// weakly reduced (< 2^256, possibly >= p) between operations and
+// fe_normalize() brings them below p where the exact value matters
+// (hashing, parity). Under nvcc the 256x256-bit product is PTX
+// mad.lo/mad.hi carry chains; other builds use the portable C path.
+#pragma once
+
+#include "device_common.cuh"
+
+namespace marauder_gpu {
+
+constexpr uint64_t kC = 0x1000003D1ULL;  // 2^256 mod p
+
+struct DFe {
+    uint64_t d[4];
+};
+
+struct DPoint {
+    DFe x, y;
+};
+
+MARAUDER_DEVICE void fe_set(DFe& r, uint64_t d0, uint64_t d1, uint64_t d2, uint64_t d3) {
+    r.d[0] = d0;
+    r.d[1] = d1;
+    r.d[2] = d2;
+    r.d[3] = d3;
+}
+
+// r += carry * C with propagation, for carry in {0, 1, 2}. The result is
+// small enough after one wrap that a second never overflows.
+MARAUDER_DEVICE void fe_fold_carry(DFe& r, uint64_t carry) {
+    for (int pass = 0; pass < 2 && carry; ++pass) {
+        uint64_t add = carry * kC;
+        carry = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint64_t s = r.d[i] + add;
+            add = s < add;
+            r.d[i] = s;
+        }
+        carry = add;
+    }
+}
+
+MARAUDER_DEVICE void fe_normalize(DFe& r) {
+    // r >= p exactly when r + C carries out of 2^256.
+    uint64_t t[4], carry = kC;
+    for (int i = 0; i < 4; ++i) {
+        t[i] = r.d[i] + carry;
+        carry = t[i] < carry;
+    }
+    if (carry) {
+        for (int i = 0; i < 4; ++i) r.d[i] = t[i];
+    }
+}
+
+MARAUDER_DEVICE void fe_add(DFe& r, const DFe& a, const DFe& b) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t s = a.d[i] + b.d[i];
+        uint64_t c = s < a.d[i];
+        r.d[i] = s + carry;
+        carry = c | (r.d[i] < s);
+    }
+    fe_fold_carry(r, carry);
+}
+
+// r = a - b via a + (p - b); b is normalised first so p - b cannot borrow.
+MARAUDER_DEVICE void fe_sub(DFe& r, const DFe& a, const DFe& b) {
+    const uint64_t p[4] = {0xFFFFFFFEFFFFFC2FULL, ~0ULL, ~0ULL, ~0ULL};
+    DFe nb = b;
+    fe_normalize(nb);
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t d = p[i] - nb.d[i];
+        uint64_t bo = p[i] < nb.d[i];
+        nb.d[i] = d - borrow;
+        borrow = bo | (d < borrow);
+    }
+    fe_add(r, a, nb);
+}
+
+// 512-bit product a * b into t[0..7].
+MARAUDER_DEVICE void mul_wide(uint64_t t[8], const DFe& a, const DFe& b) {
+#if MARAUDER_PTX
+    // Row i adds a * b[i] into t[i..i+4]: the low halves ride one carry
+    // chain into t[i+4], then the high halves a second one shifted a limb.
+    uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0, t5 = 0, t6 = 0, t7 = 0;
+#define MARAUDER_MUL_ROW(bi, r0, r1, r2, r3, r4)                                      \
+    asm("mad.lo.cc.u64 %0, %5, %9, %0;\n\t"                                           \
+        "madc.lo.cc.u64 %1, %6, %9, %1;\n\t"                                          \
+        "madc.lo.cc.u64 %2, %7, %9, %2;\n\t"                                          \
+        "madc.lo.cc.u64 %3, %8, %9, %3;\n\t"                                          \
+        "addc.u64 %4, 0, 0;\n\t"                                                      \
+        "mad.hi.cc.u64 %1, %5, %9, %1;\n\t"                                           \
+        "madc.hi.cc.u64 %2, %6, %9, %2;\n\t"                                          \
+        "madc.hi.cc.u64 %3, %7, %9, %3;\n\t"                                          \
+        "madc.hi.u64 %4, %8, %9, %4;"                                                 \
+        : "+l"(r0), "+l"(r1), "+l"(r2), "+l"(r3), "=l"(r4)                            \
+        : "l"(a.d[0]), "l"(a.d[1]), "l"(a.d[2]), "l"(a.d[3]), "l"(bi))
+    MARAUDER_MUL_ROW(b.d[0], t0, t1, t2, t3, t4);
+    MARAUDER_MUL_ROW(b.d[1], t1, t2, t3, t4, t5);
+    MARAUDER_MUL_ROW(b.d[2], t2, t3, t4, t5, t6);
+    MARAUDER_MUL_ROW(b.d[3], t3, t4, t5, t6, t7);
+#undef MARAUDER_MUL_ROW
+    t[0] = t0, t[1] = t1, t[2] = t2, t[3] = t3, t[4] = t4, t[5] = t5, t[6] = t6, t[7] = t7;
+#else
+    for (int i = 0; i < 8; ++i) t[i] = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; ++j) {
+            uint64_t lo = a.d[j] * b.d[i], hi = mul_hi(a.d[j], b.d[i]);
+            uint64_t s = t[i + j] + lo;
+            hi += s < lo;
+            s += carry;
+            hi += s < carry;
+            t[i + j] = s;
+            carry = hi;
+        }
+        t[i + 4] = carry;
+    }
+#endif
+}
+
+// Folds t[0..7] to 4 limbs with 2^256 = C (mod p).
+MARAUDER_DEVICE void reduce_wide(DFe& r, const uint64_t t[8]) {
+    uint64_t c = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t lo = t[4 + i] * kC, hi = mul_hi(t[4 + i], kC);
+        uint64_t s = t[i] + lo;
+        uint64_t k = s < lo;
+        s += c;
+        k += s < c;
+        r.d[i] = s;
+        c = hi + k;  // < 2^34
+    }
+    uint64_t lo = c * kC, hi = mul_hi(c, kC);
+    uint64_t carry;
+    r.d[0] += lo;
+    carry = r.d[0] < lo;
+    uint64_t add = hi + carry;
+    r.d[1] += add;
+    carry = r.d[1] < add;
+    r.d[2] += carry;
+    carry = r.d[2] < carry;
+    r.d[3] += carry;
+    carry = r.d[3] < carry;
+    fe_fold_carry(r, carry);
+}
+
+MARAUDER_DEVICE void fe_mul(DFe& r, const DFe& a, const DFe& b) {
+    uint64_t t[8];
+    mul_wide(t, a, b);
+    reduce_wide(r, t);
+}
+
+MARAUDER_DEVICE void fe_sqr(DFe& r, const DFe& a) { fe_mul(r, a, a); }
+
+MARAUDER_DEVICE void fe_sqr_n(DFe& r, const DFe& a, int n) {
+    r = a;
+    for (int i = 0; i < n; ++i) fe_sqr(r, r);
+}
+
+// a^(p-2), libsecp256k1's addition chain: 255 squarings, 15 multiplies.
+MARAUDER_DEVICE void fe_inv(DFe& r, const DFe& a) {
+    DFe x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t;
+    fe_sqr(x2, a);
+    fe_mul(x2, x2, a);
+    fe_sqr(x3, x2);
+    fe_mul(x3, x3, a);
+    fe_sqr_n(x6, x3, 3);
+    fe_mul(x6, x6, x3);
+    fe_sqr_n(x9, x6, 3);
+    fe_mul(x9, x9, x3);
+    fe_sqr_n(x11, x9, 2);
+    fe_mul(x11, x11, x2);
+    fe_sqr_n(x22, x11, 11);
+    fe_mul(x22, x22, x11);
+    fe_sqr_n(x44, x22, 22);
+    fe_mul(x44, x44, x22);
+    fe_sqr_n(x88, x44, 44);
+    fe_mul(x88, x88, x44);
+    fe_sqr_n(x176, x88, 88);
+    fe_mul(x176, x176, x88);
+    fe_sqr_n(x220, x176, 44);
+    fe_mul(x220, x220, x44);
+    fe_sqr_n(x223, x220, 3);
+    fe_mul(x223, x223, x3);
+    fe_sqr_n(t, x223, 23);
+    fe_mul(t, t, x22);
+    fe_sqr_n(t, t, 5);
+    fe_mul(t, t, a);
+    fe_sqr_n(t, t, 3);
+    fe_mul(t, t, x2);
+    fe_sqr_n(t, t, 2);
+    fe_mul(r, t, a);
+}
+
+// r = p + q for distinct affine points, given inv = 1 / (q.x - p.x).
+MARAUDER_DEVICE void point_add_inv(DPoint& r, const DPoint& p, const DPoint& q, const DFe& inv) {
+    DFe lambda, t, x3;
+    fe_sub(t, q.y, p.y);
+    fe_mul(lambda, t, inv);
+    fe_sqr(x3, lambda);
+    fe_sub(x3, x3, p.x);
+    fe_sub(x3, x3, q.x);
+    fe_sub(t, p.x, x3);
+    fe_mul(t, t, lambda);
+    fe_sub(r.y, t, p.y);
+    r.x = x3;
+}
+
+}  // namespace marauder_gpu
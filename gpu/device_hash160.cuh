@@ -0,0 +1,107 @@
+// hash160 of a compressed public key, one key per GPU thread.
+//
+// The message is always 33 bytes (prefix || x), so SHA-256 is one block
+// with constant padding and RIPEMD-160 one block over the 32-byte digest;
+// everything stays in registers.
+#pragma once
+
+#include "device_common.cuh"
+#include "device_field.cuh"
+
+namespace marauder_gpu {
+
+MARAUDER_CONSTANT static const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+// RIPEMD-160 message word order and rotations, left and right lines.
+MARAUDER_CONSTANT static const uint8_t kRmdR[80] = {
+    0, 1, 2,  3,  4,  5,  6,  7,  8, 9, 10, 11, 12, 13, 14, 15, 7,  4,  13, 1,  10, 6,  15, 3,  12, 0, 9,
+    5, 2, 14, 11, 8,  3,  10, 14, 4, 9, 15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12, 1,  9,  11, 10, 0, 8,
+    12, 4, 13, 3, 7, 15, 14, 5,  6, 2, 4,  0,  5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+MARAUDER_CONSTANT static const uint8_t kRmdRp[80] = {
+    5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12, 6,  11, 3,  7, 0,  13, 5,  10, 14, 15, 8,
+    12, 4,  9,  1, 2, 15, 5,  1,  3,  7,  14, 6,  9,  11, 8,  12, 2,  10, 0,  4, 13, 8,  6,  4,  1,  3,  11,
+    15, 0,  5,  12, 2, 13, 9,  7,  10, 14, 12, 15, 10, 4,  1,  5,  8,  7,  6,  2, 13, 14, 0,  3,  9,  11};
+MARAUDER_CONSTANT static const uint8_t kRmdS[80] = {
+    11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,  7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15,
+    9,  11, 7,  13, 12, 11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,  11, 12, 14, 15, 14, 15,
+    9,  8,  9,  14, 5,  6,  8,  6,  5,  12, 9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+MARAUDER_CONSTANT static const uint8_t kRmdSp[80] = {
+    8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,  9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12,
+    7,  6,  15, 13, 11, 9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,  15, 5,  8,  11, 14, 14,
+    6,  14, 6,  9,  12, 9,  12, 5,  15, 8,  8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+
+MARAUDER_DEVICE uint32_t rmd_f(int round, uint32_t x, uint32_t y, uint32_t z) {
+    switch (round) {
+        case 0: return x ^ y ^ z;
+        case 1: return (x & y) | (~x & z);
+        case 2: return (x | ~y) ^ z;
+        case 3: return (x & z) | (y & ~z);
+        default: return x ^ (y | ~z);
+    }
+}
+
+// out[0..4] are the RIPEMD-160 state words; digest byte i is byte
+// (i % 4) of out[i / 4], little-endian, exactly as the host stores it.
+MARAUDER_DEVICE void hash160_compressed(uint32_t out[5], uint32_t prefix, const DFe& x) {
+    uint32_t w[64];
+    // prefix || x big-endian || 0x80: each word takes the low byte of the
+    // previous x word and the high three bytes of the next.
+    uint32_t xw[8];
+    for (int i = 0; i < 8; ++i) xw[i] = (uint32_t)(x.d[3 - i / 2] >> (i % 2 ? 0 : 32));
+    w[0] = prefix << 24 | xw[0] >> 8;
+    for (int i = 1; i < 8; ++i) w[i] = xw[i - 1] << 24 | xw[i] >> 8;
+    w[8] = xw[7] << 24 | 0x800000;
+    for (int i = 9; i < 15; ++i) w[i] = 0;
+    w[15] = 33 * 8;
+    MARAUDER_UNROLL
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    MARAUDER_UNROLL
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + kSha256K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g, g = f, f = e, e = d + t1, d = c, c = b, b = a, a = t1 + t2;
+    }
+    h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e, h[5] += f, h[6] += g, h[7] += hh;
+
+    uint32_t m[16];
+    for (int i = 0; i < 8; ++i) m[i] = bswap32(h[i]);
+    m[8] = 0x80;
+    for (int i = 9; i < 16; ++i) m[i] = 0;
+    m[14] = 32 * 8;
+
+    const uint32_t kl[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+    const uint32_t kr[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+    uint32_t s[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    uint32_t al = s[0], bl = s[1], cl = s[2], dl = s[3], el = s[4];
+    uint32_t ar = s[0], br = s[1], cr = s[2], dr = s[3], er = s[4];
+    MARAUDER_UNROLL
+    for (int j = 0; j < 80; ++j) {
+        int round = j / 16;
+        uint32_t t = rotl(al + rmd_f(round, bl, cl, dl) + m[kRmdR[j]] + kl[round], kRmdS[j]) + el;
+        al = el, el = dl, dl = rotl(cl, 10), cl = bl, bl = t;
+        t = rotl(ar + rmd_f(4 - round, br, cr, dr) + m[kRmdRp[j]] + kr[round], kRmdSp[j]) + er;
+        ar = er, er = dr, dr = rotl(cr, 10), cr = br, br = t;
+    }
+    out[0] = s[1] + cl + dr;
+    out[1] = s[2] + dl + er;
+    out[2] = s[3] + el + ar;
+    out[3] = s[4] + al + br;
+    out[4] = s[0] + bl + cr;
+}
+
+}  // namespace marauder_gpu
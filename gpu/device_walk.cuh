@@ -0,0 +1,124 @@
+// The per-thread body of a GPU scan iteration.
+//
+// Thread t owns a run of kThreadKeys consecutive keys per iteration: its
+// current point P is key iter_offset + t * kThreadKeys, the run is
+// P, P + 1G, ..., P + (K-1)G, and afterwards P advances by the jump point
+// (threads * K) G to its run in the next iteration. The K-1 step
+// denominators and the jump's are inverted together with one field
+// inversion (Montgomery's trick) held entirely in the thread.
+#pragma once
+
+#include "device_common.cuh"
+#include "device_field.cuh"
+#include "device_hash160.cuh"
+#include "marauder/gpu_plugin.hpp"
+
+namespace marauder_gpu {
+
+constexpr int kThreadKeys = 32;
+
+struct BloomView {
+    const uint64_t* words;  // lines * 8 words
+    uint64_t lines;
+};
+
+struct WalkArgs {
+    DPoint* points;       // per-thread current point, advanced each iteration
+    const DPoint* steps;  // steps[i] = (i + 1) G for i < kThreadKeys - 1
+    DPoint jump;          // (threads * kThreadKeys) G
+    uint64_t count;       // keys in this scan call
+    uint64_t iter_offset; // offset of the iteration's first key
+    uint32_t threads;
+    uint32_t endomorphism;
+    MarauderGpuHit* hits;
+    uint32_t max_hits;
+    uint32_t* hit_count;
+};
+
+// Same line and bit selection as BloomFilter::maybe_contains.
+MARAUDER_DEVICE bool bloom_test(const BloomView& bloom, const uint32_t h[5]) {
+    uint64_t key = (uint64_t)h[1] << 32 | h[0];
+    const uint64_t* line = bloom.words + 8 * mul_hi(key, bloom.lines);
+    uint64_t lo = (uint64_t)h[3] << 32 | h[2], hi = h[4];
+    MARAUDER_UNROLL
+    for (int i = 0; i < 8; ++i) {
+        unsigned at = 9 * i;
+        uint64_t v = lo >> at;
+        if (at + 9 > 64) v |= hi << (64 - at);
+        unsigned b = (unsigned)v & 511;
+        if (!(line[b >> 6] >> (b & 63) & 1)) return false;
+    }
+    return true;
+}
+
+MARAUDER_DEVICE uint32_t hit_slot(uint32_t* counter) {
+#if defined(__CUDACC__) || defined(__HIPCC__)
+    return atomicAdd(counter, 1u);
+#else
+    return __atomic_fetch_add(counter, 1u, __ATOMIC_RELAXED);
+#endif
+}
+
+MARAUDER_DEVICE void record_hit(const WalkArgs& a, uint64_t offset, uint32_t v, const uint32_t h[5]) {
+    uint32_t slot = hit_slot(a.hit_count);
+    if (slot >= a.max_hits) return;
+    MarauderGpuHit& hit = a.hits[slot];
+    hit.offset = offset;
+    hit.candidate = v;
+    for (int i = 0; i < 20; ++i) hit.digest[i] = (uint8_t)(h[i / 4] >> (8 * (i % 4)));
+}
+
+MARAUDER_DEVICE void check_point(const WalkArgs& a, const BloomView& bloom, const DPoint& p, uint64_t offset) {
+    DFe x = p.x, y = p.y;
+    fe_normalize(x);
+    fe_normalize(y);
+    uint32_t odd = (uint32_t)(y.d[0] & 1);
+    DFe beta;
+    fe_set(beta, 0xC1396C28719501EEULL, 0x9CF0497512F58995ULL, 0x6E64479EAC3434E9ULL, 0x7AE96A2B657C0710ULL);
+    const int passes = a.endomorphism ? 3 : 1;
+    for (int e = 0; e < passes; ++e) {
+        if (e) {
+            fe_mul(x, x, beta);
+            fe_normalize(x);
+        }
+        for (uint32_t s = 0; s < (a.endomorphism ? 2u : 1u); ++s) {
+            uint32_t h[5];
+            hash160_compressed(h, 0x02 | (odd ^ s), x);
+            if (bloom_test(bloom, h)) record_hit(a, offset, 2 * e + s, h);
+        }
+    }
+}
+
+MARAUDER_DEVICE void walk_thread(const WalkArgs& a, const BloomView& bloom, uint32_t t) {
+    const uint64_t first = a.iter_offset + (uint64_t)t * kThreadKeys;
+    if (first >= a.count) return;
+    DPoint p = a.points[t];
+
+    // dx[i] = steps[i].x - P.x for i < K-1, and the jump's last.
+    DFe dx[kThreadKeys], acc[kThreadKeys];
+    for (int i = 0; i < kThreadKeys - 1; ++i) fe_sub(dx[i], a.steps[i].x, p.x);
+    fe_sub(dx[kThreadKeys - 1], a.jump.x, p.x);
+    acc[0] = dx[0];
+    for (int i = 1; i < kThreadKeys; ++i) fe_mul(acc[i], acc[i - 1], dx[i]);
+    DFe inv;
+    fe_inv(inv, acc[kThreadKeys - 1]);
+    for (int i = kThreadKeys - 1; i > 0; --i) {
+        DFe d = dx[i];
+        fe_mul(dx[i], inv, acc[i - 1]);  // 1 / dx[i]
+        fe_mul(inv, inv, d);
+    }
+    dx[0] = inv;
+
+    check_point(a, bloom, p, first);
+    for (int i = 0; i < kThreadKeys - 1; ++i) {
+        if (first + i + 1 >= a.count) break;
+        DPoint q;
+        point_add_inv(q, p, a.steps[i], dx[i]);
+        check_point(a, bloom, q, first + i + 1);
+    }
+    DPoint next;
+    point_add_inv(next, p, a.jump, dx[kThreadKeys - 1]);
+    a.points[t] = next;
+}
+
+}  // namespace marauder_gpu
@@ -0,0 +1,86 @@
+// Host-side set-up shared by the GPU plugins.
+//
+// The plugins link libmarauder and use the CPU engine for the one-off
+// point arithmetic: the step table, the jump point and every thread's
+// starting point for a scan() call (a chain of Jacobian additions of
+// K * G, normalised with one batch inversion).
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+#include "device_walk.cuh"
+#include "marauder/batch_inverse.hpp"
+#include "marauder/point.hpp"
+#include "marauder/scalar.hpp"
+#include "marauder/step_table.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder_gpu {
+
+inline DPoint to_device(const marauder::Point& p) {
+    DPoint d;
+    for (int i = 0; i < 4; ++i) {
+        d.x.d[i] = p.x.d[i];
+        d.y.d[i] = p.y.d[i];
+    }
+    return d;
+}
+
+inline void set_error(char* err, size_t len, const char* fmt, ...) {
+    if (!err || !len) return;
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(err, len, fmt, ap);
+    va_end(ap);
+}
+
+// steps[i] = (i + 1) G for i < kThreadKeys - 1.
+inline std::vector<DPoint> make_steps() {
+    auto table = marauder::StepTable::get(kThreadKeys - 1);
+    std::vector<DPoint> out;
+    for (size_t i = 0; i < table->size(); ++i) out.push_back(to_device((*table)[i]));
+    return out;
+}
+
+inline DPoint make_jump(uint32_t threads) {
+    marauder::Scalar k = marauder::Scalar::from_u256(marauder::U256::from_u64((uint64_t)threads * kThreadKeys));
+    return to_device(marauder::point_mul_g(k));
+}
+
+// The walk never meets a degenerate addition (P.x equal to a step's or
+// the jump's x) as long as every key it touches, including the
+// look-ahead jump of the last iteration, stays more than the jump
+// distance away from 0 and from n: range_margin keys at either end,
+// which go to the CPU.
+inline uint64_t range_margin(uint32_t threads) { return 2 * (uint64_t)threads * kThreadKeys; }
+
+inline bool range_supported(const marauder::U256& start, uint64_t count, uint32_t threads) {
+    using marauder::U256;
+    const uint64_t margin = range_margin(threads);
+    if (start <= U256::from_u64(margin)) return false;
+    U256 top;
+    if (u256_add_u64(top, start, count) || u256_add_u64(top, top, margin)) return false;
+    return top < marauder::kOrderN;
+}
+
+// Thread t's first point: (start + t * kThreadKeys) G, into out[t].
+inline void make_starts(DPoint* out, const marauder::U256& start, uint32_t threads) {
+    using namespace marauder;
+    std::vector<JPoint> jac(threads);
+    jac[0] = JPoint::from_affine(point_mul_g(Scalar::from_u256(start)));
+    const Point stride = point_mul_g(Scalar::from_u256(U256::from_u64(kThreadKeys)));
+    for (uint32_t t = 1; t < threads; ++t) jpoint_add_affine(jac[t], jac[t - 1], stride);
+    std::vector<Point> aff(threads);
+    std::vector<Fe> scratch(2 * threads);
+    jpoint_batch_to_affine(aff.data(), jac.data(), threads, scratch.data());
+    for (uint32_t t = 0; t < threads; ++t) out[t] = to_device(aff[t]);
+}
+
+inline void make_starts(std::vector<DPoint>& out, const marauder::U256& start, uint32_t threads) {
+    out.resize(threads);
+    make_starts(out.data(), start, threads);
+}
+
+}  // namespace marauder_gpu
@@ -0,0 +1,251 @@
+// CUDA / HIP GPU plugin.
+//
+// One context per device, with one slot per scan the host keeps in flight.
+// Each slot has its own stream, device points, hit buffer and counter, and
+// pinned host staging for the starting points and the counter. submit()
+// computes every thread's starting point on the host, then queues the
+// upload, one walk_kernel launch per iteration (threads * kThreadKeys keys
+// each) and the counter's copy-back on the slot's stream and records an
+// event; collect() waits for the oldest slot's event and copies back only
+// its Bloom positives. So while one slot computes, the next slot's points
+// upload and the previous slot's positives come back, and the host sets up
+// starting points without the device going idle.
+//
+// Filters of up to kSharedBloomBytes are staged into shared memory by
+// every block; larger ones are read from global memory. Both the filter
+// and the step table are shared by the slots, which only read them.
+#include <cstring>
+#include <vector>
+
+#include "gpu_runtime.cuh"
+#include "plugin_common.hpp"
+
+namespace marauder_gpu {
+
+namespace {
+
+constexpr unsigned kBlockThreads = 256;
+constexpr unsigned kBlocksPerSm = 8;
+constexpr size_t kSharedBloomBytes = 32 * 1024;
+
+__global__ void walk_kernel(WalkArgs args, BloomView bloom, int shared_bloom) {
+    extern __shared__ uint64_t staged[];
+    BloomView view = bloom;
+    if (shared_bloom) {
+        for (uint64_t i = threadIdx.x; i < bloom.lines * 8; i += blockDim.x) staged[i] = bloom.words[i];
+        __syncthreads();
+        view.words = staged;
+    }
+    uint32_t t = blockIdx.x * blockDim.x + threadIdx.x;
+    if (t < args.threads) walk_thread(args, view, t);
+}
+
+struct Slot {
+    gpuStream_t stream = nullptr;
+    gpuEvent_t done = nullptr;  // the hit counter has reached host_count
+    DPoint* points = nullptr;
+    MarauderGpuHit* hits = nullptr;
+    uint32_t* hit_count = nullptr;
+    DPoint* host_starts = nullptr;   // pinned
+    uint32_t* host_count = nullptr;  // pinned
+};
+
+struct Context {
+    int device = 0;
+    gpuDeviceProp props;
+    MarauderGpuConfig config;
+    uint32_t threads = 0;
+    DPoint* steps = nullptr;
+    uint64_t* bloom = nullptr;
+    uint64_t bloom_lines = 0;
+    DPoint jump;
+    std::vector<Slot> slots;  // a ring of config.depth slots
+    uint32_t oldest = 0, queued = 0;
+
+    ~Context() {
+        for (Slot& s : slots) {
+            // Waits for the slot's work before releasing its buffers.
+            if (s.stream) gpuStreamSynchronize(s.stream);
+            gpuFree(s.points);
+            gpuFree(s.hits);
+            gpuFree(s.hit_count);
+            gpuFreeHost(s.host_starts);
+            gpuFreeHost(s.host_count);
+            if (s.done) gpuEventDestroy(s.done);
+            if (s.stream) gpuStreamDestroy(s.stream);
+        }
+        gpuFree(steps);
+        gpuFree(bloom);
+    }
+};
+
+bool check(gpuError_t rc, const char* what, char* err, size_t err_len) {
+    if (rc == gpuSuccess) return true;
+    set_error(err, err_len, "%s: %s", what, gpuGetErrorString(rc));
+    return false;
+}
+
+int gpu_device_count() {
+    int n = 0;
+    return gpuGetDeviceCount(&n) == gpuSuccess ? n : 0;
+}
+
+bool open_slot(Slot& s, uint32_t threads, uint32_t max_hits, char* err, size_t err_len) {
+    return check(gpuStreamCreate(&s.stream), "create stream", err, err_len) &&
+           check(gpuEventCreateWithFlags(&s.done, gpuEventDisableTiming), "create event", err, err_len) &&
+           check(gpuMalloc(&s.points, threads * sizeof(DPoint)), "alloc points", err, err_len) &&
+           check(gpuMalloc(&s.hits, size_t(max_hits) * sizeof(MarauderGpuHit)), "alloc hits", err, err_len) &&
+           check(gpuMalloc(&s.hit_count, sizeof(uint32_t)), "alloc hit counter", err, err_len) &&
+           check(gpuMallocHost(&s.host_starts, threads * sizeof(DPoint)), "pin points", err, err_len) &&
+           check(gpuMallocHost(&s.host_count, sizeof(uint32_t)), "pin hit counter", err, err_len);
+}
+
+void* gpu_open(int device, const MarauderGpuConfig* config, char* err, size_t err_len) {
+    if (config->depth == 0) {
+        set_error(err, err_len, "pipeline depth must be at least 1");
+        return nullptr;
+    }
+    auto* ctx = new Context;
+    ctx->device = device;
+    ctx->config = *config;
+    bool ok = check(gpuSetDevice(device), "set device", err, err_len) &&
+              check(gpuGetDeviceProperties(&ctx->props, device), "device properties", err, err_len);
+    if (ok) {
+        ctx->threads = ctx->props.multiProcessorCount * kBlocksPerSm * kBlockThreads;
+        ctx->jump = make_jump(ctx->threads);
+        std::vector<DPoint> steps = make_steps();
+        const uint64_t zero_line[8] = {0};
+        ok = check(gpuMalloc(&ctx->steps, steps.size() * sizeof(DPoint)), "alloc steps", err, err_len) &&
+             check(gpuMemcpy(ctx->steps, steps.data(), steps.size() * sizeof(DPoint), gpuMemcpyHostToDevice),
+                   "upload steps", err, err_len) &&
+             check(gpuMalloc(&ctx->bloom, sizeof(zero_line)), "alloc bloom", err, err_len) &&
+             check(gpuMemcpy(ctx->bloom, zero_line, sizeof(zero_line), gpuMemcpyHostToDevice), "upload bloom", err,
+                   err_len);
+        ctx->bloom_lines = 1;
+        ctx->slots.resize(config->depth);
+        for (size_t i = 0; ok && i < ctx->slots.size(); ++i) {
+            ok = open_slot(ctx->slots[i], ctx->threads, config->max_hits, err, err_len);
+        }
+    }
+    if (!ok) {
+        delete ctx;
+        return nullptr;
+    }
+    return ctx;
+}
+
+void gpu_close(void* ctx) { delete static_cast<Context*>(ctx); }
+
+const char* gpu_device_name(void* ctx) { return static_cast<Context*>(ctx)->props.name; }
+
+// Sixteen iterations per scan keep launch overhead well below the kernel
+// time; the host-side start point set-up overlaps with other slots anyway.
+uint64_t gpu_preferred_keys(void* ctx) {
+    return uint64_t(static_cast<Context*>(ctx)->threads) * kThreadKeys * 16;
+}
+
+int gpu_set_bloom(void* p, const void* lines, uint64_t line_count, char* err, size_t err_len) {
+    auto* ctx = static_cast<Context*>(p);
+    if (line_count == 0) {
+        set_error(err, err_len, "empty Bloom filter");
+        return MARAUDER_GPU_ERROR;
+    }
+    gpuFree(ctx->bloom);
+    ctx->bloom = nullptr;
+    ctx->bloom_lines = 0;
+    if (!check(gpuSetDevice(ctx->device), "set device", err, err_len) ||
+        !check(gpuMalloc(&ctx->bloom, line_count * 64), "alloc bloom", err, err_len) ||
+        !check(gpuMemcpy(ctx->bloom, lines, line_count * 64, gpuMemcpyHostToDevice), "upload bloom", err, err_len)) {
+        return MARAUDER_GPU_ERROR;
+    }
+    ctx->bloom_lines = line_count;
+    return MARAUDER_GPU_OK;
+}
+
+int gpu_submit(void* p, const uint64_t start_limbs[4], uint64_t count, char* err, size_t err_len) {
+    auto* ctx = static_cast<Context*>(p);
+    marauder::U256 start{{start_limbs[0], start_limbs[1], start_limbs[2], start_limbs[3]}};
+    if (ctx->queued == ctx->config.depth) {
+        set_error(err, err_len, "%u scans already in flight", ctx->queued);
+        return MARAUDER_GPU_ERROR;
+    }
+    if (!range_supported(start, count, ctx->threads)) return MARAUDER_GPU_UNSUPPORTED;
+    // The slot was last collected, so its upload from host_starts is done.
+    Slot& s = ctx->slots[(ctx->oldest + ctx->queued) % ctx->config.depth];
+    make_starts(s.host_starts, start, ctx->threads);
+    if (!check(gpuSetDevice(ctx->device), "set device", err, err_len) ||
+        !check(gpuMemcpyAsync(s.points, s.host_starts, ctx->threads * sizeof(DPoint), gpuMemcpyHostToDevice,
+                              s.stream),
+               "upload points", err, err_len) ||
+        !check(gpuMemsetAsync(s.hit_count, 0, sizeof(uint32_t), s.stream), "clear hits", err, err_len)) {
+        return MARAUDER_GPU_ERROR;
+    }
+
+    WalkArgs args;
+    args.points = s.points;
+    args.steps = ctx->steps;
+    args.jump = ctx->jump;
+    args.count = count;
+    args.threads = ctx->threads;
+    args.endomorphism = ctx->config.endomorphism;
+    args.hits = s.hits;
+    args.max_hits = ctx->config.max_hits;
+    args.hit_count = s.hit_count;
+    BloomView bloom{ctx->bloom, ctx->bloom_lines};
+    const size_t bloom_bytes = ctx->bloom_lines * 64;
+    const int shared = bloom_bytes <= kSharedBloomBytes;
+    const unsigned blocks = (ctx->threads + kBlockThreads - 1) / kBlockThreads;
+    const uint64_t per_iter = uint64_t(ctx->threads) * kThreadKeys;
+    for (args.iter_offset = 0; args.iter_offset < count; args.iter_offset += per_iter) {
+        walk_kernel<<<blocks, kBlockThreads, shared ? bloom_bytes : 0, s.stream>>>(args, bloom, shared);
+    }
+    if (!check(gpuGetLastError(), "launch", err, err_len) ||
+        !check(gpuMemcpyAsync(s.host_count, s.hit_count, sizeof(uint32_t), gpuMemcpyDeviceToHost, s.stream),
+               "read hit count", err, err_len) ||
+        !check(gpuEventRecord(s.done, s.stream), "record event", err, err_len)) {
+        return MARAUDER_GPU_ERROR;
+    }
+    ++ctx->queued;
+    return MARAUDER_GPU_OK;
+}
+
+int gpu_collect(void* p, MarauderGpuHit* hits, uint32_t* hit_count, char* err, size_t err_len) {
+    auto* ctx = static_cast<Context*>(p);
+    *hit_count = 0;
+    if (ctx->queued == 0) {
+        set_error(err, err_len, "no scan in flight");
+        return MARAUDER_GPU_ERROR;
+    }
+    Slot& s = ctx->slots[ctx->oldest];
+    ctx->oldest = (ctx->oldest + 1) % ctx->config.depth;
+    --ctx->queued;
+    if (!check(gpuSetDevice(ctx->device), "set device", err, err_len) ||
+        !check(gpuEventSynchronize(s.done), "kernel", err, err_len)) {
+        return MARAUDER_GPU_ERROR;
+    }
+    const uint32_t found = *s.host_count;
+    *hit_count = found;
+    // Positives are rare, so this copy is short; the other slots' kernels
+    // keep running on their own streams meanwhile.
+    uint32_t copy = found < ctx->config.max_hits ? found : ctx->config.max_hits;
+    if (copy && (!check(gpuMemcpyAsync(hits, s.hits, copy * sizeof(MarauderGpuHit), gpuMemcpyDeviceToHost,
+                                       s.stream),
+                        "read hits", err, err_len) ||
+                 !check(gpuStreamSynchronize(s.stream), "read hits", err, err_len))) {
+        return MARAUDER_GPU_ERROR;
+    }
+    return found > ctx->config.max_hits ? MARAUDER_GPU_HIT_OVERFLOW : MARAUDER_GPU_OK;
+}
+
+const MarauderGpuApi kApi = {
+    MARAUDER_GPU_ABI_VERSION, MARAUDER_GPU_RUNTIME, gpu_device_count, gpu_open, gpu_close, gpu_device_name,
+    gpu_preferred_keys, gpu_set_bloom, gpu_submit, gpu_collect,
+};
+
+}  // namespace
+
+}  // namespace marauder_gpu
+
+extern "C" __attribute__((visibility("default"))) const MarauderGpuApi* marauder_gpu_plugin() {
+    return &marauder_gpu::kApi;
+}
@@ -0,0 +1,132 @@
+// Host emulation of the GPU plugin.
+//
+// Runs the device walk (device_walk.cuh) on the CPU, one "thread" after the
+// other, behind the real plugin ABI. It is far too slow to scan with; it
+// exists so the tests can check the device arithmetic, the hit format and
+// the host driver on machines without a GPU toolchain. submit() runs the
+// whole scan at once into one of depth slots, which collect() then hands
+// back in order, so the host sees a pipeline of the configured depth.
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "plugin_common.hpp"
+#include "plugin_emu.hpp"
+
+namespace marauder_gpu {
+
+namespace {
+
+struct EmuSlot {
+    std::unique_ptr<MarauderGpuHit[]> hits;  // max_hits, left uninitialised
+    uint32_t hit_count = 0;
+};
+
+struct EmuContext {
+    MarauderGpuConfig config;
+    std::vector<DPoint> steps, points;
+    DPoint jump;
+    std::vector<uint64_t> bloom;
+    uint64_t bloom_lines = 0;
+    std::vector<EmuSlot> slots;  // a ring of depth slots
+    uint32_t oldest = 0, queued = 0;
+};
+
+int emu_device_count() { return 1; }
+
+void* emu_open(int device, const MarauderGpuConfig* config, char* err, size_t err_len) {
+    if (device != 0) {
+        set_error(err, err_len, "no emulated device %d", device);
+        return nullptr;
+    }
+    if (config->depth == 0) {
+        set_error(err, err_len, "pipeline depth must be at least 1");
+        return nullptr;
+    }
+    auto* ctx = new EmuContext;
+    ctx->config = *config;
+    ctx->slots.resize(config->depth);
+    for (EmuSlot& s : ctx->slots) s.hits.reset(new MarauderGpuHit[config->max_hits]);
+    ctx->steps = make_steps();
+    ctx->jump = make_jump(kEmuThreads);
+    ctx->bloom.assign(8, 0);
+    ctx->bloom_lines = 1;
+    return ctx;
+}
+
+void emu_close(void* ctx) { delete static_cast<EmuContext*>(ctx); }
+
+const char* emu_device_name(void*) { return "host emulation"; }
+
+uint64_t emu_preferred_keys(void*) { return uint64_t(kEmuThreads) * kThreadKeys * 4; }
+
+int emu_set_bloom(void* p, const void* lines, uint64_t line_count, char* err, size_t err_len) {
+    auto* ctx = static_cast<EmuContext*>(p);
+    if (line_count == 0) {
+        set_error(err, err_len, "empty Bloom filter");
+        return MARAUDER_GPU_ERROR;
+    }
+    ctx->bloom.resize(line_count * 8);
+    std::memcpy(ctx->bloom.data(), lines, line_count * 64);
+    ctx->bloom_lines = line_count;
+    return MARAUDER_GPU_OK;
+}
+
+int emu_submit(void* p, const uint64_t start_limbs[4], uint64_t count, char* err, size_t err_len) {
+    auto* ctx = static_cast<EmuContext*>(p);
+    marauder::U256 start{{start_limbs[0], start_limbs[1], start_limbs[2], start_limbs[3]}};
+    if (ctx->queued == ctx->config.depth) {
+        set_error(err, err_len, "%u scans already in flight", ctx->queued);
+        return MARAUDER_GPU_ERROR;
+    }
+    if (!range_supported(start, count, kEmuThreads)) return MARAUDER_GPU_UNSUPPORTED;
+    EmuSlot& slot = ctx->slots[(ctx->oldest + ctx->queued) % ctx->config.depth];
+    make_starts(ctx->points, start, kEmuThreads);
+    slot.hit_count = 0;
+
+    WalkArgs args;
+    args.points = ctx->points.data();
+    args.steps = ctx->steps.data();
+    args.jump = ctx->jump;
+    args.count = count;
+    args.threads = kEmuThreads;
+    args.endomorphism = ctx->config.endomorphism;
+    args.hits = slot.hits.get();
+    args.max_hits = ctx->config.max_hits;
+    args.hit_count = &slot.hit_count;
+    BloomView bloom{ctx->bloom.data(), ctx->bloom_lines};
+    const uint64_t per_iter = uint64_t(kEmuThreads) * kThreadKeys;
+    for (args.iter_offset = 0; args.iter_offset < count; args.iter_offset += per_iter) {
+        for (uint32_t t = 0; t < kEmuThreads; ++t) walk_thread(args, bloom, t);
+    }
+    ++ctx->queued;
+    return MARAUDER_GPU_OK;
+}
+
+int emu_collect(void* p, MarauderGpuHit* hits, uint32_t* hit_count, char* err, size_t err_len) {
+    auto* ctx = static_cast<EmuContext*>(p);
+    if (ctx->queued == 0) {
+        set_error(err, err_len, "no scan in flight");
+        return MARAUDER_GPU_ERROR;
+    }
+    const EmuSlot& slot = ctx->slots[ctx->oldest];
+    ctx->oldest = (ctx->oldest + 1) % ctx->config.depth;
+    --ctx->queued;
+    *hit_count = slot.hit_count;
+    uint32_t copy = slot.hit_count < ctx->config.max_hits ? slot.hit_count : ctx->config.max_hits;
+    std::memcpy(hits, slot.hits.get(), copy * sizeof(MarauderGpuHit));
+    return slot.hit_count > ctx->config.max_hits ? MARAUDER_GPU_HIT_OVERFLOW : MARAUDER_GPU_OK;
+}
+
+const MarauderGpuApi kEmuApi = {
+    MARAUDER_GPU_ABI_VERSION, "emu", emu_device_count, emu_open, emu_close, emu_device_name, emu_preferred_keys,
+    emu_set_bloom, emu_submit, emu_collect,
+};
+
+}  // namespace
+
+}  // namespace marauder_gpu
+
+extern "C" __attribute__((visibility("default"))) const MarauderGpuApi* marauder_gpu_plugin() {
+    return &marauder_gpu::kEmuApi;
+}
@@ -0,0 +1,11 @@
+// Geometry of the host-emulated device, shared with the tests that probe
+// the edges of the range it accepts.
+#pragma once
+
+#include <cstdint>
+
+namespace marauder_gpu {
+
+constexpr uint32_t kEmuThreads = 64;
+
+}  // namespace marauder_gpu
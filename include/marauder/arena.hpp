@@ -0,0 +1,91 @@
+// Per-worker bump arena for batch buffers.
+//
+// A scan worker's scratch (its PointBlock, the walker's batch and
+// batch-inversion arrays, the Bloom positives of a block) is sized once
+// from the walker configuration and carved out of one mapping, so the
+// steady-state loop never reaches the heap and its working set sits on as
+// few TLB entries as possible. The mapping uses reserved huge pages
+// (MAP_HUGETLB) if the system has them and otherwise asks for transparent
+// huge pages; without either it is plain 4 KiB pages, which only costs TLB
+// misses. Slices are 64-byte aligned and live as long as the arena.
+//
+// A host that replaces operator new can count every thread's allocations
+// through note_allocation() (the test suite does); scan workers then use
+// thread_allocations() to check that a unit, once they have warmed up,
+// allocates nothing. The library itself never replaces the global
+// allocator, so it leaves the allocator of whatever process loads it alone.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace marauder {
+
+class Arena {
+public:
+    static constexpr size_t kAlign = 64;
+
+    Arena() = default;
+    // Maps at least bytes. Throws std::runtime_error if it cannot.
+    explicit Arena(size_t bytes);
+    ~Arena();
+
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Bytes alloc<T>(n) takes, for sizing an arena up front.
+    template <class T>
+    static constexpr size_t slice_bytes(size_t n) {
+        return (n * sizeof(T) + kAlign - 1) / kAlign * kAlign;
+    }
+
+    // n default-initialised objects in the next slice. They are never
+    // destroyed, hence the restriction. Throws std::runtime_error once the
+    // arena is exhausted.
+    template <class T>
+    T* alloc(size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        static_assert(alignof(T) <= kAlign, "arena slices are only 64-byte aligned");
+        T* p = static_cast<T*>(take(slice_bytes<T>(n)));
+        std::uninitialized_default_construct_n(p, n);
+        return p;
+    }
+
+    // One value-initialised T, as new T() would make it.
+    template <class T>
+    T* make() {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        static_assert(alignof(T) <= kAlign, "arena slices are only 64-byte aligned");
+        return new (take(slice_bytes<T>(1))) T();
+    }
+
+    size_t capacity() const { return size_; }
+    size_t used() const { return used_; }
+    // Backed by reserved huge pages rather than transparent or small ones.
+    bool huge_pages() const { return huge_; }
+
+private:
+    void* take(size_t bytes);
+    void reset();
+
+    uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    size_t used_ = 0;
+    bool huge_ = false;
+};
+
+// Called once by a host whose operator new calls note_allocation().
+void enable_allocation_counting();
+bool counting_allocations();
+// Counts one allocation against the calling thread.
+void note_allocation();
+// note_allocation() calls made so far by the calling thread; always 0
+// unless the host counts.
+uint64_t thread_allocations();
+
+}  // namespace marauder
@@ -0,0 +1,43 @@
+// ISA-specific versions of the Bloom prefilter over a block of digests.
+//
+// A kernel tests n candidate digests against a BloomFilter and writes the
+// indexes of the possible members, in order. Lines are prefetched a window
+// at a time as in the scalar loop; the vector kernels then test all
+// kBloomHashes bits of a line at once instead of one bit per branch:
+//
+//   scalar  one bit at a time, stopping at the first clear bit
+//   avx2    the line as 16 dwords, two permutes and a blend per digest
+//   avx512  the line in one register, a qword permute and a shift
+//
+// About 72% of random candidates fail on the first bit tested, which the
+// scalar loop exploits with a single load and branch, while the line miss
+// costs the same to every kernel. In marauder-bench "bloom" neither vector
+// kernel beats it (avx2 is clearly slower, avx512 level within noise), so
+// bloom_best() is the scalar kernel; the others stay for bloom_find() and
+// the benchmark.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "marauder/bloom.hpp"
+
+namespace marauder {
+
+struct BloomKernel {
+    const char* name;
+    // Writes the indexes i < n with bloom.maybe_contains(digests[i]) to out
+    // (room for n entries) and returns how many there were.
+    size_t (*filter)(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* out);
+};
+
+// Every kernel compiled in and supported by the running CPU, scalar first.
+// Unlike the hash160 and field dispatchers, bloom_best() is not the last.
+const std::vector<const BloomKernel*>& bloom_available();
+const BloomKernel& bloom_best();
+// Returns nullptr for unknown names and for kernels this CPU cannot run.
+const BloomKernel* bloom_find(const std::string& name);
+
+}  // namespace marauder
@@ -0,0 +1,105 @@
+// Baby-step giant-step solver with a reusable, memory-mapped baby-step table.
+//
+// A table of m baby steps stores x(jG) for 1 <= j <= m. A key k in
+// [start, end) is then found by walking giant steps: with centres
+// c_i = start + m + i * (2m + 1), the point Q - c_i * G equals +-jG for
+// some j <= m exactly when k = c_i +- j, so each giant step (one point
+// addition and one lookup) covers 2m + 1 keys. Matching on x alone is what
+// covers both signs.
+//
+// The table does not depend on the range, so it is built once with build()
+// and mapped by later runs in O(1); the page cache then shares it between
+// processes. File layout, little-endian:
+//
+//   BsgsHeader (64 bytes)
+//   Bloom lines           bloom_lines * 64 bytes, keyed on bytes 8..27 of x
+//   keys[records]         uint64 low limb of x(jG), sorted
+//   steps[records]        uint32 j of the matching key
+//
+// Giant steps test the Bloom filter first, so the (much larger) key array
+// is only touched for real matches and the rare false positive.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "marauder/bloom.hpp"
+#include "marauder/field.hpp"
+#include "marauder/mapped_file.hpp"
+#include "marauder/point.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+constexpr char kBsgsMagic[8] = {'M', 'R', 'D', 'R', 'B', 'S', 'G', 'S'};
+constexpr uint32_t kBsgsVersion = 1;
+// j is stored in 32 bits.
+constexpr uint64_t kMaxBabySteps = 0xFFFFFFFFULL;
+
+struct BsgsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bloom_bits;  // bits per key the filter was sized with
+    uint64_t baby_steps;  // m
+    uint64_t bloom_lines;
+    uint64_t records;     // == baby_steps
+    uint8_t reserved[24];
+};
+static_assert(sizeof(BsgsHeader) == 64, "BsgsHeader is part of the file format");
+
+class BsgsTable {
+public:
+    BsgsTable() = default;
+    BsgsTable(BsgsTable&&) = default;
+    BsgsTable& operator=(BsgsTable&&) = default;
+
+    // Computes jG for 1 <= j <= baby_steps on threads threads and writes the
+    // table file. Needs ~16 bytes of RAM per baby step while sorting. Throws
+    // std::invalid_argument for a bad size, std::runtime_error on IO errors.
+    static void build(const std::string& path, uint64_t baby_steps, unsigned threads = 1,
+                      unsigned bloom_bits = kBloomBitsPerKey);
+    // Maps a table file. Throws std::runtime_error if it is not one, or is
+    // truncated.
+    static BsgsTable map(const std::string& path);
+
+    uint64_t baby_steps() const { return steps_count_; }
+    const BloomFilter& bloom() const { return bloom_; }
+
+    // Bloom test on x; false means no baby step has this x.
+    bool maybe_contains(const Fe& x) const { return bloom_.maybe_contains(bloom_key(x)); }
+    // Baby steps whose x agrees with x in the stored 64 bits: writes their
+    // j into out (at most max) and returns how many matched.
+    size_t find(const Fe& x, uint64_t* out, size_t max) const;
+
+    static const uint8_t* bloom_key(const Fe& x) { return reinterpret_cast<const uint8_t*>(&x.d[1]); }
+
+private:
+    MappedFile file_;
+    BloomFilter bloom_;
+    const uint64_t* keys_ = nullptr;
+    const uint32_t* steps_ = nullptr;
+    uint64_t steps_count_ = 0;
+};
+
+struct BsgsConfig {
+    unsigned threads = 1;
+    // Giant-step lanes per thread, advanced together with one batch inversion.
+    size_t lanes = 1024;
+};
+
+struct BsgsResult {
+    bool found = false;
+    U256 key;
+    uint64_t giant_steps = 0;
+    uint64_t bloom_passes = 0;  // giant steps that got past the Bloom filter
+    double seconds = 0;
+};
+
+// Finds k with k * G == pub in [start, end). Throws std::invalid_argument
+// unless 1 <= start < end <= n and the range needs fewer than 2^64 giant
+// steps with this table.
+BsgsResult bsgs_solve(const Point& pub, const U256& start, const U256& end, const BsgsTable& table,
+                      const BsgsConfig& config = BsgsConfig());
+
+}  // namespace marauder
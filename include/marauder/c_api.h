@@ -0,0 +1,97 @@
+/* C ABI for embedding the range scan in another program.
+ *
+ * A searcher owns a target set and runs one scan_range at a time on a
+ * background thread: submit a range, poll its progress from any thread,
+ * drain its hits into a caller-owned array and wait for it to end. Every
+ * type crossing the boundary is POD with fixed-width fields; keys are 32
+ * big-endian bytes. Nothing is copied on the way out except into the
+ * caller's own buffers, and a target table or index file is searched
+ * straight from its mapping. All functions are thread-safe on the same
+ * searcher except marauder_searcher_destroy. Bump the ABI version on any
+ * change to this file; bindings check marauder_abi_version() at load time.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MARAUDER_ABI_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct marauder_searcher marauder_searcher;
+
+enum marauder_status {
+    MARAUDER_OK = 0,
+    MARAUDER_ERROR = 1, /* message in err */
+    MARAUDER_BUSY = 2,  /* a scan is still running */
+};
+
+enum marauder_state {
+    MARAUDER_IDLE = 0, /* nothing submitted yet */
+    MARAUDER_RUNNING = 1,
+    MARAUDER_FINISHED = 2, /* every unit scanned, or cancelled */
+    MARAUDER_FAILED = 3,   /* marauder_searcher_wait has the message */
+};
+
+/* Exactly one target source: digest_count 20-byte hash160 records at
+ * digests (sorted into a table of the searcher's own), a table file or a
+ * target index file. Zero fields take the CLI's defaults. */
+typedef struct marauder_config {
+    uint32_t threads;
+    uint32_t unit_bits;
+    uint32_t batch_size;
+    uint32_t endomorphism; /* also try the five endomorphism candidates */
+    uint32_t pin_threads;
+    uint32_t uncompressed; /* also match each candidate's 65-byte encoding */
+    const uint8_t* digests;
+    uint64_t digest_count;
+    const char* table_path;
+    const char* index_path;
+} marauder_config;
+
+typedef struct marauder_hit {
+    uint8_t key[32];
+    uint8_t pubkey[33]; /* compressed */
+    uint8_t digest[20];
+    uint8_t uncompressed; /* digest is of pubkey's 65-byte encoding */
+} marauder_hit;
+
+typedef struct marauder_progress {
+    uint32_t state;        /* enum marauder_state */
+    uint64_t keys;         /* candidates hashed, endomorphism passes included */
+    uint64_t units_done;
+    uint64_t units_total;
+    uint64_t hits;         /* found by this scan, fetched or not */
+    uint64_t hits_pending; /* waiting for marauder_searcher_fetch_hits */
+    double seconds;
+} marauder_progress;
+
+uint32_t marauder_abi_version(void);
+
+/* Returns NULL with a message in err if the targets cannot be loaded or
+ * the configuration is invalid. */
+marauder_searcher* marauder_searcher_create(const marauder_config* config, char* err, size_t err_len);
+/* Cancels a running scan and waits for it. */
+void marauder_searcher_destroy(marauder_searcher* searcher);
+
+/* Starts scanning [start, end). Returns MARAUDER_BUSY while the previous
+ * scan runs and MARAUDER_ERROR for a bad range; a scan that fails later
+ * reports through marauder_searcher_wait. Hits not fetched from the
+ * previous scan are dropped. */
+int marauder_searcher_submit(marauder_searcher* searcher, const uint8_t start[32], const uint8_t end[32], char* err,
+                             size_t err_len);
+void marauder_searcher_poll(const marauder_searcher* searcher, marauder_progress* out);
+/* Moves up to max hits, oldest first, into out; returns how many. */
+size_t marauder_searcher_fetch_hits(marauder_searcher* searcher, marauder_hit* out, size_t max);
+/* Stops the scan at its workers' next unit boundary. */
+void marauder_searcher_cancel(marauder_searcher* searcher);
+/* Blocks until the scan ends. MARAUDER_OK if it finished (or nothing was
+ * submitted), MARAUDER_ERROR with its message if it failed. */
+int marauder_searcher_wait(marauder_searcher* searcher, char* err, size_t err_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,137 @@
+// Crash-safe record of the work units a sweep has completed.
+//
+// Workers call mark_done() when a unit is fully scanned (its hits already
+// reported). That only pushes the index onto a lock-free list; a
+// background thread drains the list into an IntervalSet every interval and
+// rewrites the checkpoint file, so no worker ever waits on the disk or on
+// a lock. A scan worker marks through its own Marker, whose list nodes are
+// allocated once and handed back by the drain, so a unit's bookkeeping
+// stays off the heap. Each write goes to "<path>.tmp", is fsynced and then renamed over
+// the old file (and the directory fsynced), so after a crash the file is
+// either the previous checkpoint or the new one, never a torn mix.
+//
+// Units are recorded by their position in the sweep's UnitOrder, so the
+// intervals stay few whatever the order. The file is a few lines of text:
+// a header naming the range, unit size and (unless sequential) the order,
+// one "done LO HI" line per merged interval, and an "end" marker. Loading
+// a checkpoint written for a different range, unit size or order throws.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "marauder/interval_set.hpp"
+#include "marauder/metrics.hpp"
+#include "marauder/u256.hpp"
+#include "marauder/unit_order.hpp"
+
+namespace marauder {
+
+class Checkpoint {
+public:
+    class Marker;
+
+private:
+    struct Node {
+        UnitSpan units;
+        Node* next;
+        Marker* owner;  // null for nodes from the heap
+    };
+
+public:
+    // Resumes from path if it exists, else starts empty; a write happens at
+    // most every interval. Throws std::runtime_error if an existing file is
+    // corrupt or belongs to another range, unit size or order.
+    Checkpoint(const std::string& path, const U256& start, const U256& end, unsigned unit_bits,
+               std::chrono::milliseconds interval = std::chrono::seconds(60), const UnitOrder& order = UnitOrder());
+    ~Checkpoint();
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    // Positions completed before this run; pass to RangePartitioner as the skip set.
+    const IntervalSet& resumed() const { return resumed_; }
+
+    const U256& start() const { return start_; }
+    const U256& end() const { return end_; }
+    unsigned unit_bits() const { return unit_bits_; }
+    const UnitOrder& order() const { return order_; }
+
+    // Takes WorkUnit::position. Any thread; lock-free. Not after close().
+    void mark_done(uint64_t position) { mark_done(UnitSpan{position, position + 1}); }
+    void mark_done(const UnitSpan& positions);
+
+    // One worker's supply of list nodes. Its mark_done() is lock-free and
+    // allocation-free while nodes are left; a worker that runs out (having
+    // marked kMarkerNodes units since the last drain) asks the writer for a
+    // drain without a file write and waits for it. Use from one thread at a
+    // time, and destroy before the checkpoint.
+    class Marker {
+    public:
+        static constexpr size_t kMarkerNodes = 64;
+
+        explicit Marker(Checkpoint& checkpoint, size_t nodes = kMarkerNodes);
+        ~Marker();
+        Marker(const Marker&) = delete;
+        Marker& operator=(const Marker&) = delete;
+
+        void mark_done(uint64_t position);
+
+    private:
+        friend class Checkpoint;
+
+        Checkpoint& checkpoint_;
+        std::unique_ptr<Node[]> nodes_;
+        Node* free_ = nullptr;                  // taken only by the owning worker
+        std::atomic<Node*> returned_{nullptr};  // refilled by the drain
+    };
+
+    // Writes everything marked so far and waits for it to reach the disk.
+    void flush();
+    // Final flush and stop of the writer thread. Rethrows the first write
+    // error, from this call or from a background write. Idempotent.
+    void close();
+
+    // Records the duration of every file write from now on in h, which
+    // must outlive this checkpoint's writes.
+    void observe_writes(Histogram* h);
+
+    // Reads a checkpoint file; used on start-up and by tests.
+    static IntervalSet load(const std::string& path, const U256& start, const U256& end, unsigned unit_bits,
+                            const UnitOrder& order = UnitOrder());
+
+private:
+    void push(Node* n);
+    Node* wait_for_nodes(Marker& m);
+    void writer_loop();
+    void drain_locked();
+    void write_locked();
+
+    std::string path_;
+    U256 start_, end_;
+    unsigned unit_bits_;
+    std::chrono::milliseconds interval_;
+    UnitOrder order_;
+    Histogram* write_seconds_ = nullptr;  // guarded by mutex_
+    IntervalSet resumed_;
+
+    std::atomic<Node*> pending_{nullptr};
+
+    std::mutex mutex_;  // guards everything below; taken by the writer, flush() and close()
+    std::condition_variable wake_;
+    std::condition_variable drained_;  // a drain handed nodes back
+    IntervalSet done_;
+    bool starved_ = false;  // a Marker waits for its nodes
+    bool dirty_ = false;
+    bool closing_ = false;
+    std::exception_ptr error_;
+    std::thread writer_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,63 @@
+// Worker side of the coordinator protocol.
+//
+// CoordClient is one connection to marauder-coordinator; its calls are
+// blocking request/response round trips and may come from any thread.
+// scan_coordinated() is the worker loop: lease a batch of units, scan it
+// with scan_range (all local threads and GPUs), report its hits, complete
+// it, repeat until the coordinator says the range is finished. A
+// background thread heartbeats the current lease meanwhile, so one lease
+// round trip is spent per batch of units, not per unit.
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "marauder/coord_protocol.hpp"
+#include "marauder/scan.hpp"
+
+namespace marauder {
+
+struct CoordEndpoint {
+    std::string host;
+    uint16_t port;
+};
+
+// Parses "host:port" or "[v6 address]:port"; throws std::invalid_argument.
+CoordEndpoint parse_coord_endpoint(const std::string& text);
+
+class CoordClient {
+public:
+    // Connects and exchanges Hello/Welcome; throws std::runtime_error.
+    CoordClient(const CoordEndpoint& at, const HelloMsg& hello);
+    ~CoordClient();
+    CoordClient(const CoordClient&) = delete;
+    CoordClient& operator=(const CoordClient&) = delete;
+
+    const WelcomeMsg& welcome() const { return welcome_; }
+
+    LeaseMsg lease(uint32_t max_units);
+    // Returns the leases the coordinator no longer holds.
+    std::vector<uint64_t> heartbeat(const std::vector<uint64_t>& lease_ids);
+    void complete(uint64_t lease_id, const std::vector<UnitSpan>& spans);
+    void report_hits(const std::vector<ScanHit>& hits);
+
+private:
+    // Sends request and returns the reply; an Error reply throws.
+    Frame call(const std::vector<uint8_t>& request);
+
+    int fd_;
+    std::mutex mutex_;  // one round trip at a time
+    std::vector<uint8_t> in_;
+    WelcomeMsg welcome_;
+};
+
+// Scans leases from client until the range is finished. config's range
+// comes from the coordinator, as do unit_bits and endomorphism (the values
+// in config are ignored); config.checkpoint must be null, the coordinator
+// keeps the checkpoint. Each lease asks for lease_units units.
+ScanStats scan_coordinated(CoordClient& client, const ScanConfig& config, const ScanHitFn& on_hit,
+                           uint32_t lease_units);
+
+}  // namespace marauder
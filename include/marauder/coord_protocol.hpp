@@ -0,0 +1,131 @@
+// Wire protocol between marauder workers and marauder-coordinator.
+//
+// Every message is one frame: a little-endian u32 length, then a type
+// byte and the body (length counts both). Integers in bodies are LEB128
+// varints; span lists are delta-encoded (gap from the previous span's end,
+// then length), so a lease of thousands of contiguous units is a few bytes.
+// The protocol is strictly request/response from the worker's side:
+//
+//   Hello        -> Welcome        (once per connection)
+//   LeaseRequest -> Lease          (granted spans, wait, or finished)
+//   Heartbeat    -> HeartbeatAck   (leases the coordinator no longer holds)
+//   Complete     -> Ack            (spans of a lease fully scanned)
+//   Hits         -> Ack            (confirmed hits, before the Complete)
+//
+// Any request can also be answered with Error.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "marauder/scan.hpp"
+#include "marauder/u256.hpp"
+#include "marauder/work_deque.hpp"
+
+namespace marauder {
+
+constexpr uint32_t kCoordMagic = 0x5244524D;  // "MRDR"
+constexpr uint16_t kCoordVersion = 2;
+constexpr uint32_t kCoordMaxFrame = 16u << 20;
+
+enum class MsgType : uint8_t {
+    Hello = 1,
+    Welcome,
+    LeaseRequest,
+    Lease,
+    Heartbeat,
+    HeartbeatAck,
+    Complete,
+    Hits,
+    Ack,
+    Error,
+};
+
+struct HelloMsg {
+    uint32_t slots = 1;  // parallel workers behind this connection (threads + GPUs)
+    std::string name;
+};
+
+struct WelcomeMsg {
+    uint64_t worker_id = 0;
+    U256 start, end;
+    uint32_t unit_bits = 0;
+    uint32_t lease_ms = 0;      // a lease expires this long after its last heartbeat
+    uint32_t heartbeat_ms = 0;  // how often workers should heartbeat
+    bool endomorphism = false;
+};
+
+struct LeaseRequestMsg {
+    uint32_t max_units = 0;
+};
+
+enum class LeaseStatus : uint8_t {
+    Granted,
+    Wait,      // everything left is leased to someone; ask again after retry_ms
+    Finished,  // the whole range is done
+};
+
+struct LeaseMsg {
+    LeaseStatus status = LeaseStatus::Finished;
+    uint64_t lease_id = 0;
+    uint32_t retry_ms = 0;
+    std::vector<UnitSpan> spans;
+};
+
+struct HeartbeatMsg {
+    std::vector<uint64_t> lease_ids;
+};
+
+struct HeartbeatAckMsg {
+    std::vector<uint64_t> lost;  // expired or unknown; stop scanning them
+};
+
+struct CompleteMsg {
+    uint64_t lease_id = 0;
+    std::vector<UnitSpan> spans;
+};
+
+struct HitsMsg {
+    std::vector<ScanHit> hits;
+};
+
+struct ErrorMsg {
+    std::string message;
+};
+
+// A decoded frame: the type and its body bytes.
+struct Frame {
+    MsgType type;
+    std::vector<uint8_t> body;
+};
+
+std::vector<uint8_t> encode(const HelloMsg& m);
+std::vector<uint8_t> encode(const WelcomeMsg& m);
+std::vector<uint8_t> encode(const LeaseRequestMsg& m);
+std::vector<uint8_t> encode(const LeaseMsg& m);
+std::vector<uint8_t> encode(const HeartbeatMsg& m);
+std::vector<uint8_t> encode(const HeartbeatAckMsg& m);
+std::vector<uint8_t> encode(const CompleteMsg& m);
+std::vector<uint8_t> encode(const HitsMsg& m);
+std::vector<uint8_t> encode_ack();
+std::vector<uint8_t> encode(const ErrorMsg& m);
+
+// Decoders throw std::runtime_error on malformed bodies.
+void decode(const Frame& f, HelloMsg& m);
+void decode(const Frame& f, WelcomeMsg& m);
+void decode(const Frame& f, LeaseRequestMsg& m);
+void decode(const Frame& f, LeaseMsg& m);
+void decode(const Frame& f, HeartbeatMsg& m);
+void decode(const Frame& f, HeartbeatAckMsg& m);
+void decode(const Frame& f, CompleteMsg& m);
+void decode(const Frame& f, HitsMsg& m);
+void decode(const Frame& f, ErrorMsg& m);
+
+// Splits the first complete frame off the front of buf. Returns false if
+// buf does not hold a whole frame yet; throws std::runtime_error for
+// oversized frames.
+bool take_frame(std::vector<uint8_t>& buf, Frame& out);
+
+}  // namespace marauder
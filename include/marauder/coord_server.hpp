@@ -0,0 +1,67 @@
+// TCP front end of a Coordinator.
+//
+// One thread runs a poll() loop over the listening socket and every worker
+// connection, so the Coordinator needs no locking. Each connection says
+// Hello once and then sends requests; the server answers each in order.
+// A connection that drops, or sends a malformed frame, has its leases
+// returned to the pool at once instead of waiting for them to expire.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "marauder/coordinator.hpp"
+#include "marauder/scan.hpp"
+
+namespace marauder {
+
+struct CoordServerConfig {
+    std::string host;   // empty listens on every interface
+    uint16_t port = 0;  // 0 picks a free port; see CoordServer::port()
+    // Sent to workers; keep it well below the coordinator's lease time.
+    std::chrono::milliseconds heartbeat = std::chrono::seconds(30);
+    bool endomorphism = false;
+};
+
+// Called from run() for every hit a worker reports, with the worker's name.
+using CoordHitFn = std::function<void(const ScanHit&, const std::string& worker)>;
+
+class CoordServer {
+public:
+    // Binds the listening socket; throws std::runtime_error on failure.
+    CoordServer(Coordinator& coord, const CoordServerConfig& config, CoordHitFn on_hit = nullptr);
+    ~CoordServer();
+    CoordServer(const CoordServer&) = delete;
+    CoordServer& operator=(const CoordServer&) = delete;
+
+    uint16_t port() const { return port_; }
+    size_t workers() const;
+
+    // Serves until stop(), or until the range is finished and every worker
+    // has disconnected.
+    void run();
+    // Any thread, and async-signal-safe: run() returns soon after.
+    void stop();
+
+private:
+    struct Conn;
+    void accept_all();
+    bool read_from(Conn& c);
+    void handle(Conn& c, const Frame& f);
+    bool flush(Conn& c);
+    void drop(size_t i);
+
+    Coordinator& coord_;
+    CoordServerConfig config_;
+    CoordHitFn on_hit_;
+    int listen_fd_ = -1;
+    int wake_[2] = {-1, -1};
+    uint16_t port_ = 0;
+    uint64_t next_worker_ = 1;
+    std::vector<std::unique_ptr<Conn>> conns_;
+};
+
+}  // namespace marauder
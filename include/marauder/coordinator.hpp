@@ -0,0 +1,102 @@
+// Central bookkeeping for a sweep shared by many machines.
+//
+// The coordinator splits the range into the same work units as
+// RangePartitioner and hands them out as leases: batches of up to
+// max_lease_units units, as few spans as possible. A lease stays valid as
+// long as its holder heartbeats at least every lease_time; an expired
+// lease, or every lease of a worker that disconnects, goes back to the
+// pending pool and is handed to the next worker that asks. Completed
+// spans are merged into an IntervalSet (and a Checkpoint, if given), so a
+// restarted coordinator resumes with only the unfinished units.
+//
+// A completion only counts for units its lease held. That includes a lease
+// that has already expired, for its units not yet leased again: they were
+// scanned, and nobody else has them. Anything else a completion names
+// (units of another lease, an unknown lease id) is dropped and counted in
+// rejected_units(), so a confused worker cannot mark unscanned units done.
+//
+// Not thread-safe; CoordServer drives it from a single thread.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "marauder/checkpoint.hpp"
+#include "marauder/coord_protocol.hpp"
+#include "marauder/interval_set.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+struct CoordinatorConfig {
+    unsigned unit_bits = kDefaultUnitBits;
+    std::chrono::milliseconds lease_time = std::chrono::minutes(5);
+    // Cap on one lease, whatever the worker asks for.
+    uint32_t max_lease_units = 1u << 16;
+};
+
+class Coordinator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Throws std::invalid_argument like RangePartitioner for bad ranges, and
+    // if a checkpoint was opened for another range or unit size.
+    Coordinator(const U256& start, const U256& end, const CoordinatorConfig& config,
+                Checkpoint* checkpoint = nullptr);
+
+    // Grants worker up to max_units pending units. Status Wait means the
+    // remaining units are all leased out; Finished that the range is done.
+    LeaseMsg lease(uint64_t worker, uint32_t max_units, Clock::time_point now);
+    // Extends the named leases; returns those that are no longer held.
+    std::vector<uint64_t> heartbeat(const std::vector<uint64_t>& lease_ids, Clock::time_point now);
+    // Records the parts of spans the lease holds as done and ends the lease;
+    // units of the lease that are not in spans go back to the pool.
+    void complete(uint64_t lease_id, const std::vector<UnitSpan>& spans);
+    // Returns every lease of worker to the pool (it disconnected).
+    void release_worker(uint64_t worker);
+    // Returns expired leases to the pool; the number of units reclaimed.
+    uint64_t expire(Clock::time_point now);
+    // Earliest lease expiry, or Clock::time_point::max() with no leases.
+    Clock::time_point next_expiry() const;
+
+    bool finished() const { return done_.count() == units_; }
+    const U256& start() const { return start_; }
+    const U256& end() const { return end_; }
+    const CoordinatorConfig& config() const { return config_; }
+    uint64_t unit_count() const { return units_; }
+    uint64_t done_units() const { return done_.count(); }
+    uint64_t pending_units() const { return pool_.count(); }
+    uint64_t leased_units() const { return units_ - done_.count() - pool_.count(); }
+    size_t active_leases() const { return leases_.size(); }
+    uint64_t reassigned_units() const { return reassigned_; }
+    uint64_t rejected_units() const { return rejected_; }
+    const IntervalSet& done() const { return done_; }
+
+private:
+    struct Lease {
+        uint64_t worker;
+        std::vector<UnitSpan> spans;
+        Clock::time_point expires;
+    };
+
+    void return_units(const UnitSpan& s);
+    void retire(uint64_t id, const Lease& lease);
+
+    U256 start_, end_;
+    CoordinatorConfig config_;
+    Checkpoint* checkpoint_;
+    uint64_t units_;
+    IntervalSet done_;
+    IntervalSet pool_;  // neither done nor leased
+    std::unordered_map<uint64_t, Lease> leases_;
+    // Units of expired or released leases that are back in the pool but not
+    // leased again, which a late completion of that lease may still claim.
+    std::unordered_map<uint64_t, IntervalSet> retired_;
+    uint64_t next_lease_ = 1;
+    uint64_t reassigned_ = 0;
+    uint64_t rejected_ = 0;
+};
+
+}  // namespace marauder
@@ -0,0 +1,107 @@
+// Distinguished-point store for kangaroo runs too large for RAM.
+//
+// New points go into an open-addressing hash table. When that holds
+// memory_records points it is sorted and spilled to disk as a run file,
+// and the table starts over. Every insert checks the table and then each
+// run, newest first: a run keeps a Bloom filter and a sparse block index
+// in memory, so all but a tiny fraction of inserts never touch the disk
+// and the rest read one block. A collision is therefore reported at the
+// insert that causes it, wherever the earlier point lives. Since no store
+// ever holds a key twice, compacting its runs (merged once there are more
+// than kMaxDpRuns) needs no checks.
+//
+// Run files double as work files. write_work_file() streams the table and
+// all runs into one file, and merge_work_files() streams two of them
+// (say, from different machines) into a third, reporting keys found in
+// both. Both are k-way merges over mapped files, so neither loads a file.
+//
+// A run is blocks of kDpBlockRecords records sorted by key. Keys are
+// delta-encoded and distances stored in as many bytes as they need. After
+// the blocks come the block index and the Bloom filter. A 64-byte header
+// names the job, so files of different searches cannot be mixed.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+constexpr size_t kDpBlockRecords = 1024;
+constexpr size_t kMaxDpRuns = 16;
+
+struct DpRecord {
+    uint64_t key_hi = 0, key_lo = 0;  // 128 bits of the point's x
+    U256 dist;                        // distance the kangaroo had travelled
+    uint8_t kind = 0;                 // 0 or 1; kangaroo: 0 tame, 1 wild
+};
+
+inline bool dp_key_less(const DpRecord& a, const DpRecord& b) {
+    return a.key_hi != b.key_hi ? a.key_hi < b.key_hi : a.key_lo < b.key_lo;
+}
+
+struct DpStoreConfig {
+    // Run files are "<path>.<n>.dp". Empty keeps everything in memory.
+    std::string path;
+    // Points held in RAM before a spill; slots are 56 bytes at up to 3/4 load.
+    size_t memory_records = size_t(1) << 22;
+    // Identifies the search; files with another job are rejected.
+    uint64_t job = 0;
+    unsigned bloom_bits = 16;
+};
+
+class DpRun;  // one mapped run file, defined in dp_store.cpp
+
+using DpCollisionFn = std::function<void(const DpRecord& a, const DpRecord& b)>;
+
+class DpStore {
+public:
+    // Reopens the runs of an earlier store at config.path. Throws
+    // std::runtime_error for unreadable runs or runs of another job.
+    explicit DpStore(const DpStoreConfig& config);
+    ~DpStore();
+    DpStore(const DpStore&) = delete;
+    DpStore& operator=(const DpStore&) = delete;
+
+    // Stores r unless its key is present already; then copies the stored
+    // point to prev, leaves the store unchanged and returns true.
+    bool insert(const DpRecord& r, DpRecord& prev);
+
+    uint64_t size() const { return memory_count_ + on_disk_; }
+    uint64_t in_memory() const { return memory_count_; }
+    size_t runs() const { return runs_.size(); }
+    uint64_t disk_reads() const { return disk_reads_; }
+
+    // Writes the in-memory points as a new run (no-op when memory-only).
+    void spill();
+    // Writes every point, sorted, into one work file.
+    void write_work_file(const std::string& path) const;
+
+    // Streams work files a and b into out. Keys present in both are kept
+    // once (a's record) and passed to on_collision. Returns the records
+    // written. Throws std::runtime_error if the files' jobs differ.
+    static uint64_t merge_work_files(const std::string& a, const std::string& b, const std::string& out,
+                                     const DpCollisionFn& on_collision);
+
+private:
+    size_t slot_of(uint64_t key_hi, uint64_t key_lo) const;
+    void grow();
+    std::vector<DpRecord> sorted_memory() const;
+    std::string run_path(size_t n) const;
+    void compact();
+
+    DpStoreConfig config_;
+    std::vector<DpRecord> table_;  // kind 0xFF marks an empty slot
+    size_t memory_count_ = 0;
+    std::vector<std::unique_ptr<DpRun>> runs_;  // oldest first
+    uint64_t on_disk_ = 0;
+    uint64_t disk_reads_ = 0;
+    size_t next_run_ = 0;
+};
+
+}  // namespace marauder
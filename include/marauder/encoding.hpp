@@ -0,0 +1,28 @@
+// Text encodings for keys, digests, public keys and addresses.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace marauder {
+
+std::string bytes_to_hex(const uint8_t* data, size_t len);
+// Decodes exactly len bytes (2 * len digits). Throws std::invalid_argument
+// on a length mismatch or a non-hex character.
+void hex_to_bytes(const std::string& hex, uint8_t* out, size_t len);
+
+enum class AddressStatus {
+    Hash160,      // pays to the hash160 of a public key
+    Unsupported,  // valid, but pays to a script or an untweaked x-only key
+    Invalid,      // not an address: bad characters, length or checksum
+};
+
+// Decodes a mainnet P2PKH (Base58Check, version 0, "1...") or P2WPKH
+// (Bech32, witness v0 with a 20-byte program, "bc1q...") address into the
+// hash160 it pays to. Other well-formed addresses (P2SH, P2WSH, Taproot,
+// other networks) are Unsupported: no key we scan hashes to them. Does not
+// allocate, so bulk ingestion can call it once per line.
+AddressStatus decode_address(const char* text, size_t len, uint8_t out[20]);
+
+}  // namespace marauder
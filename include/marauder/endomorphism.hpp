@@ -0,0 +1,77 @@
+// secp256k1's efficient endomorphism as a source of extra candidates.
+//
+// beta is a non-trivial cube root of unity mod p and lambda the matching
+// one mod n, so (beta * x, y) = lambda * (x, y). From one computed point
+// kG we get lambda*kG and lambda^2*kG for one field multiply each, and the
+// negation of all three by flipping y: six public keys per walker step.
+//
+// The five extra keys are lambda^j * k and n - lambda^j * k, which are
+// spread over the whole group, not inside the walker's range. That only
+// pays off when any key is worth finding (multi-target or full-keyspace
+// scans); a bounded puzzle sweep must leave it off, which is why callers
+// gate it behind an explicit out-of-range opt-in.
+#pragma once
+
+#include <cstdint>
+
+#include "marauder/field.hpp"
+#include "marauder/point.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+constexpr unsigned kEndoCandidates = 6;
+
+constexpr Fe kEndoBeta = Fe{{0xC1396C28719501EEULL, 0x9CF0497512F58995ULL,
+                             0x6E64479EAC3434E9ULL, 0x7AE96A2B657C0710ULL}};
+constexpr Fe kEndoBeta2 = Fe{{0x3EC693D68E6AFA40ULL, 0x630FB68AED0A766AULL,
+                              0x919BB86153CBCB16ULL, 0x851695D49A83F8EFULL}};
+constexpr Scalar kEndoLambda = Scalar{{0xDF02967C1B23BD72ULL, 0x122E22EA20816678ULL,
+                                       0xA5261C028812645AULL, 0x5363AD4CC05C30E0ULL}};
+constexpr Scalar kEndoLambda2 = Scalar{{0xE0CFC810B51283CEULL, 0xA880B9FC8EC739C2ULL,
+                                        0x5AD9E3FD77ED9BA4ULL, 0xAC9C52B33FA3CF1FULL}};
+
+// Candidate v (0 <= v < 6) of a point P = kG is (-1)^(v & 1) * lambda^(v/2) * P,
+// so candidate 0 is P itself and odd candidates are negations.
+inline void endo_expand(const Point& p, Point out[kEndoCandidates]) {
+    out[0] = p;
+    out[2] = Point{Fe::zero(), p.y, p.infinity};
+    out[4] = Point{Fe::zero(), p.y, p.infinity};
+    fe_mul(out[2].x, p.x, kEndoBeta);
+    fe_mul(out[4].x, p.x, kEndoBeta2);
+    Fe neg_y;
+    fe_neg(neg_y, p.y);
+    for (unsigned j = 0; j < kEndoCandidates; j += 2) out[j + 1] = Point{out[j].x, neg_y, p.infinity};
+}
+
+// Private key of candidate v given the private key k of the walked point.
+Scalar endo_candidate_key(const Scalar& k, unsigned v);
+
+// PointBlock form: after hashing the walked block, pass p = 1..5 applies
+// endo_block_step(blk, p) in place (odd passes negate, even passes
+// multiply x by beta) so the block walks through all six candidates with
+// one multiply per lane per beta step. kEndoBlockOrder[p] is the candidate
+// the block holds after pass p.
+constexpr unsigned kEndoBlockOrder[kEndoCandidates] = {0, 1, 3, 2, 4, 5};
+
+template <size_t N>
+void endo_block_step(PointBlock<N>& blk, unsigned pass) {
+    if (pass & 1) {
+        for (size_t i = 0; i < blk.count; ++i) blk.y_odd[i] ^= 1;
+        if (!blk.has_y) return;
+        for (size_t i = 0; i < blk.count; ++i) {
+            Fe y{{blk.y[0][i], blk.y[1][i], blk.y[2][i], blk.y[3][i]}};
+            fe_neg(y, y);
+            for (int k = 0; k < 4; ++k) blk.y[k][i] = y.d[k];
+        }
+        return;
+    }
+    for (size_t i = 0; i < blk.count; ++i) {
+        Fe x{{blk.x[0][i], blk.x[1][i], blk.x[2][i], blk.x[3][i]}};
+        fe_mul(x, x, kEndoBeta);
+        for (int k = 0; k < 4; ++k) blk.x[k][i] = x.d[k];
+    }
+}
+
+}  // namespace marauder
@@ -0,0 +1,259 @@
+// Arithmetic in GF(p), p = 2^256 - 2^32 - 977 (the secp256k1 base field).
+//
+// Elements are four 64-bit limbs and are kept fully reduced (0 <= x < p)
+// after every operation, so equality is limb-wise and serialisation needs no
+// normalisation step. Multiplication is a 4x4 schoolbook product with
+// unsigned __int128 accumulators followed by a two-step fold using
+// 2^256 = 2^32 + 977 (mod p). Everything here is allocation-free and the hot
+// operations are inline so the walker loops can keep values in registers.
+#pragma once
+
+#include <cstdint>
+
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+struct Fe {
+    uint64_t d[4];  // little-endian limbs, always < p
+
+    static constexpr Fe zero() { return Fe{{0, 0, 0, 0}}; }
+    static constexpr Fe one() { return Fe{{1, 0, 0, 0}}; }
+    static constexpr Fe from_u64(uint64_t v) { return Fe{{v, 0, 0, 0}}; }
+
+    // Reduces an arbitrary 256-bit integer modulo p.
+    static Fe from_u256(const U256& v);
+    // Big-endian 32 bytes; returns false (and leaves r untouched) if >= p.
+    static bool from_be_bytes(Fe& r, const uint8_t in[32]);
+
+    U256 to_u256() const { return U256{{d[0], d[1], d[2], d[3]}}; }
+    void to_be_bytes(uint8_t out[32]) const { to_u256().to_be_bytes(out); }
+
+    bool is_zero() const { return (d[0] | d[1] | d[2] | d[3]) == 0; }
+    bool is_odd() const { return d[0] & 1; }
+};
+
+// 2^256 mod p.
+constexpr uint64_t kFieldC = 0x1000003D1ULL;
+
+constexpr Fe kFieldP = Fe{{0xFFFFFFFEFFFFFC2FULL, 0xFFFFFFFFFFFFFFFFULL,
+                           0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL}};
+
+inline bool operator==(const Fe& a, const Fe& b) {
+    return ((a.d[0] ^ b.d[0]) | (a.d[1] ^ b.d[1]) | (a.d[2] ^ b.d[2]) | (a.d[3] ^ b.d[3])) == 0;
+}
+inline bool operator!=(const Fe& a, const Fe& b) { return !(a == b); }
+
+namespace detail {
+
+// r = (c0..c3) + carry*2^256 reduced into [0, p). Requires the input to be
+// below 2^256 + p, which every caller below guarantees.
+inline void fe_finish(Fe& r, uint64_t c0, uint64_t c1, uint64_t c2, uint64_t c3, uint64_t carry) {
+    // x >= p  <=>  x + C overflows 2^256, since p = 2^256 - C.
+    u128 t = (u128)c0 + kFieldC;
+    uint64_t t0 = (uint64_t)t;
+    t = (t >> 64) + c1;
+    uint64_t t1 = (uint64_t)t;
+    t = (t >> 64) + c2;
+    uint64_t t2 = (uint64_t)t;
+    t = (t >> 64) + c3;
+    uint64_t t3 = (uint64_t)t;
+    uint64_t over = (uint64_t)(t >> 64) | carry;
+    uint64_t mask = 0 - over;
+    r.d[0] = (t0 & mask) | (c0 & ~mask);
+    r.d[1] = (t1 & mask) | (c1 & ~mask);
+    r.d[2] = (t2 & mask) | (c2 & ~mask);
+    r.d[3] = (t3 & mask) | (c3 & ~mask);
+}
+
+// Reduces the 512-bit product t[0..7] modulo p.
+inline void fe_reduce512(Fe& r, const uint64_t t[8]) {
+    // Fold the high half: lo + hi * C, leaving a 290-bit value.
+    u128 acc = (u128)t[4] * kFieldC + t[0];
+    uint64_t c0 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)t[5] * kFieldC + t[1];
+    uint64_t c1 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)t[6] * kFieldC + t[2];
+    uint64_t c2 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)t[7] * kFieldC + t[3];
+    uint64_t c3 = (uint64_t)acc;
+    uint64_t c4 = (uint64_t)(acc >> 64);  // < 2^34
+
+    // Fold the remaining 34 bits. The result is < 2^256 + 2^67, which
+    // fe_finish handles with its single conditional subtraction.
+    acc = (u128)c4 * kFieldC + c0;
+    c0 = (uint64_t)acc;
+    acc = (acc >> 64) + c1;
+    c1 = (uint64_t)acc;
+    acc = (acc >> 64) + c2;
+    c2 = (uint64_t)acc;
+    acc = (acc >> 64) + c3;
+    c3 = (uint64_t)acc;
+    fe_finish(r, c0, c1, c2, c3, (uint64_t)(acc >> 64));
+}
+
+}  // namespace detail
+
+inline void fe_add(Fe& r, const Fe& a, const Fe& b) {
+    u128 acc = (u128)a.d[0] + b.d[0];
+    uint64_t c0 = (uint64_t)acc;
+    acc = (acc >> 64) + a.d[1] + b.d[1];
+    uint64_t c1 = (uint64_t)acc;
+    acc = (acc >> 64) + a.d[2] + b.d[2];
+    uint64_t c2 = (uint64_t)acc;
+    acc = (acc >> 64) + a.d[3] + b.d[3];
+    uint64_t c3 = (uint64_t)acc;
+    detail::fe_finish(r, c0, c1, c2, c3, (uint64_t)(acc >> 64));
+}
+
+inline void fe_sub(Fe& r, const Fe& a, const Fe& b) {
+    u128 t = (u128)a.d[0] - b.d[0];
+    uint64_t c0 = (uint64_t)t;
+    t = (u128)a.d[1] - b.d[1] - ((uint64_t)(t >> 64) & 1);
+    uint64_t c1 = (uint64_t)t;
+    t = (u128)a.d[2] - b.d[2] - ((uint64_t)(t >> 64) & 1);
+    uint64_t c2 = (uint64_t)t;
+    t = (u128)a.d[3] - b.d[3] - ((uint64_t)(t >> 64) & 1);
+    uint64_t c3 = (uint64_t)t;
+    // On borrow add p back, i.e. subtract C modulo 2^256.
+    uint64_t mask = 0 - ((uint64_t)(t >> 64) & 1);
+    uint64_t k = kFieldC & mask;
+    t = (u128)c0 - k;
+    r.d[0] = (uint64_t)t;
+    t = (u128)c1 - ((uint64_t)(t >> 64) & 1);
+    r.d[1] = (uint64_t)t;
+    t = (u128)c2 - ((uint64_t)(t >> 64) & 1);
+    r.d[2] = (uint64_t)t;
+    r.d[3] = c3 - ((uint64_t)(t >> 64) & 1);
+}
+
+inline void fe_neg(Fe& r, const Fe& a) { fe_sub(r, Fe::zero(), a); }
+
+inline void fe_mul(Fe& r, const Fe& a, const Fe& b) {
+    uint64_t t[8];
+    u128 acc;
+    uint64_t carry;
+
+    acc = (u128)a.d[0] * b.d[0];
+    t[0] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[0] * b.d[1] + carry;
+    t[1] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[0] * b.d[2] + carry;
+    t[2] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[0] * b.d[3] + carry;
+    t[3] = (uint64_t)acc;
+    t[4] = (uint64_t)(acc >> 64);
+
+    for (int i = 1; i < 4; ++i) {
+        carry = 0;
+        for (int j = 0; j < 4; ++j) {
+            acc = (u128)a.d[i] * b.d[j] + t[i + j] + carry;
+            t[i + j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i + 4] = carry;
+    }
+    detail::fe_reduce512(r, t);
+}
+
+inline void fe_sqr(Fe& r, const Fe& a) {
+    uint64_t t[8];
+    u128 acc;
+    uint64_t carry;
+
+    // Off-diagonal products a[i]*a[j], i < j.
+    acc = (u128)a.d[0] * a.d[1];
+    t[1] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[0] * a.d[2] + carry;
+    t[2] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[0] * a.d[3] + carry;
+    t[3] = (uint64_t)acc;
+    t[4] = (uint64_t)(acc >> 64);
+
+    acc = (u128)a.d[1] * a.d[2] + t[3];
+    t[3] = (uint64_t)acc;
+    carry = (uint64_t)(acc >> 64);
+    acc = (u128)a.d[1] * a.d[3] + t[4] + carry;
+    t[4] = (uint64_t)acc;
+    t[5] = (uint64_t)(acc >> 64);
+
+    acc = (u128)a.d[2] * a.d[3] + t[5];
+    t[5] = (uint64_t)acc;
+    t[6] = (uint64_t)(acc >> 64);
+
+    // Double them.
+    t[7] = t[6] >> 63;
+    t[6] = (t[6] << 1) | (t[5] >> 63);
+    t[5] = (t[5] << 1) | (t[4] >> 63);
+    t[4] = (t[4] << 1) | (t[3] >> 63);
+    t[3] = (t[3] << 1) | (t[2] >> 63);
+    t[2] = (t[2] << 1) | (t[1] >> 63);
+    t[1] = t[1] << 1;
+
+    // Add the squares on the diagonal.
+    acc = (u128)a.d[0] * a.d[0];
+    t[0] = (uint64_t)acc;
+    acc = (acc >> 64) + t[1];
+    t[1] = (uint64_t)acc;
+    u128 sq = (u128)a.d[1] * a.d[1];
+    acc = (acc >> 64) + t[2] + (uint64_t)sq;
+    t[2] = (uint64_t)acc;
+    acc = (acc >> 64) + t[3] + (uint64_t)(sq >> 64);
+    t[3] = (uint64_t)acc;
+    sq = (u128)a.d[2] * a.d[2];
+    acc = (acc >> 64) + t[4] + (uint64_t)sq;
+    t[4] = (uint64_t)acc;
+    acc = (acc >> 64) + t[5] + (uint64_t)(sq >> 64);
+    t[5] = (uint64_t)acc;
+    sq = (u128)a.d[3] * a.d[3];
+    acc = (acc >> 64) + t[6] + (uint64_t)sq;
+    t[6] = (uint64_t)acc;
+    acc = (acc >> 64) + t[7] + (uint64_t)(sq >> 64);
+    t[7] = (uint64_t)acc;
+
+    detail::fe_reduce512(r, t);
+}
+
+// r = a * v for a small multiplier (v < 2^32), e.g. the 2, 3, 8 in the
+// doubling formulas.
+inline void fe_mul_small(Fe& r, const Fe& a, uint32_t v) {
+    u128 acc = (u128)a.d[0] * v;
+    uint64_t c0 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)a.d[1] * v;
+    uint64_t c1 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)a.d[2] * v;
+    uint64_t c2 = (uint64_t)acc;
+    acc = (acc >> 64) + (u128)a.d[3] * v;
+    uint64_t c3 = (uint64_t)acc;
+    uint64_t hi = (uint64_t)(acc >> 64);  // < 2^32
+    acc = (u128)hi * kFieldC + c0;
+    c0 = (uint64_t)acc;
+    acc = (acc >> 64) + c1;
+    c1 = (uint64_t)acc;
+    acc = (acc >> 64) + c2;
+    c2 = (uint64_t)acc;
+    acc = (acc >> 64) + c3;
+    c3 = (uint64_t)acc;
+    detail::fe_finish(r, c0, c1, c2, c3, (uint64_t)(acc >> 64));
+}
+
+// Repeated squaring: r = a^(2^n).
+inline void fe_sqr_n(Fe& r, const Fe& a, int n) {
+    r = a;
+    for (int i = 0; i < n; ++i) fe_sqr(r, r);
+}
+
+// r = a^-1 (Fermat, a^(p-2)); r = 0 for a = 0. About 255 squarings and
+// 15 multiplications, so hot loops should amortise it across many elements.
+void fe_inv(Fe& r, const Fe& a);
+
+// Square root: returns false if a is not a quadratic residue. On success
+// r^2 == a, with an unspecified choice of sign.
+bool fe_sqrt(Fe& r, const Fe& a);
+
+}  // namespace marauder
@@ -0,0 +1,47 @@
+// ISA-specific versions of the walker's batch field work.
+//
+// The hot loop of every walk is one batch inversion followed by one affine
+// addition per lane against a shared base point. Those two steps are what
+// a FieldKernel provides, compiled several times:
+//
+//   generic   the inline field.hpp arithmetic, baseline x86-64 or ARMv8
+//   bmi2-adx  the same code built for BMI2/ADX, so the 64x64 products use
+//             mulx (x86-64 from Broadwell and Zen on); GCC emits no
+//             adcx/adox for it and it measures level with generic
+//   ifma      eight lanes at once in radix 2^52 with the AVX-512 IFMA
+//             52-bit multiply-accumulate (Ice Lake, Zen 4)
+//
+// field_best() picks the last kernel the running CPU supports, checked
+// once with cpuid. Every kernel returns exactly the fully reduced results
+// of the generic one; the tests cross-check them lane by lane.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "marauder/field.hpp"
+#include "marauder/point.hpp"
+
+namespace marauder {
+
+struct FieldKernel {
+    const char* name;
+    // fe_batch_inv semantics (zero elements stay zero), but scratch must
+    // hold 2 * n elements.
+    void (*batch_inv)(Fe* elems, size_t n, Fe* scratch);
+    // out[i] = base + s_i for i < n, where s_i is steps[i] or, with negate,
+    // -steps[i], and inv[i] = 1 / (steps[i].x - base.x) from a batch
+    // inversion. Zero inverses take the general group law, as in
+    // point_add_inv.
+    void (*add_batch)(Point* out, const Point& base, const Point* steps, const Fe* inv, size_t n, bool negate);
+};
+
+// Every kernel compiled in and supported by the running CPU, generic
+// first.
+const std::vector<const FieldKernel*>& field_available();
+const FieldKernel& field_best();
+// Returns nullptr for unknown names and for kernels this CPU cannot run.
+const FieldKernel* field_find(const std::string& name);
+
+}  // namespace marauder
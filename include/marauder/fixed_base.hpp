@@ -0,0 +1,43 @@
+// Fixed-base multiplication k * G from a precomputed table.
+//
+// k is recoded into 33 signed base-256 digits d_i in [-127, 128], so
+// k * G = sum d_i * 256^i * G. The table holds j * 256^i * G for
+// 1 <= j <= 128 in affine form; a negative digit negates the entry's y.
+// One multiplication is then at most 33 mixed Jacobian additions and a
+// single inversion, with no doublings, against about 256 doublings and
+// 128 additions for double-and-add.
+//
+// The table is 4224 points (about 300 KB). It is built on first use with
+// one batched inversion per window and is immutable afterwards, so every
+// thread reads the same copy.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "marauder/point.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+constexpr unsigned kGTableWindows = 33;
+constexpr unsigned kGTableEntries = 128;
+
+class GTable {
+public:
+    // The process-wide table, built on first call; safe from any thread.
+    static const GTable& get();
+
+    // k * G; the point at infinity for k = 0.
+    Point mul(const Scalar& k) const;
+
+    // j * 256^window * G for 1 <= j <= kGTableEntries.
+    const Point& entry(unsigned window, unsigned j) const { return points_[window * kGTableEntries + j - 1]; }
+
+private:
+    GTable();
+
+    std::vector<Point> points_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,104 @@
+// Host side of the GPU backends: plugin loading and per-device scanning.
+//
+// GpuBackend dlopens a plugin (see gpu_plugin.hpp) and checks its ABI
+// version; GpuDevice drives one device. scan_range gives every device its
+// own worker next to the CPU threads, so GPUs take work units from the
+// same partitioner and the same checkpoint as the CPU workers. A device
+// worker keeps up to depth() scans queued so the device never waits for
+// the host to set up the next one or to drain the last one's positives.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "marauder/gpu_plugin.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+class BloomFilter;
+
+// Bloom positives buffered per scan; with a 1e-4 false-positive rate and
+// the endomorphism that is roughly 1.7e9 keys per scan.
+constexpr uint32_t kGpuMaxHits = 1 << 20;
+
+// Scans in flight per device: one computing, one copying its positives
+// back and one uploading its starting points.
+constexpr unsigned kDefaultGpuDepth = 3;
+constexpr unsigned kMaxGpuDepth = 16;
+
+// The Bloom positives of a device's last collect, in the device's own
+// buffer; valid until its next collect or scan.
+struct GpuHits {
+    const MarauderGpuHit* data = nullptr;
+    size_t count = 0;
+
+    const MarauderGpuHit* begin() const { return data; }
+    const MarauderGpuHit* end() const { return data + count; }
+    size_t size() const { return count; }
+};
+
+// Must not outlive the GpuBackend that opened it.
+class GpuDevice {
+public:
+    ~GpuDevice();
+    GpuDevice(const GpuDevice&) = delete;
+    GpuDevice& operator=(const GpuDevice&) = delete;
+
+    std::string name() const;
+    uint64_t preferred_keys() const;
+    unsigned depth() const { return depth_; }
+    unsigned in_flight() const { return in_flight_; }
+    // Needs no scan in flight. Throws std::runtime_error on plugin errors.
+    void set_bloom(const BloomFilter& bloom);
+
+    // All of these throw std::runtime_error on plugin errors.
+    enum class Result { Ok, Unsupported, Overflow };
+    // Queues a scan of [start, start + count) behind fewer than depth()
+    // others and returns Ok, or Unsupported without queueing it.
+    Result submit(const U256& start, uint64_t count);
+    // Waits for the oldest queued scan and points hits at its Bloom
+    // positives: Ok, or Overflow (and no hits) if they did not fit.
+    Result collect(GpuHits& hits);
+    // One scan from submit to collect; needs no scan in flight.
+    Result scan(const U256& start, uint64_t count, GpuHits& hits);
+
+private:
+    friend class GpuBackend;
+    // The hit buffer is allocated once and never cleared: collect only
+    // reads back what the plugin wrote.
+    GpuDevice(const MarauderGpuApi* api, void* ctx, unsigned depth)
+        : api_(api), ctx_(ctx), depth_(depth), hits_(new MarauderGpuHit[kGpuMaxHits]) {}
+
+    const MarauderGpuApi* api_;
+    void* ctx_;
+    unsigned depth_;
+    unsigned in_flight_ = 0;
+    std::unique_ptr<MarauderGpuHit[]> hits_;  // kGpuMaxHits
+};
+
+class GpuBackend {
+public:
+    // Loads the plugin at path. Throws std::runtime_error if it cannot be
+    // loaded, lacks the entry point or was built for another ABI version.
+    static std::unique_ptr<GpuBackend> load(const std::string& path);
+    ~GpuBackend();
+    GpuBackend(const GpuBackend&) = delete;
+    GpuBackend& operator=(const GpuBackend&) = delete;
+
+    std::string name() const { return api_->name; }
+    int device_count() const { return api_->device_count(); }
+    // Throws std::invalid_argument unless 1 <= depth <= kMaxGpuDepth and
+    // std::runtime_error if the device cannot be opened.
+    std::unique_ptr<GpuDevice> open(int device, bool endomorphism, unsigned depth = kDefaultGpuDepth) const;
+
+private:
+    GpuBackend(void* handle, const MarauderGpuApi* api) : handle_(handle), api_(api) {}
+
+    void* handle_;
+    const MarauderGpuApi* api_;
+};
+
+}  // namespace marauder
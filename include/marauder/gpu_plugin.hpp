@@ -0,0 +1,75 @@
+// C ABI between the host binary and a GPU backend plugin.
+//
+// GPU backends are shared objects loaded with dlopen at run time, so the
+// CPU build never needs the CUDA or HIP toolchain and one binary runs on
+// hosts with or without a GPU. A plugin exports marauder_gpu_plugin(),
+// returning a static table of plain C entry points; every type crossing
+// the boundary is POD with fixed-width fields. Bump the ABI version on any
+// change to this file.
+//
+// Contract of a scan: walk keys [start, start + count), hash every
+// compressed candidate (and its five endomorphism candidates when enabled)
+// and test it against the Bloom filter set by set_bloom(); hand back the
+// Bloom positives. The host confirms each against the full target table
+// and re-derives the key on the CPU, so a plugin never sees the table.
+//
+// Scans are pipelined: submit() queues one and returns at once, collect()
+// waits for the oldest queued scan and returns its positives. The host
+// keeps at most MarauderGpuConfig::depth scans in flight, so with depth 3
+// one scan's positives copy back and another's starting points upload
+// while a third computes. collect() returns scans in submission order.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MARAUDER_GPU_ABI_VERSION 2
+
+extern "C" {
+
+// A Bloom-filter positive: key start + offset, endomorphism candidate v
+// (see endo_candidate_key; 0 when endomorphism is off).
+struct MarauderGpuHit {
+    uint64_t offset;
+    uint32_t candidate;
+    uint8_t digest[20];
+};
+
+struct MarauderGpuConfig {
+    uint32_t endomorphism;
+    uint32_t max_hits;  // hit buffer entries per scan
+    uint32_t depth;     // scans the host keeps in flight, at least 1
+};
+
+enum MarauderGpuStatus {
+    MARAUDER_GPU_OK = 0,
+    MARAUDER_GPU_ERROR = 1,        // message in err
+    MARAUDER_GPU_UNSUPPORTED = 2,  // this range must be scanned on the CPU
+    MARAUDER_GPU_HIT_OVERFLOW = 3, // more than max_hits positives; rescan smaller
+};
+
+struct MarauderGpuApi {
+    uint32_t abi_version;
+    const char* name;  // "cuda", "hip", ...
+    int (*device_count)(void);
+    // Returns a context for one device, or NULL with a message in err.
+    void* (*open)(int device, const MarauderGpuConfig* config, char* err, size_t err_len);
+    void (*close)(void* ctx);
+    const char* (*device_name)(void* ctx);
+    // Keys per scan the device needs to be fully occupied.
+    uint64_t (*preferred_keys)(void* ctx);
+    // lines are 64-byte BloomLine records (see bloom.hpp). Only called
+    // with no scan in flight.
+    int (*set_bloom)(void* ctx, const void* lines, uint64_t line_count, char* err, size_t err_len);
+    // start is little-endian limbs. Queues a scan, with fewer than depth
+    // in flight; MARAUDER_GPU_UNSUPPORTED queues nothing.
+    int (*submit)(void* ctx, const uint64_t start[4], uint64_t count, char* err, size_t err_len);
+    // Completes the oldest queued scan: writes min(*hit_count, max_hits)
+    // hits and returns MARAUDER_GPU_OK or MARAUDER_GPU_HIT_OVERFLOW. After
+    // MARAUDER_GPU_ERROR the context may only be closed.
+    int (*collect)(void* ctx, MarauderGpuHit* hits, uint32_t* hit_count, char* err, size_t err_len);
+};
+
+typedef const MarauderGpuApi* (*MarauderGpuEntryFn)(void);
+
+}  // extern "C"
@@ -0,0 +1,18 @@
+// One-shot SHA-256, RIPEMD-160 and hash160 over byte strings.
+//
+// These are the straightforward, any-length versions used for checksums,
+// address decoding and as the oracle for the multi-lane pubkey kernels in
+// hash160.hpp. The scan loop never calls them.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace marauder {
+
+void sha256(const uint8_t* data, size_t len, uint8_t out[32]);
+void ripemd160(const uint8_t* data, size_t len, uint8_t out[20]);
+// RIPEMD160(SHA256(data)).
+void hash160(const uint8_t* data, size_t len, uint8_t out[20]);
+
+}  // namespace marauder
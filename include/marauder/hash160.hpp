@@ -0,0 +1,54 @@
+// Multi-lane hash160 (RIPEMD160(SHA256(pubkey))) of walker output.
+//
+// Candidates come in structure-of-arrays form: limb i of every lane's x
+// coordinate is contiguous, so a kernel can form the SHA-256 message words
+// of L lanes with plain loads instead of re-serialising each pubkey. Both
+// the 33-byte compressed (02/03 || x) and the 65-byte uncompressed
+// (04 || x || y) encodings fit in fixed-length messages, which the kernels
+// exploit: the padding and length words are constants, compressed keys need
+// one SHA-256 block and uncompressed keys two, and the RIPEMD-160 input is
+// always a single block. For target lists that mix the two, a both kernel
+// hashes each lane's encodings in one pass over x, staged once.
+//
+// Kernels exist for a portable scalar path and, depending on the target,
+// AVX2 (8 lanes), AVX-512 (16 lanes) and NEON (4 lanes). hash160_best()
+// picks the widest one the running CPU supports.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace marauder {
+
+// A block of candidate public keys in structure-of-arrays layout.
+struct PubkeyBatchView {
+    const uint64_t* x[4];   // x[limb][lane], little-endian limbs of x
+    const uint64_t* y[4];   // y[limb][lane]; only read by uncompressed kernels
+    const uint8_t* y_odd;   // y parity per lane (0 or 1)
+    size_t count;
+};
+
+// Writes out[i] = hash160 of lane i's encoding, for i < in.count.
+using Hash160Fn = void (*)(const PubkeyBatchView& in, uint8_t (*out)[20]);
+
+// Writes both encodings' hash160s; reads y like an uncompressed kernel.
+using Hash160PairFn = void (*)(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]);
+
+struct Hash160Kernel {
+    const char* name;
+    unsigned lanes;
+    Hash160Fn compressed;
+    Hash160Fn uncompressed;
+    Hash160PairFn both;
+};
+
+// Every kernel compiled in and supported by the running CPU, narrowest
+// first. The scalar kernel is always present.
+const std::vector<const Hash160Kernel*>& hash160_available();
+const Hash160Kernel& hash160_best();
+// Returns nullptr for unknown names and for kernels this CPU cannot run.
+const Hash160Kernel* hash160_find(const std::string& name);
+
+}  // namespace marauder
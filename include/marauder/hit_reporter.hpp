@@ -0,0 +1,80 @@
+// Off-thread hit reporting for scan workers.
+//
+// A worker that finds a candidate only copies it into its own SpscRing; it
+// never locks, prints or writes files from the hot loop. One reporter
+// thread drains every ring and, for each candidate, checks the digest
+// against the full target table (the worker has only passed the Bloom
+// filter), re-derives the public key with reference_pubkey() and its
+// hash160 with the one-shot hash, and then hands the verified hit to the
+// callback. A candidate whose key does not hash to its digest means a fast
+// path computed a wrong key; that is an error, raised from finish().
+//
+// The callback runs on the reporter thread only, so it needs no locking,
+// and it may block (fsync a hit log, say): that only delays workers that
+// wait in flush() before checkpointing a unit.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "marauder/metrics.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/spsc_ring.hpp"
+#include "marauder/target_set.hpp"
+
+namespace marauder {
+
+// Candidates a worker can have in flight before push() waits.
+constexpr size_t kHitRingCapacity = 1024;
+
+class HitReporter {
+public:
+    // One ring per producer. With targets == nullptr every candidate is
+    // passed through unchecked (ScanConfig::report_all). live, if not
+    // empty, holds each producer's metrics, whose hits this thread counts.
+    HitReporter(unsigned producers, const TargetSet* targets, ScanHitFn on_hit,
+                std::vector<WorkerMetrics*> live = {});
+    // Joins the thread; call finish() first to see its error.
+    ~HitReporter();
+    HitReporter(const HitReporter&) = delete;
+    HitReporter& operator=(const HitReporter&) = delete;
+
+    // Producer w only. Waits (yielding) while w's ring is full; false once
+    // the reporter has failed, in which case the candidate is dropped.
+    bool push(unsigned w, const ScanHit& candidate);
+    // Producer w only: waits until every candidate w pushed has been
+    // through the callback. False if the reporter failed first.
+    bool flush(unsigned w);
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+
+    // Reports what is still queued, stops the thread and rethrows its error.
+    // Producers must be done pushing.
+    void finish();
+
+    // Confirmed hits of producer w; stable after finish().
+    uint64_t hits(unsigned w) const { return rings_[w]->hits; }
+
+private:
+    struct Ring {
+        SpscRing<ScanHit, kHitRingCapacity> ring;
+        uint64_t hits = 0;  // reporter thread only
+        WorkerMetrics* live = nullptr;
+    };
+
+    void loop();
+    void handle(Ring& r, const ScanHit& candidate);
+
+    const TargetSet* targets_;
+    ScanHitFn on_hit_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::atomic<bool> done_{false};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,47 @@
+// Set of work-unit indexes stored as merged half-open intervals.
+//
+// Units finish roughly in order within each worker's share, so a sweep's
+// completed set collapses to a few intervals per worker no matter how many
+// units it contains; that is what keeps checkpoints small.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "marauder/work_deque.hpp"
+
+namespace marauder {
+
+class IntervalSet {
+public:
+    void insert(uint64_t unit) { insert(UnitSpan{unit, unit + 1}); }
+    // Adds [s.lo, s.hi), merging with any overlapping or adjacent interval.
+    void insert(const UnitSpan& s);
+    // Removes [s.lo, s.hi), splitting intervals that straddle its ends.
+    void erase(const UnitSpan& s);
+    // Removes and returns up to max_units of the lowest units in the set.
+    std::vector<UnitSpan> take(uint64_t max_units);
+
+    bool contains(uint64_t unit) const;
+    // Number of units in the set.
+    uint64_t count() const { return count_; }
+    size_t intervals() const { return spans_.size(); }
+    bool empty() const { return spans_.empty(); }
+
+    // The intervals in increasing order.
+    std::vector<UnitSpan> spans() const;
+    // The maximal intervals of [0, limit) not in the set, in increasing order.
+    std::vector<UnitSpan> gaps(uint64_t limit) const { return gaps(UnitSpan{0, limit}); }
+    // The same within [within.lo, within.hi).
+    std::vector<UnitSpan> gaps(const UnitSpan& within) const;
+
+    bool operator==(const IntervalSet& o) const { return spans_ == o.spans_; }
+
+private:
+    std::map<uint64_t, uint64_t> spans_;  // lo -> hi
+    uint64_t count_ = 0;
+};
+
+}  // namespace marauder
@@ -0,0 +1,13 @@
+// What the running CPU supports and which kernels the dispatchers chose.
+#pragma once
+
+#include <string>
+
+namespace marauder {
+
+// Multi-line, human-readable: the CPU features the kernels care about,
+// then for hash160, field and Bloom the chosen kernel and every available
+// one. This is what `marauder --print-isa` prints.
+std::string isa_report();
+
+}  // namespace marauder
@@ -0,0 +1,85 @@
+// Pollard's kangaroo (lambda) method for a key in a known range.
+//
+// When the public key Q of a puzzle is known, the key k in [start, end)
+// can be found in about 2 * sqrt(end - start) group operations instead of
+// end - start. Tame kangaroos start at known multiples of G spread over the
+// range, wild ones at Q plus known offsets, and all hop forward by jumps
+// s_i * G chosen by the low bits of their x coordinate. Since the jump is a
+// function of the point, a wild kangaroo that lands on any point a tame one
+// has visited follows its path from then on. Points whose x has dp_bits
+// zero bits ("distinguished points") are recorded with the distance
+// travelled; the first tame/wild pair meeting at one gives k. Two tame (or
+// two wild) kangaroos meeting just duplicate each other, and the newer one
+// is restarted elsewhere.
+//
+// Distinguished points live in a DpStore. With a work file they spill to
+// disk, so a run can outgrow RAM, be resumed, or be merged with the work
+// files of runs on other machines: any run with the same public key,
+// range, jump table and dp_bits adds to the same search.
+//
+// Every thread advances its herd of kangaroos in lockstep so that all hops
+// of one round share a single batch inversion, as the range walker does.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "marauder/dp_store.hpp"
+#include "marauder/point.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+struct KangarooConfig {
+    unsigned threads = 1;
+    // Kangaroos per thread, half tame and half wild; one batch inversion each round.
+    size_t herd = 1024;
+    // 0 picks a value that keeps the distinguished-point overhead near 1/8
+    // of the expected work.
+    unsigned dp_bits = 0;
+    // Seeds the jump table and start offsets, which runs with the same seed
+    // and thread count share. Only single-threaded runs repeat exactly: with
+    // more threads, which one reaches a shared point first decides which
+    // kangaroo is restarted, and so where the search goes from there.
+    uint64_t seed = 0x6B616E6761726F6FULL;
+    // Seeds the start offsets instead of seed when nonzero. Runs sharing
+    // work files need different ones or they retrace each other.
+    uint64_t start_seed = 0;
+    // log2 of the mean jump; 0 derives it from the kangaroo count. Runs
+    // sharing work files must agree on it (and on dp_bits).
+    unsigned jump_bits = 0;
+    // Give up after this many hops over all threads; 0 never gives up.
+    uint64_t max_jumps = 0;
+    // DpStore path prefix; empty keeps the points in memory.
+    std::string work_file;
+    // Points held in memory before a spill to the work file.
+    size_t dp_memory = size_t(1) << 22;
+};
+
+struct KangarooResult {
+    bool found = false;
+    U256 key;
+    uint64_t jumps = 0;          // hops over all threads
+    uint64_t dps = 0;            // distinguished points stored, including earlier runs'
+    uint64_t restarts = 0;       // kangaroos restarted after meeting their own kind
+    unsigned dp_bits = 0;        // as used
+    unsigned jump_bits = 0;      // as used
+    double expected_jumps = 0;   // 2 * sqrt(width) plus the DP overhead
+    double seconds = 0;
+};
+
+// Finds k with k * G == pub in [start, end). Throws std::invalid_argument
+// unless 1 <= start < end <= n and the config is sane. found is false once
+// max_jumps runs out; a key outside the range is never found, so searches
+// that cannot rule that out should set max_jumps.
+KangarooResult kangaroo_solve(const Point& pub, const U256& start, const U256& end,
+                              const KangarooConfig& config = KangarooConfig());
+
+// The key two points of one search give when they are a tame and a wild
+// one at the same x, say from DpStore::merge_work_files. Returns false for
+// a same-kind pair or when the key does not check out against pub.
+bool kangaroo_key_from_collision(const Point& pub, const U256& start, const U256& end, const DpRecord& a,
+                                 const DpRecord& b, U256& key);
+
+}  // namespace marauder
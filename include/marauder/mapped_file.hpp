@@ -0,0 +1,36 @@
+// Read-only memory mapping of a whole file.
+//
+// Large lookup structures (target tables, baby-step tables, indexes) are
+// mapped rather than read so that start-up costs nothing and the page
+// cache is shared between processes scanning against the same file.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace marauder {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void reset();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace marauder
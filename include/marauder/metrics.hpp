@@ -0,0 +1,119 @@
+// Live counters for a Prometheus scrape.
+//
+// Every worker thread owns a cache-line-aligned WorkerMetrics and is the
+// only thread that writes it. Each of its counters is a relaxed load and
+// store, which compile to plain moves, so the hot loop never does a
+// locked read-modify-write and never shares a line with another worker. A
+// scrape walks every worker's counters and sums them, so reads are
+// slightly stale but never torn.
+//
+// Counters are totals since the Metrics object was created. Rates such as
+// keys per second come from the scraper: rate(marauder_keys_total[1m]).
+// Profiling builds add marauder_stage_*_total, per worker and scan stage.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "marauder/profile.hpp"
+
+namespace marauder {
+
+// A counter with one writer and any number of readers.
+class OwnedCounter {
+public:
+    void add(uint64_t n) { v_.store(v_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    void set(uint64_t v) { v_.store(v, std::memory_order_relaxed); }
+    uint64_t get() const { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> v_{0};
+};
+
+// Durations in power-of-two buckets from 2^kHistogramMinExp seconds (about
+// a millisecond) to 2^kHistogramMaxExp seconds (about 68 minutes), plus
+// +Inf. One writer at a time, like OwnedCounter.
+constexpr int kHistogramMinExp = -10;
+constexpr int kHistogramMaxExp = 12;
+constexpr size_t kHistogramBuckets = kHistogramMaxExp - kHistogramMinExp + 2;
+
+class Histogram {
+public:
+    void observe(double seconds);
+
+    // Count of bucket i alone (not cumulative); the last one is +Inf.
+    uint64_t bucket(size_t i) const { return buckets_[i].get(); }
+    uint64_t count() const { return count_.get(); }
+    double sum() const { return static_cast<double>(sum_ns_.get()) * 1e-9; }
+    // Upper bound of bucket i in seconds, for i < kHistogramBuckets - 1.
+    static double bound(size_t i);
+
+private:
+    OwnedCounter buckets_[kHistogramBuckets];
+    OwnedCounter count_, sum_ns_;
+};
+
+// One scan stage of one worker; written only in profiling builds.
+struct StageMetrics {
+    OwnedCounter ticks, cycles, instructions, llc_misses;
+};
+
+struct alignas(64) WorkerMetrics {
+    WorkerMetrics(std::string n, std::string k) : name(std::move(n)), kind(std::move(k)) {}
+
+    const std::string name;  // "cpu3", "gpu0"
+    const std::string kind;  // "cpu" or "gpu"
+    OwnedCounter keys;             // candidates hashed, endomorphism passes included
+    OwnedCounter bloom_lookups;    // candidates tested against the Bloom filter
+    OwnedCounter bloom_positives;  // of those, passed on to the table
+    OwnedCounter hits;             // confirmed targets
+    OwnedCounter units;
+    Histogram unit_seconds;  // wall time per completed work unit
+    StageMetrics stages[kScanStages];
+};
+
+class Metrics {
+public:
+    Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    // The counters of the worker with this name, created on first use. The
+    // reference stays valid for the Metrics' lifetime, so a worker that
+    // comes back (a later scan, the next coordinator lease) keeps counting
+    // from where it was. Thread-safe; meant for start-up, not the hot loop.
+    WorkerMetrics& worker(const std::string& name, const std::string& kind);
+
+    // Written by whichever thread holds the checkpoint lock.
+    Histogram& checkpoint_flush_seconds() { return checkpoint_flush_; }
+
+    // A gauge evaluated at every scrape until remove_gauge(id) returns.
+    // labels is the inside of the braces, e.g. worker="cpu0", or empty.
+    uint64_t add_gauge(const std::string& name, const std::string& help, const std::string& labels,
+                       std::function<double()> value);
+    void remove_gauge(uint64_t id);
+
+    // Prometheus text exposition format, version 0.0.4.
+    std::string render() const;
+
+private:
+    struct Gauge {
+        std::string name, help, labels;
+        std::function<double()> value;
+    };
+
+    mutable std::mutex mutex_;
+    std::deque<WorkerMetrics> workers_;
+    Histogram checkpoint_flush_;
+    std::map<uint64_t, Gauge> gauges_;
+    uint64_t next_gauge_ = 1;
+};
+
+}  // namespace marauder
@@ -0,0 +1,40 @@
+// Minimal HTTP endpoint serving Metrics::render() at GET /metrics.
+//
+// One background thread accepts connections and answers one request per
+// connection, then closes it, which is all a Prometheus scraper needs. A
+// client gets two seconds to send its request line before it is dropped,
+// so a stuck client delays scrapes briefly but cannot wedge the thread.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "marauder/metrics.hpp"
+
+namespace marauder {
+
+class MetricsServer {
+public:
+    // Binds and starts serving; throws std::runtime_error on failure.
+    // host empty listens on every interface, port 0 picks a free one.
+    MetricsServer(const Metrics& metrics, const std::string& host, uint16_t port);
+    // Stops the thread and closes the socket.
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    uint16_t port() const { return port_; }
+
+private:
+    void run();
+    void serve(int fd);
+
+    const Metrics& metrics_;
+    int listen_fd_ = -1;
+    int wake_[2] = {-1, -1};
+    uint16_t port_ = 0;
+    std::thread thread_;
+};
+
+}  // namespace marauder
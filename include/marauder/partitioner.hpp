@@ -0,0 +1,98 @@
+// Splits a key range into fixed-size work units and hands them to workers.
+//
+// Unit i covers [start + i * 2^unit_bits, start + (i + 1) * 2^unit_bits),
+// clipped to the range end. Each worker starts with an equal contiguous
+// share of the units in its own WorkDeque. A worker pops a span from the
+// bottom of its deque, pushes back the upper halves until only one unit is
+// left and scans that; the deque therefore holds large spans at the top
+// and small ones at the bottom. A worker whose deque is empty steals the
+// top (largest) span of another, so fast cores and cores that got a quiet
+// VM slice simply end up doing more units and nobody idles until the very
+// last unit is handed out.
+//
+// With set_worker_nodes(), a thief first tries the workers on its own NUMA
+// node and only then the rest, so spans (and the cache lines of the deques
+// they sit in) cross the interconnect only when a whole node is idle.
+//
+// The deques hold visit positions, which a UnitOrder (unit_order.hpp) maps
+// to unit indexes; in the default sequential order the two are the same.
+// Positions listed in a skip set (completed in an earlier run) are never
+// handed out. The deques then hold spans of pending-position ordinals,
+// which next() maps back to positions, so skipping costs nothing per unit.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "marauder/interval_set.hpp"
+#include "marauder/u256.hpp"
+#include "marauder/unit_order.hpp"
+#include "marauder/work_deque.hpp"
+
+namespace marauder {
+
+constexpr unsigned kDefaultUnitBits = 32;
+// Deque indexes are 64-bit; no realistic sweep comes near this many units.
+constexpr unsigned kMaxUnitCountBits = 62;
+
+struct WorkUnit {
+    uint64_t index;
+    uint64_t position = 0;  // in the visit order, set by next(); what checkpoints record
+    U256 start, end;        // keys [start, end)
+};
+
+class RangePartitioner {
+public:
+    // Throws std::invalid_argument if start > end, workers is 0, the range
+    // has more than 2^kMaxUnitCountBits units or the order is invalid.
+    // Positions in skip are left out.
+    RangePartitioner(const U256& start, const U256& end, unsigned workers, unsigned unit_bits = kDefaultUnitBits,
+                     const IntervalSet* skip = nullptr, const UnitOrder& order = UnitOrder());
+    ~RangePartitioner();
+
+    // node[w] is worker w's NUMA node; call before the first next().
+    void set_worker_nodes(const std::vector<unsigned>& node);
+
+    // Called only by worker w (0 <= w < workers). Returns false once every
+    // unit has been handed out to some worker.
+    bool next(unsigned w, WorkUnit& out);
+
+    WorkUnit unit(uint64_t index) const;
+    uint64_t unit_count() const { return units_; }
+    // Positions in the visit order: unit_count(), or this node's share of
+    // it in a strided order.
+    uint64_t position_count() const { return order_.size(); }
+    // Units this partitioner will hand out: position_count() minus the skipped ones.
+    uint64_t pending_units() const { return pending_; }
+    unsigned workers() const { return workers_; }
+    unsigned unit_bits() const { return unit_bits_; }
+    // Spans worker w has stolen so far.
+    uint64_t steals(unsigned w) const;
+    // Of those, the ones taken from a worker on another node.
+    uint64_t remote_steals(unsigned w) const;
+    // Any thread, for monitoring: units not yet handed to a worker, and the
+    // spans waiting in worker w's deque.
+    uint64_t unassigned() const { return unassigned_.load(std::memory_order_relaxed); }
+    size_t queued_spans(unsigned w) const;
+
+private:
+    struct Worker;
+    bool steal(unsigned w, UnitSpan& out);
+    uint64_t position_of_ordinal(uint64_t ordinal) const;
+
+    U256 start_, end_;
+    unsigned unit_bits_;
+    unsigned workers_;
+    uint64_t units_;
+    UnitPermutation order_;
+    uint64_t pending_;
+    // Pending positions as spans; todo_first_[i] is the ordinal of todo_[i].lo.
+    std::vector<UnitSpan> todo_;
+    std::vector<uint64_t> todo_first_;
+    std::unique_ptr<Worker[]> per_worker_;
+    alignas(64) std::atomic<uint64_t> unassigned_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,66 @@
+// secp256k1 group operations (y^2 = x^3 + 7 over GF(p)).
+//
+// Point is affine and is what walkers hand out; JPoint is Jacobian
+// (x = X/Z^2, y = Y/Z^3) and is used for the occasional full scalar
+// multiplication at batch boundaries. None of this is constant time: the
+// scalars we handle are search candidates, not secrets.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "marauder/field.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+struct Point {
+    Fe x, y;
+    bool infinity;
+
+    static constexpr Point at_infinity() { return Point{Fe::zero(), Fe::zero(), true}; }
+};
+
+struct JPoint {
+    Fe x, y, z;
+    bool infinity;
+
+    static constexpr JPoint at_infinity() { return JPoint{Fe::zero(), Fe::one(), Fe::zero(), true}; }
+    static JPoint from_affine(const Point& p) { return JPoint{p.x, p.y, Fe::one(), p.infinity}; }
+};
+
+constexpr Point kGenerator = Point{
+    Fe{{0x59F2815B16F81798ULL, 0x029BFCDB2DCE28D9ULL, 0x55A06295CE870B07ULL, 0x79BE667EF9DCBBACULL}},
+    Fe{{0x9C47D08FFB10D4B8ULL, 0xFD17B448A6855419ULL, 0x5DA4FBFC0E1108A8ULL, 0x483ADA7726A3C465ULL}},
+    false};
+
+inline bool operator==(const Point& a, const Point& b) {
+    if (a.infinity || b.infinity) return a.infinity == b.infinity;
+    return a.x == b.x && a.y == b.y;
+}
+inline bool operator!=(const Point& a, const Point& b) { return !(a == b); }
+
+bool point_on_curve(const Point& p);
+void point_neg(Point& r, const Point& a);
+// Affine formulas; each costs one field inversion.
+void point_add(Point& r, const Point& a, const Point& b);
+void point_double(Point& r, const Point& a);
+
+void jpoint_double(JPoint& r, const JPoint& a);
+// r = a + b with b affine (mixed addition).
+void jpoint_add_affine(JPoint& r, const JPoint& a, const Point& b);
+void jpoint_to_affine(Point& r, const JPoint& a);
+
+// k * p by double-and-add in Jacobian coordinates.
+Point point_mul(const Scalar& k, const Point& p);
+// k * G from the shared fixed-base table (fixed_base.hpp): no doublings.
+Point point_mul_g(const Scalar& k);
+
+// SEC1 encodings. Serialising the point at infinity is a caller bug.
+void serialize_compressed(const Point& p, uint8_t out[33]);
+void serialize_uncompressed(const Point& p, uint8_t out[65]);
+// Accepts 33-byte compressed and 65-byte uncompressed encodings; returns
+// false for anything that is not a valid point on the curve.
+bool parse_pubkey(Point& r, const uint8_t* in, size_t len);
+
+}  // namespace marauder
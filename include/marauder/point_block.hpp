@@ -0,0 +1,85 @@
+// Structure-of-arrays block of walker output, shared with the hash stage.
+//
+// The walker writes each lane's x limbs, y parity (and optionally y limbs)
+// straight into these arrays and the hash160 kernels read them in place
+// through view(), so nothing is repacked between the EC and hash stages.
+// Every array is 64-byte aligned and N is a compile-time constant, so the
+// whole block can be sized for one ISA build (kBlockLanes) and allocated
+// once per worker.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "marauder/hash160.hpp"
+#include "marauder/point.hpp"
+#include "marauder/u256.hpp"
+
+#ifndef MARAUDER_BLOCK_LANES
+#define MARAUDER_BLOCK_LANES 4096
+#endif
+
+namespace marauder {
+
+// Lanes per PointBlock in this build. Walker batch sizes must divide it.
+constexpr size_t kBlockLanes = MARAUDER_BLOCK_LANES;
+
+// Per-lane destinations the walker writes to. y[0] == nullptr skips y.
+struct SoaOut {
+    uint64_t* x[4];
+    uint64_t* y[4];
+    uint8_t* y_odd;
+};
+
+template <size_t N>
+struct PointBlock {
+    static_assert(N % 64 == 0, "PointBlock lanes must be a multiple of 64");
+    static constexpr size_t kLanes = N;
+
+    alignas(64) uint64_t x[4][N];  // x[limb][lane]
+    alignas(64) uint64_t y[4][N];  // only valid when has_y
+    alignas(64) uint8_t y_odd[N];
+    alignas(64) uint8_t digest[N][20];
+    alignas(64) uint8_t digest_uncompressed[N][20];  // only written by hash_both
+
+    U256 first_key = U256::zero();  // private key of lane 0; lane i is first_key + i
+    size_t count = 0;               // lanes filled
+    bool has_y = false;
+
+    SoaOut soa_out(size_t offset, bool with_y) {
+        SoaOut out;
+        for (int i = 0; i < 4; ++i) {
+            out.x[i] = x[i] + offset;
+            out.y[i] = with_y ? y[i] + offset : nullptr;
+        }
+        out.y_odd = y_odd + offset;
+        return out;
+    }
+
+    PubkeyBatchView view() const {
+        return PubkeyBatchView{{x[0], x[1], x[2], x[3]}, {y[0], y[1], y[2], y[3]}, y_odd, count};
+    }
+
+    void hash_compressed(const Hash160Kernel& k) { k.compressed(view(), digest); }
+    // Requires has_y.
+    void hash_uncompressed(const Hash160Kernel& k) { k.uncompressed(view(), digest); }
+    // Compressed into digest, uncompressed into digest_uncompressed.
+    // Requires has_y.
+    void hash_both(const Hash160Kernel& k) { k.both(view(), digest, digest_uncompressed); }
+
+    U256 key(size_t lane) const {
+        U256 k;
+        u256_add_u64(k, first_key, lane);
+        return k;
+    }
+
+    // Requires has_y.
+    Point point(size_t lane) const {
+        return Point{Fe{{x[0][lane], x[1][lane], x[2][lane], x[3][lane]}},
+                     Fe{{y[0][lane], y[1][lane], y[2][lane], y[3][lane]}}, false};
+    }
+};
+
+using DefaultPointBlock = PointBlock<kBlockLanes>;
+
+}  // namespace marauder
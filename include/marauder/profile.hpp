@@ -0,0 +1,59 @@
+// Per-stage cost accounting for the CPU scan loop.
+//
+// Builds configured with -DMARAUDER_PROFILE=ON time every block a CPU
+// worker walks, stage by stage: the point additions, the endomorphism's
+// x rescaling, hash160, the Bloom prefilter and the hand-off to the
+// reporter. Time is the time stamp counter (steady_clock nanoseconds off
+// x86); where perf_event_open lets a thread count its own user-mode events,
+// each stage also gets core cycles, retired instructions and last-level
+// cache misses, which separate an arithmetic-bound host from one waiting on
+// the Bloom filter. The totals land in ScanStats::profile and, per worker,
+// on the metrics endpoint.
+//
+// Without the option the profiler is an empty class whose calls inline to
+// nothing, ScanProfile stays zero and no marauder_stage_* series are served.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace marauder {
+
+#ifdef MARAUDER_PROFILE
+constexpr bool kProfiling = true;
+#else
+constexpr bool kProfiling = false;
+#endif
+
+enum class ScanStage { Walk, Endomorphism, Hash, Bloom, Report };
+constexpr size_t kScanStages = 5;
+
+// "walk", "endomorphism", "hash", "bloom", "report".
+const char* scan_stage_name(ScanStage stage);
+
+struct StageCounts {
+    uint64_t ticks = 0;         // time stamp counter
+    uint64_t cycles = 0;        // the rest only from workers with perf counters
+    uint64_t instructions = 0;
+    uint64_t llc_misses = 0;
+};
+
+struct ScanProfile {
+    StageCounts stages[kScanStages];
+    uint64_t blocks = 0;  // walked by profiled workers
+    uint64_t keys = 0;    // candidates they hashed, endomorphism passes included
+    unsigned workers = 0;
+    unsigned perf_workers = 0;  // of those, with perf counters open
+
+    const StageCounts& operator[](ScanStage s) const { return stages[static_cast<size_t>(s)]; }
+    StageCounts& operator[](ScanStage s) { return stages[static_cast<size_t>(s)]; }
+    void add(const ScanProfile& other);
+    uint64_t ticks() const;
+};
+
+// A table with one line per stage: share of the time, ticks per candidate
+// and, given perf counters, IPC and LLC misses per thousand candidates.
+std::string format_profile(const ScanProfile& profile);
+
+}  // namespace marauder
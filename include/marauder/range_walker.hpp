@@ -0,0 +1,166 @@
+// Sequential public-key generation over a private-key range.
+//
+// Consecutive keys differ by G, so instead of a full scalar multiplication
+// per key the walker computes start * G once and then steps by affine
+// addition. Keys are produced a batch at a time: with base point P = kG the
+// batch is P, P + 1G, ..., P + (B-1)G, and the next base is P + BG. All B
+// additions need the inverse of (iG.x - P.x); those are computed together
+// with one Montgomery batch inversion, from a shared StepTable of iG.
+//
+// WalkMode::Center anchors each batch at its middle key instead: with
+// centre C the batch is C - hG .. C + hG, and C + iG and C - iG share the
+// denominator iG.x - C.x. Each inversion lane then covers two keys, which
+// halves the batch-inversion work per key.
+//
+// The walker is a template on the number of 64-bit limbs its private keys
+// occupy. Puzzle ranges are 32 to 80 bits wide, so in BasicRangeWalker<1>
+// or <2> the key bookkeeping (remaining keys, the next batch's first key,
+// the end test) works on one or two limbs and the zero high limbs are
+// never touched. RangeWalker is the full-width walker; scan_range picks
+// the narrowest instantiation that holds its range (walker_key_limbs).
+//
+// A walker allocates its batch buffers unless it is handed a WalkerScratch;
+// scan workers carve one from their arena and reuse it for every unit.
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "marauder/arena.hpp"
+#include "marauder/field_kernel.hpp"
+#include "marauder/point.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/step_table.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+enum class WalkMode {
+    Sequential,  // base + iG, i = 0 .. B-1
+    Center,      // centre +- iG, i = 0 .. B/2
+};
+
+const char* walk_mode_name(WalkMode mode);
+// Inverse of walk_mode_name; throws std::invalid_argument for unknown names.
+WalkMode parse_walk_mode(const std::string& name);
+
+struct WalkerConfig {
+    WalkMode mode = WalkMode::Sequential;
+    // Keys per batch inversion. Larger batches amortise the inversion
+    // further but the per-batch state (~100 bytes per key) should stay in
+    // L1/L2; 512-4096 is the useful range.
+    size_t batch_size = 1024;
+    // Batch inversion and addition kernel; nullptr picks field_best().
+    const FieldKernel* field = nullptr;
+};
+
+constexpr size_t kMaxBatchSize = size_t(1) << 20;
+
+// The fewest key limbs (1, 2 or 4) a walker needs for ranges ending at end.
+unsigned walker_key_limbs(const U256& end);
+
+// Batch buffers for walkers with batch sizes up to batch_size.
+struct WalkerScratch {
+    size_t batch_size = 0;
+    Point* batch = nullptr;
+    Fe* dx = nullptr;
+    Fe* inv = nullptr;  // 2 * batch_size: the batch inversion's prefix products
+    Point* sums = nullptr;
+
+    // Arena bytes carve() takes.
+    static size_t arena_bytes(size_t batch_size);
+    static WalkerScratch carve(Arena& arena, size_t batch_size);
+};
+
+template <unsigned KeyLimbs>
+class BasicRangeWalker {
+    static_assert(KeyLimbs == 1 || KeyLimbs == 2 || KeyLimbs == 4, "walkers come in 64, 128 and 256 bits");
+
+public:
+    // Walks keys in [start, end). Throws std::invalid_argument unless
+    // 1 <= start <= end <= n, end fits in KeyLimbs limbs and
+    // 1 <= batch_size <= kMaxBatchSize. With scratch, which must be as
+    // large as the batch size and outlive the walker, the walker works in
+    // it and allocates nothing.
+    BasicRangeWalker(const U256& start, const U256& end, const WalkerConfig& config = WalkerConfig(),
+                     const WalkerScratch* scratch = nullptr);
+    BasicRangeWalker(const BasicRangeWalker&) = delete;
+    BasicRangeWalker& operator=(const BasicRangeWalker&) = delete;
+
+    // Yields the public key of the next private key; returns false once the
+    // range is exhausted. key() then names the private key just yielded.
+    bool next(Point& pub);
+
+    // Computes the next batch and exposes it without copying: points[i] is
+    // the public key of first_key + i. The pointer stays valid until the
+    // next call. Returns 0 once the range is exhausted. Do not interleave
+    // with next().
+    size_t next_batch(const Point*& points, U256& first_key);
+
+    // Fills blk with the next blk.kLanes keys (fewer at the end of the
+    // range), writing the SoA lanes directly; y limbs only if with_y.
+    // Returns the number of lanes filled, 0 once exhausted. The batch size
+    // must divide N. Do not interleave with next().
+    template <size_t N>
+    size_t next_block(PointBlock<N>& blk, bool with_y = false) {
+        check_block_lanes(N);
+        blk.first_key = base_key_;
+        blk.has_y = with_y;
+        size_t filled = 0, n;
+        while (filled < N && (n = fill_soa(blk.soa_out(filled, with_y))) != 0) filled += n;
+        blk.count = filled;
+        return filled;
+    }
+
+    const U256& key() const { return key_; }
+    const U256& start() const { return start_; }
+    const U256& end() const { return end_; }
+    size_t batch_size() const { return config_.batch_size; }
+    // Number of keys not yet yielded.
+    U256 remaining() const;
+
+private:
+    struct AosSink;
+    struct SoaSink;
+    template <class Sink>
+    size_t produce(const Sink& out);
+    template <class Sink>
+    void fill_sequential(const Sink& out, size_t n);
+    template <class Sink>
+    void fill_center(const Sink& out, size_t n);
+    void fill_batch();
+    size_t fill_soa(const SoaOut& out);
+    void check_block_lanes(size_t lanes) const;
+
+    WalkerConfig config_;
+    const FieldKernel* field_;
+    std::shared_ptr<const StepTable> steps_;
+    U256 start_, end_;
+    U256 base_key_;  // first private key of the next batch
+    Point base_;     // next batch's first point (Sequential) or centre (Center)
+    Point jump_;     // B * G, the centre-to-centre step in Center mode
+    U256 key_;       // private key of the last point yielded by next()
+    bool started_ = false;
+
+    // Current batch, reused across batches so the hot loop never allocates:
+    // in the caller's WalkerScratch or else in the owned vectors.
+    std::vector<Point> own_points_;  // batch_ and sums_
+    std::vector<Fe> own_fes_;        // dx_ and scratch_
+    Point* batch_;
+    Fe* dx_;
+    Fe* scratch_;
+    Point* sums_;  // add_batch output before it goes to the sink
+    size_t batch_len_ = 0;
+    size_t batch_pos_ = 0;
+    U256 batch_key_;  // private key of batch_[0]
+};
+
+extern template class BasicRangeWalker<1>;
+extern template class BasicRangeWalker<2>;
+extern template class BasicRangeWalker<4>;
+
+using RangeWalker = BasicRangeWalker<4>;
+
+}  // namespace marauder
@@ -0,0 +1,17 @@
+// Slow, obviously-correct reference implementations.
+//
+// These are the oracle every optimised path is checked against: they share
+// only the field layer and the affine group law with the fast code, and
+// trade all speed for directness. Do not call them from a hot loop.
+#pragma once
+
+#include "marauder/point.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+// key * G by affine right-to-left double-and-add (one inversion per step).
+// key must be in [1, n).
+Point reference_pubkey(const U256& key);
+
+}  // namespace marauder
@@ -0,0 +1,44 @@
+// Arithmetic modulo the secp256k1 group order
+// n = 0xFFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFE BAAEDCE6 AF48A03B BFD25E8C D0364141.
+//
+// Scalars are private keys. They are only touched at batch boundaries (and
+// when mapping a hit back to its key), so unlike Fe these operations are out
+// of line and favour clarity over speed. They still never allocate.
+#pragma once
+
+#include <cstdint>
+
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+struct Scalar {
+    uint64_t d[4];  // little-endian limbs, always < n
+
+    static constexpr Scalar zero() { return Scalar{{0, 0, 0, 0}}; }
+    static constexpr Scalar one() { return Scalar{{1, 0, 0, 0}}; }
+    static constexpr Scalar from_u64(uint64_t v) { return Scalar{{v, 0, 0, 0}}; }
+
+    // Reduces an arbitrary 256-bit integer modulo n.
+    static Scalar from_u256(const U256& v);
+
+    U256 to_u256() const { return U256{{d[0], d[1], d[2], d[3]}}; }
+    bool is_zero() const { return (d[0] | d[1] | d[2] | d[3]) == 0; }
+};
+
+constexpr U256 kOrderN = U256{{0xBFD25E8CD0364141ULL, 0xBAAEDCE6AF48A03BULL,
+                               0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL}};
+
+inline bool operator==(const Scalar& a, const Scalar& b) {
+    return ((a.d[0] ^ b.d[0]) | (a.d[1] ^ b.d[1]) | (a.d[2] ^ b.d[2]) | (a.d[3] ^ b.d[3])) == 0;
+}
+inline bool operator!=(const Scalar& a, const Scalar& b) { return !(a == b); }
+
+void scalar_add(Scalar& r, const Scalar& a, const Scalar& b);
+void scalar_sub(Scalar& r, const Scalar& a, const Scalar& b);
+void scalar_neg(Scalar& r, const Scalar& a);
+void scalar_mul(Scalar& r, const Scalar& a, const Scalar& b);
+// r = a^-1 mod n (Fermat); r = 0 for a = 0.
+void scalar_inv(Scalar& r, const Scalar& a);
+
+}  // namespace marauder
@@ -0,0 +1,104 @@
+// Multi-threaded scan of a key range against a target set.
+//
+// scan_range runs one worker thread per ScanConfig::threads. Workers take
+// work units from a shared RangePartitioner, walk each unit into their own
+// PointBlock and hash it (and its endomorphism passes).
+// Workers only run the Bloom filter and queue its positives on lock-free
+// rings; one reporter thread (hit_reporter.hpp) checks them against the
+// full table, re-derives each hit's key with the reference implementation
+// and passes it to the callback. The callback therefore runs on a single
+// thread, needs no locking and may block without stalling the workers.
+//
+// With a Checkpoint, units it records as done are skipped and each unit is
+// marked done after its last hit has been through the callback. GPU
+// workers keep gpu_depth chunks queued on their device and hand the Bloom
+// positives back to the host, which re-derives and re-hashes each key
+// before queueing it like a CPU worker's.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "marauder/checkpoint.hpp"
+#include "marauder/gpu_backend.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/metrics.hpp"
+#include "marauder/partitioner.hpp"
+#include "marauder/profile.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+struct ScanConfig {
+    WalkerConfig walker;
+    unsigned threads = 1;
+    unsigned unit_bits = kDefaultUnitBits;
+    // Order the units are visited in; checkpoint and units hold positions
+    // in it (see unit_order.hpp).
+    UnitOrder order;
+    // Also try the five endomorphism candidates of every walked key.
+    bool endomorphism = false;
+    // nullptr matches nothing; with report_all, every candidate is a hit.
+    const TargetSet* targets = nullptr;
+    bool report_all = false;
+    // Also match the 65-byte uncompressed encoding of every candidate, for
+    // target lists with legacy addresses. The affine y the walker computes
+    // anyway is then copied into each block, and the kernel hashes both
+    // encodings in one pass. Needs targets; CPU only.
+    bool uncompressed = false;
+    // nullptr picks hash160_best().
+    const Hash160Kernel* kernel = nullptr;
+    // Must have been opened for the same range, unit_bits and order.
+    Checkpoint* checkpoint = nullptr;
+    // If set, only these positions are scanned; the others count as
+    // skipped. Used by coordinated workers to scan one lease of the range.
+    const IntervalSet* units = nullptr;
+    // Adds one worker per device of this backend next to the CPU threads
+    // (threads may then be 0). Incompatible with report_all.
+    const GpuBackend* gpu = nullptr;
+    // Chunks each device worker keeps queued on its device.
+    unsigned gpu_depth = kDefaultGpuDepth;
+    // Live counters for a scrape: CPU threads count as cpu0.. and devices
+    // as gpu0... Only one scan at a time may use a Metrics.
+    Metrics* metrics = nullptr;
+    // Pin each CPU worker to its own core, spread over the NUMA nodes, keep
+    // a Bloom filter replica on every node and steal within a node first.
+    bool pin_threads = false;
+    // Once this is true, workers stop at their next unit boundary and the
+    // scan returns what it did; units not reached stay pending.
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+struct ScanHit {
+    U256 key;            // private key of the candidate
+    uint8_t pubkey[33];  // compressed public key
+    Hash160 digest;
+    bool uncompressed = false;  // digest is of the 65-byte encoding of pubkey
+};
+
+// Hex of the encoding of hit.pubkey that hashes to hit.digest: 33 or 65
+// bytes, as an operator needs it to import the key.
+std::string hit_pubkey_hex(const ScanHit& hit);
+
+struct ScanStats {
+    uint64_t keys = 0;  // candidates hashed, endomorphism passes included
+    uint64_t hits = 0;
+    uint64_t units = 0;    // scanned in this run
+    uint64_t skipped = 0;  // already done according to the checkpoint
+    uint64_t steals = 0;
+    uint64_t remote_steals = 0;  // steals from a worker on another NUMA node
+    double seconds = 0;
+    ScanProfile profile;  // per-stage costs of the CPU loop; zero unless kProfiling
+};
+
+using ScanHitFn = std::function<void(const ScanHit&)>;
+
+// Scans [start, end). Throws std::invalid_argument for bad ranges or
+// configurations, and rethrows the first exception raised by a worker.
+ScanStats scan_range(const U256& start, const U256& end, const ScanConfig& config, const ScanHitFn& on_hit);
+
+}  // namespace marauder
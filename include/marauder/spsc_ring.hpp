@@ -0,0 +1,60 @@
+// Bounded single-producer, single-consumer ring.
+//
+// The producer writes a slot and then publishes it by advancing head_; the
+// consumer reads the slot, handles it, and only then advances tail_. So
+// once tail_ has caught up with a head the producer saw, every item it had
+// pushed has not just been taken but dealt with, which is what lets a scan
+// worker wait for its hits to be reported before checkpointing a unit.
+// Neither side takes a lock or makes a system call.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace marauder {
+
+template <class T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer only. False if the ring is full.
+    bool try_push(const T& item) {
+        uint64_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_cache_ == Capacity) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (h - tail_cache_ == Capacity) return false;
+        }
+        slots_[h & (Capacity - 1)] = item;
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only: everything pushed so far has been released by pop().
+    bool drained() const { return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_relaxed); }
+
+    // Consumer only. The oldest item, or nullptr if the ring is empty; it
+    // stays in place until pop().
+    const T* front() {
+        uint64_t t = tail_.load(std::memory_order_relaxed);
+        if (t == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (t == head_cache_) return nullptr;
+        }
+        return &slots_[t & (Capacity - 1)];
+    }
+
+    // Consumer only, after a non-null front(): hands the slot back.
+    void pop() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    // Each side's index and its cached copy of the other's share a line.
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t tail_cache_ = 0;
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t head_cache_ = 0;
+    alignas(64) T slots_[Capacity];
+};
+
+}  // namespace marauder
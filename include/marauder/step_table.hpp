@@ -0,0 +1,32 @@
+// Precomputed affine multiples of G used as batch step offsets.
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "marauder/point.hpp"
+
+namespace marauder {
+
+class StepTable {
+public:
+    // Holds 1*G .. count*G. Built in Jacobian coordinates and normalised
+    // with a single batched inversion.
+    explicit StepTable(size_t count);
+
+    // Returns a process-wide shared table of exactly count entries, building
+    // it on first use. Tables are immutable once built and safe to read from
+    // any thread.
+    static std::shared_ptr<const StepTable> get(size_t count);
+
+    size_t size() const { return points_.size(); }
+    // (i + 1) * G.
+    const Point& operator[](size_t i) const { return points_[i]; }
+    const Point* data() const { return points_.data(); }
+
+private:
+    std::vector<Point> points_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,96 @@
+// Prebuilt target index: the sorted hash160 table and its Bloom filter in
+// one file.
+//
+// Parsing a multi-gigabyte address dump, sorting it and filling a Bloom
+// filter takes minutes and gigabytes of RAM; marauder-index does it once,
+// and every scan then maps the result and starts in milliseconds, with the
+// page cache shared between processes. File layout, little-endian:
+//
+//   TargetIndexHeader (64 bytes)
+//   Bloom lines           bloom_lines * 64 bytes, BloomFilter's own layout
+//   records[records]      20-byte hash160 digests, sorted and unique
+//
+// TargetIndexBuilder streams digests in with bounded memory: whenever its
+// buffer fills it sorts, deduplicates and spills it as a run file (raw
+// records, the TargetTable format), and finish() merges the mapped runs
+// straight into the index.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "marauder/bloom.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/target_table.hpp"
+
+namespace marauder {
+
+constexpr char kTargetIndexMagic[8] = {'M', 'R', 'D', 'R', 'T', 'I', 'D', 'X'};
+constexpr uint32_t kTargetIndexVersion = 1;
+constexpr size_t kDefaultIndexMemory = size_t(1) << 30;
+
+struct TargetIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bloom_bits;  // bits per key the filter was sized with
+    uint64_t records;
+    uint64_t bloom_lines;
+    uint8_t reserved[32];
+};
+static_assert(sizeof(TargetIndexHeader) == 64, "TargetIndexHeader is part of the file format");
+
+// Writes table as an index file (via path.tmp and a rename).
+void write_target_index(const std::string& path, const TargetTable& table, unsigned bloom_bits = kBloomBitsPerKey);
+// Maps an index file; no digest is read until it is looked up. Throws
+// std::runtime_error if the file is not an index, has another version or is
+// truncated.
+TargetSet map_target_index(const std::string& path);
+
+enum class TargetLine {
+    Digest,       // out holds the digest
+    Blank,        // empty or a '#' comment
+    Unsupported,  // a valid address that pays to no hash160
+    Invalid,
+};
+
+// Parses one line of an address list. Its first whitespace-separated field
+// is an address (see decode_address) or a 40-digit hex hash160; anything
+// after it (a balance column, say) is ignored.
+TargetLine parse_target_line(const char* line, size_t len, Hash160& out);
+
+class TargetIndexBuilder {
+public:
+    // Run files go to tmp_dir; memory_bytes bounds the digest buffer.
+    explicit TargetIndexBuilder(const std::string& tmp_dir, size_t memory_bytes = kDefaultIndexMemory);
+    // Removes the run files.
+    ~TargetIndexBuilder();
+    TargetIndexBuilder(const TargetIndexBuilder&) = delete;
+    TargetIndexBuilder& operator=(const TargetIndexBuilder&) = delete;
+
+    void add(const Hash160& digest) {
+        if (buffer_.size() == capacity_) spill();
+        buffer_.push_back(digest);
+        ++added_;
+    }
+
+    // Merges everything added into the index at path and returns the number
+    // of unique digests written. The builder is empty afterwards.
+    uint64_t finish(const std::string& path, unsigned bloom_bits = kBloomBitsPerKey);
+
+    uint64_t added() const { return added_; }
+    size_t runs() const { return runs_.size(); }
+
+private:
+    void spill();
+
+    std::string tmp_dir_;
+    size_t capacity_;
+    std::vector<Hash160> buffer_;
+    std::vector<std::string> runs_;
+    uint64_t added_ = 0;
+};
+
+}  // namespace marauder
@@ -0,0 +1,52 @@
+// Two-level matcher of candidate hash160s against a target list.
+//
+// The Bloom filter answers almost every candidate from L2/L3; only its
+// roughly 1e-4 false positives and the real hits go on to the sorted
+// table, whose pages can stay on disk until touched. Nothing depends on
+// the number of targets: one address and fifty million take the same path.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "marauder/bloom.hpp"
+#include "marauder/target_table.hpp"
+
+namespace marauder {
+
+class TargetSet {
+public:
+    explicit TargetSet(TargetTable table, unsigned bloom_bits_per_key = kBloomBitsPerKey);
+    // Takes a filter already built over table, such as the view into a
+    // mapped target index (target_index.hpp).
+    TargetSet(TargetTable table, BloomFilter bloom);
+
+    bool contains(const uint8_t digest[20]) const {
+        return bloom_.maybe_contains(digest) && table_.contains(digest);
+    }
+
+    // Writes the indexes of the digests that are targets to hits (room for
+    // n entries) and returns how many there were. bloom_positives, if set,
+    // receives how many passed the Bloom filter.
+    size_t match(const uint8_t (*digests)[20], size_t n, uint32_t* hits, size_t* bloom_positives = nullptr) const {
+        return match(bloom_, digests, n, hits, bloom_positives);
+    }
+    // The same through bloom, which must be a clone() of bloom(): a replica
+    // on the caller's NUMA node.
+    size_t match(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* hits,
+                 size_t* bloom_positives = nullptr) const;
+
+    // Only the Bloom stage of match(): writes the indexes of the digests
+    // that may be targets to out (room for n) and returns their count.
+    size_t prefilter(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* out) const;
+
+    size_t size() const { return table_.size(); }
+    const TargetTable& table() const { return table_; }
+    const BloomFilter& bloom() const { return bloom_; }
+
+private:
+    TargetTable table_;
+    BloomFilter bloom_;
+};
+
+}  // namespace marauder
@@ -0,0 +1,59 @@
+// Sorted table of target hash160 digests.
+//
+// Records are the raw 20-byte digests, sorted and unique, back to back:
+// the same bytes in memory and on disk, so a table file is searched
+// straight from its mapping. Digests are uniform, so interpolating on the
+// first 8 bytes (big-endian) lands within a few records of the answer and a
+// lookup touches O(log log n) pages instead of binary search's O(log n).
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "marauder/mapped_file.hpp"
+
+namespace marauder {
+
+using Hash160 = std::array<uint8_t, 20>;
+
+class TargetTable {
+public:
+    TargetTable() = default;
+    TargetTable(TargetTable&&) = default;
+    TargetTable& operator=(TargetTable&&) = default;
+    TargetTable(const TargetTable&) = delete;
+    TargetTable& operator=(const TargetTable&) = delete;
+
+    // Sorts and deduplicates.
+    static TargetTable from_digests(std::vector<Hash160> digests);
+    // Maps a table file written by write(). Throws std::runtime_error if the
+    // file cannot be mapped or its size is not a whole number of records.
+    static TargetTable map(const std::string& path);
+    // count records at offset inside an already mapped file (a target
+    // index, see target_index.hpp); the table keeps the mapping.
+    static TargetTable in_file(MappedFile file, size_t offset, size_t count);
+
+    void write(const std::string& path) const;
+
+    bool contains(const uint8_t digest[20]) const;
+
+    size_t size() const { return count_; }
+    const Hash160& operator[](size_t i) const { return records_[i]; }
+    const Hash160* begin() const { return records_; }
+    const Hash160* end() const { return records_ + count_; }
+
+private:
+    const Hash160* records_ = nullptr;
+    size_t count_ = 0;
+    std::vector<Hash160> owned_;
+    MappedFile file_;
+};
+
+// Reads one hex hash160 per line; blank lines and lines starting with '#'
+// are skipped. Throws std::invalid_argument naming the offending line.
+std::vector<Hash160> read_hash160_list(const std::string& path);
+
+}  // namespace marauder
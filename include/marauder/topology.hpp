@@ -0,0 +1,43 @@
+// Which CPUs this process may run on, grouped by NUMA node, and pinning
+// of worker threads to them.
+//
+// The topology comes from /sys/devices/system/node/node*/cpulist,
+// restricted to the CPUs in the process's affinity mask (a cpuset or
+// taskset is honoured). Without sysfs node information every allowed CPU
+// is put on node 0.
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace marauder {
+
+struct CpuTopology {
+    // Allowed CPUs per node, ascending; nodes without any are left out, so
+    // indexes here are dense and need not match the kernel's node ids.
+    std::vector<std::vector<unsigned>> nodes;
+};
+
+struct WorkerPlacement {
+    unsigned cpu;
+    unsigned node;  // index into CpuTopology::nodes
+};
+
+// Read once, on first use.
+const CpuTopology& cpu_topology();
+// Reads the node directories under sysfs_node_dir, keeping only CPUs in
+// allowed (all of them if allowed is empty).
+CpuTopology read_cpu_topology(const std::string& sysfs_node_dir, const std::vector<unsigned>& allowed);
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}; throws std::invalid_argument on
+// malformed input.
+std::vector<unsigned> parse_cpu_list(const std::string& text);
+
+// Spreads workers over the nodes round-robin, and over the CPUs of each
+// node in order, so any worker count uses every node's cache and memory
+// controller. More workers than CPUs wrap around.
+std::vector<WorkerPlacement> place_workers(const CpuTopology& topo, unsigned workers);
+
+// Pins the calling thread to one CPU; throws std::runtime_error on failure.
+void pin_current_thread(unsigned cpu);
+
+}  // namespace marauder
@@ -0,0 +1,119 @@
+// 256-bit unsigned integers for key-range bookkeeping.
+//
+// U256 is a plain integer (no modulus). It is used for range bounds, key
+// counters and serialisation; field and scalar arithmetic live in field.hpp
+// and scalar.hpp.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace marauder {
+
+using u128 = unsigned __int128;
+
+struct U256 {
+    uint64_t d[4];  // little-endian 64-bit limbs
+
+    static constexpr U256 zero() { return U256{{0, 0, 0, 0}}; }
+    static constexpr U256 from_u64(uint64_t v) { return U256{{v, 0, 0, 0}}; }
+
+    // Parses an optional "0x" prefixed hexadecimal string of up to 64 digits.
+    // Throws std::invalid_argument on malformed input.
+    static U256 from_hex(const std::string& hex);
+    static U256 from_be_bytes(const uint8_t in[32]);
+
+    std::string to_hex() const;  // 64 lowercase digits, no prefix
+    void to_be_bytes(uint8_t out[32]) const;
+
+    bool is_zero() const { return (d[0] | d[1] | d[2] | d[3]) == 0; }
+    unsigned bit(unsigned i) const { return (d[i >> 6] >> (i & 63)) & 1; }
+    unsigned bit_length() const;
+};
+
+inline bool operator==(const U256& a, const U256& b) {
+    return ((a.d[0] ^ b.d[0]) | (a.d[1] ^ b.d[1]) | (a.d[2] ^ b.d[2]) | (a.d[3] ^ b.d[3])) == 0;
+}
+inline bool operator!=(const U256& a, const U256& b) { return !(a == b); }
+
+inline int u256_cmp(const U256& a, const U256& b) {
+    for (int i = 3; i >= 0; --i) {
+        if (a.d[i] != b.d[i]) return a.d[i] < b.d[i] ? -1 : 1;
+    }
+    return 0;
+}
+inline bool operator<(const U256& a, const U256& b) { return u256_cmp(a, b) < 0; }
+inline bool operator<=(const U256& a, const U256& b) { return u256_cmp(a, b) <= 0; }
+inline bool operator>(const U256& a, const U256& b) { return u256_cmp(a, b) > 0; }
+inline bool operator>=(const U256& a, const U256& b) { return u256_cmp(a, b) >= 0; }
+
+// r = a + b mod 2^256; returns the carry out.
+inline uint64_t u256_add(U256& r, const U256& a, const U256& b) {
+    u128 acc = 0;
+    for (int i = 0; i < 4; ++i) {
+        acc += (u128)a.d[i] + b.d[i];
+        r.d[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a - b mod 2^256; returns the borrow out.
+inline uint64_t u256_sub(U256& r, const U256& a, const U256& b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        u128 t = (u128)a.d[i] - b.d[i] - borrow;
+        r.d[i] = (uint64_t)t;
+        borrow = (uint64_t)(t >> 64) & 1;
+    }
+    return borrow;
+}
+
+// r = a + v mod 2^256; returns the carry out.
+inline uint64_t u256_add_u64(U256& r, const U256& a, uint64_t v) {
+    u128 acc = v;
+    for (int i = 0; i < 4; ++i) {
+        acc += a.d[i];
+        r.d[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a * v mod 2^256; returns the high limb that overflowed.
+inline uint64_t u256_mul_u64(U256& r, const U256& a, uint64_t v) {
+    u128 acc = 0;
+    for (int i = 0; i < 4; ++i) {
+        acc += (u128)a.d[i] * v;
+        r.d[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+inline U256 u256_shl(const U256& a, unsigned s) {
+    U256 r = U256::zero();
+    if (s >= 256) return r;
+    unsigned limbs = s >> 6, bits = s & 63;
+    for (int i = 3; i >= (int)limbs; --i) {
+        uint64_t v = a.d[i - limbs] << bits;
+        if (bits && i - (int)limbs - 1 >= 0) v |= a.d[i - limbs - 1] >> (64 - bits);
+        r.d[i] = v;
+    }
+    return r;
+}
+
+inline U256 u256_shr(const U256& a, unsigned s) {
+    U256 r = U256::zero();
+    if (s >= 256) return r;
+    unsigned limbs = s >> 6, bits = s & 63;
+    for (unsigned i = 0; i + limbs < 4; ++i) {
+        uint64_t v = a.d[i + limbs] >> bits;
+        if (bits && i + limbs + 1 < 4) v |= a.d[i + limbs + 1] << (64 - bits);
+        r.d[i] = v;
+    }
+    return r;
+}
+
+}  // namespace marauder
@@ -0,0 +1,71 @@
+// Orders in which a sweep visits its work units.
+//
+// The partitioner hands out visit positions 0, 1, 2, ... and maps each to
+// a unit index through a UnitPermutation; checkpoints, skip sets and
+// leases are all kept in position space. Whatever the order, a worker's
+// share and every span it steals are runs of consecutive positions, so the
+// done set stays a handful of intervals even while the units it stands
+// for are scattered over the range.
+//
+// Sequential: position p is unit p.
+// Random: a keyed permutation of the units. It is a balanced Feistel
+//   network over the smallest even-width domain holding every index,
+//   cycle-walked back into range, so each unit is visited exactly once and
+//   the seed alone fixes the order: a resumed sweep continues the same one.
+// Strided: node K of N visits units K, K + N, K + 2N, ...; N hosts given
+//   one K each sweep the range interleaved without a coordinator.
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace marauder {
+
+enum class UnitOrderMode { Sequential, Random, Strided };
+
+struct UnitOrder {
+    UnitOrderMode mode = UnitOrderMode::Sequential;
+    uint64_t seed = 0;   // Random
+    uint64_t node = 0;   // Strided: this is node of nodes
+    uint64_t nodes = 1;
+
+    static UnitOrder random(uint64_t seed) { return UnitOrder{UnitOrderMode::Random, seed, 0, 1}; }
+    static UnitOrder strided(uint64_t node, uint64_t nodes) {
+        return UnitOrder{UnitOrderMode::Strided, 0, node, nodes};
+    }
+
+    // "sequential", "random:SEED" (hex) or "strided:K/N".
+    std::string name() const;
+    bool operator==(const UnitOrder& o) const { return name() == o.name(); }
+    bool operator!=(const UnitOrder& o) const { return !(*this == o); }
+};
+
+// Inverse of UnitOrder::name(); the seed may carry a 0x prefix. Throws
+// std::invalid_argument for anything else.
+UnitOrder parse_unit_order(const std::string& text);
+
+// A UnitOrder applied to the units of one range.
+class UnitPermutation {
+public:
+    // Throws std::invalid_argument for a strided order without nodes or
+    // with node >= nodes.
+    UnitPermutation(const UnitOrder& order, uint64_t units);
+
+    // Positions: the units this order visits (for Strided, this node's).
+    uint64_t size() const { return size_; }
+    // Unit index at position, for position < size().
+    uint64_t operator()(uint64_t position) const;
+
+private:
+    static constexpr int kRounds = 6;
+
+    uint64_t feistel(uint64_t x) const;
+
+    UnitOrder order_;
+    uint64_t units_;
+    uint64_t size_;
+    unsigned half_bits_ = 0;
+    uint64_t keys_[kRounds] = {};
+};
+
+}  // namespace marauder
@@ -0,0 +1,99 @@
+// Chase-Lev work-stealing deque of unit spans.
+//
+// The owning worker pushes and pops at the bottom; any other worker may
+// steal from the top. Only the owner ever writes a slot, and a thief's read
+// of a slot is validated by its CAS on top, so neither side takes a lock.
+// Orderings follow Le, Pop, Cohen and Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+//
+// The buffer is fixed: the partitioner only ever pushes the halves of a
+// span it just popped, so a deque holds at most a couple of spans per bit
+// of the unit count and kWorkDequeCapacity is never reached in practice.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace marauder {
+
+// Half-open range [lo, hi) of work-unit indexes.
+struct UnitSpan {
+    uint64_t lo, hi;
+};
+
+constexpr size_t kWorkDequeCapacity = 256;
+
+class WorkDeque {
+public:
+    // Owner only.
+    void push(const UnitSpan& s) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(kWorkDequeCapacity)) throw std::length_error("work deque overflow");
+        Slot& slot = slots_[b % kWorkDequeCapacity];
+        slot.lo.store(s.lo, std::memory_order_relaxed);
+        slot.hi.store(s.hi, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Takes the most recently pushed span.
+    bool pop(UnitSpan& out) {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        read(b, out);
+        if (t == b) {
+            // Last span: race the thieves for it.
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the oldest (largest) span; false if empty or lost a race.
+    bool steal(UnitSpan& out) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        read(t, out);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Any thread; a snapshot that may be stale by the time it returns.
+    size_t size() const {
+        int64_t n = bottom_.load(std::memory_order_acquire) - top_.load(std::memory_order_acquire);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    bool empty() const {
+        return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> lo{0}, hi{0};
+    };
+
+    void read(int64_t i, UnitSpan& out) const {
+        const Slot& slot = slots_[i % kWorkDequeCapacity];
+        out.lo = slot.lo.load(std::memory_order_relaxed);
+        out.hi = slot.hi.load(std::memory_order_relaxed);
+    }
+
+    // top_ is written by thieves and bottom_ by the owner: keep them apart.
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) Slot slots_[kWorkDequeCapacity];
+};
+
+}  // namespace marauder
@@ -0,0 +1,11 @@
+// Links libmarauder.so. Point MARAUDER_LIB_DIR at the CMake build directory
+// (or wherever the library is installed); the directory is also put on the
+// rpath, so tests and binaries run without LD_LIBRARY_PATH.
+fn main() {
+    println!("cargo:rerun-if-env-changed=MARAUDER_LIB_DIR");
+    if let Ok(dir) = std::env::var("MARAUDER_LIB_DIR") {
+        println!("cargo:rustc-link-search=native={dir}");
+        println!("cargo:rustc-link-arg=-Wl,-rpath,{dir}");
+    }
+    println!("cargo:rustc-link-lib=dylib=marauder");
+}
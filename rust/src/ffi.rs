@@ -0,0 +1,81 @@
+//! Raw declarations of include/marauder/c_api.h.
+
+#![allow(non_camel_case_types)]
+
+use std::os::raw::{c_char, c_int};
+
+pub const MARAUDER_ABI_VERSION: u32 = 2;
+
+pub const MARAUDER_OK: c_int = 0;
+pub const MARAUDER_ERROR: c_int = 1;
+pub const MARAUDER_BUSY: c_int = 2;
+
+pub const MARAUDER_IDLE: u32 = 0;
+pub const MARAUDER_RUNNING: u32 = 1;
+pub const MARAUDER_FINISHED: u32 = 2;
+pub const MARAUDER_FAILED: u32 = 3;
+
+#[repr(C)]
+pub struct marauder_searcher {
+    _private: [u8; 0],
+}
+
+#[repr(C)]
+pub struct marauder_config {
+    pub threads: u32,
+    pub unit_bits: u32,
+    pub batch_size: u32,
+    pub endomorphism: u32,
+    pub pin_threads: u32,
+    pub uncompressed: u32,
+    pub digests: *const u8,
+    pub digest_count: u64,
+    pub table_path: *const c_char,
+    pub index_path: *const c_char,
+}
+
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct marauder_hit {
+    pub key: [u8; 32],
+    pub pubkey: [u8; 33],
+    pub digest: [u8; 20],
+    pub uncompressed: u8,
+}
+
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct marauder_progress {
+    pub state: u32,
+    pub keys: u64,
+    pub units_done: u64,
+    pub units_total: u64,
+    pub hits: u64,
+    pub hits_pending: u64,
+    pub seconds: f64,
+}
+
+extern "C" {
+    pub fn marauder_abi_version() -> u32;
+    pub fn marauder_searcher_create(
+        config: *const marauder_config,
+        err: *mut c_char,
+        err_len: usize,
+    ) -> *mut marauder_searcher;
+    pub fn marauder_searcher_destroy(searcher: *mut marauder_searcher);
+    pub fn marauder_searcher_submit(
+        searcher: *mut marauder_searcher,
+        start: *const u8,
+        end: *const u8,
+        err: *mut c_char,
+        err_len: usize,
+    ) -> c_int;
+    pub fn marauder_searcher_poll(searcher: *const marauder_searcher, out: *mut marauder_progress);
+    pub fn marauder_searcher_fetch_hits(
+        searcher: *mut marauder_searcher,
+        out: *mut marauder_hit,
+        max: usize,
+    ) -> usize;
+    pub fn marauder_searcher_cancel(searcher: *mut marauder_searcher);
+    pub fn marauder_searcher_wait(searcher: *mut marauder_searcher, err: *mut c_char, err_len: usize) -> c_int;
+}
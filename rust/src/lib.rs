@@ -0,0 +1,280 @@
+//! In-process range scans through libmarauder's C ABI.
+//!
+//! A [`Searcher`] owns a target set and runs one scan at a time on the
+//! library's own threads: [`Searcher::submit`] a range, [`Searcher::poll`]
+//! its progress, drain hits with [`Searcher::fetch_hits`] and
+//! [`Searcher::wait`] for the end. Hits are written by the library straight
+//! into the caller's `Vec`, and a table or index file is searched from its
+//! mapping without being read.
+//!
+//! Build libmarauder.so with CMake first and point `MARAUDER_LIB_DIR` at
+//! the build directory: `MARAUDER_LIB_DIR=$PWD/../build cargo test`.
+
+pub mod ffi;
+
+use std::ffi::{CStr, CString};
+use std::fmt;
+use std::os::raw::c_char;
+use std::os::unix::ffi::OsStrExt;
+use std::path::Path;
+use std::ptr::{self, NonNull};
+
+/// A private key, 32 bytes big-endian.
+pub type Key = [u8; 32];
+/// A hash160 of a public key.
+pub type Digest = [u8; 20];
+/// A confirmed target: the key, its compressed public key and digest, and
+/// whether the digest is of the uncompressed encoding.
+pub type Hit = ffi::marauder_hit;
+
+/// The key with value `v`.
+pub fn key_from_u128(v: u128) -> Key {
+    let mut key = [0u8; 32];
+    key[16..].copy_from_slice(&v.to_be_bytes());
+    key
+}
+
+/// Zero fields take the CLI's defaults.
+#[derive(Clone, Debug, Default)]
+pub struct Config {
+    pub threads: u32,
+    pub unit_bits: u32,
+    pub batch_size: u32,
+    /// Also try the five endomorphism candidates of every walked key.
+    pub endomorphism: bool,
+    pub pin_threads: bool,
+    /// Also match each candidate's 65-byte uncompressed encoding.
+    pub uncompressed: bool,
+}
+
+pub enum Targets<'a> {
+    Digests(&'a [Digest]),
+    /// A table file written by marauder-index or TargetTable::write.
+    Table(&'a Path),
+    /// A target index file.
+    Index(&'a Path),
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum State {
+    Idle,
+    Running,
+    Finished,
+    Failed,
+}
+
+#[derive(Clone, Copy, Debug)]
+pub struct Progress {
+    pub state: State,
+    /// Candidates hashed, endomorphism passes included.
+    pub keys: u64,
+    pub units_done: u64,
+    pub units_total: u64,
+    /// Found by this scan, fetched or not.
+    pub hits: u64,
+    pub hits_pending: u64,
+    pub seconds: f64,
+}
+
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub enum Error {
+    /// The previous scan is still running.
+    Busy,
+    Failed(String),
+}
+
+impl fmt::Display for Error {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Error::Busy => f.write_str("a scan is still running"),
+            Error::Failed(what) => f.write_str(what),
+        }
+    }
+}
+
+impl std::error::Error for Error {}
+
+struct ErrBuf([c_char; 512]);
+
+impl ErrBuf {
+    fn new() -> Self {
+        ErrBuf([0; 512])
+    }
+    fn ptr(&mut self) -> *mut c_char {
+        self.0.as_mut_ptr()
+    }
+    fn error(&self) -> Error {
+        // The library always NUL-terminates within the buffer.
+        let what = unsafe { CStr::from_ptr(self.0.as_ptr()) };
+        Error::Failed(what.to_string_lossy().into_owned())
+    }
+}
+
+fn path_cstring(path: &Path) -> Result<CString, Error> {
+    CString::new(path.as_os_str().as_bytes()).map_err(|_| Error::Failed("path contains a NUL byte".into()))
+}
+
+pub struct Searcher {
+    raw: NonNull<ffi::marauder_searcher>,
+}
+
+// Every entry point but destroy is thread-safe, and destroy only runs from
+// Drop, which has the searcher to itself.
+unsafe impl Send for Searcher {}
+unsafe impl Sync for Searcher {}
+
+impl Searcher {
+    pub fn new(config: &Config, targets: Targets<'_>) -> Result<Searcher, Error> {
+        let version = unsafe { ffi::marauder_abi_version() };
+        if version != ffi::MARAUDER_ABI_VERSION {
+            return Err(Error::Failed(format!(
+                "libmarauder has ABI version {version}, these bindings need {}",
+                ffi::MARAUDER_ABI_VERSION
+            )));
+        }
+        let mut c = ffi::marauder_config {
+            threads: config.threads,
+            unit_bits: config.unit_bits,
+            batch_size: config.batch_size,
+            endomorphism: config.endomorphism as u32,
+            pin_threads: config.pin_threads as u32,
+            uncompressed: config.uncompressed as u32,
+            digests: ptr::null(),
+            digest_count: 0,
+            table_path: ptr::null(),
+            index_path: ptr::null(),
+        };
+        // Only needed for the duration of the call.
+        let path;
+        match targets {
+            Targets::Digests(d) => {
+                c.digests = d.as_ptr() as *const u8;
+                c.digest_count = d.len() as u64;
+            }
+            Targets::Table(p) => {
+                path = path_cstring(p)?;
+                c.table_path = path.as_ptr();
+            }
+            Targets::Index(p) => {
+                path = path_cstring(p)?;
+                c.index_path = path.as_ptr();
+            }
+        }
+        let mut err = ErrBuf::new();
+        let raw = unsafe { ffi::marauder_searcher_create(&c, err.ptr(), err.0.len()) };
+        NonNull::new(raw).map(|raw| Searcher { raw }).ok_or_else(|| err.error())
+    }
+
+    /// Starts scanning `[start, end)`. Hits left unfetched from the previous
+    /// scan are dropped.
+    pub fn submit(&self, start: &Key, end: &Key) -> Result<(), Error> {
+        let mut err = ErrBuf::new();
+        let status = unsafe {
+            ffi::marauder_searcher_submit(self.raw.as_ptr(), start.as_ptr(), end.as_ptr(), err.ptr(), err.0.len())
+        };
+        match status {
+            ffi::MARAUDER_OK => Ok(()),
+            ffi::MARAUDER_BUSY => Err(Error::Busy),
+            _ => Err(err.error()),
+        }
+    }
+
+    pub fn poll(&self) -> Progress {
+        let mut p = ffi::marauder_progress::default();
+        unsafe { ffi::marauder_searcher_poll(self.raw.as_ptr(), &mut p) };
+        Progress {
+            state: match p.state {
+                ffi::MARAUDER_RUNNING => State::Running,
+                ffi::MARAUDER_FINISHED => State::Finished,
+                ffi::MARAUDER_FAILED => State::Failed,
+                _ => State::Idle,
+            },
+            keys: p.keys,
+            units_done: p.units_done,
+            units_total: p.units_total,
+            hits: p.hits,
+            hits_pending: p.hits_pending,
+            seconds: p.seconds,
+        }
+    }
+
+    /// Appends up to `max` hits, oldest first, to `out` and returns how many.
+    pub fn fetch_hits(&self, out: &mut Vec<Hit>, max: usize) -> usize {
+        out.reserve(max);
+        let len = out.len();
+        unsafe {
+            let n = ffi::marauder_searcher_fetch_hits(self.raw.as_ptr(), out.as_mut_ptr().add(len), max);
+            out.set_len(len + n);
+            n
+        }
+    }
+
+    /// Stops the scan at its workers' next unit boundary.
+    pub fn cancel(&self) {
+        unsafe { ffi::marauder_searcher_cancel(self.raw.as_ptr()) }
+    }
+
+    /// Blocks until the scan ends and returns its final progress.
+    pub fn wait(&self) -> Result<Progress, Error> {
+        let mut err = ErrBuf::new();
+        match unsafe { ffi::marauder_searcher_wait(self.raw.as_ptr(), err.ptr(), err.0.len()) } {
+            ffi::MARAUDER_OK => Ok(self.poll()),
+            _ => Err(err.error()),
+        }
+    }
+}
+
+impl Drop for Searcher {
+    fn drop(&mut self) {
+        unsafe { ffi::marauder_searcher_destroy(self.raw.as_ptr()) }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn digest(hex: &str) -> Digest {
+        let mut d = [0u8; 20];
+        for (i, b) in d.iter_mut().enumerate() {
+            *b = u8::from_str_radix(&hex[2 * i..2 * i + 2], 16).unwrap();
+        }
+        d
+    }
+
+    #[test]
+    fn finds_the_first_keys() {
+        let targets = [
+            digest("751e76e8199196d454941c45d1b3a323f1433bd6"), // key 1
+            digest("7dd65592d0ab2fe0d0257d571abf032cd9db93dc"), // key 3
+        ];
+        let config = Config { threads: 2, unit_bits: 10, ..Config::default() };
+        let searcher = Searcher::new(&config, Targets::Digests(&targets)).unwrap();
+        assert_eq!(searcher.poll().state, State::Idle);
+        searcher.submit(&key_from_u128(1), &key_from_u128(0x1000)).unwrap();
+        let done = searcher.wait().unwrap();
+        assert_eq!(done.state, State::Finished);
+        assert_eq!(done.units_total, 4);
+        assert_eq!(done.hits, 2);
+
+        let mut hits = Vec::new();
+        assert_eq!(searcher.fetch_hits(&mut hits, 16), 2);
+        let mut keys: Vec<Key> = hits.iter().map(|h| h.key).collect();
+        keys.sort();
+        assert_eq!(keys, vec![key_from_u128(1), key_from_u128(3)]);
+        assert_eq!(searcher.fetch_hits(&mut hits, 16), 0);
+    }
+
+    #[test]
+    fn reports_errors() {
+        let targets = [digest("751e76e8199196d454941c45d1b3a323f1433bd6")];
+        let bad = Config { batch_size: 3, ..Config::default() };
+        assert!(matches!(Searcher::new(&bad, Targets::Digests(&targets)), Err(Error::Failed(_))));
+        let missing = Searcher::new(&Config::default(), Targets::Table(Path::new("/nonexistent/table")));
+        assert!(missing.is_err());
+
+        let searcher = Searcher::new(&Config::default(), Targets::Digests(&targets)).unwrap();
+        let err = searcher.submit(&key_from_u128(9), &key_from_u128(8)).unwrap_err();
+        assert!(err.to_string().contains("past its end"), "{err}");
+    }
+}
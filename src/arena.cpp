@@ -0,0 +1,91 @@
+#include "marauder/arena.hpp"
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace marauder {
+
+namespace {
+
+// Huge page size the mapping is rounded to: 2 MiB on x86-64 and on arm64
+// with 4 KiB base pages, the common case for both.
+constexpr size_t kHugePage = size_t(2) << 20;
+
+thread_local uint64_t allocations = 0;
+std::atomic<bool> counting{false};
+
+}  // namespace
+
+Arena::Arena(size_t bytes) {
+    size_t size = (bytes + kHugePage - 1) / kHugePage * kHugePage;
+    if (size == 0) size = kHugePage;
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    // Fails with ENOMEM unless huge pages have been reserved.
+    p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_ = p != MAP_FAILED;
+#endif
+    if (p == MAP_FAILED) {
+        p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("cannot map a " + std::to_string(size >> 10) + " KiB arena: " +
+                                     std::strerror(errno));
+        }
+#ifdef MADV_HUGEPAGE
+        // Only a hint: THP may be disabled, which leaves small pages.
+        ::madvise(p, size, MADV_HUGEPAGE);
+#endif
+    }
+    base_ = static_cast<uint8_t*>(p);
+    size_ = size;
+}
+
+Arena::~Arena() { reset(); }
+
+Arena::Arena(Arena&& other) noexcept
+    : base_(other.base_), size_(other.size_), used_(other.used_), huge_(other.huge_) {
+    other.base_ = nullptr;
+    other.size_ = other.used_ = 0;
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        reset();
+        base_ = other.base_;
+        size_ = other.size_;
+        used_ = other.used_;
+        huge_ = other.huge_;
+        other.base_ = nullptr;
+        other.size_ = other.used_ = 0;
+    }
+    return *this;
+}
+
+void* Arena::take(size_t bytes) {
+    if (bytes > size_ - used_) {
+        throw std::runtime_error("arena exhausted: " + std::to_string(bytes) + " bytes wanted, " +
+                                 std::to_string(size_ - used_) + " left");
+    }
+    void* p = base_ + used_;
+    used_ += bytes;
+    return p;
+}
+
+void Arena::reset() {
+    if (base_) ::munmap(base_, size_);
+    base_ = nullptr;
+    size_ = used_ = 0;
+}
+
+void enable_allocation_counting() { counting.store(true, std::memory_order_relaxed); }
+bool counting_allocations() { return counting.load(std::memory_order_relaxed); }
+void note_allocation() { ++allocations; }
+uint64_t thread_allocations() { return allocations; }
+
+}  // namespace marauder
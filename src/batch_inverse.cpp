@@ -0,0 +1,42 @@
+#include "marauder/batch_inverse.hpp"
+
+namespace marauder {
+
+void fe_batch_inv(Fe* elems, size_t n, Fe* scratch) {
+    if (n == 0) return;
+    // scratch[i] = product of the non-zero elems[0..i).
+    Fe acc = Fe::one();
+    for (size_t i = 0; i < n; ++i) {
+        scratch[i] = acc;
+        if (!elems[i].is_zero()) fe_mul(acc, acc, elems[i]);
+    }
+    fe_inv(acc, acc);
+    // acc now inverts the product of elems[0..i]; peel one element per step.
+    for (size_t i = n; i-- > 0;) {
+        if (elems[i].is_zero()) continue;
+        Fe inv;
+        fe_mul(inv, acc, scratch[i]);
+        fe_mul(acc, acc, elems[i]);
+        elems[i] = inv;
+    }
+}
+
+void jpoint_batch_to_affine(Point* out, const JPoint* in, size_t n, Fe* scratch) {
+    Fe* zinv = scratch;
+    for (size_t i = 0; i < n; ++i) zinv[i] = in[i].infinity ? Fe::zero() : in[i].z;
+    fe_batch_inv(zinv, n, scratch + n);
+    for (size_t i = 0; i < n; ++i) {
+        if (in[i].infinity) {
+            out[i] = Point::at_infinity();
+            continue;
+        }
+        Fe z2, z3;
+        fe_sqr(z2, zinv[i]);
+        fe_mul(z3, z2, zinv[i]);
+        fe_mul(out[i].x, in[i].x, z2);
+        fe_mul(out[i].y, in[i].y, z3);
+        out[i].infinity = false;
+    }
+}
+
+}  // namespace marauder
@@ -0,0 +1,54 @@
+#include "marauder/bloom.hpp"
+
+namespace marauder {
+
+BloomFilter::BloomFilter(size_t keys, unsigned bits_per_key) {
+    size_t bits = keys * bits_per_key;
+    size_t lines = (bits + 511) / 512;
+    owned_.assign(lines ? lines : 1, BloomLine{});
+    lines_ = owned_.data();
+    count_ = owned_.size();
+}
+
+BloomFilter::BloomFilter(const BloomFilter& o)
+    : owned_(o.owned_), lines_(owned_.empty() ? o.lines_ : owned_.data()), count_(o.count_) {}
+
+BloomFilter& BloomFilter::operator=(const BloomFilter& o) {
+    if (this != &o) *this = BloomFilter(o);
+    return *this;
+}
+
+BloomFilter BloomFilter::view(const BloomLine* lines, size_t count) {
+    BloomFilter b;
+    b.lines_ = lines;
+    b.count_ = count;
+    return b;
+}
+
+BloomFilter BloomFilter::clone() const {
+    BloomFilter b;
+    b.owned_.assign(lines_, lines_ + count_);
+    b.lines_ = b.owned_.data();
+    b.count_ = count_;
+    return b;
+}
+
+void BloomFilter::insert(const uint8_t digest[20]) {
+    BloomLine& line = owned_[line_index(digest)];
+    u128 bits = bit_pool(digest);
+    for (unsigned i = 0; i < kBloomHashes; ++i, bits >>= 9) {
+        unsigned b = static_cast<unsigned>(bits) & 511;
+        line.w[b >> 6] |= uint64_t(1) << (b & 63);
+    }
+}
+
+void BloomFilter::insert_concurrent(const uint8_t digest[20]) {
+    BloomLine& line = owned_[line_index(digest)];
+    u128 bits = bit_pool(digest);
+    for (unsigned i = 0; i < kBloomHashes; ++i, bits >>= 9) {
+        unsigned b = static_cast<unsigned>(bits) & 511;
+        __atomic_fetch_or(&line.w[b >> 6], uint64_t(1) << (b & 63), __ATOMIC_RELAXED);
+    }
+}
+
+}  // namespace marauder
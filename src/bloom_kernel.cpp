@@ -0,0 +1,152 @@
+#include "marauder/bloom_kernel.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace marauder {
+
+namespace {
+
+// Digests whose Bloom lines are requested before the first is tested; enough
+// to keep several L3/DRAM misses in flight per core.
+constexpr size_t kPrefetchWindow = 16;
+
+// The same line and bit selection as BloomFilter, spelled out so the vector
+// kernels below can take the pool apart themselves.
+struct Probe {
+    const BloomLine* line;
+    uint64_t lo;  // digest bytes 8..15
+    uint64_t hi;  // digest bytes 16..19
+};
+
+inline Probe probe(const BloomFilter& bloom, const uint8_t digest[20]) {
+    uint64_t h, lo;
+    uint32_t hi;
+    std::memcpy(&h, digest, 8);
+    std::memcpy(&lo, digest + 8, 8);
+    std::memcpy(&hi, digest + 16, 4);
+    size_t line = static_cast<size_t>((static_cast<u128>(h) * bloom.lines()) >> 64);
+    return Probe{bloom.data() + line, lo, hi};
+}
+
+// Runs test(probe) over prefetch windows and collects the passing indexes.
+template <class Test>
+inline size_t filter_windows(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* out,
+                             Test test) {
+    size_t found = 0;
+    Probe p[kPrefetchWindow];
+    for (size_t base = 0; base < n; base += kPrefetchWindow) {
+        size_t end = std::min(n, base + kPrefetchWindow);
+        for (size_t i = base; i < end; ++i) {
+            p[i - base] = probe(bloom, digests[i]);
+            __builtin_prefetch(p[i - base].line);
+        }
+        for (size_t i = base; i < end; ++i) {
+            out[found] = static_cast<uint32_t>(i);
+            found += test(p[i - base]);
+        }
+    }
+    return found;
+}
+
+size_t filter_scalar(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* out) {
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += kPrefetchWindow) {
+        size_t end = std::min(n, base + kPrefetchWindow);
+        for (size_t i = base; i < end; ++i) bloom.prefetch(digests[i]);
+        for (size_t i = base; i < end; ++i) {
+            if (bloom.maybe_contains(digests[i])) out[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+#if defined(__x86_64__)
+
+// Bit k of a probe is (pool >> 9k) & 511 of the 96-bit pool hi:lo. Shift
+// counts of 64 and more give zero in the variable vector shifts, which is
+// what the k = 0 lane needs from hi << (64 - 9k).
+
+__attribute__((target("avx2"))) inline bool test_avx2(const Probe& p) {
+    const __m256i lo = _mm256_set1_epi64x(static_cast<long long>(p.lo));
+    const __m256i hi = _mm256_set1_epi64x(static_cast<long long>(p.hi));
+    const __m256i s0 = _mm256_set_epi64x(27, 18, 9, 0), s1 = _mm256_set_epi64x(63, 54, 45, 36);
+    const __m256i c64 = _mm256_set1_epi64x(64);
+    __m256i b0 = _mm256_or_si256(_mm256_srlv_epi64(lo, s0), _mm256_sllv_epi64(hi, _mm256_sub_epi64(c64, s0)));
+    __m256i b1 = _mm256_or_si256(_mm256_srlv_epi64(lo, s1), _mm256_sllv_epi64(hi, _mm256_sub_epi64(c64, s1)));
+    // Low dwords of both halves into eight dword lanes, k in order.
+    const __m256i even = _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0);
+    b0 = _mm256_permutevar8x32_epi32(b0, even);
+    b1 = _mm256_permutevar8x32_epi32(b1, even);
+    __m256i b = _mm256_and_si256(_mm256_permute2x128_si256(b0, b1, 0x20), _mm256_set1_epi32(511));
+
+    const __m256i* words = reinterpret_cast<const __m256i*>(p.line->w);
+    __m256i dword = _mm256_srli_epi32(b, 5);
+    __m256i low = _mm256_permutevar8x32_epi32(_mm256_load_si256(words), dword);
+    __m256i high = _mm256_permutevar8x32_epi32(_mm256_load_si256(words + 1), dword);
+    __m256i upper = _mm256_slli_epi32(dword, 28);  // bit 3 of the index to the sign bit
+    __m256i w = _mm256_blendv_epi8(low, high, _mm256_srai_epi32(upper, 31));
+    __m256i bit = _mm256_srlv_epi32(w, _mm256_and_si256(b, _mm256_set1_epi32(31)));
+    __m256i set = _mm256_slli_epi32(bit, 31);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(set)) == 0xFF;
+}
+
+__attribute__((target("avx2"))) size_t filter_avx2(const BloomFilter& bloom, const uint8_t (*digests)[20],
+                                                    size_t n, uint32_t* out) {
+    return filter_windows(bloom, digests, n, out, [](const Probe& p) { return test_avx2(p); });
+}
+
+__attribute__((target("avx512f"))) inline bool test_avx512(const Probe& p) {
+    const __m512i s = _mm512_set_epi64(63, 54, 45, 36, 27, 18, 9, 0);
+    __m512i lo = _mm512_srlv_epi64(_mm512_set1_epi64(static_cast<long long>(p.lo)), s);
+    __m512i hi = _mm512_sllv_epi64(_mm512_set1_epi64(static_cast<long long>(p.hi)),
+                                   _mm512_sub_epi64(_mm512_set1_epi64(64), s));
+    __m512i b = _mm512_and_si512(_mm512_or_si512(lo, hi), _mm512_set1_epi64(511));
+    __m512i w = _mm512_permutexvar_epi64(_mm512_srli_epi64(b, 6), _mm512_load_si512(p.line->w));
+    __m512i bit = _mm512_srlv_epi64(w, _mm512_and_si512(b, _mm512_set1_epi64(63)));
+    return _mm512_test_epi64_mask(bit, _mm512_set1_epi64(1)) == 0xFF;
+}
+
+__attribute__((target("avx512f"))) size_t filter_avx512(const BloomFilter& bloom, const uint8_t (*digests)[20],
+                                                         size_t n, uint32_t* out) {
+    return filter_windows(bloom, digests, n, out, [](const Probe& p) { return test_avx512(p); });
+}
+
+const BloomKernel kBloomAvx2 = {"avx2", filter_avx2};
+const BloomKernel kBloomAvx512 = {"avx512", filter_avx512};
+
+#endif
+
+const BloomKernel kBloomScalar = {"scalar", filter_scalar};
+
+std::vector<const BloomKernel*> detect() {
+    std::vector<const BloomKernel*> kernels{&kBloomScalar};
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(&kBloomAvx2);
+    if (__builtin_cpu_supports("avx512f")) kernels.push_back(&kBloomAvx512);
+#endif
+    return kernels;
+}
+
+}  // namespace
+
+const std::vector<const BloomKernel*>& bloom_available() {
+    static const std::vector<const BloomKernel*> kernels = detect();
+    return kernels;
+}
+
+const BloomKernel& bloom_best() { return kBloomScalar; }
+
+const BloomKernel* bloom_find(const std::string& name) {
+    for (const BloomKernel* k : bloom_available()) {
+        if (name == k->name) return k;
+    }
+    return nullptr;
+}
+
+}  // namespace marauder
@@ -0,0 +1,312 @@
+#include "marauder/bsgs.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "marauder/batch_inverse.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+namespace {
+
+constexpr int kInterpolationSteps = 8;
+constexpr size_t kLinearTail = 16;
+
+struct BabyStep {
+    uint64_t key;
+    uint32_t j;
+    bool operator<(const BabyStep& o) const { return key < o.key; }
+};
+
+void write_or_throw(std::FILE* f, const void* p, size_t n, const std::string& path) {
+    if (n && std::fwrite(p, 1, n, f) != n) {
+        std::fclose(f);
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+}  // namespace
+
+void BsgsTable::build(const std::string& path, uint64_t baby_steps, unsigned threads, unsigned bloom_bits) {
+    if (baby_steps == 0 || baby_steps > kMaxBabySteps) {
+        throw std::invalid_argument("baby steps must be between 1 and " + std::to_string(kMaxBabySteps));
+    }
+    if (threads == 0) throw std::invalid_argument("need at least one thread");
+    std::vector<BabyStep> steps(baby_steps);
+    BloomFilter bloom(baby_steps, bloom_bits);
+    std::vector<std::thread> pool;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    for (unsigned t = 0; t < threads; ++t) {
+        uint64_t lo = static_cast<uint64_t>(static_cast<u128>(baby_steps) * t / threads);
+        uint64_t hi = static_cast<uint64_t>(static_cast<u128>(baby_steps) * (t + 1) / threads);
+        if (lo == hi) continue;
+        pool.emplace_back([&, lo, hi] {
+            try {
+                RangeWalker walker(U256::from_u64(lo + 1), U256::from_u64(hi + 1));
+                const Point* pts;
+                U256 first;
+                size_t n;
+                uint64_t at = lo;
+                while ((n = walker.next_batch(pts, first)) != 0) {
+                    for (size_t i = 0; i < n; ++i, ++at) {
+                        steps[at] = BabyStep{pts[i].x.d[0], static_cast<uint32_t>(at + 1)};
+                        bloom.insert_concurrent(bloom_key(pts[i].x));
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+
+    std::sort(steps.begin(), steps.end());
+
+    BsgsHeader h{};
+    std::memcpy(h.magic, kBsgsMagic, sizeof(h.magic));
+    h.version = kBsgsVersion;
+    h.bloom_bits = bloom_bits;
+    h.baby_steps = baby_steps;
+    h.bloom_lines = bloom.lines();
+    h.records = baby_steps;
+
+    std::string tmp = path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) throw std::runtime_error("cannot open " + tmp);
+    write_or_throw(f, &h, sizeof(h), tmp);
+    write_or_throw(f, bloom.data(), bloom.size_bytes(), tmp);
+    std::vector<uint64_t> keys(4096);
+    std::vector<uint32_t> js(4096);
+    for (size_t i = 0; i < steps.size(); i += keys.size()) {
+        size_t n = std::min(keys.size(), steps.size() - i);
+        for (size_t k = 0; k < n; ++k) keys[k] = steps[i + k].key;
+        write_or_throw(f, keys.data(), n * sizeof(uint64_t), tmp);
+    }
+    for (size_t i = 0; i < steps.size(); i += js.size()) {
+        size_t n = std::min(js.size(), steps.size() - i);
+        for (size_t k = 0; k < n; ++k) js[k] = steps[i + k].j;
+        write_or_throw(f, js.data(), n * sizeof(uint32_t), tmp);
+    }
+    if (std::fclose(f) != 0) throw std::runtime_error("cannot write " + tmp);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) throw std::runtime_error("cannot rename " + tmp);
+}
+
+BsgsTable BsgsTable::map(const std::string& path) {
+    BsgsTable t;
+    t.file_ = MappedFile(path);
+    BsgsHeader h;
+    if (t.file_.size() < sizeof(h)) throw std::runtime_error(path + ": not a baby-step table");
+    std::memcpy(&h, t.file_.data(), sizeof(h));
+    if (std::memcmp(h.magic, kBsgsMagic, sizeof(h.magic)) != 0) {
+        throw std::runtime_error(path + ": not a baby-step table");
+    }
+    if (h.version != kBsgsVersion) throw std::runtime_error(path + ": unsupported baby-step table version");
+    const u128 want = u128(sizeof(h)) + u128(h.bloom_lines) * sizeof(BloomLine) + u128(h.records) * 12;
+    if (h.records != h.baby_steps || h.baby_steps == 0 || h.baby_steps > kMaxBabySteps || h.bloom_lines == 0 ||
+        want != t.file_.size()) {
+        throw std::runtime_error(path + ": truncated or corrupt baby-step table");
+    }
+    const uint8_t* p = t.file_.data() + sizeof(h);
+    t.bloom_ = BloomFilter::view(reinterpret_cast<const BloomLine*>(p), h.bloom_lines);
+    p += h.bloom_lines * sizeof(BloomLine);
+    t.keys_ = reinterpret_cast<const uint64_t*>(p);
+    t.steps_ = reinterpret_cast<const uint32_t*>(p + h.records * sizeof(uint64_t));
+    t.steps_count_ = h.baby_steps;
+    return t;
+}
+
+size_t BsgsTable::find(const Fe& x, uint64_t* out, size_t max) const {
+    const uint64_t key = x.d[0];
+    size_t lo = 0, hi = steps_count_ - 1;
+    // Interpolation on uniform keys, as in TargetTable::contains.
+    for (int step = 0; hi - lo >= kLinearTail; ++step) {
+        uint64_t klo = keys_[lo], khi = keys_[hi];
+        if (key < klo || key > khi) return 0;
+        size_t mid;
+        if (step < kInterpolationSteps && khi > klo) {
+            mid = lo + static_cast<size_t>(static_cast<u128>(key - klo) * (hi - lo) / (khi - klo));
+        } else {
+            mid = lo + (hi - lo) / 2;
+        }
+        if (keys_[mid] < key) {
+            lo = mid + 1;
+        } else if (keys_[mid] > key) {
+            hi = mid - 1;
+        } else {
+            // Truncated keys can repeat, and equal ones may sit before mid;
+            // everything before lo is smaller, so search [lo, mid].
+            hi = mid;
+            break;
+        }
+    }
+    const uint64_t* it = std::lower_bound(keys_ + lo, keys_ + hi + 1, key);
+    size_t n = 0;
+    for (; it != keys_ + steps_count_ && *it == key && n < max; ++it) out[n++] = steps_[it - keys_];
+    return n;
+}
+
+namespace {
+
+struct Shared {
+    Shared(const Point& p, const BsgsTable& t, const U256& s, const U256& e, uint64_t g)
+        : pub(p), table(t), start(s), end(e), giant_steps(g) {}
+
+    const Point& pub;
+    const BsgsTable& table;
+    U256 start, end;
+    uint64_t giant_steps;
+    Point stride = Point::at_infinity();  // -(2m + 1) * G
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> steps{0};
+    std::atomic<uint64_t> bloom_passes{0};
+    std::mutex mutex;  // guards the result
+    bool found = false;
+    U256 key;
+    std::exception_ptr error;
+};
+
+U256 ceil_div(const U256& a, uint64_t b) {
+    U256 q;
+    u128 rem = 0;
+    for (int i = 3; i >= 0; --i) {
+        u128 cur = rem << 64 | a.d[i];
+        q.d[i] = static_cast<uint64_t>(cur / b);
+        rem = cur % b;
+    }
+    if (rem) u256_add_u64(q, q, 1);
+    return q;
+}
+
+// start + m + g * (2m + 1)
+U256 centre(const Shared& sh, uint64_t g) {
+    const uint64_t m = sh.table.baby_steps();
+    U256 c;
+    u256_mul_u64(c, U256::from_u64(g), 2 * m + 1);
+    u256_add(c, c, sh.start);
+    u256_add_u64(c, c, m);
+    return c;
+}
+
+bool try_key(Shared& sh, const U256& k) {
+    if (k < sh.start || k >= sh.end) return false;
+    if (point_mul_g(Scalar::from_u256(k)) != sh.pub) return false;
+    std::lock_guard<std::mutex> lock(sh.mutex);
+    if (!sh.found) {
+        sh.found = true;
+        sh.key = k;
+    }
+    sh.done.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void check(Shared& sh, const Point& p, uint64_t g) {
+    U256 c = centre(sh, g);
+    if (p.infinity) {
+        try_key(sh, c);
+        return;
+    }
+    if (!sh.table.maybe_contains(p.x)) return;
+    sh.bloom_passes.fetch_add(1, std::memory_order_relaxed);
+    uint64_t js[4];
+    size_t n = sh.table.find(p.x, js, 4);
+    for (size_t i = 0; i < n; ++i) {
+        U256 k;
+        u256_add_u64(k, c, js[i]);
+        if (try_key(sh, k)) return;
+        u256_sub(k, c, U256::from_u64(js[i]));
+        if (try_key(sh, k)) return;
+    }
+}
+
+void run_giant(Shared& sh, uint64_t g0, uint64_t g1, size_t lanes) {
+    lanes = static_cast<size_t>(std::min<uint64_t>(lanes, g1 - g0));
+    const uint64_t len = (g1 - g0 + lanes - 1) / lanes;
+    std::vector<Point> pos(lanes);
+    std::vector<uint64_t> next(lanes), last(lanes);
+    for (size_t l = 0; l < lanes; ++l) {
+        next[l] = g0 + l * len;
+        last[l] = std::min(g1, next[l] + len);
+        Scalar neg;
+        scalar_neg(neg, Scalar::from_u256(centre(sh, next[l])));
+        point_add(pos[l], point_mul_g(neg), sh.pub);
+    }
+    std::vector<Fe> dx(lanes), scratch(lanes);
+    for (uint64_t round = 0; round < len && !sh.done.load(std::memory_order_relaxed); ++round) {
+        uint64_t checked = 0;
+        for (size_t l = 0; l < lanes; ++l) {
+            if (next[l] >= last[l]) continue;
+            check(sh, pos[l], next[l]++);
+            ++checked;
+        }
+        sh.steps.fetch_add(checked, std::memory_order_relaxed);
+        if (round + 1 == len) break;
+        for (size_t l = 0; l < lanes; ++l) fe_sub(dx[l], sh.stride.x, pos[l].x);
+        fe_batch_inv(dx.data(), lanes, scratch.data());
+        for (size_t l = 0; l < lanes; ++l) point_add_inv(pos[l], pos[l], sh.stride.x, sh.stride.y, dx[l]);
+    }
+}
+
+}  // namespace
+
+BsgsResult bsgs_solve(const Point& pub, const U256& start, const U256& end, const BsgsTable& table,
+                      const BsgsConfig& config) {
+    if (start.is_zero() || start >= end || end > kOrderN) {
+        throw std::invalid_argument("BSGS range must satisfy 1 <= start < end <= n");
+    }
+    if (pub.infinity || !point_on_curve(pub)) throw std::invalid_argument("public key is not on the curve");
+    if (table.baby_steps() == 0) throw std::invalid_argument("no baby-step table");
+    if (config.threads == 0 || config.lanes == 0) throw std::invalid_argument("need at least one lane");
+    auto t0 = std::chrono::steady_clock::now();
+
+    const uint64_t m = table.baby_steps();
+    U256 width;
+    u256_sub(width, end, start);
+    U256 giants = ceil_div(width, 2 * m + 1);
+    if (giants.bit_length() > 63) throw std::invalid_argument("range is too wide for this baby-step table");
+
+    Shared sh(pub, table, start, end, giants.d[0]);
+    Scalar s;
+    scalar_neg(s, Scalar::from_u64(2 * m + 1));
+    sh.stride = point_mul_g(s);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < config.threads; ++t) {
+        uint64_t g0 = static_cast<uint64_t>(static_cast<u128>(sh.giant_steps) * t / config.threads);
+        uint64_t g1 = static_cast<uint64_t>(static_cast<u128>(sh.giant_steps) * (t + 1) / config.threads);
+        if (g0 == g1) continue;
+        threads.emplace_back([&sh, &config, g0, g1] {
+            try {
+                run_giant(sh, g0, g1, config.lanes);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(sh.mutex);
+                if (!sh.error) sh.error = std::current_exception();
+                sh.done.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    if (sh.error) std::rethrow_exception(sh.error);
+
+    BsgsResult r;
+    r.found = sh.found;
+    r.key = sh.key;
+    r.giant_steps = sh.steps.load();
+    r.bloom_passes = sh.bloom_passes.load();
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+}  // namespace marauder
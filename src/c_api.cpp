@@ -0,0 +1,198 @@
+#include "marauder/c_api.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "marauder/metrics.hpp"
+#include "marauder/partitioner.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/target_index.hpp"
+#include "marauder/target_set.hpp"
+
+using namespace marauder;
+
+struct marauder_searcher {
+    ScanConfig config;
+    std::unique_ptr<TargetSet> targets;
+
+    // The current scan. Its thread only touches the fields from mutex on,
+    // under mutex; submit replaces the rest only once it has ended.
+    std::thread thread;
+    std::atomic<bool> cancel{false};
+    std::unique_ptr<Metrics> metrics;
+    std::chrono::steady_clock::time_point started;
+
+    mutable std::mutex mutex;
+    std::condition_variable ended;
+    uint32_t state = MARAUDER_IDLE;
+    uint64_t units_total = 0;
+    uint64_t hits = 0;
+    std::deque<marauder_hit> pending;
+    ScanStats stats;  // once state is MARAUDER_FINISHED
+    double seconds = 0;
+    std::string error;
+};
+
+namespace {
+
+void set_error(char* err, size_t len, const char* what) {
+    if (err && len) std::snprintf(err, len, "%s", what);
+}
+
+std::unique_ptr<TargetSet> load_targets(const marauder_config& c) {
+    int sources = (c.digests && c.digest_count) + (c.table_path != nullptr) + (c.index_path != nullptr);
+    if (sources != 1) throw std::invalid_argument("give exactly one of digests, table_path and index_path");
+    if (c.table_path) return std::make_unique<TargetSet>(TargetTable::map(c.table_path));
+    if (c.index_path) return std::make_unique<TargetSet>(map_target_index(c.index_path));
+    std::vector<Hash160> digests(c.digest_count);
+    for (uint64_t i = 0; i < c.digest_count; ++i) {
+        std::copy(c.digests + 20 * i, c.digests + 20 * (i + 1), digests[i].begin());
+    }
+    return std::make_unique<TargetSet>(TargetTable::from_digests(std::move(digests)));
+}
+
+void run(marauder_searcher* s, U256 start, U256 end) {
+    ScanStats stats;
+    std::string error;
+    try {
+        stats = scan_range(start, end, s->config, [s](const ScanHit& h) {
+            marauder_hit out;
+            h.key.to_be_bytes(out.key);
+            std::copy(h.pubkey, h.pubkey + sizeof(h.pubkey), out.pubkey);
+            std::copy(h.digest.begin(), h.digest.end(), out.digest);
+            out.uncompressed = h.uncompressed;
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->pending.push_back(out);
+            ++s->hits;
+        });
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    std::lock_guard<std::mutex> lock(s->mutex);
+    s->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - s->started).count();
+    s->stats = stats;
+    s->error = error;
+    s->state = error.empty() ? MARAUDER_FINISHED : MARAUDER_FAILED;
+    s->ended.notify_all();
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t marauder_abi_version(void) { return MARAUDER_ABI_VERSION; }
+
+marauder_searcher* marauder_searcher_create(const marauder_config* config, char* err, size_t err_len) {
+    try {
+        if (!config) throw std::invalid_argument("no configuration");
+        auto s = std::make_unique<marauder_searcher>();
+        s->targets = load_targets(*config);
+        ScanConfig& cfg = s->config;
+        // As in the CLI, zero threads means one per hardware thread.
+        cfg.threads = config->threads ? config->threads : std::max(1u, std::thread::hardware_concurrency());
+        if (config->unit_bits) cfg.unit_bits = config->unit_bits;
+        if (config->batch_size) cfg.walker.batch_size = config->batch_size;
+        cfg.endomorphism = config->endomorphism != 0;
+        cfg.pin_threads = config->pin_threads != 0;
+        cfg.uncompressed = config->uncompressed != 0;
+        cfg.targets = s->targets.get();
+        cfg.cancel = &s->cancel;
+        // Configuration errors here rather than from the first scan.
+        RangeWalker probe(U256::from_u64(1), U256::from_u64(2), cfg.walker);
+        if (kBlockLanes % cfg.walker.batch_size != 0) {
+            throw std::invalid_argument("batch size must divide the block size " + std::to_string(kBlockLanes));
+        }
+        return s.release();
+    } catch (const std::exception& e) {
+        set_error(err, err_len, e.what());
+        return nullptr;
+    }
+}
+
+void marauder_searcher_destroy(marauder_searcher* searcher) {
+    if (!searcher) return;
+    searcher->cancel.store(true);
+    if (searcher->thread.joinable()) searcher->thread.join();
+    delete searcher;
+}
+
+int marauder_searcher_submit(marauder_searcher* s, const uint8_t start[32], const uint8_t end[32], char* err,
+                             size_t err_len) {
+    std::lock_guard<std::mutex> lock(s->mutex);
+    if (s->state == MARAUDER_RUNNING) return MARAUDER_BUSY;
+    try {
+        U256 from = U256::from_be_bytes(start), to = U256::from_be_bytes(end);
+        // Checks the range the way the scan will.
+        RangeWalker probe(from, to, s->config.walker);
+        uint64_t units = RangePartitioner(from, to, 1, s->config.unit_bits).unit_count();
+        // It has set its state, so at most its return is left.
+        if (s->thread.joinable()) s->thread.join();
+        s->cancel.store(false);
+        s->metrics = std::make_unique<Metrics>();
+        s->config.metrics = s->metrics.get();
+        s->started = std::chrono::steady_clock::now();
+        s->units_total = units;
+        s->hits = 0;
+        s->pending.clear();
+        s->stats = ScanStats();
+        s->error.clear();
+        s->thread = std::thread(run, s, from, to);
+        s->state = MARAUDER_RUNNING;
+        return MARAUDER_OK;
+    } catch (const std::exception& e) {
+        set_error(err, err_len, e.what());
+        return MARAUDER_ERROR;
+    }
+}
+
+void marauder_searcher_poll(const marauder_searcher* s, marauder_progress* out) {
+    std::lock_guard<std::mutex> lock(s->mutex);
+    *out = marauder_progress();
+    out->state = s->state;
+    out->units_total = s->units_total;
+    out->hits = s->hits;
+    out->hits_pending = s->pending.size();
+    if (s->state == MARAUDER_RUNNING) {
+        for (unsigned w = 0; w < s->config.threads; ++w) {
+            const WorkerMetrics& m = s->metrics->worker("cpu" + std::to_string(w), "cpu");
+            out->keys += m.keys.get();
+            out->units_done += m.units.get();
+        }
+        out->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - s->started).count();
+    } else {
+        out->keys = s->stats.keys;
+        out->units_done = s->stats.units;
+        out->seconds = s->seconds;
+    }
+}
+
+size_t marauder_searcher_fetch_hits(marauder_searcher* s, marauder_hit* out, size_t max) {
+    std::lock_guard<std::mutex> lock(s->mutex);
+    size_t n = std::min(max, s->pending.size());
+    std::copy(s->pending.begin(), s->pending.begin() + static_cast<std::ptrdiff_t>(n), out);
+    s->pending.erase(s->pending.begin(), s->pending.begin() + static_cast<std::ptrdiff_t>(n));
+    return n;
+}
+
+void marauder_searcher_cancel(marauder_searcher* s) { s->cancel.store(true); }
+
+int marauder_searcher_wait(marauder_searcher* s, char* err, size_t err_len) {
+    std::unique_lock<std::mutex> lock(s->mutex);
+    s->ended.wait(lock, [s] { return s->state != MARAUDER_RUNNING; });
+    if (s->state != MARAUDER_FAILED) return MARAUDER_OK;
+    set_error(err, err_len, s->error.c_str());
+    return MARAUDER_ERROR;
+}
+
+}  // extern "C"
@@ -0,0 +1,243 @@
+#include "marauder/checkpoint.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace marauder {
+
+namespace {
+
+constexpr const char* kMagic = "marauder-checkpoint 1";
+
+[[noreturn]] void io_error(const std::string& what, const std::string& path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+// Sequential checkpoints keep the header they had before orders existed.
+std::string header(const U256& start, const U256& end, unsigned unit_bits, const UnitOrder& order) {
+    std::string h = std::string(kMagic) + "\nrange " + start.to_hex() + " " + end.to_hex() + "\nunit-bits " +
+                    std::to_string(unit_bits) + "\n";
+    if (order.mode != UnitOrderMode::Sequential) h += "order " + order.name() + "\n";
+    return h;
+}
+
+void write_all(int fd, const std::string& data, const std::string& path) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = ::write(fd, data.data() + off, data.size() - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            io_error("cannot write", path);
+        }
+        off += static_cast<size_t>(n);
+    }
+}
+
+void fsync_dir_of(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) io_error("cannot open directory", dir);
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0) io_error("cannot fsync directory", dir);
+}
+
+}  // namespace
+
+Checkpoint::Checkpoint(const std::string& path, const U256& start, const U256& end, unsigned unit_bits,
+                       std::chrono::milliseconds interval, const UnitOrder& order)
+    : path_(path), start_(start), end_(end), unit_bits_(unit_bits), interval_(interval), order_(order) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0) resumed_ = load(path, start, end, unit_bits, order);
+    done_ = resumed_;
+    writer_ = std::thread([this] { writer_loop(); });
+}
+
+Checkpoint::~Checkpoint() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; callers that care call close().
+    }
+}
+
+void Checkpoint::mark_done(const UnitSpan& positions) { push(new Node{positions, nullptr, nullptr}); }
+
+void Checkpoint::push(Node* n) {
+    n->next = pending_.load(std::memory_order_relaxed);
+    while (!pending_.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+Checkpoint::Marker::Marker(Checkpoint& checkpoint, size_t nodes)
+    : checkpoint_(checkpoint), nodes_(new Node[nodes]) {
+    if (nodes == 0) throw std::invalid_argument("a checkpoint marker needs at least one node");
+    for (size_t i = 0; i < nodes; ++i) nodes_[i] = Node{UnitSpan{}, i + 1 < nodes ? &nodes_[i + 1] : nullptr, this};
+    free_ = &nodes_[0];
+}
+
+Checkpoint::Marker::~Marker() {
+    // Nodes still on the pending list would be handed back to freed memory.
+    std::lock_guard<std::mutex> lock(checkpoint_.mutex_);
+    checkpoint_.drain_locked();
+}
+
+void Checkpoint::Marker::mark_done(uint64_t position) {
+    if (!free_) free_ = returned_.exchange(nullptr, std::memory_order_acquire);
+    if (!free_) free_ = checkpoint_.wait_for_nodes(*this);
+    Node* n = free_;
+    free_ = n->next;
+    n->units = UnitSpan{position, position + 1};
+    checkpoint_.push(n);
+}
+
+// The drain below inserts into done_, which allocates, so a starved worker
+// leaves it to the writer thread rather than draining itself.
+Checkpoint::Node* Checkpoint::wait_for_nodes(Marker& m) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (Node* n = m.returned_.exchange(nullptr, std::memory_order_acquire)) return n;
+        starved_ = true;
+        wake_.notify_all();
+        drained_.wait(lock);
+    }
+}
+
+IntervalSet Checkpoint::load(const std::string& path, const U256& start, const U256& end, unsigned unit_bits,
+                             const UnitOrder& order) {
+    std::ifstream in(path);
+    if (!in) io_error("cannot open", path);
+    std::stringstream buf;
+    buf << in.rdbuf();
+    std::string text = buf.str();
+
+    const std::string want = header(start, end, unit_bits, order);
+    if (text.compare(0, std::string(kMagic).size(), kMagic) != 0) {
+        throw std::runtime_error(path + ": not a marauder checkpoint");
+    }
+    // A sequential header is a prefix of every other order's.
+    if (text.compare(0, want.size(), want) != 0 || text.compare(want.size(), 6, "order ") == 0) {
+        throw std::runtime_error(path + ": checkpoint is for a different range, unit size or order");
+    }
+    std::istringstream lines(text.substr(want.size()));
+    IntervalSet set;
+    std::string word;
+    while (lines >> word) {
+        if (word == "end") return set;
+        UnitSpan s;
+        if (word != "done" || !(lines >> s.lo >> s.hi) || s.lo >= s.hi) break;
+        set.insert(s);
+    }
+    throw std::runtime_error(path + ": corrupt checkpoint");
+}
+
+void Checkpoint::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto due = std::chrono::steady_clock::now() + interval_;
+    while (!closing_) {
+        wake_.wait_until(lock, due, [this] { return closing_ || starved_; });
+        if (closing_) break;
+        // A starved marker only needs its nodes back; the file waits until due.
+        drain_locked();
+        if (std::chrono::steady_clock::now() < due) continue;
+        due = std::chrono::steady_clock::now() + interval_;
+        try {
+            write_locked();
+        } catch (...) {
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+}
+
+void Checkpoint::drain_locked() {
+    for (Node* n = pending_.exchange(nullptr, std::memory_order_acquire); n;) {
+        done_.insert(n->units);
+        Node* next = n->next;
+        if (Marker* m = n->owner) {
+            n->next = m->returned_.load(std::memory_order_relaxed);
+            while (!m->returned_.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                                       std::memory_order_relaxed)) {
+            }
+        } else {
+            delete n;
+        }
+        n = next;
+        dirty_ = true;
+    }
+    if (starved_) {
+        starved_ = false;
+        drained_.notify_all();
+    }
+}
+
+void Checkpoint::write_locked() {
+    drain_locked();
+    if (!dirty_) return;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::string text = header(start_, end_, unit_bits_, order_);
+    for (const UnitSpan& s : done_.spans()) {
+        text += "done " + std::to_string(s.lo) + " " + std::to_string(s.hi) + "\n";
+    }
+    text += "end\n";
+
+    const std::string tmp = path_ + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) io_error("cannot create", tmp);
+    try {
+        write_all(fd, text, tmp);
+        if (::fsync(fd) != 0) io_error("cannot fsync", tmp);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) io_error("cannot close", tmp);
+    if (::rename(tmp.c_str(), path_.c_str()) != 0) io_error("cannot rename over", path_);
+    fsync_dir_of(path_);
+    dirty_ = false;
+    if (write_seconds_) {
+        write_seconds_->observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+}
+
+void Checkpoint::observe_writes(Histogram* h) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_seconds_ = h;
+}
+
+void Checkpoint::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_locked();
+}
+
+void Checkpoint::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closing_ && !writer_.joinable()) {
+            if (error_) std::rethrow_exception(error_);
+            return;
+        }
+        closing_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable()) writer_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A good final write supersedes any earlier background failure.
+    try {
+        write_locked();
+        error_ = nullptr;
+    } catch (...) {
+        error_ = std::current_exception();
+    }
+    if (error_) std::rethrow_exception(error_);
+}
+
+}  // namespace marauder
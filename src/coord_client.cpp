@@ -0,0 +1,185 @@
+#include "marauder/coord_client.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+
+#include "coord_net.hpp"
+
+namespace marauder {
+
+CoordEndpoint parse_coord_endpoint(const std::string& text) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon + 1 == text.size()) {
+        throw std::invalid_argument("coordinator address must be HOST:PORT: " + text);
+    }
+    std::string host = text.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+    size_t used = 0;
+    unsigned long port = 0;
+    try {
+        port = std::stoul(text.substr(colon + 1), &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != text.size() - colon - 1 || port == 0 || port > 65535 || host.empty()) {
+        throw std::invalid_argument("bad coordinator address: " + text);
+    }
+    return CoordEndpoint{host, static_cast<uint16_t>(port)};
+}
+
+CoordClient::CoordClient(const CoordEndpoint& at, const HelloMsg& hello)
+    : fd_(coord_net::connect_tcp(at.host, at.port)) {
+    try {
+        decode(call(encode(hello)), welcome_);
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+CoordClient::~CoordClient() { ::close(fd_); }
+
+Frame CoordClient::call(const std::vector<uint8_t>& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    coord_net::send_all(fd_, request);
+    Frame f;
+    uint8_t buf[64 * 1024];
+    while (!take_frame(in_, f)) {
+        ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n == 0) throw std::runtime_error("coordinator closed the connection");
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            coord_net::fail("cannot read from coordinator");
+        }
+        in_.insert(in_.end(), buf, buf + n);
+    }
+    if (f.type == MsgType::Error) {
+        ErrorMsg e;
+        decode(f, e);
+        throw std::runtime_error("coordinator: " + e.message);
+    }
+    return f;
+}
+
+LeaseMsg CoordClient::lease(uint32_t max_units) {
+    LeaseMsg m;
+    decode(call(encode(LeaseRequestMsg{max_units})), m);
+    return m;
+}
+
+std::vector<uint64_t> CoordClient::heartbeat(const std::vector<uint64_t>& lease_ids) {
+    HeartbeatAckMsg m;
+    decode(call(encode(HeartbeatMsg{lease_ids})), m);
+    return m.lost;
+}
+
+void CoordClient::complete(uint64_t lease_id, const std::vector<UnitSpan>& spans) {
+    Frame f = call(encode(CompleteMsg{lease_id, spans}));
+    if (f.type != MsgType::Ack) throw std::runtime_error("unexpected reply to a completion");
+}
+
+void CoordClient::report_hits(const std::vector<ScanHit>& hits) {
+    Frame f = call(encode(HitsMsg{hits}));
+    if (f.type != MsgType::Ack) throw std::runtime_error("unexpected reply to a hit report");
+}
+
+namespace {
+
+// Heartbeats the current lease every interval until destroyed. A lost
+// lease does not stop the scan: its completion is still accepted.
+class Heartbeat {
+public:
+    Heartbeat(CoordClient& client, std::chrono::milliseconds interval)
+        : client_(client), interval_(interval), thread_([this] { loop(); }) {}
+    ~Heartbeat() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    void set(uint64_t lease_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lease_ = lease_id;
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval_, [this] { return done_; })) {
+            if (lease_ == 0) continue;
+            std::vector<uint64_t> ids{lease_};
+            lock.unlock();
+            try {
+                client_.heartbeat(ids);
+            } catch (const std::exception&) {
+                // The main loop sees the broken connection on its next call.
+            }
+            lock.lock();
+        }
+    }
+
+    CoordClient& client_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    uint64_t lease_ = 0;
+    bool done_ = false;
+    std::thread thread_;
+};
+
+}  // namespace
+
+ScanStats scan_coordinated(CoordClient& client, const ScanConfig& config, const ScanHitFn& on_hit,
+                           uint32_t lease_units) {
+    if (config.checkpoint) throw std::invalid_argument("coordinated workers do not keep a checkpoint");
+    if (lease_units == 0) throw std::invalid_argument("leases need at least one unit");
+    const WelcomeMsg& job = client.welcome();
+    ScanConfig cfg = config;
+    cfg.unit_bits = job.unit_bits;
+    cfg.endomorphism = job.endomorphism;
+
+    ScanStats total;
+    auto t0 = std::chrono::steady_clock::now();
+    Heartbeat beat(client, std::chrono::milliseconds(std::max<uint32_t>(job.heartbeat_ms, 1)));
+    for (;;) {
+        LeaseMsg lease = client.lease(lease_units);
+        if (lease.status == LeaseStatus::Finished) break;
+        if (lease.status == LeaseStatus::Wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(lease.retry_ms));
+            continue;
+        }
+        beat.set(lease.lease_id);
+        IntervalSet units;
+        for (const UnitSpan& s : lease.spans) units.insert(s);
+        cfg.units = &units;
+        std::vector<ScanHit> hits;
+        ScanStats s = scan_range(job.start, job.end, cfg, [&](const ScanHit& h) {
+            hits.push_back(h);
+            if (on_hit) on_hit(h);
+        });
+        // Hits first, so a crash in between can only repeat a unit, never lose a hit.
+        if (!hits.empty()) client.report_hits(hits);
+        client.complete(lease.lease_id, lease.spans);
+        beat.set(0);
+        total.keys += s.keys;
+        total.hits += s.hits;
+        total.units += s.units;
+        total.steals += s.steals;
+        total.remote_steals += s.remote_steals;
+        total.profile.add(s.profile);
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return total;
+}
+
+}  // namespace marauder
@@ -0,0 +1,111 @@
+#include "coord_net.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace marauder {
+namespace coord_net {
+
+namespace {
+
+struct AddrInfo {
+    addrinfo* list = nullptr;
+    ~AddrInfo() {
+        if (list) ::freeaddrinfo(list);
+    }
+};
+
+void resolve(AddrInfo& out, const std::string& host, uint16_t port, bool passive) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+    std::string service = std::to_string(port);
+    int rc = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &out.list);
+    if (rc != 0) throw std::runtime_error("cannot resolve " + host + ": " + ::gai_strerror(rc));
+}
+
+}  // namespace
+
+void fail(const std::string& what) { throw std::runtime_error(what + ": " + std::strerror(errno)); }
+
+int connect_tcp(const std::string& host, uint16_t port) {
+    AddrInfo ai;
+    resolve(ai, host, port, false);
+    int saved = 0;
+    for (addrinfo* a = ai.list; a; a = a->ai_next) {
+        int fd = ::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+        if (fd < 0) {
+            saved = errno;
+            continue;
+        }
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        saved = errno;
+        ::close(fd);
+    }
+    errno = saved;
+    fail("cannot connect to " + host + ":" + std::to_string(port));
+}
+
+int listen_tcp(const std::string& host, uint16_t port) {
+    AddrInfo ai;
+    resolve(ai, host, port, true);
+    int saved = 0;
+    for (addrinfo* a = ai.list; a; a = a->ai_next) {
+        int fd = ::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+        if (fd < 0) {
+            saved = errno;
+            continue;
+        }
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, a->ai_addr, a->ai_addrlen) == 0 && ::listen(fd, 128) == 0) {
+            set_nonblocking(fd);
+            return fd;
+        }
+        saved = errno;
+        ::close(fd);
+    }
+    errno = saved;
+    fail("cannot listen on " + host + ":" + std::to_string(port));
+}
+
+uint16_t local_port(int fd) {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) fail("getsockname");
+    if (addr.ss_family == AF_INET6) return ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port);
+    return ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+}
+
+void set_nonblocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) fail("fcntl");
+}
+
+void send_all(int fd, const std::vector<uint8_t>& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = ::send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fail("cannot send to coordinator");
+        }
+        off += static_cast<size_t>(n);
+    }
+}
+
+}  // namespace coord_net
+}  // namespace marauder
@@ -0,0 +1,26 @@
+// TCP plumbing shared by CoordServer and CoordClient. Internal.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace marauder {
+namespace coord_net {
+
+// Throws std::runtime_error("<what>: <strerror(errno)>").
+[[noreturn]] void fail(const std::string& what);
+
+// Blocking connected socket with TCP_NODELAY set.
+int connect_tcp(const std::string& host, uint16_t port);
+// Non-blocking listening socket; port 0 picks a free port.
+int listen_tcp(const std::string& host, uint16_t port);
+uint16_t local_port(int fd);
+void set_nonblocking(int fd);
+
+// Blocking: writes all of data.
+void send_all(int fd, const std::vector<uint8_t>& data);
+
+}  // namespace coord_net
+}  // namespace marauder
@@ -0,0 +1,292 @@
+#include "marauder/coord_protocol.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace marauder {
+
+namespace {
+
+class Writer {
+public:
+    explicit Writer(MsgType type) : buf_(4, 0) { buf_.push_back(static_cast<uint8_t>(type)); }
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            buf_.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        buf_.push_back(static_cast<uint8_t>(v));
+    }
+    void bytes(const uint8_t* p, size_t n) { buf_.insert(buf_.end(), p, p + n); }
+    void u256(const U256& v) {
+        uint8_t be[32];
+        v.to_be_bytes(be);
+        bytes(be, sizeof(be));
+    }
+    void string(const std::string& s) {
+        varint(s.size());
+        bytes(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+    void spans(const std::vector<UnitSpan>& spans) {
+        varint(spans.size());
+        uint64_t at = 0;
+        for (const UnitSpan& s : spans) {
+            varint(s.lo - at);
+            varint(s.hi - s.lo);
+            at = s.hi;
+        }
+    }
+
+    std::vector<uint8_t> finish() {
+        uint32_t len = static_cast<uint32_t>(buf_.size() - 4);
+        for (int i = 0; i < 4; ++i) buf_[i] = static_cast<uint8_t>(len >> (8 * i));
+        return std::move(buf_);
+    }
+
+private:
+    std::vector<uint8_t> buf_;
+};
+
+class Reader {
+public:
+    Reader(const Frame& f, MsgType want) : p_(f.body.data()), end_(f.body.data() + f.body.size()) {
+        if (f.type != want) throw std::runtime_error("unexpected coordinator message type");
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("bad varint in coordinator message");
+    }
+    uint32_t u32() {
+        uint64_t v = varint();
+        if (v > UINT32_MAX) throw std::runtime_error("field out of range in coordinator message");
+        return static_cast<uint32_t>(v);
+    }
+    uint8_t byte() {
+        need(1);
+        return *p_++;
+    }
+    void bytes(uint8_t* out, size_t n) {
+        need(n);
+        std::memcpy(out, p_, n);
+        p_ += n;
+    }
+    U256 u256() {
+        uint8_t be[32];
+        bytes(be, sizeof(be));
+        return U256::from_be_bytes(be);
+    }
+    std::string string() {
+        uint64_t n = varint();
+        need(n);
+        std::string s(reinterpret_cast<const char*>(p_), n);
+        p_ += n;
+        return s;
+    }
+    // Bounded by the bytes left so a hostile count cannot force a huge allocation.
+    uint64_t count(size_t min_item_bytes) {
+        uint64_t n = varint();
+        if (n > static_cast<uint64_t>(end_ - p_) / min_item_bytes) {
+            throw std::runtime_error("bad count in coordinator message");
+        }
+        return n;
+    }
+    std::vector<UnitSpan> spans() {
+        std::vector<UnitSpan> out(count(2));
+        uint64_t at = 0;
+        for (UnitSpan& s : out) {
+            s.lo = at + varint();
+            s.hi = s.lo + varint();
+            if (s.lo < at || s.hi <= s.lo) throw std::runtime_error("bad span in coordinator message");
+            at = s.hi;
+        }
+        return out;
+    }
+    void done() const {
+        if (p_ != end_) throw std::runtime_error("trailing bytes in coordinator message");
+    }
+
+private:
+    void need(size_t n) const {
+        if (static_cast<size_t>(end_ - p_) < n) throw std::runtime_error("truncated coordinator message");
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+}  // namespace
+
+std::vector<uint8_t> encode(const HelloMsg& m) {
+    Writer w(MsgType::Hello);
+    w.varint(kCoordMagic);
+    w.varint(kCoordVersion);
+    w.varint(m.slots);
+    w.string(m.name);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const WelcomeMsg& m) {
+    Writer w(MsgType::Welcome);
+    w.varint(m.worker_id);
+    w.u256(m.start);
+    w.u256(m.end);
+    w.varint(m.unit_bits);
+    w.varint(m.lease_ms);
+    w.varint(m.heartbeat_ms);
+    w.varint(m.endomorphism);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const LeaseRequestMsg& m) {
+    Writer w(MsgType::LeaseRequest);
+    w.varint(m.max_units);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const LeaseMsg& m) {
+    Writer w(MsgType::Lease);
+    w.varint(static_cast<uint8_t>(m.status));
+    w.varint(m.lease_id);
+    w.varint(m.retry_ms);
+    w.spans(m.spans);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const HeartbeatMsg& m) {
+    Writer w(MsgType::Heartbeat);
+    w.varint(m.lease_ids.size());
+    for (uint64_t id : m.lease_ids) w.varint(id);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const HeartbeatAckMsg& m) {
+    Writer w(MsgType::HeartbeatAck);
+    w.varint(m.lost.size());
+    for (uint64_t id : m.lost) w.varint(id);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const CompleteMsg& m) {
+    Writer w(MsgType::Complete);
+    w.varint(m.lease_id);
+    w.spans(m.spans);
+    return w.finish();
+}
+
+std::vector<uint8_t> encode(const HitsMsg& m) {
+    Writer w(MsgType::Hits);
+    w.varint(m.hits.size());
+    for (const ScanHit& h : m.hits) {
+        w.u256(h.key);
+        w.bytes(h.pubkey, sizeof(h.pubkey));
+        w.bytes(h.digest.data(), h.digest.size());
+        w.varint(h.uncompressed);
+    }
+    return w.finish();
+}
+
+std::vector<uint8_t> encode_ack() { return Writer(MsgType::Ack).finish(); }
+
+std::vector<uint8_t> encode(const ErrorMsg& m) {
+    Writer w(MsgType::Error);
+    w.string(m.message);
+    return w.finish();
+}
+
+void decode(const Frame& f, HelloMsg& m) {
+    Reader r(f, MsgType::Hello);
+    if (r.varint() != kCoordMagic) throw std::runtime_error("not a marauder worker");
+    if (r.varint() != kCoordVersion) throw std::runtime_error("unsupported coordinator protocol version");
+    m.slots = r.u32();
+    m.name = r.string();
+    r.done();
+}
+
+void decode(const Frame& f, WelcomeMsg& m) {
+    Reader r(f, MsgType::Welcome);
+    m.worker_id = r.varint();
+    m.start = r.u256();
+    m.end = r.u256();
+    m.unit_bits = r.u32();
+    m.lease_ms = r.u32();
+    m.heartbeat_ms = r.u32();
+    m.endomorphism = r.varint() != 0;
+    r.done();
+}
+
+void decode(const Frame& f, LeaseRequestMsg& m) {
+    Reader r(f, MsgType::LeaseRequest);
+    m.max_units = r.u32();
+    r.done();
+}
+
+void decode(const Frame& f, LeaseMsg& m) {
+    Reader r(f, MsgType::Lease);
+    uint64_t status = r.varint();
+    if (status > static_cast<uint8_t>(LeaseStatus::Finished)) throw std::runtime_error("bad lease status");
+    m.status = static_cast<LeaseStatus>(status);
+    m.lease_id = r.varint();
+    m.retry_ms = r.u32();
+    m.spans = r.spans();
+    r.done();
+}
+
+void decode(const Frame& f, HeartbeatMsg& m) {
+    Reader r(f, MsgType::Heartbeat);
+    m.lease_ids.resize(r.count(1));
+    for (uint64_t& id : m.lease_ids) id = r.varint();
+    r.done();
+}
+
+void decode(const Frame& f, HeartbeatAckMsg& m) {
+    Reader r(f, MsgType::HeartbeatAck);
+    m.lost.resize(r.count(1));
+    for (uint64_t& id : m.lost) id = r.varint();
+    r.done();
+}
+
+void decode(const Frame& f, CompleteMsg& m) {
+    Reader r(f, MsgType::Complete);
+    m.lease_id = r.varint();
+    m.spans = r.spans();
+    r.done();
+}
+
+void decode(const Frame& f, HitsMsg& m) {
+    Reader r(f, MsgType::Hits);
+    m.hits.resize(r.count(32 + 33 + 20 + 1));
+    for (ScanHit& h : m.hits) {
+        h.key = r.u256();
+        r.bytes(h.pubkey, sizeof(h.pubkey));
+        r.bytes(h.digest.data(), h.digest.size());
+        h.uncompressed = r.varint() != 0;
+    }
+    r.done();
+}
+
+void decode(const Frame& f, ErrorMsg& m) {
+    Reader r(f, MsgType::Error);
+    m.message = r.string();
+    r.done();
+}
+
+bool take_frame(std::vector<uint8_t>& buf, Frame& out) {
+    if (buf.size() < 4) return false;
+    uint32_t len = 0;
+    for (int i = 0; i < 4; ++i) len |= uint32_t(buf[i]) << (8 * i);
+    if (len == 0 || len > kCoordMaxFrame) throw std::runtime_error("bad coordinator frame length");
+    if (buf.size() < 4 + size_t(len)) return false;
+    out.type = static_cast<MsgType>(buf[4]);
+    out.body.assign(buf.begin() + 5, buf.begin() + 4 + len);
+    buf.erase(buf.begin(), buf.begin() + 4 + len);
+    return true;
+}
+
+}  // namespace marauder
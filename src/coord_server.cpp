@@ -0,0 +1,198 @@
+#include "marauder/coord_server.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+
+#include "coord_net.hpp"
+
+namespace marauder {
+
+struct CoordServer::Conn {
+    int fd;
+    uint64_t worker = 0;  // 0 until Hello
+    std::string name;
+    std::vector<uint8_t> in, out;
+    bool closing = false;  // drop once out is flushed
+};
+
+CoordServer::CoordServer(Coordinator& coord, const CoordServerConfig& config, CoordHitFn on_hit)
+    : coord_(coord), config_(config), on_hit_(std::move(on_hit)) {
+    if (config.heartbeat.count() <= 0) throw std::invalid_argument("heartbeat interval must be positive");
+    listen_fd_ = coord_net::listen_tcp(config.host, config.port);
+    port_ = coord_net::local_port(listen_fd_);
+    if (::pipe2(wake_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        ::close(listen_fd_);
+        coord_net::fail("pipe");
+    }
+}
+
+CoordServer::~CoordServer() {
+    for (auto& c : conns_) ::close(c->fd);
+    ::close(listen_fd_);
+    ::close(wake_[0]);
+    ::close(wake_[1]);
+}
+
+size_t CoordServer::workers() const { return conns_.size(); }
+
+void CoordServer::stop() {
+    char b = 1;
+    // A full pipe already means a pending wake-up.
+    [[maybe_unused]] ssize_t n = ::write(wake_[1], &b, 1);
+}
+
+void CoordServer::run() {
+    std::vector<pollfd> fds;
+    for (;;) {
+        auto now = Coordinator::Clock::now();
+        coord_.expire(now);
+        if (coord_.finished() && conns_.empty()) return;
+
+        fds.clear();
+        fds.push_back(pollfd{wake_[0], POLLIN, 0});
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        for (auto& c : conns_) {
+            fds.push_back(pollfd{c->fd, static_cast<short>(POLLIN | (c->out.empty() ? 0 : POLLOUT)), 0});
+        }
+        // Wake for the next lease expiry, and at least once a second.
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(coord_.next_expiry() - now);
+        int timeout = static_cast<int>(std::clamp<int64_t>(wait.count() + 1, 0, 1000));
+        if (::poll(fds.data(), fds.size(), timeout) < 0) {
+            if (errno == EINTR) continue;
+            coord_net::fail("poll");
+        }
+        if (fds[0].revents) return;
+        if (fds[1].revents & POLLIN) accept_all();
+        // New connections were appended past the polled ones; walk backwards
+        // so drop() does not disturb the indexes still to visit.
+        for (size_t i = fds.size() - 2; i-- > 0;) {
+            Conn& c = *conns_[i];
+            short ev = fds[i + 2].revents;
+            bool ok = true;
+            if (ev & (POLLIN | POLLHUP | POLLERR)) ok = read_from(c);
+            if (ok && !c.out.empty()) ok = flush(c);
+            if (!ok || (c.closing && c.out.empty())) drop(i);
+        }
+    }
+}
+
+void CoordServer::accept_all() {
+    for (;;) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // EAGAIN: drained. Anything else (EMFILE...) is retried next round.
+            return;
+        }
+        auto c = std::make_unique<Conn>();
+        c->fd = fd;
+        conns_.push_back(std::move(c));
+    }
+}
+
+bool CoordServer::read_from(Conn& c) {
+    uint8_t buf[64 * 1024];
+    for (;;) {
+        ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (c.closing) continue;
+        c.in.insert(c.in.end(), buf, buf + n);
+        try {
+            Frame f;
+            while (!c.closing && take_frame(c.in, f)) handle(c, f);
+        } catch (const std::exception& e) {
+            // Malformed input: say why, then hang up.
+            std::vector<uint8_t> msg = encode(ErrorMsg{e.what()});
+            c.out.insert(c.out.end(), msg.begin(), msg.end());
+            c.closing = true;
+        }
+    }
+}
+
+void CoordServer::handle(Conn& c, const Frame& f) {
+    std::vector<uint8_t> reply;
+    auto now = Coordinator::Clock::now();
+    if (c.worker == 0) {
+        HelloMsg hello;
+        decode(f, hello);
+        c.worker = next_worker_++;
+        c.name = hello.name;
+        WelcomeMsg w;
+        w.worker_id = c.worker;
+        w.start = coord_.start();
+        w.end = coord_.end();
+        w.unit_bits = coord_.config().unit_bits;
+        w.lease_ms = static_cast<uint32_t>(coord_.config().lease_time.count());
+        w.heartbeat_ms = static_cast<uint32_t>(config_.heartbeat.count());
+        w.endomorphism = config_.endomorphism;
+        reply = encode(w);
+    } else {
+        switch (f.type) {
+            case MsgType::LeaseRequest: {
+                LeaseRequestMsg m;
+                decode(f, m);
+                reply = encode(coord_.lease(c.worker, m.max_units, now));
+                break;
+            }
+            case MsgType::Heartbeat: {
+                HeartbeatMsg m;
+                decode(f, m);
+                reply = encode(HeartbeatAckMsg{coord_.heartbeat(m.lease_ids, now)});
+                break;
+            }
+            case MsgType::Complete: {
+                CompleteMsg m;
+                decode(f, m);
+                coord_.complete(m.lease_id, m.spans);
+                reply = encode_ack();
+                break;
+            }
+            case MsgType::Hits: {
+                HitsMsg m;
+                decode(f, m);
+                if (on_hit_) {
+                    for (const ScanHit& h : m.hits) on_hit_(h, c.name);
+                }
+                reply = encode_ack();
+                break;
+            }
+            default:
+                throw std::runtime_error("unexpected coordinator request");
+        }
+    }
+    c.out.insert(c.out.end(), reply.begin(), reply.end());
+}
+
+bool CoordServer::flush(Conn& c) {
+    size_t off = 0;
+    while (off < c.out.size()) {
+        ssize_t n = ::send(c.fd, c.out.data() + off, c.out.size() - off, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        off += static_cast<size_t>(n);
+    }
+    c.out.erase(c.out.begin(), c.out.begin() + off);
+    return true;
+}
+
+void CoordServer::drop(size_t i) {
+    Conn& c = *conns_[i];
+    if (c.worker != 0) coord_.release_worker(c.worker);
+    ::close(c.fd);
+    conns_.erase(conns_.begin() + i);
+}
+
+}  // namespace marauder
@@ -0,0 +1,149 @@
+#include "marauder/coordinator.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "marauder/partitioner.hpp"
+
+namespace marauder {
+
+Coordinator::Coordinator(const U256& start, const U256& end, const CoordinatorConfig& config, Checkpoint* checkpoint)
+    : start_(start), end_(end), config_(config), checkpoint_(checkpoint) {
+    if (config.max_lease_units == 0) throw std::invalid_argument("leases need at least one unit");
+    if (config.lease_time.count() <= 0) throw std::invalid_argument("lease time must be positive");
+    // The partitioner owns the unit arithmetic and its range checks.
+    units_ = RangePartitioner(start, end, 1, config.unit_bits).unit_count();
+    if (checkpoint) {
+        if (!(checkpoint->start() == start && checkpoint->end() == end) ||
+            checkpoint->unit_bits() != config.unit_bits) {
+            throw std::invalid_argument("checkpoint was opened for a different range or unit size");
+        }
+        done_ = checkpoint->resumed();
+    }
+    for (const UnitSpan& s : done_.gaps(units_)) pool_.insert(s);
+}
+
+LeaseMsg Coordinator::lease(uint64_t worker, uint32_t max_units, Clock::time_point now) {
+    LeaseMsg out;
+    if (finished()) {
+        out.status = LeaseStatus::Finished;
+        return out;
+    }
+    if (pool_.empty()) {
+        // Somebody holds the rest; ask again well before their lease could expire.
+        out.status = LeaseStatus::Wait;
+        out.retry_ms = static_cast<uint32_t>(std::clamp<int64_t>(config_.lease_time.count() / 8, 1, 5000));
+        return out;
+    }
+    out.status = LeaseStatus::Granted;
+    out.lease_id = next_lease_++;
+    out.spans = pool_.take(std::clamp<uint32_t>(max_units, 1, config_.max_lease_units));
+    leases_.emplace(out.lease_id, Lease{worker, out.spans, now + config_.lease_time});
+    // Their previous holders can no longer claim them.
+    for (auto it = retired_.begin(); it != retired_.end();) {
+        for (const UnitSpan& s : out.spans) it->second.erase(s);
+        it = it->second.empty() ? retired_.erase(it) : std::next(it);
+    }
+    return out;
+}
+
+std::vector<uint64_t> Coordinator::heartbeat(const std::vector<uint64_t>& lease_ids, Clock::time_point now) {
+    std::vector<uint64_t> lost;
+    for (uint64_t id : lease_ids) {
+        auto it = leases_.find(id);
+        if (it == leases_.end()) {
+            lost.push_back(id);
+        } else {
+            it->second.expires = now + config_.lease_time;
+        }
+    }
+    return lost;
+}
+
+void Coordinator::complete(uint64_t lease_id, const std::vector<UnitSpan>& spans) {
+    auto it = leases_.find(lease_id);
+    auto old = retired_.find(lease_id);
+    IntervalSet held;
+    if (it != leases_.end()) {
+        for (const UnitSpan& s : it->second.spans) held.insert(s);
+    } else if (old != retired_.end()) {
+        held = old->second;
+    }
+    IntervalSet accepted;
+    for (const UnitSpan& s : spans) {
+        UnitSpan c{s.lo, std::min(s.hi, units_)};
+        if (c.lo >= c.hi) continue;
+        // held intersected with c.
+        IntervalSet part;
+        part.insert(c);
+        for (const UnitSpan& g : held.gaps(c)) part.erase(g);
+        rejected_ += (c.hi - c.lo) - part.count();
+        for (const UnitSpan& a : part.spans()) {
+            accepted.insert(a);
+            done_.insert(a);
+            // A retired lease's units are back in the pool.
+            pool_.erase(a);
+            if (checkpoint_) checkpoint_->mark_done(a);
+        }
+    }
+    if (old != retired_.end()) {
+        for (const UnitSpan& a : accepted.spans()) old->second.erase(a);
+        if (old->second.empty()) retired_.erase(old);
+    }
+    if (it == leases_.end()) return;
+    // Units of the lease left out of spans go back to the pool.
+    for (const UnitSpan& s : it->second.spans) {
+        for (const UnitSpan& r : accepted.gaps(s)) return_units(r);
+    }
+    leases_.erase(it);
+}
+
+void Coordinator::retire(uint64_t id, const Lease& lease) {
+    IntervalSet& units = retired_[id];
+    for (const UnitSpan& s : lease.spans) {
+        for (const UnitSpan& r : done_.gaps(s)) units.insert(r);
+        return_units(s);
+    }
+    if (units.empty()) retired_.erase(id);
+}
+
+void Coordinator::return_units(const UnitSpan& s) {
+    // Units done through a duplicate lease stay done.
+    for (const UnitSpan& r : done_.gaps(s)) {
+        pool_.insert(r);
+        reassigned_ += r.hi - r.lo;
+    }
+}
+
+void Coordinator::release_worker(uint64_t worker) {
+    for (auto it = leases_.begin(); it != leases_.end();) {
+        if (it->second.worker == worker) {
+            retire(it->first, it->second);
+            it = leases_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+uint64_t Coordinator::expire(Clock::time_point now) {
+    uint64_t before = pool_.count();
+    for (auto it = leases_.begin(); it != leases_.end();) {
+        if (it->second.expires <= now) {
+            retire(it->first, it->second);
+            it = leases_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return pool_.count() - before;
+}
+
+Coordinator::Clock::time_point Coordinator::next_expiry() const {
+    Clock::time_point t = Clock::time_point::max();
+    for (const auto& [id, lease] : leases_) t = std::min(t, lease.expires);
+    return t;
+}
+
+}  // namespace marauder
@@ -0,0 +1,543 @@
+#include "marauder/dp_store.hpp"
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+
+#include "marauder/bloom.hpp"
+#include "marauder/mapped_file.hpp"
+
+namespace marauder {
+
+namespace {
+
+constexpr char kDpMagic[8] = {'M', 'R', 'D', 'R', 'D', 'P', 'S', 'T'};
+constexpr uint32_t kDpVersion = 1;
+constexpr uint8_t kEmpty = 0xFF;
+
+struct DpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bloom_bits;
+    uint64_t job;
+    uint64_t records;
+    uint64_t blocks;
+    uint64_t index_offset;
+    uint64_t bloom_offset;
+    uint64_t bloom_lines;
+};
+static_assert(sizeof(DpHeader) == 64, "the header is 64 bytes on disk");
+
+// First key and file offset of one block.
+struct DpIndexEntry {
+    uint64_t key_hi, key_lo, offset;
+};
+
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// The Bloom filter wants 20 uniform bytes; a DP's low x bits are zero by
+// definition, so the key is mixed rather than used as is.
+void bloom_digest(uint64_t hi, uint64_t lo, uint8_t out[20]) {
+    uint64_t a = mix64(hi ^ mix64(lo)), b = mix64(a ^ lo), c = mix64(b + hi);
+    std::memcpy(out, &a, 8);
+    std::memcpy(out + 8, &b, 8);
+    std::memcpy(out + 16, &c, 4);
+}
+
+bool same_key(const DpRecord& a, const DpRecord& b) { return a.key_hi == b.key_hi && a.key_lo == b.key_lo; }
+
+void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void write_or_throw(std::FILE* f, const void* p, size_t n, const std::string& path) {
+    if (n && std::fwrite(p, 1, n, f) != n) throw std::runtime_error("cannot write " + path);
+}
+
+// Writes one run: blocks as records arrive, then index, Bloom and header.
+class RunWriter {
+public:
+    RunWriter(const std::string& path, uint64_t job, unsigned bloom_bits, uint64_t max_records)
+        : path_(path), tmp_(path + ".tmp"), bloom_(static_cast<size_t>(max_records), bloom_bits) {
+        std::memset(&header_, 0, sizeof(header_));
+        std::memcpy(header_.magic, kDpMagic, sizeof(kDpMagic));
+        header_.version = kDpVersion;
+        header_.bloom_bits = bloom_bits;
+        header_.job = job;
+        f_ = std::fopen(tmp_.c_str(), "wb");
+        if (!f_) throw std::runtime_error("cannot open " + tmp_);
+        write_or_throw(f_, &header_, sizeof(header_), tmp_);
+    }
+
+    ~RunWriter() {
+        if (!f_) return;
+        std::fclose(f_);
+        std::remove(tmp_.c_str());
+    }
+
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+
+    // Records must arrive in strictly increasing key order.
+    void add(const DpRecord& r) {
+        if (block_count_ == kDpBlockRecords) flush_block();
+        if (block_count_ == 0) {
+            index_.push_back(DpIndexEntry{r.key_hi, r.key_lo, offset_});
+            put_u64(block_, r.key_hi);
+            put_u64(block_, r.key_lo);
+        } else if (r.key_hi == prev_.key_hi) {
+            put_varint(block_, 0);
+            put_varint(block_, r.key_lo - prev_.key_lo);
+        } else {
+            put_varint(block_, r.key_hi - prev_.key_hi);
+            put_u64(block_, r.key_lo);
+        }
+        unsigned len = (r.dist.bit_length() + 7) / 8;
+        block_.push_back(static_cast<uint8_t>(len << 1 | (r.kind & 1)));
+        for (unsigned i = 0; i < len; ++i) block_.push_back(static_cast<uint8_t>(r.dist.d[i / 8] >> (8 * (i % 8))));
+        uint8_t digest[20];
+        bloom_digest(r.key_hi, r.key_lo, digest);
+        bloom_.insert(digest);
+        prev_ = r;
+        ++block_count_;
+        ++header_.records;
+    }
+
+    void finish() {
+        flush_block();
+        static const uint8_t zeros[64] = {};
+        header_.blocks = index_.size();
+        header_.index_offset = (offset_ + 7) & ~uint64_t(7);
+        write_or_throw(f_, zeros, header_.index_offset - offset_, tmp_);
+        write_or_throw(f_, index_.data(), index_.size() * sizeof(DpIndexEntry), tmp_);
+        offset_ = header_.index_offset + index_.size() * sizeof(DpIndexEntry);
+        header_.bloom_offset = (offset_ + 63) & ~uint64_t(63);
+        header_.bloom_lines = bloom_.lines();
+        write_or_throw(f_, zeros, header_.bloom_offset - offset_, tmp_);
+        write_or_throw(f_, bloom_.data(), bloom_.size_bytes(), tmp_);
+        if (std::fseek(f_, 0, SEEK_SET) != 0) throw std::runtime_error("cannot seek " + tmp_);
+        write_or_throw(f_, &header_, sizeof(header_), tmp_);
+        // Spilled points are the whole value of a long run: make them durable.
+        if (std::fflush(f_) != 0 || ::fsync(fileno(f_)) != 0) throw std::runtime_error("cannot sync " + tmp_);
+        int rc = std::fclose(f_);
+        f_ = nullptr;
+        if (rc != 0) throw std::runtime_error("cannot write " + tmp_);
+        if (std::rename(tmp_.c_str(), path_.c_str()) != 0) throw std::runtime_error("cannot rename " + tmp_);
+    }
+
+private:
+    void flush_block() {
+        if (block_count_ == 0) return;
+        uint8_t count[4];
+        for (int i = 0; i < 4; ++i) count[i] = static_cast<uint8_t>(block_count_ >> (8 * i));
+        write_or_throw(f_, count, 4, tmp_);
+        write_or_throw(f_, block_.data(), block_.size(), tmp_);
+        offset_ += 4 + block_.size();
+        block_.clear();
+        block_count_ = 0;
+    }
+
+    std::string path_, tmp_;
+    std::FILE* f_ = nullptr;
+    DpHeader header_;
+    BloomFilter bloom_;
+    std::vector<DpIndexEntry> index_;
+    std::vector<uint8_t> block_;
+    uint32_t block_count_ = 0;
+    uint64_t offset_ = sizeof(DpHeader);
+    DpRecord prev_;
+};
+
+}  // namespace
+
+class DpRun {
+public:
+    explicit DpRun(const std::string& path) : path_(path), file_(path) {
+        if (file_.size() < sizeof(DpHeader)) corrupt();
+        std::memcpy(&h_, file_.data(), sizeof(h_));
+        if (std::memcmp(h_.magic, kDpMagic, sizeof(kDpMagic)) != 0) {
+            throw std::runtime_error(path + ": not a distinguished-point file");
+        }
+        if (h_.version != kDpVersion) throw std::runtime_error(path + ": unsupported distinguished-point file version");
+        const uint64_t size = file_.size();
+        if (h_.index_offset % 8 || h_.bloom_offset % 64 || h_.index_offset > size || h_.bloom_offset > size ||
+            h_.blocks > (size - h_.index_offset) / sizeof(DpIndexEntry) ||
+            h_.index_offset + h_.blocks * sizeof(DpIndexEntry) > h_.bloom_offset || h_.bloom_lines == 0 ||
+            h_.bloom_lines != (size - h_.bloom_offset) / sizeof(BloomLine) ||
+            h_.bloom_offset + h_.bloom_lines * sizeof(BloomLine) != size ||
+            h_.blocks != (h_.records + kDpBlockRecords - 1) / kDpBlockRecords) {
+            corrupt();
+        }
+        index_ = reinterpret_cast<const DpIndexEntry*>(file_.data() + h_.index_offset);
+        for (uint64_t b = 0; b < h_.blocks; ++b) {
+            if (index_[b].offset < sizeof(DpHeader) || index_[b].offset >= block_end(b)) corrupt();
+        }
+        bloom_ = BloomFilter::view(reinterpret_cast<const BloomLine*>(file_.data() + h_.bloom_offset),
+                                   static_cast<size_t>(h_.bloom_lines));
+    }
+
+    const std::string& path() const { return path_; }
+    uint64_t job() const { return h_.job; }
+    uint64_t records() const { return h_.records; }
+    uint64_t blocks() const { return h_.blocks; }
+    unsigned bloom_bits() const { return h_.bloom_bits; }
+
+    bool maybe_contains(const uint8_t digest[20]) const { return bloom_.maybe_contains(digest); }
+
+    // Block holding key (hi, lo) if it is in the run at all.
+    uint64_t block_for(uint64_t hi, uint64_t lo) const {
+        const DpIndexEntry* e = std::upper_bound(index_, index_ + h_.blocks, DpIndexEntry{hi, lo, 0},
+                                                 [](const DpIndexEntry& a, const DpIndexEntry& b) {
+                                                     return a.key_hi != b.key_hi ? a.key_hi < b.key_hi
+                                                                                 : a.key_lo < b.key_lo;
+                                                 });
+        return e == index_ ? h_.blocks : static_cast<uint64_t>(e - index_ - 1);
+    }
+
+    // Decodes records of one block in order.
+    class Reader {
+    public:
+        // one_block stops at the end of the first block instead of the run.
+        Reader(const DpRun& run, uint64_t block, bool one_block = false) : run_(run), one_block_(one_block) {
+            open(block);
+        }
+
+        bool next(DpRecord& r) {
+            while (left_ == 0) {
+                if (one_block_ || block_ + 1 >= run_.blocks()) return false;
+                open(block_ + 1);
+            }
+            if (first_) {
+                r.key_hi = u64();
+                r.key_lo = u64();
+                first_ = false;
+            } else {
+                uint64_t dhi = varint();
+                r.key_hi = prev_hi_ + dhi;
+                if (dhi != 0) {
+                    r.key_lo = u64();
+                } else {
+                    uint64_t dlo = varint();
+                    if (dlo == 0) run_.corrupt();
+                    r.key_lo = prev_lo_ + dlo;
+                }
+            }
+            uint8_t tag = byte();
+            unsigned len = tag >> 1;
+            if (len > 32) run_.corrupt();
+            r.kind = tag & 1;
+            r.dist = U256();
+            for (unsigned i = 0; i < len; ++i) r.dist.d[i / 8] |= uint64_t(byte()) << (8 * (i % 8));
+            prev_hi_ = r.key_hi;
+            prev_lo_ = r.key_lo;
+            --left_;
+            return true;
+        }
+
+    private:
+        void open(uint64_t block) {
+            block_ = block;
+            if (block >= run_.blocks()) return;
+            p_ = run_.file_.data() + run_.index_[block].offset;
+            end_ = run_.file_.data() + run_.block_end(block);
+            uint32_t n = 0;
+            for (int i = 0; i < 4; ++i) n |= uint32_t(byte()) << (8 * i);
+            if (n == 0 || n > kDpBlockRecords) run_.corrupt();
+            left_ = n;
+            first_ = true;
+        }
+
+        uint8_t byte() {
+            if (p_ >= end_) run_.corrupt();
+            return *p_++;
+        }
+
+        uint64_t u64() {
+            uint64_t v = 0;
+            for (int i = 0; i < 8; ++i) v |= uint64_t(byte()) << (8 * i);
+            return v;
+        }
+
+        uint64_t varint() {
+            uint64_t v = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                uint8_t b = byte();
+                v |= uint64_t(b & 0x7F) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            run_.corrupt();
+        }
+
+        const DpRun& run_;
+        const bool one_block_;
+        const uint8_t* p_ = nullptr;
+        const uint8_t* end_ = nullptr;
+        uint64_t block_ = 0;
+        uint32_t left_ = 0;
+        bool first_ = true;
+        uint64_t prev_hi_ = 0, prev_lo_ = 0;
+    };
+
+    bool find(const DpRecord& key, DpRecord& out) const {
+        uint64_t b = block_for(key.key_hi, key.key_lo);
+        if (b >= h_.blocks) return false;
+        Reader rd(*this, b, true);
+        while (rd.next(out)) {
+            if (same_key(out, key)) return true;
+            if (dp_key_less(key, out)) return false;
+        }
+        return false;
+    }
+
+    [[noreturn]] void corrupt() const {
+        throw std::runtime_error(path_ + ": truncated or corrupt distinguished-point file");
+    }
+
+private:
+    uint64_t block_end(uint64_t b) const { return b + 1 < h_.blocks ? index_[b + 1].offset : h_.index_offset; }
+
+    std::string path_;
+    MappedFile file_;
+    DpHeader h_;
+    const DpIndexEntry* index_ = nullptr;
+    BloomFilter bloom_;
+};
+
+namespace {
+
+// k-way merge source: a run or a sorted vector.
+struct Cursor {
+    Cursor(const DpRun* run, const std::vector<DpRecord>* vec) : vec(vec) {
+        if (run) reader = std::make_unique<DpRun::Reader>(*run, 0);
+        advance();
+    }
+
+    void advance() {
+        if (reader) {
+            valid = reader->next(cur);
+        } else {
+            valid = pos < vec->size();
+            if (valid) cur = (*vec)[pos++];
+        }
+    }
+
+    std::unique_ptr<DpRun::Reader> reader;
+    const std::vector<DpRecord>* vec;
+    size_t pos = 0;
+    DpRecord cur;
+    bool valid = false;
+};
+
+// Streams the sources into out in key order. A key in several sources is
+// written once, from the earliest source, and reported for every later one.
+uint64_t merge_into(std::vector<Cursor>& in, RunWriter& out, const DpCollisionFn& on_collision) {
+    auto later = [&in](size_t a, size_t b) {
+        const DpRecord &x = in[a].cur, &y = in[b].cur;
+        if (same_key(x, y)) return a > b;
+        return dp_key_less(y, x);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i].valid) heap.push(i);
+    }
+    uint64_t written = 0;
+    DpRecord kept;
+    bool any = false;
+    while (!heap.empty()) {
+        size_t i = heap.top();
+        heap.pop();
+        const DpRecord r = in[i].cur;
+        in[i].advance();
+        if (in[i].valid) {
+            if (!dp_key_less(r, in[i].cur)) throw std::runtime_error("distinguished-point file is not sorted");
+            heap.push(i);
+        }
+        if (any && same_key(r, kept)) {
+            if (on_collision) on_collision(kept, r);
+            continue;
+        }
+        out.add(r);
+        kept = r;
+        any = true;
+        ++written;
+    }
+    out.finish();
+    return written;
+}
+
+size_t capacity_for(size_t records) {
+    size_t cap = 1024;
+    while (cap / 4 * 3 < records) cap *= 2;
+    return cap;
+}
+
+}  // namespace
+
+DpStore::DpStore(const DpStoreConfig& config) : config_(config) {
+    if (config.memory_records == 0) throw std::invalid_argument("the DP store needs room for at least one point");
+    if (config.bloom_bits == 0) throw std::invalid_argument("the DP store needs at least one Bloom bit per point");
+    table_.assign(config.path.empty() ? capacity_for(0) : capacity_for(config.memory_records), DpRecord());
+    for (DpRecord& r : table_) r.kind = kEmpty;
+    if (config.path.empty()) return;
+
+    // Reopen "<base>.<n>.dp" next to config.path, oldest first.
+    size_t slash = config.path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : config.path.substr(0, slash + 1);
+    std::string base = (slash == std::string::npos ? config.path : config.path.substr(slash + 1)) + ".";
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) {
+        throw std::runtime_error("cannot open directory " + dir + ": " + std::strerror(errno));
+    }
+    std::vector<size_t> found;
+    while (dirent* e = ::readdir(d)) {
+        std::string name = e->d_name;
+        if (name.size() <= base.size() + 3 || name.compare(0, base.size(), base) != 0 ||
+            name.compare(name.size() - 3, 3, ".dp") != 0) {
+            continue;
+        }
+        std::string num = name.substr(base.size(), name.size() - base.size() - 3);
+        if (num.empty() || num.size() > 9 || num.find_first_not_of("0123456789") != std::string::npos) continue;
+        found.push_back(std::stoul(num));
+    }
+    ::closedir(d);
+    std::sort(found.begin(), found.end());
+    for (size_t n : found) {
+        auto run = std::make_unique<DpRun>(run_path(n));
+        if (run->job() != config.job) throw std::runtime_error(run->path() + ": distinguished points of another job");
+        on_disk_ += run->records();
+        runs_.push_back(std::move(run));
+        next_run_ = n + 1;
+    }
+}
+
+DpStore::~DpStore() = default;
+
+std::string DpStore::run_path(size_t n) const { return config_.path + "." + std::to_string(n) + ".dp"; }
+
+size_t DpStore::slot_of(uint64_t key_hi, uint64_t key_lo) const {
+    const size_t mask = table_.size() - 1;
+    // The high half of the key is untouched by the DP mask.
+    size_t i = static_cast<size_t>(key_hi) & mask;
+    while (table_[i].kind != kEmpty && !(table_[i].key_hi == key_hi && table_[i].key_lo == key_lo)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void DpStore::grow() {
+    std::vector<DpRecord> old(table_.size() * 2, DpRecord());
+    for (DpRecord& r : old) r.kind = kEmpty;
+    old.swap(table_);
+    for (const DpRecord& r : old) {
+        if (r.kind != kEmpty) table_[slot_of(r.key_hi, r.key_lo)] = r;
+    }
+}
+
+bool DpStore::insert(const DpRecord& r, DpRecord& prev) {
+    size_t slot = slot_of(r.key_hi, r.key_lo);
+    if (table_[slot].kind != kEmpty) {
+        prev = table_[slot];
+        return true;
+    }
+    if (!runs_.empty()) {
+        uint8_t digest[20];
+        bloom_digest(r.key_hi, r.key_lo, digest);
+        for (size_t i = runs_.size(); i-- > 0;) {
+            if (!runs_[i]->maybe_contains(digest)) continue;
+            ++disk_reads_;
+            if (runs_[i]->find(r, prev)) return true;
+        }
+    }
+    table_[slot] = r;
+    table_[slot].kind = r.kind & 1;
+    ++memory_count_;
+    if (config_.path.empty()) {
+        if (memory_count_ >= table_.size() / 4 * 3) grow();
+    } else if (memory_count_ >= config_.memory_records) {
+        spill();
+    }
+    return false;
+}
+
+std::vector<DpRecord> DpStore::sorted_memory() const {
+    std::vector<DpRecord> out;
+    out.reserve(memory_count_);
+    for (const DpRecord& r : table_) {
+        if (r.kind != kEmpty) out.push_back(r);
+    }
+    std::sort(out.begin(), out.end(), dp_key_less);
+    return out;
+}
+
+void DpStore::spill() {
+    if (config_.path.empty() || memory_count_ == 0) return;
+    std::vector<DpRecord> sorted = sorted_memory();
+    const std::string path = run_path(next_run_);
+    RunWriter w(path, config_.job, config_.bloom_bits, sorted.size());
+    for (const DpRecord& r : sorted) w.add(r);
+    w.finish();
+    ++next_run_;
+    runs_.push_back(std::make_unique<DpRun>(path));
+    on_disk_ += sorted.size();
+    for (DpRecord& r : table_) r.kind = kEmpty;
+    memory_count_ = 0;
+    if (runs_.size() > kMaxDpRuns) compact();
+}
+
+void DpStore::compact() {
+    std::vector<Cursor> in;
+    in.reserve(runs_.size());
+    for (const auto& run : runs_) in.emplace_back(run.get(), nullptr);
+    const std::string path = run_path(next_run_);
+    RunWriter w(path, config_.job, config_.bloom_bits, on_disk_);
+    on_disk_ = merge_into(in, w, nullptr);
+    in.clear();
+    ++next_run_;
+    // The merged run is in place before the old ones go; a crash in
+    // between leaves duplicates, which lookups and merges tolerate.
+    std::vector<std::unique_ptr<DpRun>> old;
+    old.swap(runs_);
+    runs_.push_back(std::make_unique<DpRun>(path));
+    for (const auto& run : old) std::remove(run->path().c_str());
+}
+
+void DpStore::write_work_file(const std::string& path) const {
+    std::vector<DpRecord> memory = sorted_memory();
+    std::vector<Cursor> in;
+    in.reserve(runs_.size() + 1);
+    for (const auto& run : runs_) in.emplace_back(run.get(), nullptr);
+    in.emplace_back(nullptr, &memory);
+    RunWriter w(path, config_.job, config_.bloom_bits, size());
+    merge_into(in, w, nullptr);
+}
+
+uint64_t DpStore::merge_work_files(const std::string& a, const std::string& b, const std::string& out,
+                                   const DpCollisionFn& on_collision) {
+    DpRun ra(a), rb(b);
+    if (ra.job() != rb.job()) throw std::runtime_error(a + " and " + b + " are distinguished points of different jobs");
+    std::vector<Cursor> in;
+    in.emplace_back(&ra, nullptr);
+    in.emplace_back(&rb, nullptr);
+    RunWriter w(out, ra.job(), ra.bloom_bits(), ra.records() + rb.records());
+    return merge_into(in, w, on_collision);
+}
+
+}  // namespace marauder
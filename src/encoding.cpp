@@ -0,0 +1,218 @@
+#include "marauder/encoding.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "marauder/hash.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+std::string bytes_to_hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(2 * len, '0');
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0xF];
+    }
+    return out;
+}
+
+void hex_to_bytes(const std::string& hex, uint8_t* out, size_t len) {
+    if (hex.size() != 2 * len) {
+        throw std::invalid_argument("expected " + std::to_string(2 * len) + " hex digits: '" + hex + "'");
+    }
+    for (size_t i = 0; i < 2 * len; ++i) {
+        char c = hex[i];
+        int v;
+        if (c >= '0' && c <= '9') {
+            v = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            v = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            v = c - 'A' + 10;
+        } else {
+            throw std::invalid_argument("invalid hex digit in '" + hex + "'");
+        }
+        if (i % 2 == 0) {
+            out[i / 2] = (uint8_t)(v << 4);
+        } else {
+            out[i / 2] |= (uint8_t)v;
+        }
+    }
+}
+
+namespace {
+
+// A Base58Check address is a version byte, 20 payload bytes and a 4-byte
+// checksum: 25 bytes, at most 35 digits.
+constexpr size_t kBase58Bytes = 25;
+constexpr size_t kBase58MaxDigits = 35;
+// 58^10 < 2^59: ten digits fold into one word before touching the limbs.
+constexpr unsigned kBase58Chunk = 10;
+
+struct Base58Table {
+    int8_t digit[256];
+    uint64_t pow[kBase58Chunk + 1];  // 58^i
+};
+
+constexpr Base58Table make_base58_table() {
+    Base58Table t{};
+    const char alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    for (int i = 0; i < 256; ++i) t.digit[i] = -1;
+    for (int i = 0; i < 58; ++i) t.digit[static_cast<uint8_t>(alphabet[i])] = static_cast<int8_t>(i);
+    t.pow[0] = 1;
+    for (unsigned i = 1; i <= kBase58Chunk; ++i) t.pow[i] = t.pow[i - 1] * 58;
+    return t;
+}
+
+constexpr Base58Table kBase58 = make_base58_table();
+
+// The value is accumulated in four 64-bit limbs, a chunk of up to ten
+// digits per multiply-add pass, instead of the textbook byte-at-a-time
+// long multiplication: about four passes of four limbs per address.
+AddressStatus decode_base58check(const char* text, size_t len, uint8_t out[20]) {
+    if (len == 0 || len > kBase58MaxDigits) return AddressStatus::Invalid;
+    size_t ones = 0;
+    while (ones < len && text[ones] == '1') ++ones;
+    uint64_t limb[4] = {0, 0, 0, 0};
+    for (size_t i = ones; i < len;) {
+        unsigned n = static_cast<unsigned>(len - i < kBase58Chunk ? len - i : kBase58Chunk);
+        uint64_t chunk = 0;
+        for (unsigned k = 0; k < n; ++k, ++i) {
+            int d = kBase58.digit[static_cast<uint8_t>(text[i])];
+            if (d < 0) return AddressStatus::Invalid;
+            chunk = chunk * 58 + static_cast<uint64_t>(d);
+        }
+        u128 carry = chunk;
+        for (uint64_t& l : limb) {
+            carry += static_cast<u128>(l) * kBase58.pow[n];
+            l = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        if (carry) return AddressStatus::Invalid;
+    }
+    if (limb[3] >> 8) return AddressStatus::Invalid;  // more than 25 bytes
+    uint8_t raw[kBase58Bytes];
+    for (size_t i = 0; i < kBase58Bytes; ++i) {
+        raw[kBase58Bytes - 1 - i] = static_cast<uint8_t>(limb[i / 8] >> (8 * (i % 8)));
+    }
+    // Each leading zero byte is spelled as exactly one leading '1'.
+    size_t zeros = 0;
+    while (zeros < kBase58Bytes && raw[zeros] == 0) ++zeros;
+    if (zeros != ones) return AddressStatus::Invalid;
+    uint8_t check[32];
+    sha256(raw, 21, check);
+    sha256(check, 32, check);
+    if (std::memcmp(check, raw + 21, 4) != 0) return AddressStatus::Invalid;
+    if (raw[0] != 0x00) return AddressStatus::Unsupported;
+    std::memcpy(out, raw + 1, 20);
+    return AddressStatus::Hash160;
+}
+
+constexpr size_t kBech32MaxLength = 90;
+constexpr uint32_t kBech32Const = 1;
+constexpr uint32_t kBech32mConst = 0x2bc830a3;
+
+struct Bech32Table {
+    int8_t value[256];
+};
+
+constexpr Bech32Table make_bech32_table() {
+    Bech32Table t{};
+    const char charset[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+    for (int i = 0; i < 256; ++i) t.value[i] = -1;
+    for (int i = 0; i < 32; ++i) {
+        t.value[static_cast<uint8_t>(charset[i])] = static_cast<int8_t>(i);
+        if (charset[i] >= 'a') t.value[static_cast<uint8_t>(charset[i] - 'a' + 'A')] = static_cast<int8_t>(i);
+    }
+    return t;
+}
+
+constexpr Bech32Table kBech32 = make_bech32_table();
+
+uint32_t bech32_polymod_step(uint32_t chk, uint32_t v) {
+    static const uint32_t gen[5] = {0x3b6a57b2, 0x26508e6d, 0x1ea119fa, 0x3d4233dd, 0x2a1462b3};
+    uint32_t b = chk >> 25;
+    chk = (chk & 0x1ffffff) << 5 ^ v;
+    for (int i = 0; i < 5; ++i) {
+        if (b >> i & 1) chk ^= gen[i];
+    }
+    return chk;
+}
+
+char lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// BIP 173 (witness v0) and BIP 350 (v1 and up, Bech32m).
+AddressStatus decode_segwit(const char* text, size_t len, uint8_t out[20]) {
+    if (len < 8 || len > kBech32MaxLength) return AddressStatus::Invalid;
+    bool has_lower = false, has_upper = false;
+    size_t sep = 0;
+    for (size_t i = 0; i < len; ++i) {
+        char c = text[i];
+        if (c < 33 || c > 126) return AddressStatus::Invalid;
+        has_lower |= c >= 'a' && c <= 'z';
+        has_upper |= c >= 'A' && c <= 'Z';
+        if (c == '1') sep = i;
+    }
+    if ((has_lower && has_upper) || sep == 0 || len - sep - 1 < 7) return AddressStatus::Invalid;
+
+    uint32_t chk = 1;
+    for (size_t i = 0; i < sep; ++i) chk = bech32_polymod_step(chk, static_cast<uint8_t>(lower(text[i])) >> 5);
+    chk = bech32_polymod_step(chk, 0);
+    for (size_t i = 0; i < sep; ++i) chk = bech32_polymod_step(chk, static_cast<uint8_t>(lower(text[i])) & 31);
+    const char* data = text + sep + 1;
+    const size_t ndata = len - sep - 1;
+    for (size_t i = 0; i < ndata; ++i) {
+        int v = kBech32.value[static_cast<uint8_t>(data[i])];
+        if (v < 0) return AddressStatus::Invalid;
+        chk = bech32_polymod_step(chk, static_cast<uint32_t>(v));
+    }
+    const unsigned version = static_cast<unsigned>(kBech32.value[static_cast<uint8_t>(data[0])]);
+    if (version > 16 || chk != (version == 0 ? kBech32Const : kBech32mConst)) return AddressStatus::Invalid;
+
+    // The program: 5-bit groups between the version and the checksum,
+    // repacked into bytes; leftover padding must be under 5 bits and zero.
+    uint8_t program[40];
+    size_t bytes = 0;
+    uint32_t acc = 0;
+    unsigned bits = 0;
+    for (size_t i = 1; i + 6 < ndata; ++i) {
+        acc = (acc << 5 | static_cast<uint32_t>(kBech32.value[static_cast<uint8_t>(data[i])])) & 0xFFF;
+        bits += 5;
+        if (bits >= 8) {
+            bits -= 8;
+            if (bytes == sizeof(program)) return AddressStatus::Invalid;
+            program[bytes++] = static_cast<uint8_t>(acc >> bits);
+        }
+    }
+    if (bits >= 5 || (acc & ((1u << bits) - 1)) != 0 || bytes < 2) return AddressStatus::Invalid;
+    if (version == 0 && bytes != 20 && bytes != 32) return AddressStatus::Invalid;
+
+    if (sep != 2 || lower(text[0]) != 'b' || lower(text[1]) != 'c') return AddressStatus::Unsupported;
+    if (version != 0 || bytes != 20) return AddressStatus::Unsupported;
+    std::memcpy(out, program, 20);
+    return AddressStatus::Hash160;
+}
+
+// Where a Bech32 human-readable part is recognised: mainnet, testnet and
+// regtest. Base58 version-0 addresses start with '1', so nothing overlaps.
+bool looks_segwit(const char* text, size_t len) {
+    auto prefix = [&](const char* p) {
+        size_t n = std::strlen(p);
+        if (len < n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (lower(text[i]) != p[i]) return false;
+        }
+        return true;
+    };
+    return prefix("bc1") || prefix("tb1") || prefix("bcrt1");
+}
+
+}  // namespace
+
+AddressStatus decode_address(const char* text, size_t len, uint8_t out[20]) {
+    return looks_segwit(text, len) ? decode_segwit(text, len, out) : decode_base58check(text, len, out);
+}
+
+}  // namespace marauder
@@ -0,0 +1,13 @@
+#include "marauder/endomorphism.hpp"
+
+namespace marauder {
+
+Scalar endo_candidate_key(const Scalar& k, unsigned v) {
+    Scalar r = k;
+    if (v / 2 == 1) scalar_mul(r, k, kEndoLambda);
+    if (v / 2 == 2) scalar_mul(r, k, kEndoLambda2);
+    if (v & 1) scalar_neg(r, r);
+    return r;
+}
+
+}  // namespace marauder
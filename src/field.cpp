@@ -0,0 +1,90 @@
+#include "marauder/field.hpp"
+
+namespace marauder {
+
+Fe Fe::from_u256(const U256& v) {
+    Fe r;
+    detail::fe_finish(r, v.d[0], v.d[1], v.d[2], v.d[3], 0);
+    return r;
+}
+
+bool Fe::from_be_bytes(Fe& r, const uint8_t in[32]) {
+    U256 v = U256::from_be_bytes(in);
+    if (v >= kFieldP.to_u256()) return false;
+    r = Fe{{v.d[0], v.d[1], v.d[2], v.d[3]}};
+    return true;
+}
+
+namespace {
+
+// Shared prefix of the inversion and square-root chains: the exponents
+// p - 2 and (p + 1) / 4 both start with a run of 223 one bits.
+struct ChainPrefix {
+    Fe x2, x3, x22, x223;
+};
+
+void chain_prefix(ChainPrefix& c, const Fe& a) {
+    Fe x6, x9, x11, x44, x88, x176, x220, t;
+
+    fe_sqr(t, a);
+    fe_mul(c.x2, t, a);
+    fe_sqr(t, c.x2);
+    fe_mul(c.x3, t, a);
+    fe_sqr_n(t, c.x3, 3);
+    fe_mul(x6, t, c.x3);
+    fe_sqr_n(t, x6, 3);
+    fe_mul(x9, t, c.x3);
+    fe_sqr_n(t, x9, 2);
+    fe_mul(x11, t, c.x2);
+    fe_sqr_n(t, x11, 11);
+    fe_mul(c.x22, t, x11);
+    fe_sqr_n(t, c.x22, 22);
+    fe_mul(x44, t, c.x22);
+    fe_sqr_n(t, x44, 44);
+    fe_mul(x88, t, x44);
+    fe_sqr_n(t, x88, 88);
+    fe_mul(x176, t, x88);
+    fe_sqr_n(t, x176, 44);
+    fe_mul(x220, t, x44);
+    fe_sqr_n(t, x220, 3);
+    fe_mul(c.x223, t, c.x3);
+}
+
+}  // namespace
+
+void fe_inv(Fe& r, const Fe& a) {
+    ChainPrefix c;
+    Fe t;
+    chain_prefix(c, a);
+
+    // p - 2 = [223 ones] 0 [22 ones] 0000 1 0 11 0 1
+    fe_sqr_n(t, c.x223, 23);
+    fe_mul(t, t, c.x22);
+    fe_sqr_n(t, t, 5);
+    fe_mul(t, t, a);
+    fe_sqr_n(t, t, 3);
+    fe_mul(t, t, c.x2);
+    fe_sqr_n(t, t, 2);
+    fe_mul(r, t, a);
+}
+
+bool fe_sqrt(Fe& r, const Fe& a) {
+    ChainPrefix c;
+    Fe t;
+    chain_prefix(c, a);
+
+    // (p + 1) / 4 = [223 ones] 0 [22 ones] 0000 11 00
+    fe_sqr_n(t, c.x223, 23);
+    fe_mul(t, t, c.x22);
+    fe_sqr_n(t, t, 6);
+    fe_mul(t, t, c.x2);
+    fe_sqr_n(t, t, 2);
+
+    Fe check;
+    fe_sqr(check, t);
+    if (check != a) return false;
+    r = t;
+    return true;
+}
+
+}  // namespace marauder
@@ -0,0 +1,39 @@
+#include "marauder/field_kernel.hpp"
+
+#include "field_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+std::vector<const FieldKernel*> detect() {
+    std::vector<const FieldKernel*> kernels{&kFieldGeneric};
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    const bool bmi2_adx = __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+    if (bmi2_adx) kernels.push_back(&kFieldBmi2Adx);
+    // The IFMA kernel falls back on the bmi2-adx code for its scalar lanes.
+    if (bmi2_adx && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma")) {
+        kernels.push_back(&kFieldIfma);
+    }
+#endif
+    return kernels;
+}
+
+}  // namespace
+
+const std::vector<const FieldKernel*>& field_available() {
+    static const std::vector<const FieldKernel*> kernels = detect();
+    return kernels;
+}
+
+const FieldKernel& field_best() { return *field_available().back(); }
+
+const FieldKernel* field_find(const std::string& name) {
+    for (const FieldKernel* k : field_available()) {
+        if (name == k->name) return k;
+    }
+    return nullptr;
+}
+
+}  // namespace marauder
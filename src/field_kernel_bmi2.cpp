@@ -0,0 +1,17 @@
+// Compiled for BMI2 and ADX: the generic bodies, with mulx products and
+// the flag-preserving carry chains available to the compiler.
+#define FIELD_TARGET __attribute__((target("bmi2,adx")))
+#include "field_kernel_impl.hpp"
+#include "field_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Bmi2Adx {};
+
+}  // namespace
+
+const FieldKernel kFieldBmi2Adx = {"bmi2-adx", field_impl::batch_inv<Bmi2Adx>, field_impl::add_batch<Bmi2Adx>};
+
+}  // namespace marauder
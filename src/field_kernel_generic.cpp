@@ -0,0 +1,15 @@
+#define FIELD_TARGET
+#include "field_kernel_impl.hpp"
+#include "field_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Generic {};
+
+}  // namespace
+
+const FieldKernel kFieldGeneric = {"generic", field_impl::batch_inv<Generic>, field_impl::add_batch<Generic>};
+
+}  // namespace marauder
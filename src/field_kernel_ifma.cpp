@@ -0,0 +1,278 @@
+// Eight lanes at a time with the AVX-512 IFMA 52-bit multiply-accumulate.
+//
+// Elements are held in radix 2^52, five limbs per lane. vpmadd52luq and
+// vpmadd52huq add the low and high halves of the 104-bit limb products
+// straight into 64-bit column sums, so a product is 50 multiply-adds with
+// no carry handling until the end. Between operations every limb is below
+// 2^52 (the multiplier ignores higher bits) and values are below 2^260;
+// results are reduced fully only when they are stored.
+//
+// Batch inversion runs eight interleaved prefix-product chains, one per
+// lane, so even the inversion itself is shared eight ways.
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#define FIELD_TARGET __attribute__((target("bmi2,adx,avx512f,avx512ifma")))
+#include "field_kernel_impl.hpp"
+#include "field_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Ifma {};
+
+static_assert(sizeof(Point) == 9 * sizeof(uint64_t) && sizeof(Fe) == 4 * sizeof(uint64_t),
+              "the gathers below assume packed Point and Fe layouts");
+
+constexpr uint64_t kMask52 = (uint64_t(1) << 52) - 1;
+constexpr uint64_t kMask48 = (uint64_t(1) << 48) - 1;
+// 2^260 mod p.
+constexpr uint64_t kR = kFieldC << 4;
+
+struct Limbs {
+    uint64_t v[5];
+};
+
+constexpr Limbs radix52(const Fe& a) {
+    return Limbs{{a.d[0] & kMask52, (a.d[0] >> 52 | a.d[1] << 12) & kMask52, (a.d[1] >> 40 | a.d[2] << 24) & kMask52,
+                  (a.d[2] >> 28 | a.d[3] << 36) & kMask52, a.d[3] >> 16}};
+}
+
+// 32p spread so that limbs 0..3 are at least 2^52 - 1 and limb 4 at least
+// 2^53 - 2: adding it before subtracting keeps every limb non-negative.
+constexpr Limbs sub_bias() {
+    Limbs p = radix52(kFieldP), q{};
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t v = p.v[i] * 32 + carry;
+        q.v[i] = v & kMask52;
+        carry = v >> 52;
+    }
+    q.v[4] = p.v[4] * 32 + carry;
+    const uint64_t b = uint64_t(1) << 52;
+    return Limbs{{q.v[0] + b, q.v[1] + b - 1, q.v[2] + b - 1, q.v[3] + b - 1, q.v[4] - 1}};
+}
+
+constexpr Limbs kBias = sub_bias();
+
+struct F8 {
+    __m512i l[5];
+};
+
+FIELD_TARGET inline __m512i mask52() { return _mm512_set1_epi64(static_cast<long long>(kMask52)); }
+
+FIELD_TARGET inline F8 broadcast(const Limbs& a) {
+    F8 r;
+    for (int k = 0; k < 5; ++k) r.l[k] = _mm512_set1_epi64(static_cast<long long>(a.v[k]));
+    return r;
+}
+
+// Lane i reads the element at base + idx[i] words.
+FIELD_TARGET inline F8 load(const uint64_t* base, __m512i idx) {
+    __m512i d[4];
+    for (int k = 0; k < 4; ++k) d[k] = _mm512_i64gather_epi64(idx, base + k, 8);
+    const __m512i m = mask52();
+    F8 r;
+    r.l[0] = _mm512_and_si512(d[0], m);
+    r.l[1] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(d[0], 52), _mm512_slli_epi64(d[1], 12)), m);
+    r.l[2] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(d[1], 40), _mm512_slli_epi64(d[2], 24)), m);
+    r.l[3] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(d[2], 28), _mm512_slli_epi64(d[3], 36)), m);
+    r.l[4] = _mm512_srli_epi64(d[3], 16);
+    return r;
+}
+
+FIELD_TARGET inline void carry(__m512i t[6]) {
+    const __m512i m = mask52();
+    for (int k = 0; k < 5; ++k) {
+        t[k + 1] = _mm512_add_epi64(t[k + 1], _mm512_srli_epi64(t[k], 52));
+        t[k] = _mm512_and_si512(t[k], m);
+    }
+}
+
+// Five limbs below 2^52 from column sums t[0..5] (t[5] included, every sum
+// well below 2^64 and the value below 2^262 or so).
+FIELD_TARGET inline F8 fold(__m512i t[6]) {
+    const __m512i R = _mm512_set1_epi64(static_cast<long long>(kR));
+    carry(t);
+    // t5 * 2^260 = t5 * R; t5 is small, so this leaves a value below
+    // 2^260 + 2^75.
+    t[0] = _mm512_madd52lo_epu64(t[0], t[5], R);
+    t[1] = _mm512_madd52hi_epu64(t[1], t[5], R);
+    t[5] = _mm512_setzero_si512();
+    carry(t);
+    // t5 is now 0 or 1, and a 1 leaves only t0 and t1 (small) below it.
+    t[0] = _mm512_madd52lo_epu64(t[0], t[5], R);
+    t[1] = _mm512_add_epi64(t[1], _mm512_srli_epi64(t[0], 52));
+    t[0] = _mm512_and_si512(t[0], mask52());
+    F8 r;
+    for (int k = 0; k < 5; ++k) r.l[k] = t[k];
+    return r;
+}
+
+FIELD_TARGET inline F8 mul(const F8& a, const F8& b) {
+    __m512i c[10];
+    for (__m512i& v : c) v = _mm512_setzero_si512();
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            c[i + j] = _mm512_madd52lo_epu64(c[i + j], a.l[i], b.l[j]);
+            c[i + j + 1] = _mm512_madd52hi_epu64(c[i + j + 1], a.l[i], b.l[j]);
+        }
+    }
+    const __m512i m = mask52();
+    for (int k = 0; k < 9; ++k) {
+        c[k + 1] = _mm512_add_epi64(c[k + 1], _mm512_srli_epi64(c[k], 52));
+        c[k] = _mm512_and_si512(c[k], m);
+    }
+    // Columns 5..9 weigh 2^260 * 2^(52(k-5)) = R * 2^(52(k-5)).
+    const __m512i R = _mm512_set1_epi64(static_cast<long long>(kR));
+    __m512i t[6] = {c[0], c[1], c[2], c[3], c[4], _mm512_setzero_si512()};
+    for (int k = 5; k < 10; ++k) {
+        t[k - 5] = _mm512_madd52lo_epu64(t[k - 5], c[k], R);
+        t[k - 4] = _mm512_madd52hi_epu64(t[k - 4], c[k], R);
+    }
+    return fold(t);
+}
+
+FIELD_TARGET inline F8 sqr_n(F8 a, int n) {
+    while (n-- > 0) a = mul(a, a);
+    return a;
+}
+
+FIELD_TARGET inline F8 sub(const F8& a, const F8& b) {
+    __m512i t[6];
+    for (int k = 0; k < 5; ++k) {
+        t[k] = _mm512_sub_epi64(_mm512_add_epi64(a.l[k], _mm512_set1_epi64(static_cast<long long>(kBias.v[k]))),
+                                b.l[k]);
+    }
+    t[5] = _mm512_setzero_si512();
+    return fold(t);
+}
+
+// The fe_inv addition chain, lane-wise.
+FIELD_TARGET F8 inv(const F8& a) {
+    F8 x2 = mul(sqr_n(a, 1), a);
+    F8 x3 = mul(sqr_n(x2, 1), a);
+    F8 x6 = mul(sqr_n(x3, 3), x3);
+    F8 x9 = mul(sqr_n(x6, 3), x3);
+    F8 x11 = mul(sqr_n(x9, 2), x2);
+    F8 x22 = mul(sqr_n(x11, 11), x11);
+    F8 x44 = mul(sqr_n(x22, 22), x22);
+    F8 x88 = mul(sqr_n(x44, 44), x44);
+    F8 x176 = mul(sqr_n(x88, 88), x88);
+    F8 x220 = mul(sqr_n(x176, 44), x44);
+    F8 x223 = mul(sqr_n(x220, 3), x3);
+    F8 t = mul(sqr_n(x223, 23), x22);
+    t = mul(sqr_n(t, 5), a);
+    t = mul(sqr_n(t, 3), x2);
+    return mul(sqr_n(t, 2), a);
+}
+
+// Fully reduces and writes the lanes in mask to base + idx[i] words.
+FIELD_TARGET inline void store(const F8& a, uint64_t* base, __m512i idx, __mmask8 lanes = 0xFF) {
+    const __m512i m = mask52();
+    const __m512i C = _mm512_set1_epi64(static_cast<long long>(kFieldC));
+    // Bits 256..259 times 2^256 = C: the value drops below 2^256 + 2^37.
+    __m512i t[5] = {a.l[0], a.l[1], a.l[2], a.l[3], a.l[4]};
+    __m512i h = _mm512_srli_epi64(t[4], 48);
+    t[4] = _mm512_and_si512(t[4], _mm512_set1_epi64(static_cast<long long>(kMask48)));
+    t[0] = _mm512_madd52lo_epu64(t[0], h, C);
+    for (int k = 0; k < 4; ++k) {
+        t[k + 1] = _mm512_add_epi64(t[k + 1], _mm512_srli_epi64(t[k], 52));
+        t[k] = _mm512_and_si512(t[k], m);
+    }
+    // x >= p exactly when x + C reaches 2^256; then x - p = x + C - 2^256.
+    __m512i w[5];
+    w[0] = _mm512_add_epi64(t[0], C);
+    for (int k = 0; k < 4; ++k) {
+        w[k + 1] = _mm512_add_epi64(t[k + 1], _mm512_srli_epi64(w[k], 52));
+        w[k] = _mm512_and_si512(w[k], m);
+    }
+    __mmask8 over = _mm512_test_epi64_mask(w[4], _mm512_set1_epi64(static_cast<long long>(uint64_t(1) << 48)));
+    w[4] = _mm512_and_si512(w[4], _mm512_set1_epi64(static_cast<long long>(kMask48)));
+    for (int k = 0; k < 5; ++k) t[k] = _mm512_mask_blend_epi64(over, t[k], w[k]);
+
+    __m512i d[4];
+    d[0] = _mm512_or_si512(t[0], _mm512_slli_epi64(t[1], 52));
+    d[1] = _mm512_or_si512(_mm512_srli_epi64(t[1], 12), _mm512_slli_epi64(t[2], 40));
+    d[2] = _mm512_or_si512(_mm512_srli_epi64(t[2], 24), _mm512_slli_epi64(t[3], 28));
+    d[3] = _mm512_or_si512(_mm512_srli_epi64(t[3], 36), _mm512_slli_epi64(t[4], 16));
+    for (int k = 0; k < 4; ++k) _mm512_mask_i64scatter_epi64(base + k, lanes, idx, d[k], 8);
+}
+
+FIELD_TARGET inline __mmask8 nonzero(const F8& a) {
+    __m512i any = _mm512_or_si512(_mm512_or_si512(a.l[0], a.l[1]), _mm512_or_si512(a.l[2], a.l[3]));
+    any = _mm512_or_si512(any, a.l[4]);
+    return _mm512_test_epi64_mask(any, any);
+}
+
+FIELD_TARGET __m512i fe_index() { return _mm512_set_epi64(28, 24, 20, 16, 12, 8, 4, 0); }
+FIELD_TARGET __m512i point_index() { return _mm512_set_epi64(63, 54, 45, 36, 27, 18, 9, 0); }
+
+FIELD_TARGET void batch_inv(Fe* elems, size_t n, Fe* scratch) {
+    const size_t groups = n / 8;
+    // Below a few groups the eight-lane inversion costs more than it saves.
+    if (groups < 4) {
+        field_impl::batch_inv<Ifma>(elems, n, scratch);
+        return;
+    }
+    // Group prefixes are stashed as raw vectors, five per group, in the
+    // scratch space (which is only 8-byte aligned).
+    static_assert(5 * sizeof(__m512i) <= 16 * sizeof(Fe), "a stashed group fits the scratch of its eight elements");
+    uint64_t* prefix = scratch[0].d;
+    const __m512i idx = fe_index();
+    F8 one = broadcast(Limbs{{1, 0, 0, 0, 0}});
+    F8 acc = one;
+    for (size_t g = 0; g < groups; ++g) {
+        for (int k = 0; k < 5; ++k) _mm512_storeu_si512(prefix + 8 * (5 * g + k), acc.l[k]);
+        F8 e = load(elems[8 * g].d, idx);
+        __mmask8 nz = nonzero(e);
+        for (int k = 0; k < 5; ++k) e.l[k] = _mm512_mask_blend_epi64(nz, one.l[k], e.l[k]);
+        acc = mul(acc, e);
+    }
+    acc = inv(acc);
+    for (size_t g = groups; g-- > 0;) {
+        F8 e = load(elems[8 * g].d, idx);
+        __mmask8 nz = nonzero(e);
+        for (int k = 0; k < 5; ++k) e.l[k] = _mm512_mask_blend_epi64(nz, one.l[k], e.l[k]);
+        F8 p;
+        for (int k = 0; k < 5; ++k) p.l[k] = _mm512_loadu_si512(prefix + 8 * (5 * g + k));
+        F8 r = mul(acc, p);
+        acc = mul(acc, e);
+        store(r, elems[8 * g].d, idx, nz);
+    }
+    field_impl::batch_inv<Ifma>(elems + 8 * groups, n - 8 * groups, scratch);
+}
+
+FIELD_TARGET void add_batch(Point* out, const Point& base, const Point* steps, const Fe* invs, size_t n,
+                            bool negate) {
+    size_t i = 0;
+    if (!base.infinity) {
+        const F8 bx = broadcast(radix52(base.x)), by = broadcast(radix52(base.y));
+        const F8 zero = broadcast(Limbs{});
+        const __m512i pidx = point_index(), fidx = fe_index();
+        for (; i + 8 <= n; i += 8) {
+            F8 sx = load(steps[i].x.d, pidx), sy = load(steps[i].y.d, pidx);
+            F8 iv = load(invs[i].d, fidx);
+            if (negate) sy = sub(zero, sy);
+            F8 lambda = mul(sub(sy, by), iv);
+            F8 x3 = sub(sub(mul(lambda, lambda), bx), sx);
+            F8 y3 = sub(mul(sub(bx, x3), lambda), by);
+            store(x3, out[i].x.d, pidx);
+            store(y3, out[i].y.d, pidx);
+            for (size_t j = i; j < i + 8; ++j) {
+                out[j].infinity = false;
+                if (invs[j].is_zero()) field_impl::add_batch<Ifma>(out + j, base, steps + j, invs + j, 1, negate);
+            }
+        }
+    }
+    field_impl::add_batch<Ifma>(out + i, base, steps + i, invs + i, n - i, negate);
+}
+
+}  // namespace
+
+const FieldKernel kFieldIfma = {"ifma", batch_inv, add_batch};
+
+}  // namespace marauder
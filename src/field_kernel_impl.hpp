@@ -0,0 +1,51 @@
+// Scalar field kernel bodies, instantiated once per ISA.
+//
+// Each ISA translation unit defines FIELD_TARGET (a target attribute, or
+// nothing) before including this header and instantiates the templates
+// with a type of its own, so the instantiations stay local to it. The
+// inline field.hpp arithmetic is inlined into them and compiled for that
+// ISA (the compiler emits mulx for the 64x64 products under BMI2), while
+// any out-of-line copies of those shared inline functions stay baseline.
+// That is why the field kernels use target attributes where the hash160
+// kernels use per-file -m flags: they share far more inline code.
+#pragma once
+
+#include <cstddef>
+
+#include "marauder/batch_inverse.hpp"
+#include "marauder/field.hpp"
+#include "marauder/point.hpp"
+
+namespace marauder {
+namespace field_impl {
+
+template <class Tag>
+FIELD_TARGET void batch_inv(Fe* elems, size_t n, Fe* scratch) {
+    if (n == 0) return;
+    Fe acc = Fe::one();
+    for (size_t i = 0; i < n; ++i) {
+        scratch[i] = acc;
+        if (!elems[i].is_zero()) fe_mul(acc, acc, elems[i]);
+    }
+    fe_inv(acc, acc);
+    for (size_t i = n; i-- > 0;) {
+        if (elems[i].is_zero()) continue;
+        Fe inv;
+        fe_mul(inv, acc, scratch[i]);
+        fe_mul(acc, acc, elems[i]);
+        elems[i] = inv;
+    }
+}
+
+template <class Tag>
+FIELD_TARGET void add_batch(Point* out, const Point& base, const Point* steps, const Fe* inv, size_t n,
+                            bool negate) {
+    for (size_t i = 0; i < n; ++i) {
+        Fe sy = steps[i].y;
+        if (negate) fe_neg(sy, sy);
+        point_add_inv(out[i], base, steps[i].x, sy, inv[i]);
+    }
+}
+
+}  // namespace field_impl
+}  // namespace marauder
@@ -0,0 +1,14 @@
+// Per-ISA field kernel tables, defined in their own translation units.
+#pragma once
+
+#include "marauder/field_kernel.hpp"
+
+namespace marauder {
+
+extern const FieldKernel kFieldGeneric;
+#if defined(__x86_64__)
+extern const FieldKernel kFieldBmi2Adx;
+extern const FieldKernel kFieldIfma;
+#endif
+
+}  // namespace marauder
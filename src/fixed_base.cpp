@@ -0,0 +1,54 @@
+#include "marauder/fixed_base.hpp"
+
+#include "marauder/batch_inverse.hpp"
+
+namespace marauder {
+
+GTable::GTable() : points_(kGTableWindows * kGTableEntries) {
+    std::vector<JPoint> jac(kGTableEntries);
+    std::vector<Fe> scratch(2 * kGTableEntries);
+    Point base = kGenerator;
+    for (unsigned w = 0; w < kGTableWindows; ++w) {
+        JPoint acc = JPoint::from_affine(base);
+        for (unsigned j = 0; j < kGTableEntries; ++j) {
+            jac[j] = acc;
+            jpoint_add_affine(acc, acc, base);
+        }
+        Point* row = &points_[w * kGTableEntries];
+        jpoint_batch_to_affine(row, jac.data(), kGTableEntries, scratch.data());
+        // 256^(w+1) G = 2 * (128 * 256^w G).
+        point_double(base, row[kGTableEntries - 1]);
+    }
+}
+
+const GTable& GTable::get() {
+    static const GTable table;
+    return table;
+}
+
+Point GTable::mul(const Scalar& k) const {
+    const U256 e = k.to_u256();
+    JPoint acc = JPoint::at_infinity();
+    unsigned carry = 0;
+    for (unsigned w = 0; w < kGTableWindows; ++w) {
+        int d = static_cast<int>(carry);
+        if (w < 32) d += static_cast<int>((e.d[w / 8] >> (8 * (w % 8))) & 0xFF);
+        carry = d > static_cast<int>(kGTableEntries);
+        if (carry) d -= 256;
+        if (d == 0) continue;
+        if (d > 0) {
+            jpoint_add_affine(acc, acc, entry(w, static_cast<unsigned>(d)));
+        } else {
+            Point neg;
+            point_neg(neg, entry(w, static_cast<unsigned>(-d)));
+            jpoint_add_affine(acc, acc, neg);
+        }
+    }
+    Point r;
+    jpoint_to_affine(r, acc);
+    return r;
+}
+
+Point point_mul_g(const Scalar& k) { return GTable::get().mul(k); }
+
+}  // namespace marauder
@@ -0,0 +1,94 @@
+#include "marauder/gpu_backend.hpp"
+
+#include <dlfcn.h>
+
+#include <stdexcept>
+
+#include "marauder/bloom.hpp"
+
+namespace marauder {
+
+namespace {
+
+constexpr size_t kErrLen = 256;
+
+}  // namespace
+
+GpuDevice::~GpuDevice() { api_->close(ctx_); }
+
+std::string GpuDevice::name() const { return api_->device_name(ctx_); }
+
+uint64_t GpuDevice::preferred_keys() const { return api_->preferred_keys(ctx_); }
+
+void GpuDevice::set_bloom(const BloomFilter& bloom) {
+    char err[kErrLen] = "";
+    if (api_->set_bloom(ctx_, bloom.data(), bloom.lines(), err, sizeof(err)) != MARAUDER_GPU_OK) {
+        throw std::runtime_error(std::string("GPU Bloom upload failed: ") + err);
+    }
+}
+
+GpuDevice::Result GpuDevice::submit(const U256& start, uint64_t count) {
+    if (in_flight_ >= depth_) throw std::runtime_error("GPU pipeline is full");
+    char err[kErrLen] = "";
+    switch (api_->submit(ctx_, start.d, count, err, sizeof(err))) {
+        case MARAUDER_GPU_OK:
+            ++in_flight_;
+            return Result::Ok;
+        case MARAUDER_GPU_UNSUPPORTED:
+            return Result::Unsupported;
+        default:
+            throw std::runtime_error(std::string("GPU scan failed: ") + err);
+    }
+}
+
+GpuDevice::Result GpuDevice::collect(GpuHits& hits) {
+    if (in_flight_ == 0) throw std::runtime_error("no GPU scan in flight");
+    char err[kErrLen] = "";
+    uint32_t found = 0;
+    int rc = api_->collect(ctx_, hits_.get(), &found, err, sizeof(err));
+    --in_flight_;
+    hits = GpuHits{hits_.get(), rc == MARAUDER_GPU_OK ? found : 0};
+    switch (rc) {
+        case MARAUDER_GPU_OK: return Result::Ok;
+        case MARAUDER_GPU_HIT_OVERFLOW: return Result::Overflow;
+        default: throw std::runtime_error(std::string("GPU scan failed: ") + err);
+    }
+}
+
+GpuDevice::Result GpuDevice::scan(const U256& start, uint64_t count, GpuHits& hits) {
+    if (in_flight_ != 0) throw std::runtime_error("GPU scans still in flight");
+    Result r = submit(start, count);
+    if (r != Result::Ok) {
+        hits = GpuHits{};
+        return r;
+    }
+    return collect(hits);
+}
+
+std::unique_ptr<GpuBackend> GpuBackend::load(const std::string& path) {
+    void* handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) throw std::runtime_error("cannot load GPU plugin: " + std::string(::dlerror()));
+    auto entry = reinterpret_cast<MarauderGpuEntryFn>(::dlsym(handle, "marauder_gpu_plugin"));
+    const MarauderGpuApi* api = entry ? entry() : nullptr;
+    if (!api || api->abi_version != MARAUDER_GPU_ABI_VERSION) {
+        ::dlclose(handle);
+        throw std::runtime_error(path + ": not a marauder GPU plugin for ABI version " +
+                                 std::to_string(MARAUDER_GPU_ABI_VERSION));
+    }
+    return std::unique_ptr<GpuBackend>(new GpuBackend(handle, api));
+}
+
+GpuBackend::~GpuBackend() { ::dlclose(handle_); }
+
+std::unique_ptr<GpuDevice> GpuBackend::open(int device, bool endomorphism, unsigned depth) const {
+    if (depth == 0 || depth > kMaxGpuDepth) {
+        throw std::invalid_argument("GPU pipeline depth must be between 1 and " + std::to_string(kMaxGpuDepth));
+    }
+    MarauderGpuConfig config{endomorphism ? 1u : 0u, kGpuMaxHits, depth};
+    char err[kErrLen] = "";
+    void* ctx = api_->open(device, &config, err, sizeof(err));
+    if (!ctx) throw std::runtime_error("cannot open GPU device " + std::to_string(device) + ": " + err);
+    return std::unique_ptr<GpuDevice>(new GpuDevice(api_, ctx, depth));
+}
+
+}  // namespace marauder
@@ -0,0 +1,38 @@
+#include "marauder/hash160.hpp"
+
+#include "hash160_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+std::vector<const Hash160Kernel*> detect() {
+    std::vector<const Hash160Kernel*> kernels{&kHash160Scalar};
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(&kHash160Avx2);
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) kernels.push_back(&kHash160Avx512);
+#endif
+#if defined(__aarch64__)
+    kernels.push_back(&kHash160Neon);
+#endif
+    return kernels;
+}
+
+}  // namespace
+
+const std::vector<const Hash160Kernel*>& hash160_available() {
+    static const std::vector<const Hash160Kernel*> kernels = detect();
+    return kernels;
+}
+
+const Hash160Kernel& hash160_best() { return *hash160_available().back(); }
+
+const Hash160Kernel* hash160_find(const std::string& name) {
+    for (const Hash160Kernel* k : hash160_available()) {
+        if (name == k->name) return k;
+    }
+    return nullptr;
+}
+
+}  // namespace marauder
@@ -0,0 +1,51 @@
+// 8-lane AVX2 hash160 kernel. Built with -mavx2; only reached through the
+// runtime dispatch in hash160.cpp after a cpuid check.
+#include <immintrin.h>
+
+#include "hash160_impl.hpp"
+#include "hash160_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Avx2 : hash160_impl::BoolOps<Avx2> {
+    using T = __m256i;
+    static constexpr size_t kLanes = 8;
+
+    static T set1(uint32_t v) { return _mm256_set1_epi32((int)v); }
+    static T load(const uint32_t* p) { return _mm256_load_si256((const __m256i*)p); }
+    static void store(uint32_t* p, T v) { _mm256_store_si256((__m256i*)p, v); }
+    static T add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm256_xor_si256(a, b); }
+    static T and_(T a, T b) { return _mm256_and_si256(a, b); }
+    static T or_(T a, T b) { return _mm256_or_si256(a, b); }
+    static T andnot(T a, T b) { return _mm256_andnot_si256(a, b); }
+    template <int S>
+    static T shr(T a) { return _mm256_srli_epi32(a, S); }
+    template <int S>
+    static T rotl(T a) { return _mm256_or_si256(_mm256_slli_epi32(a, S), _mm256_srli_epi32(a, 32 - S)); }
+    static T bswap(T a) {
+        const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        return _mm256_shuffle_epi8(a, mask);
+    }
+};
+
+void compressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_compressed_lanes<Avx2>(in, out);
+}
+
+void uncompressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_uncompressed_lanes<Avx2>(in, out);
+}
+
+void both(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]) {
+    hash160_impl::hash160_both_lanes<Avx2>(in, compressed, uncompressed);
+}
+
+}  // namespace
+
+const Hash160Kernel kHash160Avx2 = {"avx2", 8, compressed, uncompressed, both};
+
+}  // namespace marauder
@@ -0,0 +1,64 @@
+// 16-lane AVX-512 hash160 kernel. Built with -mavx512f -mavx512bw; uses
+// native rotates and vpternlogd for the three-input boolean functions.
+#include <immintrin.h>
+
+#include "hash160_impl.hpp"
+#include "hash160_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Avx512 : hash160_impl::BoolOps<Avx512> {
+    using T = __m512i;
+    static constexpr size_t kLanes = 16;
+
+    static T set1(uint32_t v) { return _mm512_set1_epi32((int)v); }
+    static T load(const uint32_t* p) { return _mm512_load_si512((const void*)p); }
+    static void store(uint32_t* p, T v) { _mm512_store_si512((void*)p, v); }
+    static T add(T a, T b) { return _mm512_add_epi32(a, b); }
+    static T xor_(T a, T b) { return _mm512_xor_si512(a, b); }
+    static T and_(T a, T b) { return _mm512_and_si512(a, b); }
+    static T or_(T a, T b) { return _mm512_or_si512(a, b); }
+    static T andnot(T a, T b) { return _mm512_andnot_si512(a, b); }
+    template <int S>
+    static T shr(T a) { return _mm512_srli_epi32(a, S); }
+    template <int S>
+    static T rotl(T a) { return _mm512_rol_epi32(a, S); }
+    static T bswap(T a) {
+        const __m512i mask = _mm512_set_epi8(
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        return _mm512_shuffle_epi8(a, mask);
+    }
+
+    // vpternlogd truth tables, indexed by (a << 2) | (b << 1) | c.
+    template <class U>
+    static T xor3(U a, U b, U c) { return _mm512_ternarylogic_epi32(a, b, c, 0x96); }
+    template <class U>
+    static T ch(U x, U y, U z) { return _mm512_ternarylogic_epi32(x, y, z, 0xCA); }
+    template <class U>
+    static T maj(U a, U b, U c) { return _mm512_ternarylogic_epi32(a, b, c, 0xE8); }
+    template <class U>
+    static T ornot_xor(U x, U y, U z) { return _mm512_ternarylogic_epi32(x, y, z, 0x59); }
+    template <class U>
+    static T xor_ornot(U x, U y, U z) { return _mm512_ternarylogic_epi32(x, y, z, 0x2D); }
+};
+
+void compressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_compressed_lanes<Avx512>(in, out);
+}
+
+void uncompressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_uncompressed_lanes<Avx512>(in, out);
+}
+
+void both(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]) {
+    hash160_impl::hash160_both_lanes<Avx512>(in, compressed, uncompressed);
+}
+
+}  // namespace
+
+const Hash160Kernel kHash160Avx512 = {"avx512", 16, compressed, uncompressed, both};
+
+}  // namespace marauder
@@ -0,0 +1,330 @@
+// Lane-generic hash160 kernel bodies, instantiated once per ISA.
+//
+// Each ISA translation unit defines a vector type V with the primitives
+// below and instantiates hash160_compressed_lanes<V>,
+// hash160_uncompressed_lanes<V> and hash160_both_lanes<V>. The translation units are compiled with
+// their own target flags, so this header must only be included from them.
+//
+// V provides: T, kLanes, set1, load, store (kLanes words, 64-byte aligned),
+// add, xor_, and_, or_, andnot (~a & b), shr<S>, rotl<S>, bswap, plus the
+// boolean helpers from BoolOps (which wide ISAs may override).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "marauder/hash160.hpp"
+
+namespace marauder {
+namespace hash160_impl {
+
+// Three-input boolean functions of SHA-256 and RIPEMD-160 in terms of the
+// two-input primitives.
+template <class V>
+struct BoolOps {
+    template <class T>
+    static T xor3(T a, T b, T c) { return V::xor_(V::xor_(a, b), c); }
+    // x ? y : z
+    template <class T>
+    static T ch(T x, T y, T z) { return V::or_(V::and_(x, y), V::andnot(x, z)); }
+    template <class T>
+    static T maj(T a, T b, T c) { return V::or_(V::and_(a, b), V::and_(c, V::or_(a, b))); }
+    // (x | ~y) ^ z
+    template <class T>
+    static T ornot_xor(T x, T y, T z) { return V::xor_(V::or_(x, V::xor_(y, V::set1(0xFFFFFFFFu))), z); }
+    // x ^ (y | ~z)
+    template <class T>
+    static T xor_ornot(T x, T y, T z) { return V::xor_(x, V::or_(y, V::xor_(z, V::set1(0xFFFFFFFFu)))); }
+};
+
+constexpr uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+constexpr uint32_t kSha256Init[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+constexpr uint8_t kRmdR[80] = {0, 1, 2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 7,  4,  13, 1,
+                               10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,  3,  10, 14, 4,  9,  15, 8,  1,
+                               2,  7,  0,  6,  13, 11, 5,  12, 1,  9,  11, 10, 0,  8,  12, 4,  13, 3,  7,  15,
+                               14, 5,  6,  2,  4,  0,  5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+constexpr uint8_t kRmdRp[80] = {5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12, 6,  11, 3,  7,
+                                0,  13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,  15, 5,  1,  3,  7,  14, 6,  9,
+                                11, 8,  12, 2,  10, 0,  4,  13, 8,  6,  4,  1,  3,  11, 15, 0,  5,  12, 2,  13,
+                                9,  7,  10, 14, 12, 15, 10, 4,  1,  5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11};
+constexpr uint8_t kRmdS[80] = {11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,  7,  6,  8,  13,
+                               11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12, 11, 13, 6,  7,  14, 9,  13, 15,
+                               14, 8,  13, 6,  5,  12, 7,  5,  11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,
+                               8,  6,  5,  12, 9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+constexpr uint8_t kRmdSp[80] = {8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,  9,  13, 15, 7,
+                                12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11, 9,  7,  15, 11, 8,  6,  6,  14,
+                                12, 13, 5,  14, 13, 13, 7,  5,  15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,
+                                12, 5,  15, 8,  8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+constexpr uint32_t kRmdK[5] = {0x00000000, 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xA953FD4E};
+constexpr uint32_t kRmdKp[5] = {0x50A28BE6, 0x5C4DD124, 0x6D703EF3, 0x7A6D76E9, 0x00000000};
+constexpr uint32_t kRmdInit[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+template <class V>
+struct Lanes {
+    using T = typename V::T;
+
+    template <int S>
+    static T rotr(T x) { return V::template rotl<32 - S>(x); }
+
+    template <int N>
+    static void sha_round(T a, T b, T c, T& d, T e, T f, T g, T& h, const T w[16], int i) {
+        T s1 = V::xor3(rotr<6>(e), rotr<11>(e), rotr<25>(e));
+        T t1 = V::add(V::add(h, s1), V::add(V::ch(e, f, g), V::add(V::set1(kSha256K[i + N]), w[(i + N) & 15])));
+        T s0 = V::xor3(rotr<2>(a), rotr<13>(a), rotr<22>(a));
+        T t2 = V::add(s0, V::maj(a, b, c));
+        d = V::add(d, t1);
+        h = V::add(t1, t2);
+    }
+
+    static void sha_expand(T w[16], int i) {
+        for (int j = i; j < i + 8; ++j) {
+            T w15 = w[(j - 15) & 15], w2 = w[(j - 2) & 15];
+            T s0 = V::xor3(rotr<7>(w15), rotr<18>(w15), V::template shr<3>(w15));
+            T s1 = V::xor3(rotr<17>(w2), rotr<19>(w2), V::template shr<10>(w2));
+            w[j & 15] = V::add(V::add(w[j & 15], s0), V::add(w[(j - 7) & 15], s1));
+        }
+    }
+
+    // One SHA-256 compression: h += rounds(h, w). w is clobbered.
+    static void sha256_compress(T h[8], T w[16]) {
+        T s[8];
+        for (int i = 0; i < 8; ++i) s[i] = h[i];
+        for (int i = 0; i < 64; i += 8) {
+            if (i >= 16) sha_expand(w, i);
+            sha_round<0>(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], w, i);
+            sha_round<1>(s[7], s[0], s[1], s[2], s[3], s[4], s[5], s[6], w, i);
+            sha_round<2>(s[6], s[7], s[0], s[1], s[2], s[3], s[4], s[5], w, i);
+            sha_round<3>(s[5], s[6], s[7], s[0], s[1], s[2], s[3], s[4], w, i);
+            sha_round<4>(s[4], s[5], s[6], s[7], s[0], s[1], s[2], s[3], w, i);
+            sha_round<5>(s[3], s[4], s[5], s[6], s[7], s[0], s[1], s[2], w, i);
+            sha_round<6>(s[2], s[3], s[4], s[5], s[6], s[7], s[0], s[1], w, i);
+            sha_round<7>(s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[0], w, i);
+        }
+        for (int i = 0; i < 8; ++i) h[i] = V::add(h[i], s[i]);
+    }
+
+    template <int R>
+    static T rmd_f(T x, T y, T z) {
+        if constexpr (R == 0) return V::xor3(x, y, z);
+        if constexpr (R == 1) return V::ch(x, y, z);
+        if constexpr (R == 2) return V::ornot_xor(x, y, z);
+        if constexpr (R == 3) return V::ch(z, x, y);
+        if constexpr (R == 4) return V::xor_ornot(x, y, z);
+    }
+
+    // Step J of both RIPEMD-160 lines. The five working variables rotate
+    // roles every step; indexing by (role - J) mod 5 lets the compiler keep
+    // them in registers without moves.
+    template <int J>
+    static void rmd_step(T l[5], T r[5], const T x[16]) {
+        constexpr int round = J / 16;
+        constexpr int o = 5 - J % 5;
+        T& al = l[o % 5];
+        T& cl = l[(o + 2) % 5];
+        al = V::add(V::template rotl<kRmdS[J]>(V::add(V::add(al, rmd_f<round>(l[(o + 1) % 5], cl, l[(o + 3) % 5])),
+                                                      V::add(x[kRmdR[J]], V::set1(kRmdK[round])))),
+                    l[(o + 4) % 5]);
+        cl = V::template rotl<10>(cl);
+
+        T& ar = r[o % 5];
+        T& cr = r[(o + 2) % 5];
+        ar = V::add(V::template rotl<kRmdSp[J]>(
+                        V::add(V::add(ar, rmd_f<4 - round>(r[(o + 1) % 5], cr, r[(o + 3) % 5])),
+                               V::add(x[kRmdRp[J]], V::set1(kRmdKp[round])))),
+                    r[(o + 4) % 5]);
+        cr = V::template rotl<10>(cr);
+    }
+
+    template <size_t... J>
+    static void rmd_steps(T l[5], T r[5], const T x[16], std::index_sequence<J...>) {
+        (rmd_step<(int)J>(l, r, x), ...);
+    }
+
+    // RIPEMD-160 of the 32-byte SHA-256 digest held big-endian in sha[8].
+    static void ripemd160_of_sha(T out[5], const T sha[8]) {
+        T x[16];
+        for (int i = 0; i < 8; ++i) x[i] = V::bswap(sha[i]);
+        x[8] = V::set1(0x80);
+        for (int i = 9; i < 16; ++i) x[i] = V::set1(0);
+        x[14] = V::set1(256);
+
+        T l[5], r[5];
+        for (int i = 0; i < 5; ++i) l[i] = r[i] = V::set1(kRmdInit[i]);
+        rmd_steps(l, r, x, std::make_index_sequence<80>());
+        // 80 steps is a multiple of 5, so the roles are back where they began.
+        out[0] = V::add(V::add(V::set1(kRmdInit[1]), l[2]), r[3]);
+        out[1] = V::add(V::add(V::set1(kRmdInit[2]), l[3]), r[4]);
+        out[2] = V::add(V::add(V::set1(kRmdInit[3]), l[4]), r[0]);
+        out[3] = V::add(V::add(V::set1(kRmdInit[4]), l[0]), r[1]);
+        out[4] = V::add(V::add(V::set1(kRmdInit[0]), l[1]), r[2]);
+    }
+
+    static void sha256_init(T h[8]) {
+        for (int i = 0; i < 8; ++i) h[i] = V::set1(kSha256Init[i]);
+    }
+};
+
+// Big-endian message words of lead || X (X given as little-endian limbs):
+// w[0..7] and the high byte of w[8], whose low 24 bits are 'trail'. V is
+// unused; the template makes this, like everything here, a distinct
+// function per ISA translation unit instead of one inline definition the
+// linker would take from whichever ISA's build it saw first.
+template <class V>
+void stage_x_words(uint32_t* w, size_t stride, uint32_t lead, uint64_t l0, uint64_t l1, uint64_t l2, uint64_t l3,
+                   uint32_t trail) {
+    w[0 * stride] = lead << 24 | (uint32_t)(l3 >> 40);
+    w[1 * stride] = (uint32_t)(l3 >> 8);
+    w[2 * stride] = (uint32_t)(l3 << 24) | (uint32_t)(l2 >> 40);
+    w[3 * stride] = (uint32_t)(l2 >> 8);
+    w[4 * stride] = (uint32_t)(l2 << 24) | (uint32_t)(l1 >> 40);
+    w[5 * stride] = (uint32_t)(l1 >> 8);
+    w[6 * stride] = (uint32_t)(l1 << 24) | (uint32_t)(l0 >> 40);
+    w[7 * stride] = (uint32_t)(l0 >> 8);
+    w[8 * stride] = (uint32_t)(l0 << 24) | trail;
+}
+
+template <class V>
+void store_digests(const typename V::T h[5], uint8_t (*out)[20], size_t n) {
+    alignas(64) uint32_t words[5][V::kLanes];
+    for (int i = 0; i < 5; ++i) V::store(words[i], h[i]);
+    for (size_t lane = 0; lane < n; ++lane) {
+        for (int i = 0; i < 5; ++i) {
+            uint32_t v = words[i][lane];
+            out[lane][4 * i] = (uint8_t)v;
+            out[lane][4 * i + 1] = (uint8_t)(v >> 8);
+            out[lane][4 * i + 2] = (uint8_t)(v >> 16);
+            out[lane][4 * i + 3] = (uint8_t)(v >> 24);
+        }
+    }
+}
+
+// 33-byte 02/03 || x: one SHA-256 block.
+template <class V>
+void hash160_compressed_lanes(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    using T = typename V::T;
+    constexpr size_t L = V::kLanes;
+    alignas(64) uint32_t stage[9][L];
+    for (size_t base = 0; base < in.count; base += L) {
+        size_t n = in.count - base < L ? in.count - base : L;
+        for (size_t lane = 0; lane < L; ++lane) {
+            if (lane < n) {
+                size_t i = base + lane;
+                stage_x_words<V>(&stage[0][lane], L, 0x02u | in.y_odd[i], in.x[0][i], in.x[1][i], in.x[2][i],
+                                 in.x[3][i], 0x00800000u);
+            } else {
+                for (int k = 0; k < 9; ++k) stage[k][lane] = 0;
+            }
+        }
+        T w[16], h[8], rmd[5];
+        for (int k = 0; k < 9; ++k) w[k] = V::load(stage[k]);
+        for (int k = 9; k < 15; ++k) w[k] = V::set1(0);
+        w[15] = V::set1(33 * 8);
+        Lanes<V>::sha256_init(h);
+        Lanes<V>::sha256_compress(h, w);
+        Lanes<V>::ripemd160_of_sha(rmd, h);
+        store_digests<V>(rmd, out + base, n);
+    }
+}
+
+// 65-byte 04 || x || y: two SHA-256 blocks.
+template <class V>
+void hash160_uncompressed_lanes(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    using T = typename V::T;
+    constexpr size_t L = V::kLanes;
+    alignas(64) uint32_t stage[17][L];
+    for (size_t base = 0; base < in.count; base += L) {
+        size_t n = in.count - base < L ? in.count - base : L;
+        for (size_t lane = 0; lane < L; ++lane) {
+            if (lane < n) {
+                size_t i = base + lane;
+                uint64_t y0 = in.y[0][i], y1 = in.y[1][i], y2 = in.y[2][i], y3 = in.y[3][i];
+                stage_x_words<V>(&stage[0][lane], L, 0x04u, in.x[0][i], in.x[1][i], in.x[2][i], in.x[3][i],
+                                 (uint32_t)(y3 >> 40));
+                // Words 8..16 are y's bytes shifted by one, i.e. the same
+                // pattern with y's top byte folded into word 8 above.
+                uint32_t tmp[9];
+                stage_x_words<V>(tmp, 1, 0, y0, y1, y2, y3, 0x00800000u);
+                for (int k = 1; k < 9; ++k) stage[8 + k][lane] = tmp[k];
+            } else {
+                for (int k = 0; k < 17; ++k) stage[k][lane] = 0;
+            }
+        }
+        T w[16], h[8], rmd[5];
+        for (int k = 0; k < 16; ++k) w[k] = V::load(stage[k]);
+        Lanes<V>::sha256_init(h);
+        Lanes<V>::sha256_compress(h, w);
+        w[0] = V::load(stage[16]);
+        for (int k = 1; k < 15; ++k) w[k] = V::set1(0);
+        w[15] = V::set1(65 * 8);
+        Lanes<V>::sha256_compress(h, w);
+        Lanes<V>::ripemd160_of_sha(rmd, h);
+        store_digests<V>(rmd, out + base, n);
+    }
+}
+
+// Both encodings at once, for target lists that mix them. The 33- and
+// 65-byte messages agree in words 1..7, so x is staged once and the
+// compressed block takes its words 0 and 8 from the uncompressed ones.
+// Interleaving the two first blocks (and sharing their seven common sigma0
+// terms) measured no faster than running them one after the other.
+template <class V>
+void hash160_both_lanes(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]) {
+    using T = typename V::T;
+    constexpr size_t L = V::kLanes;
+    // Rows 0..16 are the uncompressed message, 17 and 18 the compressed
+    // words 0 and 8.
+    alignas(64) uint32_t stage[19][L];
+    for (size_t base = 0; base < in.count; base += L) {
+        size_t n = in.count - base < L ? in.count - base : L;
+        for (size_t lane = 0; lane < L; ++lane) {
+            if (lane < n) {
+                size_t i = base + lane;
+                uint64_t y0 = in.y[0][i], y1 = in.y[1][i], y2 = in.y[2][i], y3 = in.y[3][i];
+                stage_x_words<V>(&stage[0][lane], L, 0x04u, in.x[0][i], in.x[1][i], in.x[2][i], in.x[3][i],
+                                 (uint32_t)(y3 >> 40));
+                stage[17][lane] = (stage[0][lane] & 0x00FFFFFFu) | (0x02u | in.y_odd[i]) << 24;
+                stage[18][lane] = (stage[8][lane] & 0xFF000000u) | 0x00800000u;
+                uint32_t tmp[9];
+                stage_x_words<V>(tmp, 1, 0, y0, y1, y2, y3, 0x00800000u);
+                for (int k = 1; k < 9; ++k) stage[8 + k][lane] = tmp[k];
+            } else {
+                for (int k = 0; k < 19; ++k) stage[k][lane] = 0;
+            }
+        }
+        T w[16], h[8], rmd[5];
+        w[0] = V::load(stage[17]);
+        for (int k = 1; k < 8; ++k) w[k] = V::load(stage[k]);
+        w[8] = V::load(stage[18]);
+        for (int k = 9; k < 15; ++k) w[k] = V::set1(0);
+        w[15] = V::set1(33 * 8);
+        Lanes<V>::sha256_init(h);
+        Lanes<V>::sha256_compress(h, w);
+        Lanes<V>::ripemd160_of_sha(rmd, h);
+        store_digests<V>(rmd, compressed + base, n);
+
+        for (int k = 0; k < 16; ++k) w[k] = V::load(stage[k]);
+        Lanes<V>::sha256_init(h);
+        Lanes<V>::sha256_compress(h, w);
+        w[0] = V::load(stage[16]);
+        for (int k = 1; k < 15; ++k) w[k] = V::set1(0);
+        w[15] = V::set1(65 * 8);
+        Lanes<V>::sha256_compress(h, w);
+        Lanes<V>::ripemd160_of_sha(rmd, h);
+        store_digests<V>(rmd, uncompressed + base, n);
+    }
+}
+
+}  // namespace hash160_impl
+}  // namespace marauder
@@ -0,0 +1,17 @@
+// Per-ISA hash160 kernel tables, defined in their own translation units.
+#pragma once
+
+#include "marauder/hash160.hpp"
+
+namespace marauder {
+
+extern const Hash160Kernel kHash160Scalar;
+#if defined(__x86_64__)
+extern const Hash160Kernel kHash160Avx2;
+extern const Hash160Kernel kHash160Avx512;
+#endif
+#if defined(__aarch64__)
+extern const Hash160Kernel kHash160Neon;
+#endif
+
+}  // namespace marauder
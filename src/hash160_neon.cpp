@@ -0,0 +1,53 @@
+// 4-lane NEON hash160 kernel for AArch64, where NEON is always available.
+#include <arm_neon.h>
+
+#include "hash160_impl.hpp"
+#include "hash160_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Neon : hash160_impl::BoolOps<Neon> {
+    using T = uint32x4_t;
+    static constexpr size_t kLanes = 4;
+
+    static T set1(uint32_t v) { return vdupq_n_u32(v); }
+    static T load(const uint32_t* p) { return vld1q_u32(p); }
+    static void store(uint32_t* p, T v) { vst1q_u32(p, v); }
+    static T add(T a, T b) { return vaddq_u32(a, b); }
+    static T xor_(T a, T b) { return veorq_u32(a, b); }
+    static T and_(T a, T b) { return vandq_u32(a, b); }
+    static T or_(T a, T b) { return vorrq_u32(a, b); }
+    static T andnot(T a, T b) { return vbicq_u32(b, a); }
+    template <int S>
+    static T shr(T a) { return vshrq_n_u32(a, S); }
+    template <int S>
+    static T rotl(T a) { return vsliq_n_u32(vshrq_n_u32(a, 32 - S), a, S); }
+    static T bswap(T a) { return vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(a))); }
+
+    template <class U>
+    static T ch(U x, U y, U z) { return vbslq_u32(x, y, z); }
+    template <class U>
+    static T ornot_xor(U x, U y, U z) { return veorq_u32(vornq_u32(x, y), z); }
+    template <class U>
+    static T xor_ornot(U x, U y, U z) { return veorq_u32(x, vornq_u32(y, z)); }
+};
+
+void compressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_compressed_lanes<Neon>(in, out);
+}
+
+void uncompressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_uncompressed_lanes<Neon>(in, out);
+}
+
+void both(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]) {
+    hash160_impl::hash160_both_lanes<Neon>(in, compressed, uncompressed);
+}
+
+}  // namespace
+
+const Hash160Kernel kHash160Neon = {"neon", 4, compressed, uncompressed, both};
+
+}  // namespace marauder
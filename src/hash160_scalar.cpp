@@ -0,0 +1,44 @@
+// Portable one-lane hash160 kernel; the fallback on every target.
+#include "hash160_impl.hpp"
+#include "hash160_kernels.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Scalar32 : hash160_impl::BoolOps<Scalar32> {
+    using T = uint32_t;
+    static constexpr size_t kLanes = 1;
+
+    static T set1(uint32_t v) { return v; }
+    static T load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, T v) { *p = v; }
+    static T add(T a, T b) { return a + b; }
+    static T xor_(T a, T b) { return a ^ b; }
+    static T and_(T a, T b) { return a & b; }
+    static T or_(T a, T b) { return a | b; }
+    static T andnot(T a, T b) { return ~a & b; }
+    template <int S>
+    static T shr(T a) { return a >> S; }
+    template <int S>
+    static T rotl(T a) { return (a << S) | (a >> (32 - S)); }
+    static T bswap(T a) { return __builtin_bswap32(a); }
+};
+
+void compressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_compressed_lanes<Scalar32>(in, out);
+}
+
+void uncompressed(const PubkeyBatchView& in, uint8_t (*out)[20]) {
+    hash160_impl::hash160_uncompressed_lanes<Scalar32>(in, out);
+}
+
+void both(const PubkeyBatchView& in, uint8_t (*compressed)[20], uint8_t (*uncompressed)[20]) {
+    hash160_impl::hash160_both_lanes<Scalar32>(in, compressed, uncompressed);
+}
+
+}  // namespace
+
+const Hash160Kernel kHash160Scalar = {"scalar", 1, compressed, uncompressed, both};
+
+}  // namespace marauder
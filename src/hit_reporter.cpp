@@ -0,0 +1,111 @@
+#include "marauder/hit_reporter.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "marauder/hash.hpp"
+#include "marauder/point.hpp"
+#include "marauder/reference.hpp"
+
+namespace marauder {
+
+namespace {
+
+// How long the reporter sleeps when every ring is empty. Hits are rare, so
+// this bounds both its idle wakeups and the wait in flush().
+constexpr auto kIdleSleep = std::chrono::microseconds(200);
+
+}  // namespace
+
+HitReporter::HitReporter(unsigned producers, const TargetSet* targets, ScanHitFn on_hit,
+                         std::vector<WorkerMetrics*> live)
+    : targets_(targets), on_hit_(std::move(on_hit)) {
+    for (unsigned w = 0; w < producers; ++w) {
+        rings_.push_back(std::make_unique<Ring>());
+        if (w < live.size()) rings_.back()->live = live[w];
+    }
+    thread_ = std::thread([this] { loop(); });
+}
+
+HitReporter::~HitReporter() {
+    done_.store(true, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+}
+
+bool HitReporter::push(unsigned w, const ScanHit& candidate) {
+    SpscRing<ScanHit, kHitRingCapacity>& ring = rings_[w]->ring;
+    if (failed()) return false;
+    while (!ring.try_push(candidate)) {
+        if (failed()) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool HitReporter::flush(unsigned w) {
+    const SpscRing<ScanHit, kHitRingCapacity>& ring = rings_[w]->ring;
+    while (!ring.drained()) {
+        if (failed()) return false;
+        std::this_thread::yield();
+    }
+    return !failed();
+}
+
+void HitReporter::finish() {
+    done_.store(true, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+    if (error_) std::rethrow_exception(error_);
+}
+
+void HitReporter::handle(Ring& r, const ScanHit& candidate) {
+    ScanHit hit = candidate;
+    if (targets_) {
+        // Bloom false positives end here, before the expensive part.
+        if (!targets_->table().contains(hit.digest.data())) return;
+        Point p = reference_pubkey(hit.key);
+        serialize_compressed(p, hit.pubkey);
+        Hash160 digest;
+        if (hit.uncompressed) {
+            uint8_t full[65];
+            serialize_uncompressed(p, full);
+            hash160(full, sizeof(full), digest.data());
+        } else {
+            hash160(hit.pubkey, sizeof(hit.pubkey), digest.data());
+        }
+        if (digest != hit.digest) {
+            throw std::runtime_error("hit for key " + hit.key.to_hex() + " does not verify against the reference");
+        }
+    }
+    on_hit_(hit);
+    ++r.hits;
+    if (r.live) r.live->hits.add(1);
+}
+
+void HitReporter::loop() {
+    try {
+        for (;;) {
+            // Read before draining: whatever was pushed before done_ is seen.
+            const bool done = done_.load(std::memory_order_acquire);
+            bool any = false;
+            for (const std::unique_ptr<Ring>& r : rings_) {
+                // At most one ring's worth each, so a busy ring (report_all)
+                // cannot starve the others.
+                for (size_t i = 0; i < kHitRingCapacity; ++i) {
+                    const ScanHit* candidate = r->ring.front();
+                    if (!candidate) break;
+                    handle(*r, *candidate);
+                    r->ring.pop();
+                    any = true;
+                }
+            }
+            if (done) return;
+            if (!any) std::this_thread::sleep_for(kIdleSleep);
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+}  // namespace marauder
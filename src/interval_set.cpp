@@ -0,0 +1,90 @@
+#include "marauder/interval_set.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace marauder {
+
+void IntervalSet::insert(const UnitSpan& s) {
+    if (s.lo >= s.hi) return;
+    uint64_t lo = s.lo, hi = s.hi;
+    // First interval that could touch [lo, hi): the one starting at or
+    // before lo, if it reaches lo.
+    auto it = spans_.upper_bound(lo);
+    if (it != spans_.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= lo) it = prev;
+    }
+    while (it != spans_.end() && it->first <= hi) {
+        lo = std::min(lo, it->first);
+        hi = std::max(hi, it->second);
+        count_ -= it->second - it->first;
+        it = spans_.erase(it);
+    }
+    spans_.emplace(lo, hi);
+    count_ += hi - lo;
+}
+
+void IntervalSet::erase(const UnitSpan& s) {
+    if (s.lo >= s.hi) return;
+    auto it = spans_.upper_bound(s.lo);
+    if (it != spans_.begin() && std::prev(it)->second > s.lo) --it;
+    while (it != spans_.end() && it->first < s.hi) {
+        uint64_t lo = it->first, hi = it->second;
+        count_ -= hi - lo;
+        it = spans_.erase(it);
+        if (lo < s.lo) {
+            spans_.emplace(lo, s.lo);
+            count_ += s.lo - lo;
+        }
+        if (hi > s.hi) {
+            it = spans_.emplace(s.hi, hi).first;
+            count_ += hi - s.hi;
+            break;
+        }
+    }
+}
+
+std::vector<UnitSpan> IntervalSet::take(uint64_t max_units) {
+    std::vector<UnitSpan> out;
+    while (max_units > 0 && !spans_.empty()) {
+        auto it = spans_.begin();
+        uint64_t lo = it->first, hi = it->second;
+        uint64_t n = std::min(max_units, hi - lo);
+        out.push_back(UnitSpan{lo, lo + n});
+        spans_.erase(it);
+        if (lo + n < hi) spans_.emplace(lo + n, hi);
+        count_ -= n;
+        max_units -= n;
+    }
+    return out;
+}
+
+bool IntervalSet::contains(uint64_t unit) const {
+    auto it = spans_.upper_bound(unit);
+    if (it == spans_.begin()) return false;
+    return unit < std::prev(it)->second;
+}
+
+std::vector<UnitSpan> IntervalSet::spans() const {
+    std::vector<UnitSpan> out;
+    out.reserve(spans_.size());
+    for (const auto& [lo, hi] : spans_) out.push_back(UnitSpan{lo, hi});
+    return out;
+}
+
+std::vector<UnitSpan> IntervalSet::gaps(const UnitSpan& within) const {
+    std::vector<UnitSpan> out;
+    uint64_t at = within.lo;
+    auto it = spans_.upper_bound(at);
+    if (it != spans_.begin()) --it;
+    for (; it != spans_.end(); ++it) {
+        if (it->first >= within.hi) break;
+        if (it->first > at) out.push_back(UnitSpan{at, it->first});
+        at = std::max(at, it->second);
+    }
+    if (at < within.hi) out.push_back(UnitSpan{at, within.hi});
+    return out;
+}
+
+}  // namespace marauder
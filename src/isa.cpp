@@ -0,0 +1,60 @@
+#include "marauder/isa.hpp"
+
+#include <vector>
+
+#include "marauder/bloom_kernel.hpp"
+#include "marauder/field_kernel.hpp"
+#include "marauder/hash160.hpp"
+
+namespace marauder {
+
+namespace {
+
+std::string cpu_line() {
+    std::string s = "cpu:     ";
+#if defined(__x86_64__)
+    s += "x86_64";
+    __builtin_cpu_init();
+    struct Feature {
+        const char* name;
+        bool present;
+    };
+    const Feature features[] = {
+        {"avx2", __builtin_cpu_supports("avx2") != 0},
+        {"bmi2", __builtin_cpu_supports("bmi2") != 0},
+        {"adx", __builtin_cpu_supports("adx") != 0},
+        {"avx512f", __builtin_cpu_supports("avx512f") != 0},
+        {"avx512bw", __builtin_cpu_supports("avx512bw") != 0},
+        {"avx512ifma", __builtin_cpu_supports("avx512ifma") != 0},
+        {"sha", __builtin_cpu_supports("sha") != 0},
+    };
+    for (const Feature& f : features) {
+        if (f.present) s += std::string(" ") + f.name;
+    }
+#elif defined(__aarch64__)
+    s += "aarch64 neon";
+#else
+    s += "unknown";
+#endif
+    return s + "\n";
+}
+
+template <class Kernel>
+std::string kernel_line(const char* what, const Kernel& best, const std::vector<const Kernel*>& available) {
+    std::string s = std::string(what) + ":";
+    s.append(9 - s.size(), ' ');
+    s += best.name;
+    s += " (available:";
+    for (const Kernel* k : available) s += std::string(" ") + k->name;
+    return s + ")\n";
+}
+
+}  // namespace
+
+std::string isa_report() {
+    return cpu_line() + kernel_line("hash160", hash160_best(), hash160_available()) +
+           kernel_line("field", field_best(), field_available()) +
+           kernel_line("bloom", bloom_best(), bloom_available());
+}
+
+}  // namespace marauder
@@ -0,0 +1,295 @@
+#include "marauder/kangaroo.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "marauder/batch_inverse.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+namespace {
+
+constexpr unsigned kJumpCount = 64;  // jump index: low 6 bits of x
+constexpr unsigned kJumpIndexBits = 6;
+constexpr unsigned kMaxDpBits = 40;
+// Below this width a plain walk is as fast as setting up the herds.
+constexpr unsigned kWalkWidthBits = 20;
+
+struct Rng {
+    uint64_t s;
+    uint64_t next() {
+        // splitmix64
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+// Uniform in [0, bound), bound > 0.
+U256 random_below(Rng& rng, const U256& bound) {
+    unsigned bits = bound.bit_length();
+    for (;;) {
+        U256 v;
+        for (int i = 0; i < 4; ++i) v.d[i] = rng.next();
+        v = u256_shr(u256_shl(v, 256 - bits), 256 - bits);
+        if (v < bound) return v;
+    }
+}
+
+// Stored under the low 128 bits of x; a false match is checked against
+// pub before use.
+struct Found {
+    DpRecord dp;
+    size_t kangaroo;
+};
+
+struct Shared {
+    Point pub;
+    U256 start, end, half;  // half = width / 2: wild kangaroos start at pub - half * G + offset
+    Point jump[kJumpCount];
+    U256 jump_dist[kJumpCount];
+    unsigned dp_bits;
+    uint64_t max_jumps;
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> jumps{0};
+
+    std::mutex mutex;  // guards everything below
+    std::unique_ptr<DpStore> store;
+    uint64_t restarts = 0;
+    bool found = false;
+    U256 key;
+    std::exception_ptr error;
+};
+
+bool is_distinguished(const Fe& x, unsigned dp_bits) {
+    return ((x.d[0] >> kJumpIndexBits) & ((uint64_t(1) << dp_bits) - 1)) == 0;
+}
+
+// Tame: dist * G relative to start. Wild: pub + (dist - half) * G.
+void place(const Shared& sh, Rng& rng, bool wild, Point& pos, U256& dist) {
+    U256 width;
+    u256_sub(width, sh.end, sh.start);
+    dist = random_below(rng, width);
+    if (!wild) {
+        U256 k;
+        u256_add(k, sh.start, dist);
+        pos = point_mul_g(Scalar::from_u256(k));
+        return;
+    }
+    Scalar off;
+    scalar_sub(off, Scalar::from_u256(dist), Scalar::from_u256(sh.half));
+    point_add(pos, point_mul_g(off), sh.pub);
+}
+
+// With the lock held. Returns true if kangaroo f has to be restarted.
+bool record(Shared& sh, const Found& f) {
+    DpRecord prev;
+    if (!sh.store->insert(f.dp, prev)) return false;
+    if (prev.kind == f.dp.kind) return true;
+    U256 k;
+    if (!sh.found && kangaroo_key_from_collision(sh.pub, sh.start, sh.end, prev, f.dp, k)) {
+        sh.found = true;
+        sh.key = k;
+        sh.done.store(true, std::memory_order_relaxed);
+    }
+    // A 128-bit x collision that is not the same point; keep the old entry.
+    return false;
+}
+
+void run_herd(Shared& sh, unsigned thread, size_t herd, uint64_t seed) {
+    Rng rng{seed ^ (0xD1B54A32D192ED03ULL * (thread + 1))};
+    // Even kangaroos are tame, odd ones wild.
+    std::vector<Point> pos(herd);
+    std::vector<U256> dist(herd);
+    for (size_t j = 0; j < herd; ++j) place(sh, rng, j & 1, pos[j], dist[j]);
+    std::vector<Fe> dx(herd), scratch(herd);
+    std::vector<uint8_t> idx(herd);
+    std::vector<Found> found;
+    std::vector<size_t> restart;
+
+    while (!sh.done.load(std::memory_order_relaxed)) {
+        for (size_t j = 0; j < herd; ++j) {
+            idx[j] = static_cast<uint8_t>(pos[j].x.d[0] & (kJumpCount - 1));
+            fe_sub(dx[j], sh.jump[idx[j]].x, pos[j].x);
+        }
+        fe_batch_inv(dx.data(), herd, scratch.data());
+        for (size_t j = 0; j < herd; ++j) {
+            const Point& s = sh.jump[idx[j]];
+            point_add_inv(pos[j], pos[j], s.x, s.y, dx[j]);
+            u256_add(dist[j], dist[j], sh.jump_dist[idx[j]]);
+            // Only a kangaroo landing on -s_i * G gets here.
+            if (pos[j].infinity) {
+                restart.push_back(j);
+            } else if (is_distinguished(pos[j].x, sh.dp_bits)) {
+                found.push_back(Found{DpRecord{pos[j].x.d[1], pos[j].x.d[0], dist[j], uint8_t(j & 1)}, j});
+            }
+        }
+        if (!found.empty()) {
+            std::lock_guard<std::mutex> lock(sh.mutex);
+            for (const Found& f : found) {
+                if (record(sh, f)) restart.push_back(f.kangaroo);
+            }
+            sh.restarts += restart.size();
+        }
+        found.clear();
+        for (size_t j : restart) place(sh, rng, j & 1, pos[j], dist[j]);
+        restart.clear();
+        uint64_t total = sh.jumps.fetch_add(herd, std::memory_order_relaxed) + herd;
+        if (sh.max_jumps && total >= sh.max_jumps) sh.done.store(true, std::memory_order_relaxed);
+    }
+}
+
+// Names the search for its work files: everything a stored distance
+// depends on.
+uint64_t job_of(const Shared& sh) {
+    uint64_t h = 0x6B616E6761726F6FULL;
+    auto mix = [&h](uint64_t v) {
+        Rng r{h ^ v};
+        h = r.next();
+    };
+    for (const U256* v : {&sh.start, &sh.end}) {
+        for (uint64_t w : v->d) mix(w);
+    }
+    for (uint64_t w : sh.pub.x.d) mix(w);
+    for (uint64_t w : sh.pub.y.d) mix(w);
+    for (const U256& j : sh.jump_dist) {
+        for (uint64_t w : j.d) mix(w);
+    }
+    mix(sh.dp_bits);
+    return h;
+}
+
+double to_double(const U256& v) {
+    double r = 0;
+    for (int i = 3; i >= 0; --i) r = r * 18446744073709551616.0 + double(v.d[i]);
+    return r;
+}
+
+KangarooResult walk_small(const Point& pub, const U256& start, const U256& end) {
+    KangarooResult r;
+    RangeWalker walker(start, end);
+    Point p;
+    while (walker.next(p)) {
+        ++r.jumps;
+        if (p == pub) {
+            r.found = true;
+            r.key = walker.key();
+            break;
+        }
+    }
+    return r;
+}
+
+}  // namespace
+
+bool kangaroo_key_from_collision(const Point& pub, const U256& start, const U256& end, const DpRecord& a,
+                                 const DpRecord& b, U256& key) {
+    if (a.kind == b.kind) return false;
+    // tame: start + t; wild: k - half + w; so k = start + t - w + half.
+    const U256& t = a.kind ? b.dist : a.dist;
+    const U256& w = a.kind ? a.dist : b.dist;
+    U256 width;
+    u256_sub(width, end, start);
+    u256_add(key, start, t);
+    u256_sub(key, key, w);
+    u256_add(key, key, u256_shr(width, 1));
+    return key >= start && key < end && point_mul_g(Scalar::from_u256(key)) == pub;
+}
+
+KangarooResult kangaroo_solve(const Point& pub, const U256& start, const U256& end, const KangarooConfig& config) {
+    if (start.is_zero() || start >= end || end > kOrderN) {
+        throw std::invalid_argument("kangaroo range must satisfy 1 <= start < end <= n");
+    }
+    if (pub.infinity || !point_on_curve(pub)) throw std::invalid_argument("public key is not on the curve");
+    if (config.threads == 0 || config.herd == 0) throw std::invalid_argument("need at least one kangaroo");
+    if (config.dp_bits > kMaxDpBits) {
+        throw std::invalid_argument("distinguished-point bits must be at most " + std::to_string(kMaxDpBits));
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    U256 width;
+    u256_sub(width, end, start);
+    const unsigned width_bits = width.bit_length();
+    if (width_bits <= kWalkWidthBits) {
+        KangarooResult r = walk_small(pub, start, end);
+        r.expected_jumps = to_double(width) / 2;
+        r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return r;
+    }
+
+    Shared sh;
+    sh.pub = pub;
+    sh.start = start;
+    sh.end = end;
+    sh.half = u256_shr(width, 1);
+    sh.max_jumps = config.max_jumps;
+
+    // With N kangaroos a mean jump of N * sqrt(width) / 8 measured best
+    // (about 2 * sqrt(width) hops on average; the textbook N * sqrt / 4
+    // needed 1.5x that with random starts). DPs should be rare enough that
+    // the ~2^dp_bits hops every kangaroo makes past the meeting point stay
+    // a small part of the work.
+    const double kangaroos = double(config.threads) * double(config.herd);
+    const int sqrt_bits = static_cast<int>((width_bits + 1) / 2);
+    const int herd_bits = static_cast<int>(std::log2(kangaroos));
+    sh.dp_bits = config.dp_bits ? config.dp_bits
+                                : static_cast<unsigned>(std::clamp(sqrt_bits - herd_bits - 3, 0, int(kMaxDpBits)));
+    const unsigned mean_bits =
+        config.jump_bits ? config.jump_bits
+                         : static_cast<unsigned>(std::clamp(sqrt_bits + herd_bits - 3, 1, int(width_bits) - 1));
+    if (mean_bits >= width_bits) throw std::invalid_argument("jump bits must be below the range width in bits");
+    Rng rng{config.seed};
+    for (unsigned i = 0; i < kJumpCount; ++i) {
+        // Uniform in [1, 2 * mean].
+        u256_add_u64(sh.jump_dist[i], random_below(rng, u256_shl(U256::from_u64(1), mean_bits + 1)), 1);
+        sh.jump[i] = point_mul_g(Scalar::from_u256(sh.jump_dist[i]));
+    }
+    DpStoreConfig store;
+    store.path = config.work_file;
+    store.memory_records = config.dp_memory;
+    store.job = job_of(sh);
+    sh.store = std::make_unique<DpStore>(store);
+    const uint64_t start_seed = config.start_seed ? config.start_seed : config.seed;
+
+    std::vector<std::thread> threads;
+    threads.reserve(config.threads);
+    for (unsigned t = 0; t < config.threads; ++t) {
+        threads.emplace_back([&sh, &config, start_seed, t] {
+            try {
+                run_herd(sh, t, config.herd, start_seed);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(sh.mutex);
+                if (!sh.error) sh.error = std::current_exception();
+                sh.done.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    if (sh.error) std::rethrow_exception(sh.error);
+    sh.store->spill();
+
+    KangarooResult r;
+    r.found = sh.found;
+    r.key = sh.key;
+    r.jumps = sh.jumps.load();
+    r.dps = sh.store->size();
+    r.restarts = sh.restarts;
+    r.dp_bits = sh.dp_bits;
+    r.jump_bits = mean_bits;
+    r.expected_jumps = 2.0 * std::sqrt(to_double(width)) + kangaroos * std::ldexp(1.0, sh.dp_bits);
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+}  // namespace marauder
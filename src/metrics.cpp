@@ -0,0 +1,171 @@
+#include "marauder/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace marauder {
+
+namespace {
+
+std::string number(double v) {
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    if (std::isnan(v)) return "NaN";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+void header(std::string& out, const char* name, const char* type, const char* help) {
+    out += std::string("# HELP ") + name + " " + help + "\n";
+    out += std::string("# TYPE ") + name + " " + type + "\n";
+}
+
+void sample(std::string& out, const std::string& name, const std::string& labels, double v) {
+    out += name;
+    if (!labels.empty()) out += "{" + labels + "}";
+    out += " " + number(v) + "\n";
+}
+
+// Sums of several single-writer histograms, in exposition order.
+struct HistogramSum {
+    uint64_t buckets[kHistogramBuckets] = {};
+    uint64_t count = 0;
+    double sum = 0;
+
+    void add(const Histogram& h) {
+        for (size_t i = 0; i < kHistogramBuckets; ++i) buckets[i] += h.bucket(i);
+        count += h.count();
+        sum += h.sum();
+    }
+};
+
+// labels go first; le is appended to them.
+void histogram(std::string& out, const std::string& name, const std::string& labels, const HistogramSum& h) {
+    const std::string sep = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+        cumulative += h.buckets[i];
+        double le = i + 1 < kHistogramBuckets ? Histogram::bound(i) : INFINITY;
+        sample(out, name + "_bucket", labels + sep + "le=\"" + number(le) + "\"", static_cast<double>(cumulative));
+    }
+    sample(out, name + "_sum", labels, h.sum);
+    // Bucket counts are read one by one, so keep count consistent with +Inf.
+    sample(out, name + "_count", labels, static_cast<double>(cumulative));
+}
+
+}  // namespace
+
+void Histogram::observe(double seconds) {
+    size_t i = kHistogramBuckets - 1;
+    if (!(seconds > 0)) {
+        i = 0;
+    } else if (seconds <= bound(kHistogramBuckets - 2)) {
+        int e = static_cast<int>(std::ceil(std::log2(seconds)));
+        i = static_cast<size_t>(std::max(e, kHistogramMinExp) - kHistogramMinExp);
+    }
+    buckets_[i].add(1);
+    count_.add(1);
+    sum_ns_.add(seconds > 0 ? static_cast<uint64_t>(seconds * 1e9) : 0);
+}
+
+double Histogram::bound(size_t i) { return std::ldexp(1.0, kHistogramMinExp + static_cast<int>(i)); }
+
+WorkerMetrics& Metrics::worker(const std::string& name, const std::string& kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (WorkerMetrics& w : workers_) {
+        if (w.name == name) return w;
+    }
+    return workers_.emplace_back(name, kind);
+}
+
+uint64_t Metrics::add_gauge(const std::string& name, const std::string& help, const std::string& labels,
+                            std::function<double()> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = next_gauge_++;
+    gauges_.emplace(id, Gauge{name, help, labels, std::move(value)});
+    return id;
+}
+
+void Metrics::remove_gauge(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gauges_.erase(id);
+}
+
+std::string Metrics::render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    auto per_worker = [&](const char* name, const char* help, OwnedCounter WorkerMetrics::*counter) {
+        header(out, name, "counter", help);
+        for (const WorkerMetrics& w : workers_) {
+            sample(out, name, "worker=\"" + w.name + "\",kind=\"" + w.kind + "\"",
+                   static_cast<double>((w.*counter).get()));
+        }
+    };
+    per_worker("marauder_keys_total", "Candidate keys hashed, endomorphism passes included.", &WorkerMetrics::keys);
+    per_worker("marauder_units_total", "Work units completed.", &WorkerMetrics::units);
+    per_worker("marauder_hits_total", "Candidates confirmed against the target table.", &WorkerMetrics::hits);
+    per_worker("marauder_bloom_lookups_total", "Candidates tested against the Bloom filter.",
+               &WorkerMetrics::bloom_lookups);
+    per_worker("marauder_bloom_positives_total", "Bloom filter positives passed on to the target table.",
+               &WorkerMetrics::bloom_positives);
+
+    if (kProfiling) {
+        auto per_stage = [&](const char* name, const char* help, OwnedCounter StageMetrics::*counter) {
+            header(out, name, "counter", help);
+            for (const WorkerMetrics& w : workers_) {
+                for (size_t s = 0; s < kScanStages; ++s) {
+                    sample(out, name,
+                           "worker=\"" + w.name + "\",kind=\"" + w.kind + "\",stage=\"" +
+                               scan_stage_name(static_cast<ScanStage>(s)) + "\"",
+                           static_cast<double>((w.stages[s].*counter).get()));
+                }
+            }
+        };
+        per_stage("marauder_stage_ticks_total", "Time stamp counter ticks spent in each scan stage.",
+                  &StageMetrics::ticks);
+        per_stage("marauder_stage_cycles_total", "Core cycles spent in each scan stage, from perf counters.",
+                  &StageMetrics::cycles);
+        per_stage("marauder_stage_instructions_total", "Instructions retired in each scan stage, from perf counters.",
+                  &StageMetrics::instructions);
+        per_stage("marauder_stage_llc_misses_total", "Last-level cache misses in each scan stage, from perf counters.",
+                  &StageMetrics::llc_misses);
+    }
+
+    uint64_t lookups = 0, positives = 0, hits = 0;
+    std::map<std::string, HistogramSum> by_kind;
+    for (const WorkerMetrics& w : workers_) {
+        lookups += w.bloom_lookups.get();
+        positives += w.bloom_positives.get();
+        hits += w.hits.get();
+        by_kind[w.kind].add(w.unit_seconds);
+    }
+    header(out, "marauder_bloom_false_positive_ratio", "gauge",
+           "Bloom positives that were not targets, per non-target lookup.");
+    uint64_t negatives = lookups - std::min(hits, lookups);
+    uint64_t false_pos = positives - std::min(hits, positives);
+    sample(out, "marauder_bloom_false_positive_ratio", "",
+           negatives ? static_cast<double>(false_pos) / static_cast<double>(negatives) : 0.0);
+
+    header(out, "marauder_unit_seconds", "histogram", "Wall time per completed work unit.");
+    for (const auto& [kind, h] : by_kind) histogram(out, "marauder_unit_seconds", "kind=\"" + kind + "\"", h);
+    header(out, "marauder_checkpoint_flush_seconds", "histogram", "Time to write and fsync one checkpoint.");
+    HistogramSum flush;
+    flush.add(checkpoint_flush_);
+    histogram(out, "marauder_checkpoint_flush_seconds", "", flush);
+
+    // Gauges grouped by name, one HELP and TYPE each.
+    std::vector<const Gauge*> gauges;
+    for (const auto& [id, g] : gauges_) gauges.push_back(&g);
+    std::stable_sort(gauges.begin(), gauges.end(), [](const Gauge* a, const Gauge* b) { return a->name < b->name; });
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        const Gauge& g = *gauges[i];
+        if (i == 0 || gauges[i - 1]->name != g.name) header(out, g.name.c_str(), "gauge", g.help.c_str());
+        sample(out, g.name, g.labels, g.value());
+    }
+    return out;
+}
+
+}  // namespace marauder
@@ -0,0 +1,99 @@
+#include "marauder/metrics_server.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "coord_net.hpp"
+
+namespace marauder {
+
+namespace {
+
+// Request line and headers; anything larger is not a scrape.
+constexpr size_t kMaxRequest = 8192;
+
+std::string response(const char* status, const char* type, const std::string& body) {
+    return std::string("HTTP/1.0 ") + status + "\r\nContent-Type: " + type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(const Metrics& metrics, const std::string& host, uint16_t port) : metrics_(metrics) {
+    listen_fd_ = coord_net::listen_tcp(host, port);
+    port_ = coord_net::local_port(listen_fd_);
+    if (::pipe2(wake_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        ::close(listen_fd_);
+        coord_net::fail("pipe");
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+MetricsServer::~MetricsServer() {
+    char b = 1;
+    [[maybe_unused]] ssize_t n = ::write(wake_[1], &b, 1);
+    thread_.join();
+    ::close(listen_fd_);
+    ::close(wake_[0]);
+    ::close(wake_[1]);
+}
+
+void MetricsServer::run() {
+    pollfd fds[2] = {{wake_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+    for (;;) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;  // nothing sensible to do on a monitoring thread
+        }
+        if (fds[0].revents) return;
+        if (!(fds[1].revents & POLLIN)) continue;
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        serve(fd);
+        ::close(fd);
+    }
+}
+
+void MetricsServer::serve(int fd) {
+    timeval timeout{2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    std::string req;
+    char buf[1024];
+    while (req.find("\r\n\r\n") == std::string::npos && req.find("\n\n") == std::string::npos) {
+        if (req.size() > kMaxRequest) return;
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        req.append(buf, static_cast<size_t>(n));
+    }
+
+    std::string out;
+    size_t sp1 = req.find(' '), sp2 = req.find(' ', sp1 + 1);
+    std::string method = req.substr(0, sp1);
+    std::string path = sp1 == std::string::npos ? "" : req.substr(sp1 + 1, sp2 - sp1 - 1);
+    path = path.substr(0, path.find('?'));
+    if (method != "GET" && method != "HEAD") {
+        out = response("405 Method Not Allowed", "text/plain", "only GET /metrics\n");
+    } else if (path != "/metrics") {
+        out = response("404 Not Found", "text/plain", "only GET /metrics\n");
+    } else {
+        out = response("200 OK", "text/plain; version=0.0.4", metrics_.render());
+        if (method == "HEAD") out.resize(out.find("\r\n\r\n") + 4);
+    }
+    try {
+        coord_net::send_all(fd, std::vector<uint8_t>(out.begin(), out.end()));
+    } catch (const std::exception&) {
+        // The scraper went away; the next one will connect afresh.
+    }
+}
+
+}  // namespace marauder
@@ -0,0 +1,133 @@
+#include "marauder/partitioner.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace marauder {
+
+struct RangePartitioner::Worker {
+    WorkDeque deque;
+    alignas(64) uint64_t rng;  // victim selection, touched by the owner only
+    unsigned node = 0;
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> remote_steals{0};
+};
+
+RangePartitioner::RangePartitioner(const U256& start, const U256& end, unsigned workers, unsigned unit_bits,
+                                   const IntervalSet* skip, const UnitOrder& order)
+    : start_(start), end_(end), unit_bits_(unit_bits), workers_(workers), order_(order, 0) {
+    if (start > end) throw std::invalid_argument("range start is past its end");
+    if (workers == 0) throw std::invalid_argument("need at least one worker");
+    if (unit_bits > 255) throw std::invalid_argument("unit bits must be below 256");
+    U256 width, units;
+    u256_sub(width, end, start);
+    units = u256_shr(width, unit_bits);
+    if (!(u256_shl(units, unit_bits) == width)) u256_add_u64(units, units, 1);
+    if (units.bit_length() > kMaxUnitCountBits) {
+        throw std::invalid_argument("range has more than 2^" + std::to_string(kMaxUnitCountBits) +
+                                    " work units; raise the unit size");
+    }
+    units_ = units.d[0];
+    order_ = UnitPermutation(order, units_);
+    const uint64_t positions = order_.size();
+    todo_ = skip ? skip->gaps(positions) : std::vector<UnitSpan>{UnitSpan{0, positions}};
+    pending_ = 0;
+    for (const UnitSpan& s : todo_) {
+        todo_first_.push_back(pending_);
+        pending_ += s.hi - s.lo;
+    }
+    unassigned_.store(pending_, std::memory_order_relaxed);
+
+    per_worker_.reset(new Worker[workers]);
+    for (unsigned w = 0; w < workers; ++w) {
+        per_worker_[w].rng = 0x9E3779B97F4A7C15ULL * (w + 1);
+        uint64_t lo = static_cast<uint64_t>(static_cast<u128>(pending_) * w / workers);
+        uint64_t hi = static_cast<uint64_t>(static_cast<u128>(pending_) * (w + 1) / workers);
+        if (lo < hi) per_worker_[w].deque.push(UnitSpan{lo, hi});
+    }
+}
+
+RangePartitioner::~RangePartitioner() = default;
+
+WorkUnit RangePartitioner::unit(uint64_t index) const {
+    WorkUnit u;
+    u.index = index;
+    u256_add(u.start, start_, u256_shl(U256::from_u64(index), unit_bits_));
+    U256 width;
+    u256_sub(width, end_, u.start);
+    if (width.bit_length() > unit_bits_) {
+        u256_add(u.end, u.start, u256_shl(U256::from_u64(1), unit_bits_));
+    } else {
+        u.end = end_;
+    }
+    return u;
+}
+
+uint64_t RangePartitioner::position_of_ordinal(uint64_t ordinal) const {
+    size_t i = std::upper_bound(todo_first_.begin(), todo_first_.end(), ordinal) - todo_first_.begin() - 1;
+    return todo_[i].lo + (ordinal - todo_first_[i]);
+}
+
+bool RangePartitioner::steal(unsigned w, UnitSpan& out) {
+    if (workers_ == 1) return false;
+    Worker& self = per_worker_[w];
+    // xorshift64: a random first victim keeps thieves from piling on worker 0.
+    self.rng ^= self.rng << 13;
+    self.rng ^= self.rng >> 7;
+    self.rng ^= self.rng << 17;
+    unsigned first = static_cast<unsigned>(self.rng % workers_);
+    // Own node first; without set_worker_nodes() every worker is on node 0.
+    for (bool remote : {false, true}) {
+        for (unsigned i = 0; i < workers_; ++i) {
+            unsigned v = (first + i) % workers_;
+            if (v == w || (per_worker_[v].node != self.node) != remote) continue;
+            if (per_worker_[v].deque.steal(out)) {
+                self.steals.fetch_add(1, std::memory_order_relaxed);
+                if (remote) self.remote_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RangePartitioner::set_worker_nodes(const std::vector<unsigned>& node) {
+    if (node.size() != workers_) throw std::invalid_argument("need one node per worker");
+    for (unsigned w = 0; w < workers_; ++w) per_worker_[w].node = node[w];
+}
+
+bool RangePartitioner::next(unsigned w, WorkUnit& out) {
+    Worker& self = per_worker_[w];
+    UnitSpan s;
+    for (;;) {
+        if (self.deque.pop(s) || steal(w, s)) break;
+        // Empty deques do not mean no work: a span may be between another
+        // worker's pop and the push of its halves.
+        if (unassigned_.load(std::memory_order_acquire) == 0) return false;
+        std::this_thread::yield();
+    }
+    while (s.hi - s.lo > 1) {
+        uint64_t mid = s.lo + (s.hi - s.lo) / 2;
+        self.deque.push(UnitSpan{mid, s.hi});
+        s.hi = mid;
+    }
+    unassigned_.fetch_sub(1, std::memory_order_acq_rel);
+    const uint64_t position = position_of_ordinal(s.lo);
+    out = unit(order_(position));
+    out.position = position;
+    return true;
+}
+
+uint64_t RangePartitioner::steals(unsigned w) const {
+    return per_worker_[w].steals.load(std::memory_order_relaxed);
+}
+
+uint64_t RangePartitioner::remote_steals(unsigned w) const {
+    return per_worker_[w].remote_steals.load(std::memory_order_relaxed);
+}
+
+size_t RangePartitioner::queued_spans(unsigned w) const { return per_worker_[w].deque.size(); }
+
+}  // namespace marauder
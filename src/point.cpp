@@ -0,0 +1,208 @@
+#include "marauder/point.hpp"
+
+namespace marauder {
+
+bool point_on_curve(const Point& p) {
+    if (p.infinity) return false;
+    Fe lhs, rhs;
+    fe_sqr(lhs, p.y);
+    fe_sqr(rhs, p.x);
+    fe_mul(rhs, rhs, p.x);
+    fe_add(rhs, rhs, Fe::from_u64(7));
+    return lhs == rhs;
+}
+
+void point_neg(Point& r, const Point& a) {
+    r.x = a.x;
+    fe_neg(r.y, a.y);
+    r.infinity = a.infinity;
+}
+
+void point_add(Point& r, const Point& a, const Point& b) {
+    if (a.infinity) {
+        r = b;
+        return;
+    }
+    if (b.infinity) {
+        r = a;
+        return;
+    }
+    if (a.x == b.x) {
+        if (a.y == b.y) {
+            point_double(r, a);
+        } else {
+            r = Point::at_infinity();
+        }
+        return;
+    }
+    Fe dx, dy, lambda, x3, y3;
+    fe_sub(dx, b.x, a.x);
+    fe_sub(dy, b.y, a.y);
+    fe_inv(dx, dx);
+    fe_mul(lambda, dy, dx);
+    fe_sqr(x3, lambda);
+    fe_sub(x3, x3, a.x);
+    fe_sub(x3, x3, b.x);
+    fe_sub(y3, a.x, x3);
+    fe_mul(y3, y3, lambda);
+    fe_sub(y3, y3, a.y);
+    r = Point{x3, y3, false};
+}
+
+void point_double(Point& r, const Point& a) {
+    if (a.infinity || a.y.is_zero()) {
+        r = Point::at_infinity();
+        return;
+    }
+    Fe num, den, lambda, x3, y3;
+    fe_sqr(num, a.x);
+    fe_mul_small(num, num, 3);
+    fe_add(den, a.y, a.y);
+    fe_inv(den, den);
+    fe_mul(lambda, num, den);
+    fe_sqr(x3, lambda);
+    fe_sub(x3, x3, a.x);
+    fe_sub(x3, x3, a.x);
+    fe_sub(y3, a.x, x3);
+    fe_mul(y3, y3, lambda);
+    fe_sub(y3, y3, a.y);
+    r = Point{x3, y3, false};
+}
+
+void jpoint_double(JPoint& r, const JPoint& a) {
+    if (a.infinity || a.y.is_zero()) {
+        r = JPoint::at_infinity();
+        return;
+    }
+    // dbl-2009-l for a = 0.
+    Fe A, B, C, D, E, F, t;
+    fe_sqr(A, a.x);
+    fe_sqr(B, a.y);
+    fe_sqr(C, B);
+    fe_add(t, a.x, B);
+    fe_sqr(t, t);
+    fe_sub(t, t, A);
+    fe_sub(t, t, C);
+    fe_add(D, t, t);
+    fe_mul_small(E, A, 3);
+    fe_sqr(F, E);
+
+    Fe x3, y3, z3;
+    fe_sub(x3, F, D);
+    fe_sub(x3, x3, D);
+    fe_sub(t, D, x3);
+    fe_mul(y3, E, t);
+    fe_mul_small(t, C, 8);
+    fe_sub(y3, y3, t);
+    fe_mul(z3, a.y, a.z);
+    fe_add(z3, z3, z3);
+    r = JPoint{x3, y3, z3, false};
+}
+
+void jpoint_add_affine(JPoint& r, const JPoint& a, const Point& b) {
+    if (b.infinity) {
+        r = a;
+        return;
+    }
+    if (a.infinity) {
+        r = JPoint::from_affine(b);
+        return;
+    }
+    // madd-2007-bl.
+    Fe z1z1, u2, s2, h, hh, i, j, rr, v, t;
+    fe_sqr(z1z1, a.z);
+    fe_mul(u2, b.x, z1z1);
+    fe_mul(s2, b.y, a.z);
+    fe_mul(s2, s2, z1z1);
+    fe_sub(h, u2, a.x);
+    fe_sub(rr, s2, a.y);
+    if (h.is_zero()) {
+        if (rr.is_zero()) {
+            jpoint_double(r, a);
+        } else {
+            r = JPoint::at_infinity();
+        }
+        return;
+    }
+    fe_sqr(hh, h);
+    fe_mul_small(i, hh, 4);
+    fe_mul(j, h, i);
+    fe_add(rr, rr, rr);
+    fe_mul(v, a.x, i);
+
+    Fe x3, y3, z3;
+    fe_sqr(x3, rr);
+    fe_sub(x3, x3, j);
+    fe_sub(x3, x3, v);
+    fe_sub(x3, x3, v);
+    fe_sub(t, v, x3);
+    fe_mul(y3, rr, t);
+    fe_mul(t, a.y, j);
+    fe_add(t, t, t);
+    fe_sub(y3, y3, t);
+    fe_add(z3, a.z, h);
+    fe_sqr(z3, z3);
+    fe_sub(z3, z3, z1z1);
+    fe_sub(z3, z3, hh);
+    r = JPoint{x3, y3, z3, false};
+}
+
+void jpoint_to_affine(Point& r, const JPoint& a) {
+    if (a.infinity) {
+        r = Point::at_infinity();
+        return;
+    }
+    Fe zi, zi2, zi3;
+    fe_inv(zi, a.z);
+    fe_sqr(zi2, zi);
+    fe_mul(zi3, zi2, zi);
+    fe_mul(r.x, a.x, zi2);
+    fe_mul(r.y, a.y, zi3);
+    r.infinity = false;
+}
+
+Point point_mul(const Scalar& k, const Point& p) {
+    JPoint acc = JPoint::at_infinity();
+    U256 e = k.to_u256();
+    for (int i = (int)e.bit_length() - 1; i >= 0; --i) {
+        jpoint_double(acc, acc);
+        if (e.bit((unsigned)i)) jpoint_add_affine(acc, acc, p);
+    }
+    Point r;
+    jpoint_to_affine(r, acc);
+    return r;
+}
+
+void serialize_compressed(const Point& p, uint8_t out[33]) {
+    out[0] = p.y.is_odd() ? 0x03 : 0x02;
+    p.x.to_be_bytes(out + 1);
+}
+
+void serialize_uncompressed(const Point& p, uint8_t out[65]) {
+    out[0] = 0x04;
+    p.x.to_be_bytes(out + 1);
+    p.y.to_be_bytes(out + 33);
+}
+
+bool parse_pubkey(Point& r, const uint8_t* in, size_t len) {
+    Point p;
+    p.infinity = false;
+    if (len == 33 && (in[0] == 0x02 || in[0] == 0x03)) {
+        if (!Fe::from_be_bytes(p.x, in + 1)) return false;
+        Fe rhs;
+        fe_sqr(rhs, p.x);
+        fe_mul(rhs, rhs, p.x);
+        fe_add(rhs, rhs, Fe::from_u64(7));
+        if (!fe_sqrt(p.y, rhs)) return false;
+        if (p.y.is_odd() != (in[0] == 0x03)) fe_neg(p.y, p.y);
+    } else if (len == 65 && in[0] == 0x04) {
+        if (!Fe::from_be_bytes(p.x, in + 1) || !Fe::from_be_bytes(p.y, in + 33)) return false;
+        if (!point_on_curve(p)) return false;
+    } else {
+        return false;
+    }
+    r = p;
+    return true;
+}
+
+}  // namespace marauder
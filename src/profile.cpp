@@ -0,0 +1,173 @@
+#include "marauder/profile.hpp"
+
+#include <cstdio>
+
+#include "stage_profiler.hpp"
+
+#ifdef MARAUDER_PROFILE
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace marauder {
+
+const char* scan_stage_name(ScanStage stage) {
+    switch (stage) {
+        case ScanStage::Walk:
+            return "walk";
+        case ScanStage::Endomorphism:
+            return "endomorphism";
+        case ScanStage::Hash:
+            return "hash";
+        case ScanStage::Bloom:
+            return "bloom";
+        case ScanStage::Report:
+            return "report";
+    }
+    return "?";
+}
+
+void ScanProfile::add(const ScanProfile& other) {
+    for (size_t s = 0; s < kScanStages; ++s) {
+        stages[s].ticks += other.stages[s].ticks;
+        stages[s].cycles += other.stages[s].cycles;
+        stages[s].instructions += other.stages[s].instructions;
+        stages[s].llc_misses += other.stages[s].llc_misses;
+    }
+    blocks += other.blocks;
+    keys += other.keys;
+    workers += other.workers;
+    perf_workers += other.perf_workers;
+}
+
+uint64_t ScanProfile::ticks() const {
+    uint64_t t = 0;
+    for (const StageCounts& s : stages) t += s.ticks;
+    return t;
+}
+
+std::string format_profile(const ScanProfile& p) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "profile: %llu blocks, %llu candidates, %u workers (%u with perf counters)\n",
+                  (unsigned long long)p.blocks, (unsigned long long)p.keys, p.workers, p.perf_workers);
+    std::string out = line;
+    out += "  stage          share  ticks/key      IPC  LLC misses/kkey\n";
+    const double total = static_cast<double>(p.ticks());
+    const double keys = static_cast<double>(p.keys);
+    for (size_t s = 0; s < kScanStages; ++s) {
+        const StageCounts& c = p.stages[s];
+        std::snprintf(line, sizeof(line), "  %-12s %6.1f%% %10.1f", scan_stage_name(static_cast<ScanStage>(s)),
+                      total > 0 ? 100.0 * c.ticks / total : 0.0, keys > 0 ? c.ticks / keys : 0.0);
+        out += line;
+        if (p.perf_workers && c.cycles) {
+            std::snprintf(line, sizeof(line), " %8.2f %16.3f\n", static_cast<double>(c.instructions) / c.cycles,
+                          keys > 0 ? 1000.0 * c.llc_misses / keys : 0.0);
+        } else {
+            std::snprintf(line, sizeof(line), " %8s %16s\n", "-", "-");
+        }
+        out += line;
+    }
+    if (p.workers && !p.perf_workers) {
+        out += "  (no perf counters: perf_event_open was refused, see /proc/sys/kernel/perf_event_paranoid)\n";
+    }
+    return out;
+}
+
+#ifdef MARAUDER_PROFILE
+
+namespace {
+
+int open_counter(uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // User mode only, which perf_event_paranoid 2 (the usual default) allows.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+uint64_t timestamp() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+}  // namespace
+
+StageProfiler::StageProfiler(ScanProfile& totals, WorkerMetrics* live) : totals_(totals), live_(live) {
+    ++totals_.workers;
+    group_ = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (group_ >= 0) {
+        members_[0] = open_counter(PERF_COUNT_HW_INSTRUCTIONS, group_);
+        // The generic cache-miss event is the last-level cache on x86 and arm64.
+        members_[1] = open_counter(PERF_COUNT_HW_CACHE_MISSES, group_);
+    }
+    if (group_ < 0 || members_[0] < 0 || members_[1] < 0) {
+        // All or nothing: a partial group would make IPC meaningless.
+        for (int fd : {group_, members_[0], members_[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+        group_ = members_[0] = members_[1] = -1;
+    } else {
+        ++totals_.perf_workers;
+    }
+    start();
+}
+
+StageProfiler::~StageProfiler() {
+    for (int fd : {members_[1], members_[0], group_}) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+StageProfiler::Sample StageProfiler::sample() const {
+    Sample s = last_;  // a failed read charges nothing
+    s.ticks = timestamp();
+    if (group_ >= 0) {
+        uint64_t buf[4] = {};  // nr, then the values in open order
+        if (::read(group_, buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf)) && buf[0] == 3) {
+            s.cycles = buf[1];
+            s.instructions = buf[2];
+            s.llc_misses = buf[3];
+        }
+    }
+    return s;
+}
+
+void StageProfiler::lap(ScanStage stage) {
+    Sample now = sample();
+    StageCounts& c = totals_[stage];
+    uint64_t ticks = now.ticks - last_.ticks, cycles = now.cycles - last_.cycles;
+    uint64_t instructions = now.instructions - last_.instructions, misses = now.llc_misses - last_.llc_misses;
+    c.ticks += ticks;
+    c.cycles += cycles;
+    c.instructions += instructions;
+    c.llc_misses += misses;
+    if (live_) {
+        StageMetrics& m = live_->stages[static_cast<size_t>(stage)];
+        m.ticks.add(ticks);
+        m.cycles.add(cycles);
+        m.instructions.add(instructions);
+        m.llc_misses.add(misses);
+    }
+    last_ = now;
+}
+
+#endif
+
+}  // namespace marauder
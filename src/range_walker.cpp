@@ -0,0 +1,282 @@
+#include "marauder/range_walker.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "marauder/batch_inverse.hpp"
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+const char* walk_mode_name(WalkMode mode) {
+    switch (mode) {
+        case WalkMode::Sequential:
+            return "sequential";
+        case WalkMode::Center:
+            return "center";
+    }
+    return "unknown";
+}
+
+WalkMode parse_walk_mode(const std::string& name) {
+    if (name == "sequential") return WalkMode::Sequential;
+    if (name == "center") return WalkMode::Center;
+    throw std::invalid_argument("unknown walker mode '" + name + "'");
+}
+
+size_t WalkerScratch::arena_bytes(size_t batch_size) {
+    return 2 * Arena::slice_bytes<Point>(batch_size) + 3 * Arena::slice_bytes<Fe>(batch_size);
+}
+
+WalkerScratch WalkerScratch::carve(Arena& arena, size_t batch_size) {
+    WalkerScratch s;
+    s.batch_size = batch_size;
+    s.batch = arena.alloc<Point>(batch_size);
+    s.dx = arena.alloc<Fe>(batch_size);
+    s.inv = arena.alloc<Fe>(2 * batch_size);
+    s.sums = arena.alloc<Point>(batch_size);
+    return s;
+}
+
+unsigned walker_key_limbs(const U256& end) {
+    unsigned bits = end.bit_length();
+    return bits <= 64 ? 1 : bits <= 128 ? 2 : 4;
+}
+
+namespace {
+
+// Key bookkeeping on the low L limbs only: in a walker of that width the
+// others are zero and stay zero, since every key is at most end.
+
+template <unsigned L>
+void key_add(U256& k, uint64_t n) {
+    if constexpr (L == 1) {
+        k.d[0] += n;
+    } else if constexpr (L == 2) {
+        u128 v = (static_cast<u128>(k.d[1]) << 64 | k.d[0]) + n;
+        k.d[0] = static_cast<uint64_t>(v);
+        k.d[1] = static_cast<uint64_t>(v >> 64);
+    } else {
+        u256_add_u64(k, k, n);
+    }
+}
+
+template <unsigned L>
+bool key_less(const U256& a, const U256& b) {
+    if constexpr (L == 1) {
+        return a.d[0] < b.d[0];
+    } else if constexpr (L == 2) {
+        return a.d[1] < b.d[1] || (a.d[1] == b.d[1] && a.d[0] < b.d[0]);
+    } else {
+        return a < b;
+    }
+}
+
+// min(end - k, cap) for k <= end.
+template <unsigned L>
+size_t keys_left(const U256& end, const U256& k, size_t cap) {
+    if constexpr (L == 1) {
+        uint64_t left = end.d[0] - k.d[0];
+        return left >= cap ? cap : static_cast<size_t>(left);
+    } else if constexpr (L == 2) {
+        u128 left = (static_cast<u128>(end.d[1]) << 64 | end.d[0]) - (static_cast<u128>(k.d[1]) << 64 | k.d[0]);
+        return left >= cap ? cap : static_cast<size_t>(left);
+    } else {
+        U256 left;
+        u256_sub(left, end, k);
+        return (left.d[1] | left.d[2] | left.d[3]) || left.d[0] >= cap ? cap : static_cast<size_t>(left.d[0]);
+    }
+}
+
+}  // namespace
+
+template <unsigned KeyLimbs>
+BasicRangeWalker<KeyLimbs>::BasicRangeWalker(const U256& start, const U256& end, const WalkerConfig& config,
+                                             const WalkerScratch* scratch)
+    : config_(config), field_(config.field ? config.field : &field_best()), start_(start), end_(end),
+      base_key_(start), base_(Point::at_infinity()),
+      jump_(Point::at_infinity()), key_(start),
+      batch_key_(start) {
+    if (start.is_zero()) throw std::invalid_argument("range start must be at least 1");
+    if (start > end) throw std::invalid_argument("range start is past its end");
+    if (end > kOrderN) throw std::invalid_argument("range end is beyond the group order");
+    if (walker_key_limbs(end) > KeyLimbs) {
+        throw std::invalid_argument("range end does not fit a " + std::to_string(64 * KeyLimbs) + "-bit walker");
+    }
+    if (config.batch_size == 0 || config.batch_size > kMaxBatchSize) {
+        throw std::invalid_argument("batch size must be between 1 and " + std::to_string(kMaxBatchSize));
+    }
+    if (config.mode == WalkMode::Center) {
+        // Offsets reach +-B/2 around the centre; the jump moves it by B.
+        steps_ = StepTable::get(std::max<size_t>(config.batch_size / 2, 1));
+        jump_ = point_mul_g(Scalar::from_u64(config.batch_size));
+    } else {
+        steps_ = StepTable::get(config.batch_size);
+    }
+    const size_t b = config.batch_size;
+    if (scratch) {
+        if (scratch->batch_size < b) throw std::invalid_argument("walker scratch is smaller than the batch size");
+        batch_ = scratch->batch;
+        dx_ = scratch->dx;
+        scratch_ = scratch->inv;
+        sums_ = scratch->sums;
+    } else {
+        own_points_.resize(2 * b);
+        own_fes_.resize(3 * b);
+        batch_ = own_points_.data();
+        sums_ = batch_ + b;
+        dx_ = own_fes_.data();
+        scratch_ = dx_ + b;
+    }
+}
+
+// Walker output sinks: the AoS batch behind next()/next_batch(), and the
+// SoA lanes of a PointBlock.
+template <unsigned KeyLimbs>
+struct BasicRangeWalker<KeyLimbs>::AosSink {
+    Point* points;
+    void put(size_t i, const Point& p) const { points[i] = p; }
+};
+
+template <unsigned KeyLimbs>
+struct BasicRangeWalker<KeyLimbs>::SoaSink {
+    const SoaOut& out;
+    void put(size_t i, const Point& p) const {
+        for (int k = 0; k < 4; ++k) out.x[k][i] = p.x.d[k];
+        if (out.y[0]) {
+            for (int k = 0; k < 4; ++k) out.y[k][i] = p.y.d[k];
+        }
+        out.y_odd[i] = (uint8_t)p.y.is_odd();
+    }
+};
+
+template <unsigned KeyLimbs>
+template <class Sink>
+size_t BasicRangeWalker<KeyLimbs>::produce(const Sink& out) {
+    size_t n = keys_left<KeyLimbs>(end_, base_key_, config_.batch_size);
+
+    if (config_.mode == WalkMode::Center) {
+        fill_center(out, n);
+    } else {
+        fill_sequential(out, n);
+    }
+    key_add<KeyLimbs>(base_key_, n);
+    return n;
+}
+
+template <unsigned KeyLimbs>
+void BasicRangeWalker<KeyLimbs>::fill_batch() {
+    batch_key_ = base_key_;
+    batch_len_ = produce(AosSink{batch_});
+    batch_pos_ = 0;
+}
+
+template <unsigned KeyLimbs>
+size_t BasicRangeWalker<KeyLimbs>::fill_soa(const SoaOut& out) {
+    if (!key_less<KeyLimbs>(base_key_, end_)) return 0;
+    return produce(SoaSink{out});
+}
+
+template <unsigned KeyLimbs>
+void BasicRangeWalker<KeyLimbs>::check_block_lanes(size_t lanes) const {
+    if (lanes % config_.batch_size != 0) {
+        throw std::invalid_argument("batch size " + std::to_string(config_.batch_size) +
+                                    " does not divide the block size " + std::to_string(lanes));
+    }
+}
+
+template <unsigned KeyLimbs>
+template <class Sink>
+void BasicRangeWalker<KeyLimbs>::fill_sequential(const Sink& out, size_t n) {
+    const size_t B = config_.batch_size;
+    if (!started_) {
+        base_ = point_mul_g(Scalar::from_u256(base_key_));
+        started_ = true;
+    }
+
+    // Lane i computes base + (i+1)G: lanes 0..n-2 are the rest of this
+    // batch and lane B-1 is the next base. A short final batch needs no
+    // next base.
+    const Point* steps = steps_->data();
+    size_t lanes = n == B ? B : n - 1;
+    for (size_t i = 0; i < lanes; ++i) fe_sub(dx_[i], steps[i].x, base_.x);
+    field_->batch_inv(dx_, lanes, scratch_);
+
+    out.put(0, base_);
+    field_->add_batch(sums_, base_, steps, dx_, n - 1, false);
+    for (size_t i = 0; i + 1 < n; ++i) out.put(i + 1, sums_[i]);
+    if (n == B) point_add_inv(base_, base_, steps[B - 1].x, steps[B - 1].y, dx_[B - 1]);
+}
+
+template <unsigned KeyLimbs>
+template <class Sink>
+void BasicRangeWalker<KeyLimbs>::fill_center(const Sink& out, size_t n) {
+    const size_t B = config_.batch_size;
+    const size_t h = B / 2;
+    if (!started_) {
+        U256 center;
+        u256_add_u64(center, base_key_, h);
+        base_ = point_mul_g(Scalar::from_u256(center));
+        started_ = true;
+    }
+
+    // base_ is the centre C of the batch, at index h. Lane i - 1 holds the
+    // inverse of (iG.x - C.x), shared by C + iG and C - iG since negation
+    // only flips y. Lane h is the jump C + BG to the next centre.
+    const Point* steps = steps_->data();
+    size_t lanes = h;
+    for (size_t i = 0; i < h; ++i) fe_sub(dx_[i], steps[i].x, base_.x);
+    if (n == B) fe_sub(dx_[lanes++], jump_.x, base_.x);
+    if (base_.infinity) {
+        for (size_t i = 0; i < lanes; ++i) dx_[i] = Fe::zero();
+    }
+    field_->batch_inv(dx_, lanes, scratch_);
+
+    // C + iG lands in sums_[i - 1] and C - iG in sums_[h + i - 1]; only
+    // indices below n are in range.
+    field_->add_batch(sums_, base_, steps, dx_, h, false);
+    field_->add_batch(sums_ + h, base_, steps, dx_, h, true);
+    if (h < n) out.put(h, base_);
+    for (size_t i = 1; i <= h; ++i) {
+        if (h + i < n) out.put(h + i, sums_[i - 1]);
+        if (h - i < n) out.put(h - i, sums_[h + i - 1]);
+    }
+    if (n == B) point_add_inv(base_, base_, jump_.x, jump_.y, dx_[h]);
+}
+
+template <unsigned KeyLimbs>
+size_t BasicRangeWalker<KeyLimbs>::next_batch(const Point*& points, U256& first_key) {
+    if (!key_less<KeyLimbs>(base_key_, end_)) return 0;
+    fill_batch();
+    points = batch_;
+    first_key = batch_key_;
+    batch_pos_ = batch_len_;
+    return batch_len_;
+}
+
+template <unsigned KeyLimbs>
+bool BasicRangeWalker<KeyLimbs>::next(Point& pub) {
+    if (batch_pos_ == batch_len_) {
+        if (!key_less<KeyLimbs>(base_key_, end_)) return false;
+        fill_batch();
+    }
+    key_ = batch_key_;
+    key_add<KeyLimbs>(key_, batch_pos_);
+    pub = batch_[batch_pos_++];
+    return true;
+}
+
+template <unsigned KeyLimbs>
+U256 BasicRangeWalker<KeyLimbs>::remaining() const {
+    U256 r;
+    u256_sub(r, end_, base_key_);
+    u256_add_u64(r, r, batch_len_ - batch_pos_);
+    return r;
+}
+
+template class BasicRangeWalker<1>;
+template class BasicRangeWalker<2>;
+template class BasicRangeWalker<4>;
+
+}  // namespace marauder
@@ -0,0 +1,15 @@
+#include "marauder/reference.hpp"
+
+namespace marauder {
+
+Point reference_pubkey(const U256& key) {
+    Point acc = Point::at_infinity();
+    Point base = kGenerator;
+    for (unsigned i = 0; i < key.bit_length(); ++i) {
+        if (key.bit(i)) point_add(acc, acc, base);
+        point_double(base, base);
+    }
+    return acc;
+}
+
+}  // namespace marauder
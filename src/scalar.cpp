@@ -0,0 +1,98 @@
+#include "marauder/scalar.hpp"
+
+namespace marauder {
+
+namespace {
+
+// 2^256 - n, a 129-bit constant.
+constexpr uint64_t kNC[3] = {0x402DA1732FC9BEBFULL, 0x4551231950B75FC4ULL, 0x1ULL};
+
+// Subtracts n once if v >= n (or if the addition that produced v carried).
+void reduce_once(Scalar& r, const U256& v, uint64_t carry) {
+    U256 t;
+    uint64_t borrow = u256_sub(t, v, kOrderN);
+    const U256& src = (carry || !borrow) ? t : v;
+    r = Scalar{{src.d[0], src.d[1], src.d[2], src.d[3]}};
+}
+
+// Reduces the 512-bit value t[0..7] modulo n by folding hi * 2^256 into
+// hi * (2^256 - n). Each fold shrinks the value by ~127 bits, so three
+// passes always suffice for a full 512-bit input.
+void reduce512(Scalar& r, uint64_t t[8]) {
+    while (t[4] | t[5] | t[6] | t[7]) {
+        uint64_t out[8] = {t[0], t[1], t[2], t[3], 0, 0, 0, 0};
+        for (int i = 0; i < 4; ++i) {
+            u128 carry = 0;
+            for (int j = 0; j < 3; ++j) {
+                carry += (u128)t[4 + i] * kNC[j] + out[i + j];
+                out[i + j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            for (int k = i + 3; carry && k < 8; ++k) {
+                carry += out[k];
+                out[k] = (uint64_t)carry;
+                carry >>= 64;
+            }
+        }
+        for (int i = 0; i < 8; ++i) t[i] = out[i];
+    }
+    reduce_once(r, U256{{t[0], t[1], t[2], t[3]}}, 0);
+}
+
+}  // namespace
+
+Scalar Scalar::from_u256(const U256& v) {
+    Scalar r;
+    reduce_once(r, v, 0);
+    return r;
+}
+
+void scalar_add(Scalar& r, const Scalar& a, const Scalar& b) {
+    U256 sum;
+    uint64_t carry = u256_add(sum, a.to_u256(), b.to_u256());
+    reduce_once(r, sum, carry);
+}
+
+void scalar_neg(Scalar& r, const Scalar& a) {
+    if (a.is_zero()) {
+        r = a;
+        return;
+    }
+    U256 t;
+    u256_sub(t, kOrderN, a.to_u256());
+    r = Scalar{{t.d[0], t.d[1], t.d[2], t.d[3]}};
+}
+
+void scalar_sub(Scalar& r, const Scalar& a, const Scalar& b) {
+    Scalar nb;
+    scalar_neg(nb, b);
+    scalar_add(r, a, nb);
+}
+
+void scalar_mul(Scalar& r, const Scalar& a, const Scalar& b) {
+    uint64_t t[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        u128 carry = 0;
+        for (int j = 0; j < 4; ++j) {
+            carry += (u128)a.d[i] * b.d[j] + t[i + j];
+            t[i + j] = (uint64_t)carry;
+            carry >>= 64;
+        }
+        t[i + 4] = (uint64_t)carry;
+    }
+    reduce512(r, t);
+}
+
+void scalar_inv(Scalar& r, const Scalar& a) {
+    // a^(n-2) by left-to-right square-and-multiply.
+    U256 e;
+    u256_sub(e, kOrderN, U256::from_u64(2));
+    Scalar acc = Scalar::one();
+    for (int i = 255; i >= 0; --i) {
+        scalar_mul(acc, acc, acc);
+        if (e.bit((unsigned)i)) scalar_mul(acc, acc, a);
+    }
+    r = acc;
+}
+
+}  // namespace marauder
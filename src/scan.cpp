@@ -0,0 +1,495 @@
+#include "marauder/scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "marauder/arena.hpp"
+#include "marauder/bloom.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/hit_reporter.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/topology.hpp"
+#include "stage_profiler.hpp"
+
+namespace marauder {
+
+namespace {
+
+struct Shared {
+    Shared(const ScanConfig& c, RangePartitioner& p)
+        : config(c), kernel(c.kernel ? *c.kernel : hash160_best()), partitioner(p) {}
+
+    const ScanConfig& config;
+    const Hash160Kernel& kernel;
+    RangePartitioner& partitioner;
+    // Takes worker w's candidates on its ring w; set before workers start.
+    HitReporter* reporter = nullptr;
+    // Every unit lies below the range end, so its walker needs no more.
+    unsigned key_limbs = 4;
+    // With pin_threads: CPU worker w runs on placement[w], and replicas
+    // holds one Bloom filter per NUMA node if there is more than one.
+    std::vector<WorkerPlacement> placement;
+    std::vector<BloomFilter> replicas;
+    // A failed worker stops the others at their next unit boundary.
+    std::atomic<bool> stop{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    bool stopping() const {
+        return stop.load(std::memory_order_relaxed) ||
+               (config.cancel && config.cancel->load(std::memory_order_relaxed));
+    }
+
+    // The Bloom filter worker w should read: its node's replica if any.
+    const BloomFilter* bloom(unsigned w) const {
+        if (!config.targets) return nullptr;
+        if (replicas.empty() || w >= placement.size()) return &config.targets->bloom();
+        return &replicas[placement[w].node];
+    }
+};
+
+struct alignas(64) WorkerTotals {
+    uint64_t keys = 0, units = 0;  // hits are counted by the reporter
+    WorkerMetrics* live = nullptr;  // written by this worker only
+    ScanProfile profile;            // stays zero unless kProfiling
+
+    void publish(uint64_t k, uint64_t lookups, uint64_t positives, uint64_t h) {
+        if (!live) return;
+        live->keys.add(k);
+        live->bloom_lookups.add(lookups);
+        live->bloom_positives.add(positives);
+        live->hits.add(h);
+    }
+    void unit_done(std::chrono::steady_clock::time_point t0) {
+        ++units;
+        if (!live) return;
+        live->units.add(1);
+        live->unit_seconds.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+};
+
+// Gauges over this scan's partitioner, withdrawn before it goes away.
+class ScanGauges {
+public:
+    explicit ScanGauges(Metrics* m) : metrics_(m) {}
+    ~ScanGauges() {
+        for (uint64_t id : ids_) metrics_->remove_gauge(id);
+    }
+    ScanGauges(const ScanGauges&) = delete;
+    ScanGauges& operator=(const ScanGauges&) = delete;
+
+    void add(const std::string& name, const std::string& help, const std::string& labels,
+             std::function<double()> value) {
+        if (metrics_) ids_.push_back(metrics_->add_gauge(name, help, labels, std::move(value)));
+    }
+
+private:
+    Metrics* metrics_;
+    std::vector<uint64_t> ids_;
+};
+
+// Pins nothing yet: picks a CPU per CPU worker, tells the partitioner their
+// nodes and, on a multi-node host, copies the Bloom filter once per node
+// from a thread running there so first touch puts its pages in local
+// memory. The target table stays shared: only Bloom positives, about 1e-4
+// of the candidates, ever read it.
+void place(Shared& sh) {
+    const ScanConfig& cfg = sh.config;
+    const CpuTopology& topo = cpu_topology();
+    sh.placement = place_workers(topo, cfg.threads);
+    std::vector<unsigned> nodes(sh.partitioner.workers(), 0);
+    for (unsigned w = 0; w < cfg.threads; ++w) nodes[w] = sh.placement[w].node;
+    sh.partitioner.set_worker_nodes(nodes);
+    if (topo.nodes.size() < 2 || !cfg.targets) return;
+
+    sh.replicas.resize(topo.nodes.size());
+    std::vector<std::thread> copiers;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    for (size_t n = 0; n < topo.nodes.size(); ++n) {
+        copiers.emplace_back([&, n] {
+            try {
+                pin_current_thread(topo.nodes[n][0]);
+                sh.replicas[n] = cfg.targets->bloom().clone();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& t : copiers) t.join();
+    if (error) std::rethrow_exception(error);
+}
+
+std::string worker_name(const ScanConfig& config, unsigned w) {
+    return w < config.threads ? "cpu" + std::to_string(w) : "gpu" + std::to_string(w - config.threads);
+}
+
+// One worker's batch buffers, sized from the walker configuration and
+// carved from an arena mapped by the worker itself, so after pinning its
+// pages are local. Nothing a unit needs is left to the heap.
+struct Workspace {
+    Workspace(const WalkerConfig& walker_config, WorkerTotals& totals)
+        : arena(Arena::slice_bytes<DefaultPointBlock>(1) + Arena::slice_bytes<uint32_t>(kBlockLanes) +
+                WalkerScratch::arena_bytes(walker_config.batch_size)),
+          blk(*arena.make<DefaultPointBlock>()),
+          positives(arena.alloc<uint32_t>(kBlockLanes)),
+          walker(WalkerScratch::carve(arena, walker_config.batch_size)),
+          profiler(totals.profile, totals.live) {}
+
+    Arena arena;
+    DefaultPointBlock& blk;
+    uint32_t* positives;  // Bloom positives of blk
+    WalkerScratch walker;
+    StageProfiler profiler;
+};
+
+// Hands one candidate lane to the reporter; no lock, no IO.
+void report(Shared& sh, unsigned w, const DefaultPointBlock& blk, size_t lane, unsigned v,
+            bool uncompressed = false) {
+    ScanHit hit;
+    hit.key = endo_candidate_key(Scalar::from_u256(blk.key(lane)), v).to_u256();
+    hit.pubkey[0] = 0x02 | blk.y_odd[lane];
+    U256{{blk.x[0][lane], blk.x[1][lane], blk.x[2][lane], blk.x[3][lane]}}.to_be_bytes(hit.pubkey + 1);
+    const uint8_t* digest = uncompressed ? blk.digest_uncompressed[lane] : blk.digest[lane];
+    std::copy(digest, digest + 20, hit.digest.begin());
+    hit.uncompressed = uncompressed;
+    sh.reporter->push(w, hit);
+}
+
+// Walks [start, end) on this CPU thread (or a GPU worker's fallback) as
+// worker w, with keys KeyLimbs limbs wide. Only the Bloom filter runs here;
+// its positives go to the reporter, which checks them against the table.
+template <unsigned KeyLimbs>
+void scan_cpu_keys(Shared& sh, unsigned w, const U256& start, const U256& end, const BloomFilter* bloom,
+                   WorkerTotals& totals, Workspace& ws) {
+    const ScanConfig& cfg = sh.config;
+    const unsigned passes = cfg.endomorphism ? kEndoCandidates : 1;
+    // The walker computes y either way; it is only copied into the block
+    // when the uncompressed encoding will be hashed.
+    const bool both = cfg.uncompressed;
+    DefaultPointBlock& blk = ws.blk;
+    StageProfiler& prof = ws.profiler;
+    BasicRangeWalker<KeyLimbs> walker(start, end, cfg.walker, &ws.walker);
+    prof.start();
+    while (walker.next_block(blk, both) != 0) {
+        prof.lap(ScanStage::Walk);
+        prof.block();
+        for (unsigned pass = 0; pass < passes; ++pass) {
+            if (pass) {
+                endo_block_step(blk, pass);
+                prof.lap(ScanStage::Endomorphism);
+            }
+            if (both) {
+                blk.hash_both(sh.kernel);
+            } else {
+                blk.hash_compressed(sh.kernel);
+            }
+            prof.lap(ScanStage::Hash);
+            prof.hashed(blk.count);
+            totals.keys += blk.count;
+            unsigned v = kEndoBlockOrder[pass];
+            if (cfg.report_all) {
+                for (size_t i = 0; i < blk.count; ++i) report(sh, w, blk, i, v);
+                totals.publish(blk.count, 0, 0, 0);
+            } else if (cfg.targets) {
+                size_t positives = cfg.targets->prefilter(*bloom, blk.digest, blk.count, ws.positives);
+                prof.lap(ScanStage::Bloom);
+                for (size_t h = 0; h < positives; ++h) report(sh, w, blk, ws.positives[h], v);
+                size_t probes = blk.count, found = positives;
+                if (both) {
+                    prof.lap(ScanStage::Report);
+                    positives = cfg.targets->prefilter(*bloom, blk.digest_uncompressed, blk.count, ws.positives);
+                    prof.lap(ScanStage::Bloom);
+                    for (size_t h = 0; h < positives; ++h) report(sh, w, blk, ws.positives[h], v, true);
+                    probes += blk.count;
+                    found += positives;
+                }
+                totals.publish(blk.count, probes, found, 0);
+            } else {
+                totals.publish(blk.count, 0, 0, 0);
+            }
+            prof.lap(ScanStage::Report);
+        }
+    }
+}
+
+void scan_cpu(Shared& sh, unsigned w, const U256& start, const U256& end, const BloomFilter* bloom,
+              WorkerTotals& totals, Workspace& ws) {
+    switch (sh.key_limbs) {
+        case 1:
+            return scan_cpu_keys<1>(sh, w, start, end, bloom, totals, ws);
+        case 2:
+            return scan_cpu_keys<2>(sh, w, start, end, bloom, totals, ws);
+        default:
+            return scan_cpu_keys<4>(sh, w, start, end, bloom, totals, ws);
+    }
+}
+
+void run_cpu_worker(Shared& sh, unsigned w, WorkerTotals& totals) {
+    if (w < sh.placement.size()) pin_current_thread(sh.placement[w].cpu);
+    const BloomFilter* bloom = sh.bloom(w);
+    Workspace ws(sh.config.walker, totals);
+    std::optional<Checkpoint::Marker> marker;
+    if (sh.config.checkpoint) marker.emplace(*sh.config.checkpoint);
+    // The first unit may build lazily cached tables; every later one,
+    // checkpointing included, must stay off the heap, which hosts that
+    // count allocations check.
+    bool warm = false;
+    WorkUnit unit;
+    while (!sh.stopping() && !sh.reporter->failed() && sh.partitioner.next(w, unit)) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t allocations = thread_allocations();
+        scan_cpu(sh, w, unit.start, unit.end, bloom, totals, ws);
+        // Done means reported: wait until the reporter has been through
+        // this unit's candidates (immediate if there were none).
+        if (!sh.reporter->flush(w)) break;
+        if (marker) marker->mark_done(unit.position);
+        totals.unit_done(t0);
+        if (warm && thread_allocations() != allocations) {
+            throw std::runtime_error("scan worker allocated " + std::to_string(thread_allocations() - allocations) +
+                                     " times in one unit");
+        }
+        warm = true;
+    }
+}
+
+// Confirms one GPU Bloom positive: the key is re-derived and re-hashed on
+// the CPU, so a faulty device can cost a missed key but never a false hit.
+// The table check is left to the reporter, as for CPU workers.
+void confirm_gpu_hit(Shared& sh, unsigned w, const U256& chunk_start, const MarauderGpuHit& g) {
+    U256 walked;
+    u256_add_u64(walked, chunk_start, g.offset);
+    ScanHit hit;
+    hit.key = endo_candidate_key(Scalar::from_u256(walked), g.candidate).to_u256();
+    serialize_compressed(point_mul_g(Scalar::from_u256(hit.key)), hit.pubkey);
+    hash160(hit.pubkey, sizeof(hit.pubkey), hit.digest.data());
+    if (!std::equal(hit.digest.begin(), hit.digest.end(), g.digest)) {
+        throw std::runtime_error("GPU reported a digest that does not match key " + hit.key.to_hex());
+    }
+    if (sh.config.targets) sh.reporter->push(w, hit);
+}
+
+// Smallest chunk worth splitting further after a hit-buffer overflow.
+constexpr uint64_t kMinGpuChunk = uint64_t(1) << 16;
+
+// Accounts for a chunk the device finished and confirms its positives.
+void gpu_chunk_done(Shared& sh, unsigned w, const U256& start, uint64_t count, WorkerTotals& totals,
+                    const GpuHits& hits) {
+    uint64_t keys = count * (sh.config.endomorphism ? kEndoCandidates : 1);
+    totals.keys += keys;
+    // Every device hit is a Bloom positive; the confirmed ones count as hits.
+    totals.publish(keys, sh.config.targets ? keys : 0, hits.size(), 0);
+    for (const MarauderGpuHit& g : hits) confirm_gpu_hit(sh, w, start, g);
+}
+
+void scan_gpu_chunk(Shared& sh, unsigned w, GpuDevice& dev, const U256& start, uint64_t count,
+                    WorkerTotals& totals, GpuHits& hits, Workspace& ws);
+
+// Rescans a chunk whose positives overflowed the hit buffer in two halves.
+void split_gpu_chunk(Shared& sh, unsigned w, GpuDevice& dev, const U256& start, uint64_t count,
+                     WorkerTotals& totals, GpuHits& hits, Workspace& ws) {
+    if (count <= kMinGpuChunk) throw std::runtime_error("GPU hit buffer overflow: Bloom filter too dense");
+    U256 mid;
+    u256_add_u64(mid, start, count / 2);
+    scan_gpu_chunk(sh, w, dev, start, count / 2, totals, hits, ws);
+    scan_gpu_chunk(sh, w, dev, mid, count - count / 2, totals, hits, ws);
+}
+
+// One chunk through the device alone, with nothing else in flight.
+void scan_gpu_chunk(Shared& sh, unsigned w, GpuDevice& dev, const U256& start, uint64_t count,
+                    WorkerTotals& totals, GpuHits& hits, Workspace& ws) {
+    switch (dev.scan(start, count, hits)) {
+        case GpuDevice::Result::Ok:
+            return gpu_chunk_done(sh, w, start, count, totals, hits);
+        case GpuDevice::Result::Unsupported: {
+            U256 end;
+            u256_add_u64(end, start, count);
+            scan_cpu(sh, w, start, end, sh.config.targets ? &sh.config.targets->bloom() : nullptr, totals, ws);
+            return;
+        }
+        case GpuDevice::Result::Overflow:
+            return split_gpu_chunk(sh, w, dev, start, count, totals, hits, ws);
+    }
+}
+
+struct GpuChunk {
+    U256 start;
+    uint64_t count = 0;
+};
+
+// Streams each unit through the device in chunks, keeping up to depth()
+// of them queued: the next chunk is submitted as soon as the oldest has
+// been collected, so the device computes while the host confirms one
+// chunk's positives and sets up another's starting points. The pipeline
+// drains at the end of every unit, before it is checkpointed.
+void run_gpu_worker(Shared& sh, unsigned w, int device, WorkerTotals& totals) {
+    const ScanConfig& cfg = sh.config;
+    std::unique_ptr<GpuDevice> dev = cfg.gpu->open(device, cfg.endomorphism, cfg.gpu_depth);
+    dev->set_bloom(cfg.targets ? cfg.targets->bloom() : BloomFilter(0));
+    const uint64_t chunk = dev->preferred_keys();
+    // Rare CPU fallbacks (ranges near 0 or n) need their own buffers.
+    Workspace ws(cfg.walker, totals);
+    GpuHits hits;
+    std::optional<Checkpoint::Marker> marker;
+    if (cfg.checkpoint) marker.emplace(*cfg.checkpoint);
+    std::vector<GpuChunk> queued(dev->depth());  // ring of chunks in flight, oldest first
+    std::vector<GpuChunk> overflowed;
+    size_t oldest = 0;
+    auto collect_oldest = [&] {
+        const GpuChunk c = queued[oldest];
+        oldest = (oldest + 1) % queued.size();
+        if (dev->collect(hits) == GpuDevice::Result::Overflow) {
+            overflowed.push_back(c);
+        } else {
+            gpu_chunk_done(sh, w, c.start, c.count, totals, hits);
+        }
+    };
+    WorkUnit unit;
+    while (!sh.stopping() && !sh.reporter->failed() && sh.partitioner.next(w, unit)) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (U256 at = unit.start; at < unit.end;) {
+            U256 left;
+            u256_sub(left, unit.end, at);
+            uint64_t n = left.bit_length() > 64 || left.d[0] > chunk ? chunk : left.d[0];
+            if (dev->in_flight() == dev->depth()) collect_oldest();
+            if (dev->submit(at, n) == GpuDevice::Result::Ok) {
+                queued[(oldest + dev->in_flight() - 1) % queued.size()] = GpuChunk{at, n};
+            } else {
+                // The device keeps working on what is queued meanwhile.
+                U256 end;
+                u256_add_u64(end, at, n);
+                scan_cpu(sh, w, at, end, cfg.targets ? &cfg.targets->bloom() : nullptr, totals, ws);
+            }
+            u256_add_u64(at, at, n);
+        }
+        while (dev->in_flight() != 0) collect_oldest();
+        for (const GpuChunk& c : overflowed) split_gpu_chunk(sh, w, *dev, c.start, c.count, totals, hits, ws);
+        overflowed.clear();
+        if (!sh.reporter->flush(w)) break;
+        if (marker) marker->mark_done(unit.position);
+        totals.unit_done(t0);
+    }
+}
+
+}  // namespace
+
+std::string hit_pubkey_hex(const ScanHit& hit) {
+    if (!hit.uncompressed) return bytes_to_hex(hit.pubkey, sizeof(hit.pubkey));
+    Point p;
+    uint8_t full[65];
+    if (!parse_pubkey(p, hit.pubkey, sizeof(hit.pubkey))) throw std::runtime_error("hit has an invalid public key");
+    serialize_uncompressed(p, full);
+    return bytes_to_hex(full, sizeof(full));
+}
+
+ScanStats scan_range(const U256& start, const U256& end, const ScanConfig& config, const ScanHitFn& on_hit) {
+    const unsigned gpus = config.gpu ? static_cast<unsigned>(config.gpu->device_count()) : 0;
+    if (config.gpu && gpus == 0) throw std::invalid_argument("the GPU plugin found no devices");
+    if (config.gpu && config.report_all) throw std::invalid_argument("GPU workers cannot report every candidate");
+    if (config.uncompressed && (!config.targets || config.report_all)) {
+        throw std::invalid_argument("uncompressed matching needs targets and cannot report every candidate");
+    }
+    if (config.gpu && config.uncompressed) {
+        throw std::invalid_argument("GPU workers only hash compressed keys");
+    }
+    if (config.gpu && (config.gpu_depth == 0 || config.gpu_depth > kMaxGpuDepth)) {
+        throw std::invalid_argument("GPU pipeline depth must be between 1 and " + std::to_string(kMaxGpuDepth));
+    }
+    const unsigned workers = config.threads + gpus;
+    if (workers == 0) throw std::invalid_argument("need at least one thread");
+    // Surface walker configuration errors here rather than in every worker.
+    RangeWalker probe(start, end, config.walker);
+    if (kBlockLanes % config.walker.batch_size != 0) {
+        throw std::invalid_argument("batch size must divide the block size " + std::to_string(kBlockLanes));
+    }
+
+    const IntervalSet* skip = nullptr;
+    if (config.checkpoint) {
+        const Checkpoint& cp = *config.checkpoint;
+        if (!(cp.start() == start && cp.end() == end) || cp.unit_bits() != config.unit_bits ||
+            cp.order() != config.order) {
+            throw std::invalid_argument("checkpoint was opened for a different range, unit size or order");
+        }
+        skip = &cp.resumed();
+    }
+    IntervalSet outside;
+    if (config.units) {
+        for (const UnitSpan& s : config.units->gaps(uint64_t(1) << kMaxUnitCountBits)) outside.insert(s);
+        if (skip) {
+            for (const UnitSpan& s : skip->spans()) outside.insert(s);
+        }
+        skip = &outside;
+    }
+    RangePartitioner partitioner(start, end, workers, config.unit_bits, skip, config.order);
+    Shared sh(config, partitioner);
+    sh.key_limbs = walker_key_limbs(end);
+    if (config.pin_threads) place(sh);
+    std::vector<WorkerTotals> totals(workers);
+    ScanGauges gauges(config.metrics);
+    if (config.metrics) {
+        gauges.add("marauder_units_unassigned", "Work units of the current scan not yet handed to a worker.", "",
+                   [&partitioner] { return static_cast<double>(partitioner.unassigned()); });
+        for (unsigned w = 0; w < workers; ++w) {
+            const std::string name = worker_name(config, w);
+            totals[w].live = &config.metrics->worker(name, w < config.threads ? "cpu" : "gpu");
+            gauges.add("marauder_deque_spans", "Unit spans queued in a worker's deque.", "worker=\"" + name + "\"",
+                       [&partitioner, w] { return static_cast<double>(partitioner.queued_spans(w)); });
+        }
+    }
+
+    std::vector<WorkerMetrics*> live;
+    for (const WorkerTotals& t : totals) live.push_back(t.live);
+    HitReporter reporter(workers, config.report_all ? nullptr : config.targets, on_hit, live);
+    sh.reporter = &reporter;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned w = 0; w < workers; ++w) {
+        threads.emplace_back([&sh, &totals, w] {
+            try {
+                // Workers past the CPU threads each drive one GPU.
+                if (w < sh.config.threads) {
+                    run_cpu_worker(sh, w, totals[w]);
+                } else {
+                    run_gpu_worker(sh, w, static_cast<int>(w - sh.config.threads), totals[w]);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(sh.error_mutex);
+                if (!sh.error) sh.error = std::current_exception();
+                sh.stop.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    if (sh.error) std::rethrow_exception(sh.error);
+    reporter.finish();
+
+    ScanStats stats;
+    stats.skipped = partitioner.position_count() - partitioner.pending_units();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (unsigned w = 0; w < workers; ++w) {
+        stats.keys += totals[w].keys;
+        stats.hits += reporter.hits(w);
+        stats.units += totals[w].units;
+        stats.steals += partitioner.steals(w);
+        stats.remote_steals += partitioner.remote_steals(w);
+        stats.profile.add(totals[w].profile);
+    }
+    return stats;
+}
+
+}  // namespace marauder
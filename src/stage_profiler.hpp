@@ -0,0 +1,55 @@
+// The scan loop's per-worker stage clock (see marauder/profile.hpp).
+#pragma once
+
+#include <cstdint>
+
+#include "marauder/metrics.hpp"
+#include "marauder/profile.hpp"
+
+namespace marauder {
+
+#ifdef MARAUDER_PROFILE
+
+// Opens its perf counters for the constructing thread, so a worker makes
+// its own. Each lap charges the interval since the previous lap (or start)
+// to one stage, in totals and, if there is one, in live.
+class StageProfiler {
+public:
+    StageProfiler(ScanProfile& totals, WorkerMetrics* live);
+    ~StageProfiler();
+    StageProfiler(const StageProfiler&) = delete;
+    StageProfiler& operator=(const StageProfiler&) = delete;
+
+    void start() { last_ = sample(); }
+    void lap(ScanStage stage);
+    void block() { ++totals_.blocks; }
+    void hashed(uint64_t keys) { totals_.keys += keys; }
+
+private:
+    struct Sample {
+        uint64_t ticks = 0, cycles = 0, instructions = 0, llc_misses = 0;
+    };
+
+    Sample sample() const;
+
+    ScanProfile& totals_;
+    WorkerMetrics* live_;
+    int group_ = -1;  // cycles leads; instructions and LLC misses follow
+    int members_[2] = {-1, -1};
+    Sample last_;
+};
+
+#else
+
+class StageProfiler {
+public:
+    StageProfiler(ScanProfile&, WorkerMetrics*) {}
+    void start() {}
+    void lap(ScanStage) {}
+    void block() {}
+    void hashed(uint64_t) {}
+};
+
+#endif
+
+}  // namespace marauder
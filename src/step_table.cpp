@@ -0,0 +1,30 @@
+#include "marauder/step_table.hpp"
+
+#include <map>
+#include <mutex>
+
+#include "marauder/batch_inverse.hpp"
+
+namespace marauder {
+
+StepTable::StepTable(size_t count) : points_(count) {
+    std::vector<JPoint> jac(count);
+    JPoint acc = JPoint::from_affine(kGenerator);
+    for (size_t i = 0; i < count; ++i) {
+        jac[i] = acc;
+        jpoint_add_affine(acc, acc, kGenerator);
+    }
+    std::vector<Fe> scratch(2 * count);
+    jpoint_batch_to_affine(points_.data(), jac.data(), count, scratch.data());
+}
+
+std::shared_ptr<const StepTable> StepTable::get(size_t count) {
+    static std::mutex mu;
+    static std::map<size_t, std::shared_ptr<const StepTable>> cache;
+    std::lock_guard<std::mutex> lock(mu);
+    auto& slot = cache[count];
+    if (!slot) slot = std::make_shared<const StepTable>(count);
+    return slot;
+}
+
+}  // namespace marauder
@@ -0,0 +1,200 @@
+#include "marauder/target_index.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+namespace {
+
+// One sorted, unique input of a merge: a run file or an in-memory table.
+struct Source {
+    const Hash160* at;
+    const Hash160* end;
+};
+
+bool less(const Hash160& a, const Hash160& b) { return std::memcmp(a.data(), b.data(), 20) < 0; }
+
+// Calls fn once per distinct digest of the sources, in order.
+template <class Fn>
+void merge_unique(std::vector<Source> sources, Fn fn) {
+    auto later = [](const Source& a, const Source& b) { return less(*b.at, *a.at); };
+    std::priority_queue<Source, std::vector<Source>, decltype(later)> heap(later);
+    for (const Source& s : sources) {
+        if (s.at != s.end) heap.push(s);
+    }
+    const Hash160* last = nullptr;
+    while (!heap.empty()) {
+        Source s = heap.top();
+        heap.pop();
+        if (!last || *last != *s.at) {
+            fn(*s.at);
+            last = s.at;
+        }
+        if (++s.at != s.end) heap.push(s);
+    }
+}
+
+void write_or_throw(std::FILE* f, const void* p, size_t n, const std::string& path) {
+    if (n && std::fwrite(p, 1, n, f) != n) throw std::runtime_error("cannot write " + path);
+}
+
+// Two passes over the sources: one to count the records, which sizes the
+// Bloom filter, and one to write them while filling it. The filter goes in
+// last, over the empty copy written ahead of the records.
+uint64_t write_index(const std::string& path, const std::vector<Source>& sources, unsigned bloom_bits) {
+    if (bloom_bits == 0) throw std::invalid_argument("the Bloom filter needs at least one bit per key");
+    uint64_t records = 0;
+    merge_unique(sources, [&](const Hash160&) { ++records; });
+    BloomFilter bloom(static_cast<size_t>(records), bloom_bits);
+
+    TargetIndexHeader h{};
+    std::memcpy(h.magic, kTargetIndexMagic, sizeof(h.magic));
+    h.version = kTargetIndexVersion;
+    h.bloom_bits = bloom_bits;
+    h.records = records;
+    h.bloom_lines = bloom.lines();
+
+    std::string tmp = path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) throw std::runtime_error("cannot open " + tmp);
+    try {
+        write_or_throw(f, &h, sizeof(h), tmp);
+        write_or_throw(f, bloom.data(), bloom.size_bytes(), tmp);
+        std::vector<Hash160> block;
+        block.reserve(4096);
+        merge_unique(sources, [&](const Hash160& d) {
+            bloom.insert(d.data());
+            block.push_back(d);
+            if (block.size() == block.capacity()) {
+                write_or_throw(f, block.data(), block.size() * sizeof(Hash160), tmp);
+                block.clear();
+            }
+        });
+        write_or_throw(f, block.data(), block.size() * sizeof(Hash160), tmp);
+        if (std::fseek(f, sizeof(h), SEEK_SET) != 0) throw std::runtime_error("cannot seek " + tmp);
+        write_or_throw(f, bloom.data(), bloom.size_bytes(), tmp);
+    } catch (...) {
+        std::fclose(f);
+        std::remove(tmp.c_str());
+        throw;
+    }
+    if (std::fclose(f) != 0) throw std::runtime_error("cannot write " + tmp);
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) throw std::runtime_error("cannot rename " + tmp);
+    return records;
+}
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ';'; }
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+void write_target_index(const std::string& path, const TargetTable& table, unsigned bloom_bits) {
+    write_index(path, {Source{table.begin(), table.end()}}, bloom_bits);
+}
+
+TargetSet map_target_index(const std::string& path) {
+    MappedFile file(path);
+    TargetIndexHeader h;
+    if (file.size() < sizeof(h)) throw std::runtime_error(path + ": not a target index");
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, kTargetIndexMagic, sizeof(h.magic)) != 0) {
+        throw std::runtime_error(path + ": not a target index");
+    }
+    if (h.version != kTargetIndexVersion) throw std::runtime_error(path + ": unsupported target index version");
+    const u128 want = u128(sizeof(h)) + u128(h.bloom_lines) * sizeof(BloomLine) + u128(h.records) * sizeof(Hash160);
+    if (h.bloom_lines == 0 || want != file.size()) {
+        throw std::runtime_error(path + ": truncated or corrupt target index");
+    }
+    const size_t records_at = sizeof(h) + static_cast<size_t>(h.bloom_lines) * sizeof(BloomLine);
+    // The mapping does not move with the MappedFile, so the view stays valid.
+    BloomFilter bloom = BloomFilter::view(reinterpret_cast<const BloomLine*>(file.data() + sizeof(h)),
+                                          static_cast<size_t>(h.bloom_lines));
+    TargetTable table = TargetTable::in_file(std::move(file), records_at, static_cast<size_t>(h.records));
+    return TargetSet(std::move(table), std::move(bloom));
+}
+
+TargetLine parse_target_line(const char* line, size_t len, Hash160& out) {
+    size_t b = 0;
+    while (b < len && is_space(line[b])) ++b;
+    if (b == len || line[b] == '#') return TargetLine::Blank;
+    size_t e = b;
+    while (e < len && !is_space(line[e])) ++e;
+    const char* field = line + b;
+    const size_t n = e - b;
+    if (n == 2 * out.size()) {
+        bool hex = true;
+        for (size_t i = 0; i < out.size() && hex; ++i) {
+            int hi = hex_value(field[2 * i]), lo = hex_value(field[2 * i + 1]);
+            hex = hi >= 0 && lo >= 0;
+            out[i] = static_cast<uint8_t>(hi << 4 | lo);
+        }
+        if (hex) return TargetLine::Digest;
+    }
+    switch (decode_address(field, n, out.data())) {
+    case AddressStatus::Hash160:
+        return TargetLine::Digest;
+    case AddressStatus::Unsupported:
+        return TargetLine::Unsupported;
+    case AddressStatus::Invalid:
+        break;
+    }
+    return TargetLine::Invalid;
+}
+
+TargetIndexBuilder::TargetIndexBuilder(const std::string& tmp_dir, size_t memory_bytes)
+    : tmp_dir_(tmp_dir.empty() ? "." : tmp_dir), capacity_(std::max<size_t>(memory_bytes / sizeof(Hash160), 1)) {
+    // Reserved, not touched: pages are only committed as digests arrive.
+    buffer_.reserve(capacity_);
+}
+
+TargetIndexBuilder::~TargetIndexBuilder() {
+    for (const std::string& run : runs_) std::remove(run.c_str());
+}
+
+void TargetIndexBuilder::spill() {
+    runs_.push_back(tmp_dir_ + "/marauder-index." + std::to_string(::getpid()) + "." + std::to_string(runs_.size()) +
+                    ".run");
+    TargetTable::from_digests(std::move(buffer_)).write(runs_.back());
+    buffer_.clear();
+    buffer_.reserve(capacity_);
+}
+
+uint64_t TargetIndexBuilder::finish(const std::string& path, unsigned bloom_bits) {
+    uint64_t records;
+    if (runs_.empty()) {
+        TargetTable table = TargetTable::from_digests(std::move(buffer_));
+        records = write_index(path, {Source{table.begin(), table.end()}}, bloom_bits);
+    } else {
+        if (!buffer_.empty()) spill();
+        std::vector<TargetTable> runs;
+        std::vector<Source> sources;
+        for (const std::string& run : runs_) {
+            runs.push_back(TargetTable::map(run));
+            sources.push_back(Source{runs.back().begin(), runs.back().end()});
+        }
+        records = write_index(path, sources, bloom_bits);
+        runs.clear();
+        for (const std::string& run : runs_) std::remove(run.c_str());
+        runs_.clear();
+    }
+    buffer_.clear();
+    added_ = 0;
+    return records;
+}
+
+}  // namespace marauder
@@ -0,0 +1,33 @@
+#include "marauder/target_set.hpp"
+
+#include <utility>
+
+#include "marauder/bloom_kernel.hpp"
+
+namespace marauder {
+
+TargetSet::TargetSet(TargetTable table, unsigned bloom_bits_per_key)
+    : table_(std::move(table)), bloom_(table_.size(), bloom_bits_per_key) {
+    for (const Hash160& h : table_) bloom_.insert(h.data());
+}
+
+TargetSet::TargetSet(TargetTable table, BloomFilter bloom) : table_(std::move(table)), bloom_(std::move(bloom)) {}
+
+size_t TargetSet::prefilter(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* out) const {
+    static const BloomKernel& kernel = bloom_best();
+    return kernel.filter(bloom, digests, n, out);
+}
+
+size_t TargetSet::match(const BloomFilter& bloom, const uint8_t (*digests)[20], size_t n, uint32_t* hits,
+                        size_t* bloom_positives) const {
+    // The Bloom positives go to hits first and the table check compacts
+    // them in place.
+    size_t maybe = prefilter(bloom, digests, n, hits), found = 0;
+    for (size_t h = 0; h < maybe; ++h) {
+        if (table_.contains(digests[hits[h]])) hits[found++] = hits[h];
+    }
+    if (bloom_positives) *bloom_positives = maybe;
+    return found;
+}
+
+}  // namespace marauder
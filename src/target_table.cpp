@@ -0,0 +1,126 @@
+#include "marauder/target_table.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "marauder/encoding.hpp"
+#include "marauder/u256.hpp"
+
+namespace marauder {
+
+namespace {
+
+// Interpolation steps before falling back to bisection, so a skewed table
+// (hand-made, not digests) still costs O(log n).
+constexpr int kInterpolationSteps = 8;
+// Below this many records a lower_bound is cheaper than another probe.
+constexpr size_t kLinearTail = 16;
+
+uint64_t prefix(const uint8_t* d) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = v << 8 | d[i];
+    return v;
+}
+
+bool less(const Hash160& a, const Hash160& b) { return std::memcmp(a.data(), b.data(), 20) < 0; }
+
+}  // namespace
+
+TargetTable TargetTable::from_digests(std::vector<Hash160> digests) {
+    std::sort(digests.begin(), digests.end(), less);
+    digests.erase(std::unique(digests.begin(), digests.end()), digests.end());
+    TargetTable t;
+    t.owned_ = std::move(digests);
+    t.records_ = t.owned_.data();
+    t.count_ = t.owned_.size();
+    return t;
+}
+
+TargetTable TargetTable::map(const std::string& path) {
+    TargetTable t;
+    t.file_ = MappedFile(path);
+    if (t.file_.size() % sizeof(Hash160) != 0) {
+        throw std::runtime_error(path + ": size is not a multiple of 20 bytes");
+    }
+    t.records_ = reinterpret_cast<const Hash160*>(t.file_.data());
+    t.count_ = t.file_.size() / sizeof(Hash160);
+    return t;
+}
+
+TargetTable TargetTable::in_file(MappedFile file, size_t offset, size_t count) {
+    if (offset > file.size() || count > (file.size() - offset) / sizeof(Hash160)) {
+        throw std::runtime_error("target records lie outside their file");
+    }
+    TargetTable t;
+    t.file_ = std::move(file);
+    t.records_ = reinterpret_cast<const Hash160*>(t.file_.data() + offset);
+    t.count_ = count;
+    return t;
+}
+
+void TargetTable::write(const std::string& path) const {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("cannot open " + path);
+    bool ok = std::fwrite(records_, sizeof(Hash160), count_, f) == count_;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) throw std::runtime_error("cannot write " + path);
+}
+
+bool TargetTable::contains(const uint8_t digest[20]) const {
+    if (count_ == 0) return false;
+    const uint64_t key = prefix(digest);
+    size_t lo = 0, hi = count_ - 1;
+    uint64_t klo = prefix(records_[lo].data()), khi = prefix(records_[hi].data());
+    for (int step = 0; hi - lo >= kLinearTail; ++step) {
+        if (key < klo || key > khi) return false;
+        size_t mid;
+        if (step < kInterpolationSteps && khi > klo) {
+            mid = lo + static_cast<size_t>(static_cast<u128>(key - klo) * (hi - lo) / (khi - klo));
+        } else {
+            mid = lo + (hi - lo) / 2;
+        }
+        uint64_t kmid = prefix(records_[mid].data());
+        if (kmid < key) {
+            lo = mid + 1;
+            klo = prefix(records_[lo].data());
+        } else if (kmid > key) {
+            hi = mid - 1;
+            khi = prefix(records_[hi].data());
+        } else {
+            // Records sharing the prefix are adjacent; widen to them.
+            lo = hi = mid;
+            while (lo > 0 && prefix(records_[lo - 1].data()) == key) --lo;
+            while (hi + 1 < count_ && prefix(records_[hi + 1].data()) == key) ++hi;
+            break;
+        }
+    }
+    Hash160 want;
+    std::memcpy(want.data(), digest, 20);
+    const Hash160* it = std::lower_bound(records_ + lo, records_ + hi + 1, want, less);
+    return it != records_ + hi + 1 && *it == want;
+}
+
+std::vector<Hash160> read_hash160_list(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    std::vector<Hash160> out;
+    std::string line;
+    for (size_t lineno = 1; std::getline(in, line); ++lineno) {
+        size_t b = line.find_first_not_of(" \t\r");
+        if (b == std::string::npos || line[b] == '#') continue;
+        size_t e = line.find_last_not_of(" \t\r");
+        Hash160 h;
+        try {
+            hex_to_bytes(line.substr(b, e - b + 1), h.data(), h.size());
+        } catch (const std::invalid_argument& err) {
+            throw std::invalid_argument(path + ":" + std::to_string(lineno) + ": " + err.what());
+        }
+        out.push_back(h);
+    }
+    return out;
+}
+
+}  // namespace marauder
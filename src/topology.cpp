@@ -0,0 +1,116 @@
+#include "marauder/topology.hpp"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace marauder {
+
+namespace {
+
+std::vector<unsigned> allowed_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<unsigned> cpus;
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (unsigned c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+}  // namespace
+
+std::vector<unsigned> parse_cpu_list(const std::string& text) {
+    std::vector<unsigned> cpus;
+    size_t i = 0;
+    auto number = [&]() -> unsigned {
+        size_t start = i;
+        unsigned long v = 0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') v = v * 10 + (text[i++] - '0');
+        if (i == start || v >= CPU_SETSIZE) throw std::invalid_argument("bad CPU list '" + text + "'");
+        return static_cast<unsigned>(v);
+    };
+    while (i < text.size() && text[i] != '\n') {
+        unsigned lo = number(), hi = lo;
+        if (i < text.size() && text[i] == '-') {
+            ++i;
+            hi = number();
+            if (hi < lo) throw std::invalid_argument("bad CPU list '" + text + "'");
+        }
+        for (unsigned c = lo; c <= hi; ++c) cpus.push_back(c);
+        if (i < text.size() && text[i] == ',') ++i;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+CpuTopology read_cpu_topology(const std::string& sysfs_node_dir, const std::vector<unsigned>& allowed) {
+    std::vector<std::pair<unsigned, std::vector<unsigned>>> found;
+    if (DIR* dir = ::opendir(sysfs_node_dir.c_str())) {
+        while (dirent* e = ::readdir(dir)) {
+            const char* name = e->d_name;
+            if (std::strncmp(name, "node", 4) != 0 || name[4] < '0' || name[4] > '9') continue;
+            std::ifstream in(sysfs_node_dir + "/" + name + "/cpulist");
+            std::string line;
+            if (!std::getline(in, line)) continue;
+            found.emplace_back(static_cast<unsigned>(std::stoul(name + 4)), parse_cpu_list(line));
+        }
+        ::closedir(dir);
+    }
+    std::sort(found.begin(), found.end());
+
+    CpuTopology topo;
+    std::vector<unsigned> placed;
+    for (auto& [id, cpus] : found) {
+        std::vector<unsigned> keep;
+        for (unsigned c : cpus) {
+            if (allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), c)) keep.push_back(c);
+        }
+        placed.insert(placed.end(), keep.begin(), keep.end());
+        if (!keep.empty()) topo.nodes.push_back(std::move(keep));
+    }
+    // CPUs sysfs does not place (or no sysfs at all) go to the first node.
+    std::sort(placed.begin(), placed.end());
+    for (unsigned c : allowed) {
+        if (std::binary_search(placed.begin(), placed.end(), c)) continue;
+        if (topo.nodes.empty()) topo.nodes.emplace_back();
+        topo.nodes[0].push_back(c);
+    }
+    if (topo.nodes.empty()) topo.nodes.push_back({0});
+    for (auto& n : topo.nodes) std::sort(n.begin(), n.end());
+    return topo;
+}
+
+const CpuTopology& cpu_topology() {
+    static const CpuTopology topo = read_cpu_topology("/sys/devices/system/node", allowed_cpus());
+    return topo;
+}
+
+std::vector<WorkerPlacement> place_workers(const CpuTopology& topo, unsigned workers) {
+    std::vector<WorkerPlacement> out;
+    const unsigned nodes = static_cast<unsigned>(topo.nodes.size());
+    for (unsigned w = 0; w < workers; ++w) {
+        unsigned node = w % nodes;
+        const std::vector<unsigned>& cpus = topo.nodes[node];
+        out.push_back(WorkerPlacement{cpus[(w / nodes) % cpus.size()], node});
+    }
+    return out;
+}
+
+void pin_current_thread(unsigned cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    if (rc != 0) throw std::runtime_error("cannot pin thread to CPU " + std::to_string(cpu) + ": " + std::strerror(rc));
+}
+
+}  // namespace marauder
@@ -0,0 +1,70 @@
+#include "marauder/u256.hpp"
+
+#include <stdexcept>
+
+namespace marauder {
+
+namespace {
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+U256 U256::from_hex(const std::string& hex) {
+    size_t pos = 0;
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) pos = 2;
+    size_t digits = hex.size() - pos;
+    if (digits == 0 || digits > 64) {
+        throw std::invalid_argument("expected 1 to 64 hex digits: '" + hex + "'");
+    }
+    U256 r = zero();
+    for (size_t i = 0; i < digits; ++i) {
+        int v = hex_value(hex[hex.size() - 1 - i]);
+        if (v < 0) throw std::invalid_argument("invalid hex digit in '" + hex + "'");
+        r.d[i / 16] |= (uint64_t)v << (4 * (i % 16));
+    }
+    return r;
+}
+
+U256 U256::from_be_bytes(const uint8_t in[32]) {
+    U256 r;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t v = 0;
+        for (int j = 0; j < 8; ++j) v = (v << 8) | in[(3 - i) * 8 + j];
+        r.d[i] = v;
+    }
+    return r;
+}
+
+std::string U256::to_hex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(64, '0');
+    for (int i = 0; i < 64; ++i) {
+        out[63 - i] = digits[(d[i / 16] >> (4 * (i % 16))) & 0xF];
+    }
+    return out;
+}
+
+void U256::to_be_bytes(uint8_t out[32]) const {
+    for (int i = 0; i < 4; ++i) {
+        uint64_t v = d[3 - i];
+        for (int j = 7; j >= 0; --j) {
+            out[i * 8 + j] = (uint8_t)v;
+            v >>= 8;
+        }
+    }
+}
+
+unsigned U256::bit_length() const {
+    for (int i = 3; i >= 0; --i) {
+        if (d[i]) return (unsigned)(64 * i + 64 - __builtin_clzll(d[i]));
+    }
+    return 0;
+}
+
+}  // namespace marauder
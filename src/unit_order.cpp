@@ -0,0 +1,132 @@
+#include "marauder/unit_order.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace marauder {
+
+namespace {
+
+// splitmix64's finaliser: a cheap, well-mixed round function.
+uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+bool parse_u64(const std::string& text, int base, uint64_t& out) {
+    if (text.empty()) return false;
+    uint64_t v = 0;
+    for (char c : text) {
+        unsigned d;
+        if (c >= '0' && c <= '9') {
+            d = c - '0';
+        } else if (base == 16 && c >= 'a' && c <= 'f') {
+            d = c - 'a' + 10;
+        } else if (base == 16 && c >= 'A' && c <= 'F') {
+            d = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        if (v > (UINT64_MAX - d) / base) return false;
+        v = v * base + d;
+    }
+    out = v;
+    return true;
+}
+
+}  // namespace
+
+std::string UnitOrder::name() const {
+    char buf[64];
+    switch (mode) {
+        case UnitOrderMode::Sequential:
+            return "sequential";
+        case UnitOrderMode::Random:
+            std::snprintf(buf, sizeof(buf), "random:%016llx", (unsigned long long)seed);
+            return buf;
+        case UnitOrderMode::Strided:
+            std::snprintf(buf, sizeof(buf), "strided:%llu/%llu", (unsigned long long)node,
+                          (unsigned long long)nodes);
+            return buf;
+    }
+    return "unknown";
+}
+
+UnitOrder parse_unit_order(const std::string& text) {
+    if (text == "sequential") return UnitOrder();
+    const std::string random = "random:", strided = "strided:";
+    if (text.compare(0, random.size(), random) == 0) {
+        std::string hex = text.substr(random.size());
+        if (hex.compare(0, 2, "0x") == 0) hex = hex.substr(2);
+        uint64_t seed;
+        if (hex.size() <= 16 && parse_u64(hex, 16, seed)) return UnitOrder::random(seed);
+    } else if (text.compare(0, strided.size(), strided) == 0) {
+        std::string spec = text.substr(strided.size());
+        size_t slash = spec.find('/');
+        uint64_t node, nodes;
+        if (slash != std::string::npos && parse_u64(spec.substr(0, slash), 10, node) &&
+            parse_u64(spec.substr(slash + 1), 10, nodes) && node < nodes) {
+            return UnitOrder::strided(node, nodes);
+        }
+    }
+    throw std::invalid_argument("unknown unit order '" + text + "' (sequential, random:SEED or strided:K/N)");
+}
+
+UnitPermutation::UnitPermutation(const UnitOrder& order, uint64_t units) : order_(order), units_(units) {
+    switch (order.mode) {
+        case UnitOrderMode::Sequential:
+            size_ = units;
+            break;
+        case UnitOrderMode::Random: {
+            size_ = units;
+            unsigned bits = 0;
+            while (units > 1 && (units - 1) >> bits) ++bits;
+            half_bits_ = bits < 2 ? 1 : (bits + 1) / 2;
+            uint64_t state = order.seed;
+            for (uint64_t& k : keys_) {
+                state += 0x9E3779B97F4A7C15ULL;
+                k = mix(state);
+            }
+            break;
+        }
+        case UnitOrderMode::Strided:
+            if (order.nodes == 0 || order.node >= order.nodes) {
+                throw std::invalid_argument("strided order needs node < nodes");
+            }
+            size_ = units > order.node ? (units - order.node - 1) / order.nodes + 1 : 0;
+            break;
+    }
+}
+
+uint64_t UnitPermutation::feistel(uint64_t x) const {
+    const uint64_t mask = (uint64_t(1) << half_bits_) - 1;
+    uint64_t left = x >> half_bits_, right = x & mask;
+    for (uint64_t k : keys_) {
+        uint64_t next = left ^ (mix(right ^ k) & mask);
+        left = right;
+        right = next;
+    }
+    return left << half_bits_ | right;
+}
+
+uint64_t UnitPermutation::operator()(uint64_t position) const {
+    switch (order_.mode) {
+        case UnitOrderMode::Sequential:
+            return position;
+        case UnitOrderMode::Random: {
+            // The domain is under 4 * units, so this takes under 4 rounds on
+            // average, and it ends: the cycle through position holds it.
+            uint64_t x = position;
+            do {
+                x = feistel(x);
+            } while (x >= units_);
+            return x;
+        }
+        case UnitOrderMode::Strided:
+            return position * order_.nodes + order_.node;
+    }
+    return position;
+}
+
+}  // namespace marauder
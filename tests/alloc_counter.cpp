@@ -0,0 +1,29 @@
+// Counting replacements for the two allocating forms of operator new, so
+// the suite can check that scan workers stay off the heap. They live in
+// the test binary rather than libmarauder, whose hosts keep their own
+// allocator. The array and nothrow forms call these, and the default
+// operator delete frees either.
+#include <cstdlib>
+#include <new>
+
+#include "marauder/arena.hpp"
+
+namespace {
+
+const bool kCounting = (marauder::enable_allocation_counting(), true);
+
+}  // namespace
+
+void* operator new(std::size_t n) {
+    marauder::note_allocation();
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n, std::align_val_t al) {
+    marauder::note_allocation();
+    // aligned_alloc wants a non-zero multiple of the alignment.
+    size_t a = static_cast<size_t>(al);
+    if (void* p = std::aligned_alloc(a, n ? (n + a - 1) / a * a : a)) return p;
+    throw std::bad_alloc();
+}
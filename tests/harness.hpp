@@ -0,0 +1,44 @@
+// Minimal self-registering test harness.
+//
+// Each TEST(name) body runs once; CHECK failures are counted and reported
+// but do not abort the test. Tests that produce oracle data write it through
+// test_log(), which lands in test_output.txt in the working directory.
+#pragma once
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace marauder_test {
+
+using TestFn = void (*)();
+
+struct Registrar {
+    Registrar(const char* name, TestFn fn);
+};
+
+void record_failure(const char* file, int line, const std::string& what);
+std::ostream& test_log();
+
+}  // namespace marauder_test
+
+#define TEST(name)                                                    \
+    static void test_##name();                                        \
+    static ::marauder_test::Registrar registrar_##name(#name, test_##name); \
+    static void test_##name()
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) ::marauder_test::record_failure(__FILE__, __LINE__, #cond); \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+    do {                                                                       \
+        const auto& check_a_ = (a);                                            \
+        const auto& check_b_ = (b);                                            \
+        if (!(check_a_ == check_b_)) {                                         \
+            std::ostringstream check_msg_;                                     \
+            check_msg_ << #a " == " #b " (" << check_a_ << " vs " << check_b_ << ")"; \
+            ::marauder_test::record_failure(__FILE__, __LINE__, check_msg_.str()); \
+        }                                                                      \
+    } while (0)
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <vector>
+
+#include "harness.hpp"
+
+namespace marauder_test {
+
+namespace {
+
+struct Entry {
+    const char* name;
+    TestFn fn;
+};
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> tests;
+    return tests;
+}
+
+int g_failures = 0;
+std::ofstream g_log;
+
+}  // namespace
+
+Registrar::Registrar(const char* name, TestFn fn) { registry().push_back({name, fn}); }
+
+void record_failure(const char* file, int line, const std::string& what) {
+    ++g_failures;
+    std::fprintf(stderr, "  %s:%d: CHECK failed: %s\n", file, line, what.c_str());
+}
+
+std::ostream& test_log() { return g_log; }
+
+}  // namespace marauder_test
+
+// Usage: marauder-tests [filter]. Runs every test whose name contains filter.
+int main(int argc, char** argv) {
+    using namespace marauder_test;
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    g_log.open("test_output.txt", std::ios::trunc);
+
+    int failed_tests = 0, run = 0;
+    for (const Entry& t : registry()) {
+        if (filter && !std::strstr(t.name, filter)) continue;
+        ++run;
+        int before = g_failures;
+        g_log << "## " << t.name << "\n";
+        try {
+            t.fn();
+        } catch (const std::exception& e) {
+            record_failure(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        bool ok = g_failures == before;
+        if (!ok) ++failed_tests;
+        std::printf("[%s] %s\n", ok ? " OK " : "FAIL", t.name);
+    }
+    std::printf("%d/%d tests passed\n", run - failed_tests, run);
+    return failed_tests == 0 ? 0 : 1;
+}
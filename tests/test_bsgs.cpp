@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/bsgs.hpp"
+#include "marauder/point.hpp"
+#include "marauder/scalar.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+const char* const kPath = "test_bsgs.tmp";
+
+Point pub_of(const U256& k) { return point_mul_g(Scalar::from_u256(k)); }
+
+template <class Fn>
+bool throws_runtime(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+// The mapped table answers for every baby step, and keys anywhere in a range
+// (both ends, both signs of the baby step) come back from the giant walk.
+TEST(bsgs_table_and_solve) {
+    const uint64_t m = 5000;
+    BsgsTable::build(kPath, m, 3);
+    BsgsTable table = BsgsTable::map(kPath);
+    CHECK_EQ(table.baby_steps(), m);
+    for (uint64_t j : {uint64_t(1), uint64_t(2), uint64_t(2500), m}) {
+        Point p = pub_of(U256::from_u64(j));
+        uint64_t got[4];
+        CHECK(table.maybe_contains(p.x));
+        CHECK(table.find(p.x, got, 4) == 1 && got[0] == j);
+    }
+    uint64_t none[4];
+    CHECK_EQ(table.find(pub_of(U256::from_u64(m + 1)).x, none, 4), size_t(0));
+
+    const U256 start = U256::from_hex("0x3c0000000");
+    const U256 end = U256::from_hex("0x3d0000000");  // 2^28 keys, ~26844 giant steps
+    BsgsConfig cfg;
+    cfg.threads = 2;
+    cfg.lanes = 256;
+    for (const char* k : {"0x3c0000000", "0x3c0001388", "0x3c0002711", "0x3c9abcdef", "0x3cfffffff"}) {
+        U256 key = U256::from_hex(k);
+        BsgsResult r = bsgs_solve(pub_of(key), start, end, table, cfg);
+        CHECK(r.found && r.key == key);
+        test_log() << "bsgs " << k << ": " << r.giant_steps << " giant steps, " << r.bloom_passes
+                   << " Bloom passes\n";
+    }
+    BsgsResult miss = bsgs_solve(pub_of(U256::from_hex("0x3d0000000")), start, end, table, cfg);
+    CHECK(!miss.found);
+    CHECK_EQ(miss.giant_steps, uint64_t((0x10000000 + 2 * m) / (2 * m + 1)));
+    std::remove(kPath);
+}
+
+// Keys are x truncated to 64 bits, so equal keys can happen; find returns
+// every baby step with the key, wherever the search first lands among them.
+TEST(bsgs_find_returns_every_equal_key) {
+    const uint64_t m = 5000;
+    BsgsTable::build(kPath, m);
+    std::string bytes;
+    {
+        std::ifstream in(kPath, std::ios::binary);
+        bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    BsgsHeader h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    char* keys = &bytes[sizeof(h) + h.bloom_lines * sizeof(BloomLine)];
+    const char* steps = keys + h.records * sizeof(uint64_t);
+    auto key_at = [&](size_t i) {
+        uint64_t k;
+        std::memcpy(&k, keys + 8 * i, 8);
+        return k;
+    };
+    // Give the 40 records sorted before j = 2500's its key; they stay sorted.
+    const Fe x = pub_of(U256::from_u64(2500)).x;
+    size_t slot = 0;
+    while (key_at(slot) != x.d[0]) ++slot;
+    CHECK(slot >= 40);
+    std::vector<uint64_t> want{2500};
+    for (size_t i = slot - 40; i < slot; ++i) {
+        uint32_t j;
+        std::memcpy(&j, steps + 4 * i, 4);
+        want.push_back(j);
+        std::memcpy(keys + 8 * i, &x.d[0], 8);
+    }
+    {
+        std::ofstream out(kPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+    BsgsTable table = BsgsTable::map(kPath);
+    uint64_t got[64];
+    size_t n = table.find(x, got, 64);
+    CHECK_EQ(n, want.size());
+    std::vector<uint64_t> found(got, got + n);
+    std::sort(found.begin(), found.end());
+    std::sort(want.begin(), want.end());
+    CHECK(found == want);
+    std::remove(kPath);
+}
+
+TEST(bsgs_rejects_bad_tables) {
+    {
+        std::ofstream f(kPath, std::ios::binary);
+        f << "definitely not a table, but longer than a header................................";
+    }
+    CHECK(throws_runtime([] { BsgsTable::map(kPath); }));
+    BsgsTable::build(kPath, 100);
+    {
+        // Drop the last record.
+        std::ifstream in(kPath, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(kPath, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 12);
+    }
+    CHECK(throws_runtime([] { BsgsTable::map(kPath); }));
+    std::remove(kPath);
+
+    bool threw = false;
+    try {
+        BsgsTable::build(kPath, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
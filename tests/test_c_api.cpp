@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/c_api.h"
+#include "marauder/hash.hpp"
+#include "marauder/point.hpp"
+#include "marauder/target_table.hpp"
+#include "marauder/u256.hpp"
+
+using namespace marauder;
+
+namespace {
+
+Hash160 digest_of(uint64_t key) {
+    uint8_t pub[33];
+    serialize_compressed(point_mul_g(Scalar::from_u64(key)), pub);
+    Hash160 d;
+    hash160(pub, sizeof(pub), d.data());
+    return d;
+}
+
+struct Key {
+    uint8_t be[32];
+    explicit Key(uint64_t v) { U256::from_u64(v).to_be_bytes(be); }
+};
+
+}  // namespace
+
+// A searcher run through the C ABI finds what scan_range would, reports
+// progress, hands its hits out in caller-sized batches and can be reused.
+TEST(c_api_scans_and_fetches_hits) {
+    CHECK_EQ(marauder_abi_version(), uint32_t(MARAUDER_ABI_VERSION));
+    std::vector<Hash160> digests{digest_of(0x51234), digest_of(0x52345), digest_of(0x60001)};
+    marauder_config cfg{};
+    cfg.threads = 2;
+    cfg.unit_bits = 12;
+    cfg.digests = digests[0].data();
+    cfg.digest_count = digests.size();
+    char err[256] = "";
+    marauder_searcher* s = marauder_searcher_create(&cfg, err, sizeof(err));
+    CHECK(s != nullptr);
+    if (!s) return;
+
+    marauder_progress p;
+    marauder_searcher_poll(s, &p);
+    CHECK_EQ(p.state, uint32_t(MARAUDER_IDLE));
+    CHECK_EQ(marauder_searcher_wait(s, err, sizeof(err)), int(MARAUDER_OK));
+
+    CHECK_EQ(marauder_searcher_submit(s, Key(0x50000).be, Key(0x58000).be, err, sizeof(err)), int(MARAUDER_OK));
+    CHECK_EQ(marauder_searcher_submit(s, Key(0x50000).be, Key(0x58000).be, err, sizeof(err)), int(MARAUDER_BUSY));
+    marauder_searcher_poll(s, &p);
+    CHECK(p.state == MARAUDER_RUNNING || p.state == MARAUDER_FINISHED);
+    CHECK_EQ(p.units_total, uint64_t(8));
+    CHECK_EQ(marauder_searcher_wait(s, err, sizeof(err)), int(MARAUDER_OK));
+    marauder_searcher_poll(s, &p);
+    CHECK_EQ(p.state, uint32_t(MARAUDER_FINISHED));
+    CHECK_EQ(p.keys, uint64_t(0x8000));
+    CHECK_EQ(p.units_done, uint64_t(8));
+    CHECK_EQ(p.hits, uint64_t(2));
+    CHECK_EQ(p.hits_pending, uint64_t(2));
+
+    marauder_hit hits[2];
+    CHECK_EQ(marauder_searcher_fetch_hits(s, hits, 1), size_t(1));
+    CHECK_EQ(marauder_searcher_fetch_hits(s, hits + 1, 2), size_t(1));
+    CHECK_EQ(marauder_searcher_fetch_hits(s, hits, 2), size_t(0));
+    uint64_t found[2];
+    for (int i = 0; i < 2; ++i) {
+        U256 key = U256::from_be_bytes(hits[i].key);
+        found[i] = key.d[0];
+        Hash160 d = digest_of(found[i]);
+        CHECK(std::memcmp(hits[i].digest, d.data(), 20) == 0);
+        CHECK(hits[i].pubkey[0] == 2 || hits[i].pubkey[0] == 3);
+    }
+    CHECK((found[0] == 0x51234 && found[1] == 0x52345) || (found[0] == 0x52345 && found[1] == 0x51234));
+
+    // The same searcher takes another range; a cancelled scan still ends.
+    CHECK_EQ(marauder_searcher_submit(s, Key(0x60000).be, Key(0x61000).be, err, sizeof(err)), int(MARAUDER_OK));
+    CHECK_EQ(marauder_searcher_wait(s, err, sizeof(err)), int(MARAUDER_OK));
+    CHECK_EQ(marauder_searcher_fetch_hits(s, hits, 2), size_t(1));
+    CHECK_EQ(U256::from_be_bytes(hits[0].key).d[0], uint64_t(0x60001));
+    CHECK_EQ(marauder_searcher_submit(s, Key(1).be, Key(uint64_t(1) << 40).be, err, sizeof(err)), int(MARAUDER_OK));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    marauder_searcher_cancel(s);
+    CHECK_EQ(marauder_searcher_wait(s, err, sizeof(err)), int(MARAUDER_OK));
+    marauder_searcher_poll(s, &p);
+    CHECK(p.units_done < p.units_total);
+    marauder_searcher_destroy(s);
+}
+
+TEST(c_api_reports_errors) {
+    std::vector<Hash160> digests{digest_of(5)};
+    char err[256] = "";
+    marauder_config cfg{};
+    CHECK(marauder_searcher_create(&cfg, err, sizeof(err)) == nullptr);
+    CHECK(std::strstr(err, "exactly one") != nullptr);
+    cfg.table_path = "test_c_api_missing.tmp";
+    CHECK(marauder_searcher_create(&cfg, err, sizeof(err)) == nullptr);
+
+    cfg.table_path = nullptr;
+    cfg.digests = digests[0].data();
+    cfg.digest_count = 1;
+    cfg.batch_size = 3;
+    CHECK(marauder_searcher_create(&cfg, err, sizeof(err)) == nullptr);
+    CHECK(std::strstr(err, "batch size") != nullptr);
+
+    cfg.batch_size = 0;
+    marauder_searcher* s = marauder_searcher_create(&cfg, err, sizeof(err));
+    CHECK(s != nullptr);
+    if (!s) return;
+    CHECK_EQ(marauder_searcher_submit(s, Key(9).be, Key(8).be, err, sizeof(err)), int(MARAUDER_ERROR));
+    CHECK(std::strstr(err, "past its end") != nullptr);
+    CHECK_EQ(marauder_searcher_submit(s, Key(0).be, Key(8).be, err, sizeof(err)), int(MARAUDER_ERROR));
+    marauder_progress p;
+    marauder_searcher_poll(s, &p);
+    CHECK_EQ(p.state, uint32_t(MARAUDER_IDLE));
+    marauder_searcher_destroy(s);
+}
@@ -0,0 +1,231 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/arena.hpp"
+#include "marauder/checkpoint.hpp"
+#include "marauder/interval_set.hpp"
+#include "marauder/scan.hpp"
+
+using namespace marauder;
+
+namespace {
+
+const char* const kPath = "test_checkpoint.tmp";
+
+bool file_exists(const std::string& path) { return std::ifstream(path).good(); }
+
+template <class Fn>
+bool throws_runtime(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(interval_set_merges) {
+    IntervalSet s;
+    for (uint64_t u : {5, 3, 4, 9, 0, 10, 1}) s.insert(u);
+    CHECK_EQ(s.count(), uint64_t(7));
+    CHECK_EQ(s.intervals(), size_t(3));  // [0,2) [3,6) [9,11)
+    CHECK(s.contains(4) && !s.contains(2) && !s.contains(11));
+    s.insert(UnitSpan{2, 9});
+    CHECK_EQ(s.intervals(), size_t(1));
+    CHECK_EQ(s.count(), uint64_t(11));
+    s.insert(UnitSpan{4, 6});  // already covered
+    CHECK_EQ(s.count(), uint64_t(11));
+
+    IntervalSet t;
+    t.insert(UnitSpan{2, 4});
+    t.insert(UnitSpan{6, 7});
+    std::vector<UnitSpan> g = t.gaps(10);
+    CHECK_EQ(g.size(), size_t(3));
+    CHECK(g[0].lo == 0 && g[0].hi == 2 && g[1].lo == 4 && g[1].hi == 6 && g[2].lo == 7 && g[2].hi == 10);
+    CHECK_EQ(t.gaps(3).size(), size_t(1));
+}
+
+TEST(checkpoint_round_trip) {
+    const U256 start = U256::from_hex("0x20000000000000000");
+    const U256 end = U256::from_hex("0x3ffffffffffffffff");
+    std::remove(kPath);
+    {
+        Checkpoint cp(kPath, start, end, 32, std::chrono::milliseconds(5));
+        CHECK(cp.resumed().empty());
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < 4; ++t) {
+            threads.emplace_back([&cp, t] {
+                for (uint64_t u = t * 1000; u < t * 1000 + 900; ++u) cp.mark_done(u);
+            });
+        }
+        for (std::thread& t : threads) t.join();
+        // Let the background writer run at least once before the final flush.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cp.close();
+        cp.close();
+    }
+    CHECK(!file_exists(std::string(kPath) + ".tmp"));
+    IntervalSet got = Checkpoint::load(kPath, start, end, 32);
+    CHECK_EQ(got.count(), uint64_t(3600));
+    CHECK_EQ(got.intervals(), size_t(4));
+    {
+        Checkpoint again(kPath, start, end, 32);
+        CHECK(again.resumed() == got);
+        again.mark_done(950);
+    }
+    CHECK_EQ(Checkpoint::load(kPath, start, end, 32).count(), uint64_t(3601));
+
+    CHECK(throws_runtime([&] { Checkpoint::load(kPath, start, end, 31); }));
+    CHECK(throws_runtime([&] { Checkpoint::load(kPath, U256::from_u64(1), end, 32); }));
+    // A torn file (no end marker) is rejected rather than half-trusted.
+    {
+        std::ifstream in(kPath);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(kPath, std::ios::trunc) << text.substr(0, text.size() - 4);
+    }
+    CHECK(throws_runtime([&] { Checkpoint::load(kPath, start, end, 32); }));
+    std::remove(kPath);
+}
+
+// A resumed scan covers exactly the units the checkpoint lacks and leaves a
+// checkpoint of the whole range.
+TEST(scan_resumes_from_checkpoint) {
+    const U256 start = U256::from_hex("0x90000");
+    const U256 end = U256::from_hex("0x90c00");  // 12 units of 256 keys
+    std::remove(kPath);
+    {
+        Checkpoint cp(kPath, start, end, 8);
+        for (uint64_t u : {0, 1, 2, 3, 7}) cp.mark_done(u);
+    }
+
+    Checkpoint cp(kPath, start, end, 8);
+    ScanConfig cfg;
+    cfg.threads = 3;
+    cfg.unit_bits = 8;
+    cfg.walker.batch_size = 128;
+    cfg.report_all = true;
+    cfg.checkpoint = &cp;
+    std::set<std::string> keys;
+    ScanStats stats = scan_range(start, end, cfg, [&](const ScanHit& h) { keys.insert(h.key.to_hex()); });
+    cp.close();
+
+    CHECK_EQ(stats.units, uint64_t(7));
+    CHECK_EQ(stats.skipped, uint64_t(5));
+    CHECK_EQ(keys.size(), size_t(7 * 256));
+    CHECK(keys.count(U256::from_hex("0x90400").to_hex()) != 0);   // unit 4
+    CHECK(keys.count(U256::from_hex("0x90700").to_hex()) == 0);   // unit 7, done before
+    CHECK(keys.count(U256::from_hex("0x903ff").to_hex()) == 0);   // unit 3, done before
+    IntervalSet all = Checkpoint::load(kPath, start, end, 8);
+    CHECK_EQ(all.count(), uint64_t(12));
+    CHECK_EQ(all.intervals(), size_t(1));
+
+    Checkpoint other(kPath, start, end, 8);
+    cfg.unit_bits = 9;
+    cfg.checkpoint = &other;
+    bool threw = false;
+    try {
+        scan_range(start, end, cfg, [](const ScanHit&) {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    other.close();
+    std::remove(kPath);
+}
+
+// In a random order the checkpoint holds positions, so an interrupted scan
+// leaves a few intervals however scattered its units are, and resuming
+// finishes exactly the units it had not reached.
+TEST(scan_resumes_random_order) {
+    const U256 start = U256::from_hex("0xa0000");
+    const U256 end = U256::from_hex("0xa4000");  // 64 units of 256 keys
+    const UnitOrder order = UnitOrder::random(0x5eed);
+    const UnitPermutation perm(order, 64);
+    std::remove(kPath);
+    {
+        Checkpoint cp(kPath, start, end, 8, std::chrono::seconds(60), order);
+        for (uint64_t p = 0; p < 20; ++p) cp.mark_done(p);
+    }
+    CHECK_EQ(Checkpoint::load(kPath, start, end, 8, order).intervals(), size_t(1));
+    CHECK(throws_runtime([&] { Checkpoint::load(kPath, start, end, 8); }));
+    CHECK(throws_runtime([&] { Checkpoint::load(kPath, start, end, 8, UnitOrder::random(0x5eee)); }));
+
+    Checkpoint cp(kPath, start, end, 8, std::chrono::seconds(60), order);
+    ScanConfig cfg;
+    cfg.threads = 3;
+    cfg.unit_bits = 8;
+    cfg.walker.batch_size = 128;
+    cfg.report_all = true;
+    cfg.order = order;
+    cfg.checkpoint = &cp;
+    std::set<uint64_t> units;
+    ScanStats stats = scan_range(start, end, cfg, [&](const ScanHit& h) {
+        U256 off;
+        u256_sub(off, h.key, start);
+        units.insert(off.d[0] >> 8);
+    });
+    cp.close();
+    CHECK_EQ(stats.units, uint64_t(44));
+    CHECK_EQ(stats.skipped, uint64_t(20));
+    std::set<uint64_t> want;
+    for (uint64_t p = 20; p < 64; ++p) want.insert(perm(p));
+    CHECK(units == want);
+    IntervalSet all = Checkpoint::load(kPath, start, end, 8, order);
+    CHECK_EQ(all.count(), uint64_t(64));
+    CHECK_EQ(all.intervals(), size_t(1));
+
+    Checkpoint sequential(kPath, start, end, 8, std::chrono::seconds(60), order);
+    cfg.order = UnitOrder();
+    cfg.checkpoint = &sequential;
+    bool threw = false;
+    try {
+        scan_range(start, end, cfg, [](const ScanHit&) {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    sequential.close();
+    std::remove(kPath);
+}
+
+// A marker recycles its few nodes through the writer's drains, so marking
+// allocates nothing however far it outruns the file writes, and a scan
+// worker (which throws if a warm unit allocates) checkpoints every unit.
+TEST(checkpoint_markers_do_not_allocate) {
+    const U256 start = U256::from_hex("0xb0000");
+    const U256 end = U256::from_hex("0xb8000");  // 512 units of 64 keys
+    std::remove(kPath);
+    CHECK(counting_allocations());
+    {
+        Checkpoint cp(kPath, start, end, 6);
+        Checkpoint::Marker marker(cp, 2);
+        uint64_t before = thread_allocations();
+        for (uint64_t p = 0; p < 100; ++p) marker.mark_done(p);
+        CHECK_EQ(thread_allocations(), before);
+        cp.flush();
+        CHECK_EQ(Checkpoint::load(kPath, start, end, 6).count(), uint64_t(100));
+    }
+
+    Checkpoint cp(kPath, start, end, 6);
+    ScanConfig cfg;
+    cfg.threads = 2;
+    cfg.unit_bits = 6;
+    cfg.walker.batch_size = 64;
+    cfg.checkpoint = &cp;
+    ScanStats stats = scan_range(start, end, cfg, [](const ScanHit&) {});
+    cp.close();
+    CHECK_EQ(stats.units, uint64_t(412));
+    IntervalSet all = Checkpoint::load(kPath, start, end, 6);
+    CHECK_EQ(all.count(), uint64_t(512));
+    CHECK_EQ(all.intervals(), size_t(1));
+    std::remove(kPath);
+}
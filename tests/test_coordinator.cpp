@@ -0,0 +1,330 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/coord_client.hpp"
+#include "marauder/coord_protocol.hpp"
+#include "marauder/coord_server.hpp"
+#include "marauder/coordinator.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/point.hpp"
+#include "marauder/target_set.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+using Clock = Coordinator::Clock;
+
+template <class Fn>
+bool throws_runtime(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+Frame frame_of(std::vector<uint8_t> bytes) {
+    Frame f;
+    bool whole = take_frame(bytes, f);
+    CHECK(whole && bytes.empty());
+    return f;
+}
+
+uint64_t units_in(const std::vector<UnitSpan>& spans) {
+    uint64_t n = 0;
+    for (const UnitSpan& s : spans) n += s.hi - s.lo;
+    return n;
+}
+
+Hash160 digest_of(const U256& key, bool uncompressed = false) {
+    uint8_t pub[65];
+    Point p = point_mul_g(Scalar::from_u256(key));
+    if (uncompressed) {
+        serialize_uncompressed(p, pub);
+    } else {
+        serialize_compressed(p, pub);
+    }
+    Hash160 h;
+    hash160(pub, uncompressed ? 65 : 33, h.data());
+    return h;
+}
+
+}  // namespace
+
+TEST(interval_set_erase_and_take) {
+    IntervalSet s;
+    s.insert(UnitSpan{0, 10});
+    s.insert(UnitSpan{20, 30});
+    s.erase(UnitSpan{5, 25});
+    CHECK_EQ(s.count(), uint64_t(10));
+    CHECK(s.contains(4) && !s.contains(5) && !s.contains(24) && s.contains(25));
+    s.erase(UnitSpan{40, 50});
+    CHECK_EQ(s.intervals(), size_t(2));
+
+    std::vector<UnitSpan> got = s.take(7);
+    CHECK_EQ(got.size(), size_t(2));
+    CHECK(got[0].lo == 0 && got[0].hi == 5 && got[1].lo == 25 && got[1].hi == 27);
+    CHECK_EQ(s.count(), uint64_t(3));
+    CHECK(s.contains(27) && !s.contains(26));
+    CHECK_EQ(s.take(100).size(), size_t(1));
+    CHECK(s.empty());
+
+    IntervalSet t;
+    t.insert(UnitSpan{3, 5});
+    std::vector<UnitSpan> g = t.gaps(UnitSpan{4, 9});
+    CHECK(g.size() == 1 && g[0].lo == 5 && g[0].hi == 9);
+}
+
+TEST(coord_protocol_round_trip) {
+    WelcomeMsg w;
+    w.worker_id = 77;
+    w.start = U256::from_hex("0x400000000000000000");
+    w.end = U256::from_hex("0x7fffffffffffffffff");
+    w.unit_bits = 36;
+    w.lease_ms = 300000;
+    w.heartbeat_ms = 75000;
+    w.endomorphism = true;
+    WelcomeMsg w2;
+    decode(frame_of(encode(w)), w2);
+    CHECK(w2.worker_id == 77 && w2.start == w.start && w2.end == w.end && w2.unit_bits == 36);
+    CHECK(w2.lease_ms == 300000 && w2.heartbeat_ms == 75000 && w2.endomorphism);
+
+    // A lease of many spans costs a few bytes per span.
+    LeaseMsg l;
+    l.status = LeaseStatus::Granted;
+    l.lease_id = 1u << 20;
+    for (uint64_t i = 0; i < 1000; ++i) l.spans.push_back(UnitSpan{(1ull << 40) + i * 100, (1ull << 40) + i * 100 + 64});
+    std::vector<uint8_t> bytes = encode(l);
+    test_log() << "lease of 1000 spans: " << bytes.size() << " bytes\n";
+    CHECK(bytes.size() < 2100);
+    LeaseMsg l2;
+    decode(frame_of(bytes), l2);
+    CHECK(l2.status == LeaseStatus::Granted && l2.lease_id == l.lease_id && l2.spans.size() == l.spans.size());
+    bool same = true;
+    for (size_t i = 0; i < l.spans.size(); ++i) same &= l2.spans[i].lo == l.spans[i].lo && l2.spans[i].hi == l.spans[i].hi;
+    CHECK(same);
+
+    HitsMsg h;
+    h.hits.resize(2);
+    h.hits[1].key = U256::from_hex("0xdeadbeef");
+    h.hits[1].pubkey[32] = 0x5a;
+    h.hits[1].digest[19] = 0xa5;
+    h.hits[1].uncompressed = true;
+    HitsMsg h2;
+    decode(frame_of(encode(h)), h2);
+    CHECK(h2.hits.size() == 2 && h2.hits[1].key == h.hits[1].key && h2.hits[1].pubkey[32] == 0x5a &&
+          h2.hits[1].digest[19] == 0xa5);
+    CHECK(!h2.hits[0].uncompressed && h2.hits[1].uncompressed);
+
+    // Frames arrive in pieces; nothing is taken until a whole one is there.
+    std::vector<uint8_t> stream = encode(HeartbeatMsg{{1, 2, 300}});
+    std::vector<uint8_t> ack = encode_ack();
+    stream.insert(stream.end(), ack.begin(), ack.end());
+    std::vector<uint8_t> buf;
+    std::vector<Frame> frames;
+    for (uint8_t b : stream) {
+        buf.push_back(b);
+        Frame f;
+        while (take_frame(buf, f)) frames.push_back(f);
+    }
+    CHECK_EQ(frames.size(), size_t(2));
+    HeartbeatMsg hb;
+    decode(frames[0], hb);
+    CHECK(hb.lease_ids.size() == 3 && hb.lease_ids[2] == 300);
+    CHECK(frames[1].type == MsgType::Ack);
+
+    // Malformed bodies and the wrong message type are rejected.
+    Frame cut = frame_of(encode(CompleteMsg{5, {UnitSpan{1, 9}}}));
+    cut.body.pop_back();
+    CompleteMsg c;
+    CHECK(throws_runtime([&] { decode(cut, c); }));
+    CHECK(throws_runtime([&] { decode(frame_of(encode_ack()), c); }));
+    std::vector<uint8_t> huge{0xff, 0xff, 0xff, 0xff, 1};
+    Frame f;
+    CHECK(throws_runtime([&] { take_frame(huge, f); }));
+}
+
+// Leases expire back into the pool and are reassigned; completions merge
+// into the done set, partial ones return the rest.
+TEST(coordinator_leases_and_reassignment) {
+    CoordinatorConfig cc;
+    cc.unit_bits = 8;
+    cc.lease_time = std::chrono::seconds(10);
+    cc.max_lease_units = 40;
+    // 100 units, the last one short.
+    Coordinator coord(U256::from_u64(1), U256::from_u64(1 + 99 * 256 + 17), cc);
+    CHECK_EQ(coord.unit_count(), uint64_t(100));
+    Clock::time_point t = Clock::now();
+
+    LeaseMsg a = coord.lease(1, 1000, t);  // capped at 40
+    LeaseMsg b = coord.lease(2, 30, t);
+    LeaseMsg c = coord.lease(3, 40, t);
+    CHECK(a.status == LeaseStatus::Granted && units_in(a.spans) == 40);
+    CHECK(units_in(b.spans) == 30 && units_in(c.spans) == 30);
+    CHECK(coord.lease(4, 10, t).status == LeaseStatus::Wait);
+    CHECK_EQ(coord.pending_units(), uint64_t(0));
+
+    // b keeps its lease alive, a and c do not.
+    t += std::chrono::seconds(6);
+    CHECK(coord.heartbeat({b.lease_id}, t).empty());
+    t += std::chrono::seconds(6);
+    CHECK_EQ(coord.expire(t), uint64_t(70));
+    CHECK_EQ(coord.heartbeat({a.lease_id, b.lease_id}, t).size(), size_t(1));
+
+    // a finishes anyway; its units come out of the pool again.
+    coord.complete(a.lease_id, a.spans);
+    CHECK_EQ(coord.done_units(), uint64_t(40));
+    CHECK_EQ(coord.pending_units(), uint64_t(30));
+
+    // b reports only the first 10 of its units; the other 20 go back.
+    coord.complete(b.lease_id, {UnitSpan{b.spans[0].lo, b.spans[0].lo + 10}});
+    CHECK_EQ(coord.done_units(), uint64_t(50));
+    CHECK_EQ(coord.pending_units(), uint64_t(50));
+
+    // A worker that disconnects loses its leases at once.
+    LeaseMsg d = coord.lease(5, 25, t);
+    CHECK_EQ(coord.leased_units(), uint64_t(25));
+    coord.release_worker(5);
+    CHECK_EQ(coord.leased_units(), uint64_t(0));
+    CHECK(!coord.heartbeat({d.lease_id}, t).empty());
+
+    while (!coord.finished()) {
+        LeaseMsg e = coord.lease(6, 40, t);
+        CHECK(e.status == LeaseStatus::Granted);
+        if (e.status != LeaseStatus::Granted) break;
+        coord.complete(e.lease_id, e.spans);
+    }
+    CHECK(coord.lease(6, 40, t).status == LeaseStatus::Finished);
+    CHECK_EQ(coord.done().intervals(), size_t(1));
+    CHECK(coord.reassigned_units() >= 70);
+}
+
+// A completion only marks units its lease held, or, for an expired lease,
+// still holds unclaimed; everything else is counted and dropped.
+TEST(coordinator_clips_completions_to_the_lease) {
+    CoordinatorConfig cc;
+    cc.unit_bits = 8;
+    cc.lease_time = std::chrono::seconds(10);
+    Coordinator coord(U256::from_u64(1), U256::from_u64(1 + 100 * 256), cc);
+    Clock::time_point t = Clock::now();
+    LeaseMsg a = coord.lease(1, 40, t);
+    LeaseMsg b = coord.lease(2, 30, t);
+    CHECK(a.spans.size() == 1 && a.spans[0].lo == 0 && a.spans[0].hi == 40);
+
+    // b names a's units: none count, and b's own go back.
+    coord.complete(b.lease_id, a.spans);
+    CHECK_EQ(coord.done_units(), uint64_t(0));
+    CHECK_EQ(coord.rejected_units(), uint64_t(40));
+    CHECK_EQ(coord.pending_units(), uint64_t(60));
+    coord.complete(12345, {UnitSpan{0, 1000}});
+    CHECK_EQ(coord.rejected_units(), uint64_t(140));
+    CHECK_EQ(coord.done_units(), uint64_t(0));
+
+    // a expires and its first 10 units are leased again; a's late
+    // completion still counts for the other 30, and only once.
+    t += std::chrono::seconds(11);
+    CHECK_EQ(coord.expire(t), uint64_t(40));
+    LeaseMsg c = coord.lease(3, 10, t);
+    CHECK(c.spans.size() == 1 && c.spans[0].lo == 0 && c.spans[0].hi == 10);
+    coord.complete(a.lease_id, a.spans);
+    CHECK_EQ(coord.done_units(), uint64_t(30));
+    CHECK_EQ(coord.rejected_units(), uint64_t(150));
+    CHECK(!coord.done().contains(5) && coord.done().contains(10));
+    coord.complete(a.lease_id, a.spans);
+    CHECK_EQ(coord.done_units(), uint64_t(30));
+    CHECK_EQ(coord.rejected_units(), uint64_t(190));
+    coord.complete(c.lease_id, c.spans);
+    CHECK_EQ(coord.done_units(), uint64_t(40));
+    CHECK_EQ(coord.pending_units(), uint64_t(60));
+}
+
+// Two workers over TCP scan a range leased in small batches; every planted
+// key is reported to the coordinator exactly as a local scan would, the
+// uncompressed one still marked as such.
+TEST(coordinated_scan_end_to_end) {
+    const U256 start = U256::from_hex("0x30000");
+    const U256 end = U256::from_hex("0x38000");
+    std::vector<Hash160> digests;
+    std::set<std::string> want;
+    const U256 legacy = U256::from_hex("0x35555");
+    for (const char* k : {"0x30000", "0x31234", "0x35555", "0x37fff"}) {
+        digests.push_back(digest_of(U256::from_hex(k), U256::from_hex(k) == legacy));
+        want.insert(U256::from_hex(k).to_hex());
+    }
+    TargetSet targets(TargetTable::from_digests(digests));
+
+    CoordinatorConfig cc;
+    cc.unit_bits = 10;
+    cc.lease_time = std::chrono::seconds(30);
+    Coordinator coord(start, end, cc);
+    CoordServerConfig sc;
+    sc.host = "127.0.0.1";
+    sc.heartbeat = std::chrono::milliseconds(5);
+    std::mutex hits_mutex;
+    std::set<std::string> at_coord;
+    std::set<std::string> names;
+    unsigned bad_hits = 0;
+    auto server = std::make_unique<CoordServer>(coord, sc, [&](const ScanHit& h, const std::string& worker) {
+        std::lock_guard<std::mutex> lock(hits_mutex);
+        at_coord.insert(h.key.to_hex());
+        names.insert(worker);
+        if (h.uncompressed != (h.key == legacy) || h.digest != digest_of(h.key, h.uncompressed)) bad_hits++;
+    });
+    const uint16_t port = server->port();
+    std::thread serve([&] { server->run(); });
+
+    std::vector<uint64_t> units(2);
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < 2; ++w) {
+        workers.emplace_back([&, w] {
+            CoordClient client(CoordEndpoint{"127.0.0.1", port}, HelloMsg{1, "w" + std::to_string(w)});
+            CHECK(client.welcome().start == start && client.welcome().unit_bits == 10);
+            ScanConfig cfg;
+            cfg.walker.batch_size = 256;
+            cfg.unit_bits = 32;  // overridden by the coordinator
+            cfg.targets = &targets;
+            cfg.uncompressed = true;
+            units[w] = scan_coordinated(client, cfg, nullptr, 3).units;
+        });
+    }
+    for (std::thread& t : workers) t.join();
+    // run() returns by itself once the range is done and both have hung up.
+    serve.join();
+
+    CHECK(coord.finished());
+    CHECK(at_coord == want);
+    CHECK_EQ(bad_hits, 0u);
+    CHECK_EQ(units[0] + units[1], uint64_t(32));
+    CHECK(!names.empty());
+    test_log() << "coordinated scan: worker units " << units[0] << " + " << units[1] << "\n";
+
+    // Once the server is gone, connecting fails cleanly.
+    server.reset();
+    CHECK(throws_runtime([&] { CoordClient(CoordEndpoint{"127.0.0.1", port}, HelloMsg{}); }));
+}
+
+TEST(coord_endpoint_parsing) {
+    CoordEndpoint e = parse_coord_endpoint("gpu-box-3:7420");
+    CHECK(e.host == "gpu-box-3" && e.port == 7420);
+    CHECK(parse_coord_endpoint("[::1]:9").host == "::1");
+    size_t rejected = 0;
+    const char* const bad[] = {"nohost", "host:", ":80", "h:0", "h:70000", "h:12x"};
+    for (const char* text : bad) {
+        try {
+            parse_coord_endpoint(text);
+        } catch (const std::invalid_argument&) {
+            ++rejected;
+        }
+    }
+    CHECK_EQ(rejected, sizeof(bad) / sizeof(bad[0]));
+}
@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/dp_store.hpp"
+#include "marauder/kangaroo.hpp"
+#include "marauder/point.hpp"
+#include "marauder/scalar.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+// Keys shaped like real DPs: the low bits of key_lo are zero.
+DpRecord record(uint64_t i) {
+    uint64_t z = (i + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 31)) * 0xBF58476D1CE4E5B9ULL;
+    DpRecord r;
+    r.key_hi = z ^ (z >> 29);
+    r.key_lo = (z * 0x94D049BB133111EBULL) << 20;
+    r.dist = U256::from_u64(i * 977);
+    if (i % 5 == 0) r.dist.d[2] = i;  // some distances past 128 bits
+    r.kind = i & 1;
+    return r;
+}
+
+void remove_runs(const std::string& prefix) {
+    for (int n = 0; n < 1024; ++n) std::remove((prefix + "." + std::to_string(n) + ".dp").c_str());
+}
+
+}  // namespace
+
+// Every point stays findable through spills, compaction and a reopen, and
+// a repeated key reports the first record stored under it.
+TEST(dp_store_spills_and_finds) {
+    const std::string prefix = "test_dp_store.tmp";
+    remove_runs(prefix);
+    DpStoreConfig cfg;
+    cfg.path = prefix;
+    cfg.memory_records = 1500;
+    cfg.job = 42;
+    const uint64_t n = 30000;
+    {
+        DpStore store(cfg);
+        DpRecord prev;
+        for (uint64_t i = 0; i < n; ++i) CHECK(!store.insert(record(i), prev));
+        CHECK_EQ(store.size(), n);
+        CHECK(store.runs() >= 1 && store.runs() <= kMaxDpRuns);
+        test_log() << "dp store: " << store.runs() << " runs, " << store.in_memory() << " in memory, "
+                   << store.disk_reads() << " disk reads\n";
+        CHECK(store.disk_reads() < n / 100);
+
+        for (uint64_t i = 0; i < n; i += 7) {
+            DpRecord again = record(i);
+            again.dist = U256::from_u64(1);
+            again.kind ^= 1;
+            CHECK(store.insert(again, prev));
+            CHECK(prev.dist == record(i).dist);
+            CHECK_EQ(int(prev.kind), int(record(i).kind));
+        }
+        CHECK_EQ(store.size(), n);
+        store.spill();
+    }
+    DpStore reopened(cfg);
+    CHECK_EQ(reopened.size(), n);
+    CHECK_EQ(reopened.in_memory(), uint64_t(0));
+    DpRecord prev;
+    CHECK(reopened.insert(record(12345), prev));
+    CHECK(prev.dist == record(12345).dist);
+    CHECK(!reopened.insert(record(n), prev));
+
+    // Another job cannot reuse these runs.
+    cfg.job = 43;
+    bool threw = false;
+    try {
+        DpStore other(cfg);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    remove_runs(prefix);
+}
+
+// Two work files with overlapping points merge into their union, and each
+// shared key is reported once with both records.
+TEST(dp_store_merges_work_files) {
+    const std::string a = "test_dp_a.tmp", b = "test_dp_b.tmp", out = "test_dp_out.tmp";
+    DpStoreConfig cfg;
+    cfg.memory_records = 1000;
+    cfg.job = 7;
+    DpStore sa(cfg), sb(cfg);  // memory only
+    DpRecord prev;
+    for (uint64_t i = 0; i < 6000; ++i) sa.insert(record(i), prev);
+    for (uint64_t i = 4000; i < 9000; ++i) {
+        DpRecord r = record(i);
+        r.kind ^= 1;
+        sb.insert(r, prev);
+    }
+    sa.write_work_file(a);
+    sb.write_work_file(b);
+
+    uint64_t shared = 0;
+    bool records_ok = true;
+    uint64_t written = DpStore::merge_work_files(a, b, out, [&](const DpRecord& x, const DpRecord& y) {
+        ++shared;
+        records_ok = records_ok && x.key_hi == y.key_hi && x.key_lo == y.key_lo && x.kind != y.kind &&
+                     x.dist == y.dist;
+    });
+    CHECK_EQ(written, uint64_t(9000));
+    CHECK_EQ(shared, uint64_t(2000));
+    CHECK(records_ok);
+
+    // The merged file is itself a work file: reopen it as a store's run.
+    std::rename(out.c_str(), "test_dp_merged.tmp.0.dp");
+    cfg.path = "test_dp_merged.tmp";
+    {
+        DpStore merged(cfg);
+        CHECK_EQ(merged.size(), uint64_t(9000));
+        CHECK(merged.insert(record(8999), prev));
+        CHECK(merged.insert(record(0), prev) && prev.kind == record(0).kind);
+    }
+    remove_runs(cfg.path);
+
+    // Damaged and foreign files are refused.
+    {
+        std::ofstream junk(out, std::ios::binary);
+        junk << std::string(200, 'x');
+    }
+    auto merge_throws = [&](const std::string& x, const std::string& y) {
+        try {
+            DpStore::merge_work_files(x, y, "test_dp_never.tmp", nullptr);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(merge_throws(a, out));
+    cfg.path.clear();
+    cfg.job = 8;
+    DpStore foreign(cfg);
+    foreign.insert(record(1), prev);
+    foreign.write_work_file(out);
+    CHECK(merge_throws(a, out));
+    for (const std::string& f : {a, b, out}) std::remove(f.c_str());
+}
+
+// A kangaroo run that gives up leaves its points in the work file, and the
+// next run on the same job starts from them.
+TEST(kangaroo_resumes_from_work_file) {
+    const std::string prefix = "test_kangaroo_work.tmp";
+    remove_runs(prefix);
+    const U256 start = U256::from_hex("0x3000000000");
+    const U256 end = U256::from_hex("0x4000000000");
+    const U256 key = U256::from_hex("0x3a5a5a5a5a");
+    const Point pub = point_mul_g(Scalar::from_u256(key));
+    KangarooConfig cfg;
+    cfg.herd = 256;
+    cfg.work_file = prefix;
+    cfg.dp_memory = 256;
+    cfg.start_seed = 1;
+    cfg.max_jumps = 100000;
+    KangarooResult first = kangaroo_solve(pub, start, end, cfg);
+    CHECK(first.dps > 0);
+
+    cfg.start_seed = 2;
+    cfg.max_jumps = 0;
+    KangarooResult second = kangaroo_solve(pub, start, end, cfg);
+    CHECK(second.found && second.key == key);
+    CHECK(second.dps > first.dps);
+    test_log() << "kangaroo resume: " << first.dps << " DPs, then solved with " << second.dps << " after "
+               << second.jumps << " more jumps\n";
+    remove_runs(prefix);
+}
@@ -0,0 +1,58 @@
+#include <memory>
+
+#include "harness.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/reference.hpp"
+
+using namespace marauder;
+
+TEST(endomorphism_constants) {
+    Fe cube;
+    fe_sqr(cube, kEndoBeta);
+    CHECK(cube == kEndoBeta2);
+    fe_mul(cube, cube, kEndoBeta);
+    CHECK(cube == Fe::one());
+
+    Scalar l3;
+    scalar_mul(l3, kEndoLambda, kEndoLambda);
+    CHECK(l3 == kEndoLambda2);
+    scalar_mul(l3, l3, kEndoLambda);
+    CHECK(l3 == Scalar::one());
+}
+
+// Every expanded candidate must be the public key of the scalar it maps to.
+TEST(endomorphism_candidates_map_back) {
+    WalkerConfig config;
+    config.batch_size = 16;
+    RangeWalker walker(U256::from_hex("0x3fffff00"), U256::from_hex("0x3fffff20"), config);
+    Point pub, cand[kEndoCandidates];
+    while (walker.next(pub)) {
+        endo_expand(pub, cand);
+        Scalar k = Scalar::from_u256(walker.key());
+        for (unsigned v = 0; v < kEndoCandidates; ++v) {
+            Scalar ck = endo_candidate_key(k, v);
+            CHECK(cand[v] == reference_pubkey(ck.to_u256()));
+        }
+    }
+}
+
+TEST(endomorphism_block_passes) {
+    WalkerConfig config;
+    config.batch_size = 64;
+    RangeWalker walker(U256::from_hex("0x7000000000"), U256::from_hex("0x7000000050"), config);
+    auto blk = std::make_unique<PointBlock<64>>();
+    while (walker.next_block(*blk, true) != 0) {
+        auto orig = std::make_unique<PointBlock<64>>(*blk);
+        for (unsigned pass = 1; pass < kEndoCandidates; ++pass) {
+            endo_block_step(*blk, pass);
+            for (size_t i = 0; i < blk->count; ++i) {
+                Point cand[kEndoCandidates];
+                endo_expand(orig->point(i), cand);
+                const Point& expect = cand[kEndoBlockOrder[pass]];
+                CHECK(blk->point(i) == expect);
+                CHECK_EQ((int)blk->y_odd[i], (int)expect.y.is_odd());
+            }
+        }
+    }
+}
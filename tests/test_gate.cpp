@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/field_kernel.hpp"
+#include "marauder/gpu_backend.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/reference.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/target_set.hpp"
+#include "plugin_common.hpp"
+#include "plugin_emu.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+// The gate's cross-checks: every kernel combination and the GPU device code
+// against the scalar reference, on random ranges and on the edges of the
+// field and the group, then the solved puzzles found again end to end.
+
+namespace {
+
+uint64_t next_random(uint64_t& seed) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed ^ (seed >> 29);
+}
+
+U256 order_minus(uint64_t v) {
+    U256 r;
+    u256_sub(r, kOrderN, U256::from_u64(v));
+    return r;
+}
+
+U256 plus(const U256& a, uint64_t v) {
+    U256 r;
+    u256_add_u64(r, a, v);
+    return r;
+}
+
+U256 minus(const U256& a, uint64_t v) {
+    U256 r;
+    u256_sub(r, a, U256::from_u64(v));
+    return r;
+}
+
+U256 power_of_two(unsigned bits) { return u256_shl(U256::from_u64(1), bits); }
+
+// A random key in [2^64, n / 2), all four limbs busy.
+U256 random_key(uint64_t& seed) {
+    return U256{{next_random(seed), next_random(seed), next_random(seed), (next_random(seed) >> 2) | 1}};
+}
+
+struct Digests {
+    Hash160 comp, uncomp;
+};
+
+// Digests of every endomorphism candidate of every key in [start, start +
+// count), indexed [offset * kEndoCandidates + v], from one affine addition
+// per key (every 97th checked against the reference) and the byte-string
+// hash. None of it shares code with the batched walk.
+std::vector<Digests> oracle(const U256& start, uint64_t count) {
+    std::vector<Digests> out(count * kEndoCandidates);
+    const Point g = point_mul_g(Scalar::one());
+    Point p = point_mul_g(Scalar::from_u256(start));
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i) point_add(p, p, g);
+        if (i % 97 == 0) CHECK(p == reference_pubkey(plus(start, i)));
+        Point cand[kEndoCandidates];
+        endo_expand(p, cand);
+        for (unsigned v = 0; v < kEndoCandidates; ++v) {
+            uint8_t ser[65];
+            serialize_compressed(cand[v], ser);
+            hash160(ser, 33, out[i * kEndoCandidates + v].comp.data());
+            serialize_uncompressed(cand[v], ser);
+            hash160(ser, 65, out[i * kEndoCandidates + v].uncomp.data());
+        }
+    }
+    return out;
+}
+
+// Solved puzzles of the 2015 transaction: key N lies in [2^(N-1), 2^N).
+struct Puzzle {
+    unsigned n;
+    const char* key;
+    const char* address;
+};
+
+const Puzzle kPuzzles[] = {
+    {1, "1", "1BgGZ9tcN4rm9KBzDn7KprQz87SZ26SAMH"},
+    {2, "3", "1CUNEBjYrCn2y1SdiUMohaKUi4wpP326Lb"},
+    {3, "7", "19ZewH8Kk1PDbSNdJ97FP4EiCjTRaZMZQA"},
+    {4, "8", "1EhqbyUMvvs7BfL8goY6qcPbD6YKfPqb7e"},
+    {5, "15", "1E6NuFjCi27W5zoXg8TRdcSRq84zJeBW3k"},
+    {6, "31", "1PitScNLyp2HCygzadCh7FveTnfmpPbfp8"},
+    {7, "4c", "1McVt1vMtCC7yn5b9wgX1833yCcLXzueeC"},
+    {8, "e0", "1M92tSqNmQLYw33fuBvjmeadirh1ysMBxK"},
+    {9, "1d3", "1CQFwcjw1dwhtkVWBttNLDtqL7ivBonGPV"},
+    {10, "202", "1LeBZP5QCwwgXRtmVUvTVrraqPUokyLHqe"},
+    {11, "483", "1PgQVLmst3Z314JrQn5TNiys8Hc38TcXJu"},
+    {12, "a7b", "1DBaumZxUkM4qMQRt2LVWyFJq5kDtSZQot"},
+    {13, "1460", "1Pie8JkxBT6MGPz9Nvi3fsPkr2D8q3GBc1"},
+    {14, "2930", "1ErZWg5cFCe4Vw5BzgfzB74VNLaXEiEkhk"},
+    {15, "68f3", "1QCbW9HWnwQWiQqVo5exhAnmfqKRrCRsvW"},
+    {16, "c936", "1BDyrQ6WoF8VN3g9SAS1iKZcPzFfnDVieY"},
+    {17, "1764f", "1HduPEXZRdG26SUT5Yk83mLkPyjnZuJ7Bm"},
+    {18, "3080d", "1GnNTmTVLZiqQfLbAdp9DVdicEnB5GoERE"},
+    {19, "5749f", "1NWmZRpHH4XSPwsW6dsS3nrNWfL1yrJj4w"},
+    {20, "d2c55", "1HsMJxNiV7TLxmoF6uJNkydxPFDog4NQum"},
+    {21, "1ba534", "14oFNXucftsHiUMY8uctg6N487riuyXs4h"},
+    {22, "2de40f", "1CfZWK1QTQE3eS9qn61dQjV89KDjZzfNcv"},
+    {23, "556e52", "1L2GM8eE7mJWLdo3HZS6su1832NX2txaac"},
+    {24, "dc2a04", "1rSnXMr63jdCuegJFuidJqWxUPV7AtUf7"},
+    {25, "1fa5ee5", "15JhYXn6Mx3oF4Y7PcTAv2wVVAuCFFQNiP"},
+    {26, "340326e", "1JVnST957hGztonaWK6FougdtjxzHzRMMg"},
+    {27, "6ac3875", "128z5d7nN7PkCuX5qoA4Ys6pmxUYnEy86k"},
+    {28, "d916ce8", "12jbtzBb54r97TCwW3G1gCFoumpckRAPdY"},
+    {29, "17e2551e", "19EEC52krRUK1RkUAEZmQdjTyHT7Gp1TYT"},
+    {30, "3d94cd64", "1LHtnpd8nU5VHEMkG2TMYYNUjjLc992bps"},
+};
+
+Hash160 puzzle_digest(const Puzzle& p) {
+    Hash160 h{};
+    CHECK(decode_address(p.address, std::strlen(p.address), h.data()) == AddressStatus::Hash160);
+    return h;
+}
+
+}  // namespace
+
+// Each field kernel walking and each hash160 kernel hashing, all six
+// endomorphism passes, compressed and uncompressed: every lane must match
+// the reference key's digests. The ranges cover the doubling and infinity
+// lanes of keys 1.., carries into each limb, a random key and the last
+// keys below n.
+TEST(gate_kernels_match_reference_at_edges) {
+    uint64_t seed = 0x452821E638D01377ULL;
+    const uint64_t width = 0x180;
+    const std::vector<U256> starts = {U256::from_u64(1),         minus(power_of_two(64), width / 2),
+                                      minus(power_of_two(128), 7), minus(power_of_two(192), width - 1),
+                                      random_key(seed),          order_minus(width)};
+    auto blk = std::make_unique<PointBlock<256>>();
+    for (const U256& start : starts) {
+        const std::vector<Digests> want = oracle(start, width);
+        for (const FieldKernel* fk : field_available()) {
+            for (const Hash160Kernel* hk : hash160_available()) {
+                WalkerConfig config;
+                config.batch_size = 64;
+                config.field = fk;
+                RangeWalker walker(start, plus(start, width), config);
+                uint64_t offset = 0, bad = 0;
+                size_t n;
+                while ((n = walker.next_block(*blk, true)) != 0) {
+                    for (unsigned pass = 0; pass < kEndoCandidates; ++pass) {
+                        if (pass) endo_block_step(*blk, pass);
+                        const unsigned v = kEndoBlockOrder[pass];
+                        blk->hash_compressed(*hk);
+                        for (size_t i = 0; i < n; ++i) {
+                            bad += !std::equal(want[(offset + i) * kEndoCandidates + v].comp.begin(),
+                                               want[(offset + i) * kEndoCandidates + v].comp.end(), blk->digest[i]);
+                        }
+                        blk->hash_uncompressed(*hk);
+                        for (size_t i = 0; i < n; ++i) {
+                            bad += !std::equal(want[(offset + i) * kEndoCandidates + v].uncomp.begin(),
+                                               want[(offset + i) * kEndoCandidates + v].uncomp.end(), blk->digest[i]);
+                        }
+                    }
+                    offset += n;
+                }
+                CHECK_EQ(offset, width);
+                CHECK_EQ(bad, uint64_t(0));
+                test_log() << start.to_hex() << " field " << fk->name << " hash160 " << hk->name << ": "
+                           << offset * kEndoCandidates * 2 << " digests, " << bad << " wrong\n";
+            }
+        }
+    }
+}
+
+// The device walk and hash through the plugin ABI, with every candidate of
+// every key a target: each must come back as a positive at its own offset
+// and candidate index. The ranges run from the lowest start a device takes
+// to the highest, across each limb carry and from a random key; one step
+// past either end the device declines.
+TEST(gate_gpu_matches_reference_on_every_lane) {
+    auto backend = GpuBackend::load(MARAUDER_GPU_EMU_PLUGIN);
+    auto dev = backend->open(0, true);
+    const uint64_t count = dev->preferred_keys();
+    const uint64_t margin = marauder_gpu::range_margin(marauder_gpu::kEmuThreads);
+    uint64_t seed = 0xBE5466CF34E90C6CULL;
+    const U256 lowest = U256::from_u64(margin + 1), highest = order_minus(margin + count + 1);
+    GpuHits hits;
+    CHECK(dev->scan(U256::from_u64(margin), count, hits) == GpuDevice::Result::Unsupported);
+    CHECK(dev->scan(plus(highest, 1), count, hits) == GpuDevice::Result::Unsupported);
+
+    for (const U256& start : {lowest, minus(power_of_two(64), 1000), minus(power_of_two(128), count / 2),
+                              minus(power_of_two(192), 3), random_key(seed), highest}) {
+        const std::vector<Digests> want = oracle(start, count);
+        std::vector<Hash160> digests;
+        for (const Digests& d : want) digests.push_back(d.comp);
+        TargetSet targets(TargetTable::from_digests(digests));
+        dev->set_bloom(targets.bloom());
+
+        CHECK(dev->scan(start, count, hits) == GpuDevice::Result::Ok);
+        std::vector<bool> seen(want.size());
+        uint64_t bad = 0;
+        for (const MarauderGpuHit& h : hits) {
+            if (h.offset >= count || h.candidate >= kEndoCandidates) {
+                ++bad;
+                continue;
+            }
+            const Hash160& d = want[h.offset * kEndoCandidates + h.candidate].comp;
+            if (std::equal(d.begin(), d.end(), h.digest)) {
+                seen[h.offset * kEndoCandidates + h.candidate] = true;
+            } else if (targets.contains(h.digest)) {
+                ++bad;  // a real target reported at the wrong offset or candidate
+            }
+        }
+        uint64_t missing = static_cast<uint64_t>(std::count(seen.begin(), seen.end(), false));
+        CHECK_EQ(bad, uint64_t(0));
+        CHECK_EQ(missing, uint64_t(0));
+        test_log() << start.to_hex() << " gpu " << dev->name() << ": " << want.size() << " candidates, " << missing
+                   << " missing, " << bad << " wrong\n";
+    }
+}
+
+// The published addresses of the solved puzzles as targets: a sweep of
+// puzzles 1-22 in full finds exactly their keys, and a window around each
+// of puzzles 23-30 (endomorphism on) finds that one. Throughput goes to
+// the log as a smoke test of the build.
+TEST(gate_solves_low_puzzles) {
+    std::vector<Hash160> digests;
+    std::map<Hash160, std::string> key_of;
+    for (const Puzzle& p : kPuzzles) {
+        digests.push_back(puzzle_digest(p));
+        key_of[digests.back()] = U256::from_hex(p.key).to_hex();
+    }
+    TargetSet targets(TargetTable::from_digests(digests));
+
+    ScanConfig cfg;
+    cfg.threads = 2;
+    cfg.unit_bits = 16;
+    cfg.targets = &targets;
+    std::set<std::string> found;
+    ScanStats stats = scan_range(U256::from_u64(1), power_of_two(22), cfg, [&](const ScanHit& h) {
+        CHECK_EQ(key_of[h.digest], h.key.to_hex());
+        found.insert(h.key.to_hex());
+    });
+    std::set<std::string> want;
+    for (const Puzzle& p : kPuzzles) {
+        if (p.n <= 22) want.insert(U256::from_hex(p.key).to_hex());
+    }
+    CHECK(found == want);
+    CHECK_EQ(stats.keys, (uint64_t(1) << 22) - 1);
+    test_log() << "puzzles 1-22: " << stats.keys << " keys in " << stats.seconds << " s, "
+               << (stats.seconds > 0 ? stats.keys / stats.seconds / 1e6 : 0.0) << " Mkeys/s, hash160 kernel "
+               << hash160_best().name << ", field kernel " << field_best().name << "\n";
+
+    cfg.endomorphism = true;
+    cfg.unit_bits = 12;
+    for (const Puzzle& p : kPuzzles) {
+        if (p.n <= 22) continue;
+        const U256 key = U256::from_hex(p.key);
+        found.clear();
+        stats = scan_range(minus(key, 0x7123), plus(key, 0x8edd), cfg, [&](const ScanHit& h) {
+            found.insert(h.key.to_hex());
+        });
+        CHECK(found == std::set<std::string>{key.to_hex()});
+        test_log() << "puzzle " << p.n << ": " << (found.size() == 1 ? "solved" : "missed") << ", " << stats.keys
+                   << " candidates in " << stats.seconds << " s\n";
+    }
+}
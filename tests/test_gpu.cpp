@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/gpu_backend.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/point.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/target_set.hpp"
+
+using namespace marauder;
+
+// These run the device walk through the host-emulation plugin, so they
+// cover the device field and hash code, the hit format and the host side
+// of the plugin ABI, but not a real GPU.
+
+namespace {
+
+Hash160 digest_of(const U256& key) {
+    uint8_t pub[33];
+    serialize_compressed(point_mul_g(Scalar::from_u256(key)), pub);
+    Hash160 h;
+    hash160(pub, sizeof(pub), h.data());
+    return h;
+}
+
+std::unique_ptr<GpuBackend> emu() { return GpuBackend::load(MARAUDER_GPU_EMU_PLUGIN); }
+
+}  // namespace
+
+TEST(gpu_plugin_loads) {
+    auto backend = emu();
+    CHECK_EQ(backend->name(), std::string("emu"));
+    CHECK_EQ(backend->device_count(), 1);
+    auto dev = backend->open(0, false);
+    CHECK_EQ(dev->name(), std::string("host emulation"));
+
+    bool threw = false;
+    try {
+        GpuBackend::load("libdoes-not-exist.so");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Every planted key must come back as a Bloom positive with the right
+// offset and candidate index, across iteration and thread boundaries and a
+// ragged final iteration.
+TEST(gpu_device_scan_finds_planted_keys) {
+    const U256 start = U256::from_hex("0x1d00000000");
+    auto backend = emu();
+    auto dev = backend->open(0, true);
+    const uint64_t count = dev->preferred_keys() + 77;
+
+    std::vector<std::pair<uint64_t, unsigned>> planted = {{0, 0}, {31, 1}, {32, 2}, {2047, 3}, {2048, 4},
+                                                          {5000, 5}, {count - 1, 0}};
+    std::vector<Hash160> digests;
+    for (auto [offset, v] : planted) {
+        U256 k;
+        u256_add_u64(k, start, offset);
+        digests.push_back(digest_of(endo_candidate_key(Scalar::from_u256(k), v).to_u256()));
+    }
+    TargetSet targets(TargetTable::from_digests(digests));
+    dev->set_bloom(targets.bloom());
+
+    GpuHits hits;
+    CHECK(dev->scan(start, count, hits) == GpuDevice::Result::Ok);
+    std::set<std::pair<uint64_t, unsigned>> got;
+    for (const MarauderGpuHit& h : hits) {
+        CHECK(h.offset < count && h.candidate < kEndoCandidates);
+        U256 k;
+        u256_add_u64(k, start, h.offset);
+        Hash160 want = digest_of(endo_candidate_key(Scalar::from_u256(k), h.candidate).to_u256());
+        CHECK(std::equal(want.begin(), want.end(), h.digest));
+        if (targets.contains(h.digest)) got.insert({h.offset, h.candidate});
+    }
+    const std::set<std::pair<uint64_t, unsigned>> expect(planted.begin(), planted.end());
+    CHECK(got == expect);
+
+    // Keys near 0 are left to the CPU.
+    CHECK(dev->scan(U256::from_u64(5), 1000, hits) == GpuDevice::Result::Unsupported);
+}
+
+// Queued scans come back in submission order, each with its own hits.
+TEST(gpu_device_pipeline_keeps_order) {
+    auto backend = emu();
+    auto dev = backend->open(0, false, 2);
+    CHECK_EQ(dev->depth(), 2u);
+    const uint64_t count = dev->preferred_keys();
+    const U256 a = U256::from_hex("0x2d00000000");
+    U256 b;
+    u256_add_u64(b, a, count);
+    U256 ka, kb;
+    u256_add_u64(ka, a, 100);
+    u256_add_u64(kb, b, 200);
+    TargetSet targets(TargetTable::from_digests({digest_of(ka), digest_of(kb)}));
+    dev->set_bloom(targets.bloom());
+
+    auto planted = [&](const GpuHits& hits) {
+        std::set<uint64_t> offsets;
+        for (const MarauderGpuHit& h : hits) {
+            if (targets.contains(h.digest)) offsets.insert(h.offset);
+        }
+        return offsets;
+    };
+    GpuHits hits;
+    CHECK(dev->submit(a, count) == GpuDevice::Result::Ok);
+    CHECK(dev->submit(b, count) == GpuDevice::Result::Ok);
+    CHECK_EQ(dev->in_flight(), 2u);
+    bool threw = false;
+    try {
+        dev->submit(a, count);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(dev->collect(hits) == GpuDevice::Result::Ok);
+    CHECK(planted(hits) == std::set<uint64_t>{100});
+    // Every collect reads back into the same device buffer.
+    const MarauderGpuHit* buffer = hits.data;
+    CHECK(dev->submit(U256::from_u64(5), 1000) == GpuDevice::Result::Unsupported);
+    CHECK(dev->submit(a, count) == GpuDevice::Result::Ok);
+    CHECK(dev->collect(hits) == GpuDevice::Result::Ok);
+    CHECK(planted(hits) == std::set<uint64_t>{200});
+    CHECK(dev->collect(hits) == GpuDevice::Result::Ok);
+    CHECK(planted(hits) == std::set<uint64_t>{100});
+    CHECK(hits.data == buffer);
+    CHECK_EQ(dev->in_flight(), 0u);
+
+    threw = false;
+    try {
+        backend->open(0, false, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// scan_range with a GPU worker (and CPU workers or none) reports exactly
+// the planted keys, including in a unit the plugin hands back to the CPU.
+TEST(gpu_scan_range_matches_cpu) {
+    auto backend = emu();
+    const U256 start = U256::from_hex("0x1000");
+    const U256 end = U256::from_hex("0x6000");
+    std::vector<Hash160> digests;
+    std::set<std::string> want;
+    for (const char* k : {"0x1000", "0x1abc", "0x4000", "0x5fff"}) {
+        digests.push_back(digest_of(U256::from_hex(k)));
+        want.insert(U256::from_hex(k).to_hex());
+    }
+    TargetSet targets(TargetTable::from_digests(digests));
+
+    for (auto [threads, depth] : {std::pair{0u, 1u}, std::pair{0u, kDefaultGpuDepth}, std::pair{2u, 4u}}) {
+        ScanConfig cfg;
+        cfg.threads = threads;
+        cfg.gpu_depth = depth;
+        cfg.unit_bits = 12;
+        cfg.walker.batch_size = 256;
+        cfg.targets = &targets;
+        cfg.gpu = backend.get();
+        std::set<std::string> got;
+        ScanStats stats = scan_range(start, end, cfg, [&](const ScanHit& h) { got.insert(h.key.to_hex()); });
+        CHECK(got == want);
+        CHECK_EQ(stats.keys, uint64_t(0x5000));
+        CHECK_EQ(stats.units, uint64_t(5));
+    }
+}
@@ -0,0 +1,123 @@
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/range_walker.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+std::string hex_of(const std::string& s, void (*fn)(const uint8_t*, size_t, uint8_t*), size_t out_len) {
+    uint8_t out[32];
+    fn((const uint8_t*)s.data(), s.size(), out);
+    return bytes_to_hex(out, out_len);
+}
+
+// SoA copy of n walker points plus the byte-string oracle digests.
+struct Batch {
+    std::vector<uint64_t> x[4], y[4];
+    std::vector<uint8_t> odd;
+    std::vector<std::array<uint8_t, 20>> comp, uncomp;
+
+    PubkeyBatchView view() const {
+        return PubkeyBatchView{{x[0].data(), x[1].data(), x[2].data(), x[3].data()},
+                               {y[0].data(), y[1].data(), y[2].data(), y[3].data()},
+                               odd.data(),
+                               odd.size()};
+    }
+};
+
+Batch make_batch(const U256& start, size_t n) {
+    Batch b;
+    U256 end;
+    u256_add_u64(end, start, n);
+    RangeWalker walker(start, end);
+    Point p;
+    while (walker.next(p)) {
+        for (int i = 0; i < 4; ++i) {
+            b.x[i].push_back(p.x.d[i]);
+            b.y[i].push_back(p.y.d[i]);
+        }
+        b.odd.push_back(p.y.is_odd());
+        uint8_t ser[65];
+        std::array<uint8_t, 20> d;
+        serialize_compressed(p, ser);
+        hash160(ser, 33, d.data());
+        b.comp.push_back(d);
+        serialize_uncompressed(p, ser);
+        hash160(ser, 65, d.data());
+        b.uncomp.push_back(d);
+    }
+    return b;
+}
+
+}  // namespace
+
+TEST(hash_known_vectors) {
+    CHECK_EQ(hex_of("", sha256, 32), std::string("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    CHECK_EQ(hex_of("abc", sha256, 32),
+             std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    std::string long_msg(1000, 'a');
+    CHECK_EQ(hex_of(long_msg, sha256, 32),
+             std::string("41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3"));
+    CHECK_EQ(hex_of("", ripemd160, 20), std::string("9c1185a5c5e9fc54612808977ee8f548b2258d31"));
+    CHECK_EQ(hex_of("abc", ripemd160, 20), std::string("8eb208f7e05d987a9b044a8e98c6b087f15a0bfc"));
+    CHECK_EQ(hex_of("12345678901234567890123456789012345678901234567890123456789012345678901234567890", ripemd160, 20),
+             std::string("9b752e45573d4b39f4dbd3323cab82bf63326bfb"));
+}
+
+TEST(hash160_generator_pubkeys) {
+    Batch b = make_batch(U256::from_u64(1), 1);
+    CHECK_EQ(bytes_to_hex(b.comp[0].data(), 20), std::string("751e76e8199196d454941c45d1b3a323f1433bd6"));
+    CHECK_EQ(bytes_to_hex(b.uncomp[0].data(), 20), std::string("91b24bf9f5288532960ac687abb035127b1d28a5"));
+}
+
+// Every kernel this CPU supports must agree with the byte-string oracle,
+// including the partial trailing group of lanes.
+TEST(hash160_kernels_match_oracle) {
+    Batch b = make_batch(U256::from_hex("0x1fffffff0"), 16 * 3 + 5);
+    size_t n = b.odd.size();
+    for (const Hash160Kernel* k : hash160_available()) {
+        test_log() << "hash160 kernel " << k->name << " lanes=" << k->lanes << "\n";
+        std::vector<std::array<uint8_t, 20>> out(n);
+        k->compressed(b.view(), (uint8_t(*)[20])out.data());
+        for (size_t i = 0; i < n; ++i) CHECK(out[i] == b.comp[i]);
+        k->uncompressed(b.view(), (uint8_t(*)[20])out.data());
+        for (size_t i = 0; i < n; ++i) CHECK(out[i] == b.uncomp[i]);
+        std::vector<std::array<uint8_t, 20>> comp(n), uncomp(n);
+        k->both(b.view(), (uint8_t(*)[20])comp.data(), (uint8_t(*)[20])uncomp.data());
+        for (size_t i = 0; i < n; ++i) CHECK(comp[i] == b.comp[i] && uncomp[i] == b.uncomp[i]);
+    }
+    CHECK(hash160_find("scalar") != nullptr);
+    CHECK(hash160_find("no-such-kernel") == nullptr);
+}
+
+// The walker's PointBlock output feeds the kernels without repacking.
+TEST(hash160_of_point_block) {
+    WalkerConfig config;
+    config.batch_size = 64;
+    RangeWalker walker(U256::from_hex("0x5000"), U256::from_hex("0x5100"), config);
+    auto blk = std::make_unique<PointBlock<192>>();
+    const Hash160Kernel& kernel = hash160_best();
+    while (walker.next_block(*blk, true) != 0) {
+        Batch ref = make_batch(blk->first_key, blk->count);
+        blk->hash_compressed(kernel);
+        for (size_t i = 0; i < blk->count; ++i) CHECK(std::memcmp(blk->digest[i], ref.comp[i].data(), 20) == 0);
+        blk->hash_uncompressed(kernel);
+        for (size_t i = 0; i < blk->count; ++i) CHECK(std::memcmp(blk->digest[i], ref.uncomp[i].data(), 20) == 0);
+        blk->hash_both(kernel);
+        for (size_t i = 0; i < blk->count; ++i) {
+            CHECK(std::memcmp(blk->digest[i], ref.comp[i].data(), 20) == 0);
+            CHECK(std::memcmp(blk->digest_uncompressed[i], ref.uncomp[i].data(), 20) == 0);
+        }
+    }
+}
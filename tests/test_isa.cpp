@@ -0,0 +1,153 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/batch_inverse.hpp"
+#include "marauder/bloom_kernel.hpp"
+#include "marauder/field_kernel.hpp"
+#include "marauder/fixed_base.hpp"
+#include "marauder/isa.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/reference.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+uint64_t next_random(uint64_t& seed) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed ^ (seed >> 29);
+}
+
+Fe random_fe(uint64_t& seed) {
+    U256 v{{next_random(seed), next_random(seed), next_random(seed), next_random(seed)}};
+    return Fe::from_u256(v);
+}
+
+Point random_point(uint64_t& seed) {
+    U256 k{{next_random(seed), next_random(seed), next_random(seed), next_random(seed) >> 4}};
+    return point_mul_g(Scalar::from_u256(k));
+}
+
+// Field elements that stress the reductions: 0, 1, p - 1, p - 2^32 and
+// values with long runs of set limbs.
+std::vector<Fe> edge_elements() {
+    Fe p1, p32;
+    fe_sub(p1, Fe::zero(), Fe::one());
+    fe_sub(p32, Fe::zero(), Fe::from_u64(uint64_t(1) << 32));
+    return {Fe::zero(), Fe::one(), p1, p32, Fe{{~0ULL, ~0ULL, ~0ULL, 0}}, Fe{{0, 0, 0, ~0ULL >> 1}},
+            Fe{{~0ULL, 0, ~0ULL, 0}}, Fe::from_u64(kFieldC)};
+}
+
+}  // namespace
+
+// Every field kernel returns bit for bit what the generic one does, on
+// random and boundary inputs, at lengths off the vector width and with
+// zero lanes in the batch inversion.
+TEST(field_kernels_match_generic) {
+    const FieldKernel& generic = *field_available().front();
+    CHECK_EQ(std::string(generic.name), std::string("generic"));
+    uint64_t seed = 0x243F6A8885A308D3ULL;
+    const std::vector<Fe> edges = edge_elements();
+    for (const FieldKernel* k : field_available()) {
+        test_log() << "field kernel " << k->name << "\n";
+        for (size_t n : {size_t(0), size_t(1), size_t(7), size_t(31), size_t(32), size_t(67), size_t(520)}) {
+            std::vector<Fe> in(n);
+            for (size_t i = 0; i < n; ++i) in[i] = i % 13 == 5 ? edges[i % edges.size()] : random_fe(seed);
+            std::vector<Fe> want = in, got = in, scratch(2 * n + 1);
+            generic.batch_inv(want.data(), n, scratch.data());
+            k->batch_inv(got.data(), n, scratch.data());
+            CHECK(want == got);
+            // And both agree with fe_inv lane by lane.
+            for (size_t i = 0; i < n; i += 9) {
+                Fe r = Fe::zero();
+                if (!in[i].is_zero()) fe_inv(r, in[i]);
+                CHECK(got[i] == r);
+            }
+        }
+
+        // add_batch: random steps plus lanes where the step is the base
+        // (doubling) or its negation (infinity).
+        const size_t n = 83;
+        Point base = random_point(seed);
+        std::vector<Point> steps(n);
+        for (size_t i = 0; i < n; ++i) steps[i] = random_point(seed);
+        steps[3] = base;
+        point_neg(steps[17], base);
+        steps[40] = base;
+        std::vector<Fe> inv(n), scratch(2 * n);
+        for (bool negate : {false, true}) {
+            for (size_t i = 0; i < n; ++i) fe_sub(inv[i], steps[i].x, base.x);
+            generic.batch_inv(inv.data(), n, scratch.data());
+            std::vector<Point> want(n), got(n);
+            generic.add_batch(want.data(), base, steps.data(), inv.data(), n, negate);
+            k->add_batch(got.data(), base, steps.data(), inv.data(), n, negate);
+            CHECK(want == got);
+            for (size_t i = 0; i < n; i += 5) {
+                Point s = steps[i], r;
+                if (negate) point_neg(s, s);
+                point_add(r, base, s);
+                CHECK(got[i] == r);
+            }
+        }
+        std::vector<Point> want(4), got(4);
+        std::vector<Fe> zeros(4, Fe::zero());
+        generic.add_batch(want.data(), Point::at_infinity(), steps.data(), zeros.data(), 4, false);
+        k->add_batch(got.data(), Point::at_infinity(), steps.data(), zeros.data(), 4, false);
+        CHECK(want == got);
+        CHECK(got[2] == steps[2]);
+    }
+}
+
+// A walk through each field kernel matches the reference in both modes.
+TEST(walker_runs_on_every_field_kernel) {
+    const U256 start = U256::from_hex("0xfffffffffffffe00");
+    const U256 end = U256::from_hex("0x10000000000000321");
+    for (const FieldKernel* k : field_available()) {
+        for (WalkMode mode : {WalkMode::Sequential, WalkMode::Center}) {
+            WalkerConfig config;
+            config.mode = mode;
+            config.batch_size = 256;
+            config.field = k;
+            RangeWalker walker(start, end, config);
+            Point pub;
+            size_t i = 0;
+            while (walker.next(pub)) {
+                if (i++ % 61 == 0) CHECK(pub == reference_pubkey(walker.key()));
+            }
+            CHECK_EQ(i, size_t(0x521));
+        }
+    }
+}
+
+// Every Bloom kernel passes exactly the digests the scalar one does.
+TEST(bloom_kernels_match_scalar) {
+    uint64_t seed = 0x13198A2E03707344ULL;
+    for (size_t keys : {size_t(1), size_t(3000)}) {
+        BloomFilter bloom(keys, 8);  // dense, so plenty of false positives
+        std::vector<uint8_t> digests(20 * 4099);
+        for (uint8_t& b : digests) b = static_cast<uint8_t>(next_random(seed));
+        const auto* d = reinterpret_cast<const uint8_t(*)[20]>(digests.data());
+        for (size_t i = 0; i < 4099; i += 3) {
+            if (i / 3 < keys) bloom.insert(d[i]);
+        }
+        const BloomKernel& scalar = *bloom_available().front();
+        std::vector<uint32_t> want(4099), got(4099);
+        size_t nw = scalar.filter(bloom, d, 4099, want.data());
+        CHECK(nw >= std::min<size_t>(keys, 1367));
+        for (const BloomKernel* k : bloom_available()) {
+            size_t ng = k->filter(bloom, d, 4099, got.data());
+            test_log() << "bloom kernel " << k->name << ": " << ng << " of 4099 pass\n";
+            CHECK_EQ(ng, nw);
+            CHECK(std::memcmp(got.data(), want.data(), nw * sizeof(uint32_t)) == 0);
+        }
+    }
+}
+
+TEST(isa_report_names_chosen_kernels) {
+    std::string r = isa_report();
+    CHECK(r.find(std::string("field:   ") + field_best().name) != std::string::npos);
+    CHECK(r.find(std::string("bloom:   ") + bloom_best().name) != std::string::npos);
+}
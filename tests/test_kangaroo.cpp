@@ -0,0 +1,57 @@
+#include <stdexcept>
+
+#include "harness.hpp"
+#include "marauder/kangaroo.hpp"
+#include "marauder/point.hpp"
+#include "marauder/scalar.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+Point pub_of(const U256& k) { return point_mul_g(Scalar::from_u256(k)); }
+
+}  // namespace
+
+// Keys anywhere in a 2^36-wide range, including both ends, are recovered in
+// a small multiple of 2 * sqrt(width) jumps.
+TEST(kangaroo_solves_range) {
+    const U256 start = U256::from_hex("0x9a000000000");
+    const U256 end = U256::from_hex("0xaa000000000");
+    KangarooConfig cfg;
+    cfg.threads = 2;
+    cfg.herd = 256;
+    for (const char* k : {"0x9a000000000", "0x9f123456789", "0xa9fffffffff"}) {
+        U256 key = U256::from_hex(k);
+        KangarooResult r = kangaroo_solve(pub_of(key), start, end, cfg);
+        CHECK(r.found);
+        CHECK(r.key == key);
+        CHECK(r.jumps < 8 * r.expected_jumps);
+        test_log() << "kangaroo " << k << ": " << r.jumps << " jumps (expected " << r.expected_jumps << "), "
+                   << r.dps << " DPs at " << r.dp_bits << " bits, " << r.restarts << " restarts\n";
+    }
+}
+
+TEST(kangaroo_small_and_hopeless_ranges) {
+    // Narrow ranges are walked directly.
+    KangarooResult small = kangaroo_solve(pub_of(U256::from_u64(1000)), U256::from_u64(1), U256::from_u64(5000));
+    CHECK(small.found && small.key == U256::from_u64(1000));
+
+    // A key outside the range is never found; max_jumps ends the search.
+    KangarooConfig cfg;
+    cfg.herd = 64;
+    cfg.max_jumps = 100000;
+    KangarooResult lost =
+        kangaroo_solve(pub_of(U256::from_u64(7)), U256::from_hex("0x100000000"), U256::from_hex("0x200000000"), cfg);
+    CHECK(!lost.found);
+    CHECK(lost.jumps >= cfg.max_jumps);
+
+    bool threw = false;
+    try {
+        kangaroo_solve(pub_of(U256::from_u64(7)), U256::from_u64(10), U256::from_u64(10));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
@@ -0,0 +1,178 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/metrics.hpp"
+#include "marauder/metrics_server.hpp"
+#include "marauder/point.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/profile.hpp"
+#include "marauder/scan.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+// The value of the sample line that starts with prefix, or -1.
+double sample_value(const std::string& text, const std::string& prefix) {
+    size_t at = text.find("\n" + prefix + " ");
+    if (at == std::string::npos) return -1;
+    return std::stod(text.substr(at + prefix.size() + 2));
+}
+
+std::string http_get(uint16_t port, const std::string& path) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string out;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        std::string req = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        if (::send(fd, req.data(), req.size(), 0) == static_cast<ssize_t>(req.size())) {
+            char buf[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) out.append(buf, static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+    return out;
+}
+
+}  // namespace
+
+TEST(histogram_buckets_by_power_of_two) {
+    Histogram h;
+    h.observe(0.0001);  // below the first bound
+    h.observe(0.5);
+    h.observe(1.0);     // bounds are inclusive
+    h.observe(1.5);
+    h.observe(1e6);     // +Inf
+    CHECK_EQ(h.count(), uint64_t(5));
+    CHECK_EQ(h.bucket(0), uint64_t(1));
+    CHECK_EQ(h.bucket(9), uint64_t(1));   // (2^-2, 2^-1]
+    CHECK_EQ(h.bucket(10), uint64_t(1));  // (2^-1, 1]
+    CHECK_EQ(h.bucket(11), uint64_t(1));  // (1, 2]
+    CHECK_EQ(h.bucket(kHistogramBuckets - 1), uint64_t(1));
+    CHECK(h.sum() > 1e6 && h.sum() < 1e6 + 4);
+}
+
+// A scan with metrics attached counts exactly what its stats report, per
+// worker, and the endpoint serves the same text.
+TEST(scan_metrics_match_stats) {
+    const U256 start = U256::from_hex("0x30000");
+    uint8_t pub[33];
+    serialize_compressed(point_mul_g(Scalar::from_u64(0x31234)), pub);
+    std::vector<Hash160> digests(1);
+    hash160(pub, sizeof(pub), digests[0].data());
+    TargetSet targets(TargetTable::from_digests(digests));
+
+    Metrics metrics;
+    ScanConfig cfg;
+    cfg.threads = 3;
+    cfg.unit_bits = 12;
+    cfg.walker.batch_size = 256;
+    cfg.targets = &targets;
+    cfg.metrics = &metrics;
+    ScanStats stats = scan_range(start, U256::from_hex("0x38000"), cfg, [](const ScanHit&) {});
+    CHECK_EQ(stats.hits, uint64_t(1));
+
+    std::string text = metrics.render();
+    test_log() << text.substr(0, text.find("# HELP marauder_bloom_false")) << "\n";
+    double keys = 0, units = 0, lookups = 0;
+    for (int w = 0; w < 3; ++w) {
+        std::string labels = "{worker=\"cpu" + std::to_string(w) + "\",kind=\"cpu\"}";
+        keys += sample_value(text, "marauder_keys_total" + labels);
+        units += sample_value(text, "marauder_units_total" + labels);
+        lookups += sample_value(text, "marauder_bloom_lookups_total" + labels);
+    }
+    CHECK_EQ(keys, double(stats.keys));
+    CHECK_EQ(lookups, double(stats.keys));
+    CHECK_EQ(units, double(stats.units));
+    CHECK_EQ(units, 8.0);
+    CHECK_EQ(sample_value(text, "marauder_unit_seconds_count{kind=\"cpu\"}"), 8.0);
+    CHECK_EQ(sample_value(text, "marauder_unit_seconds_bucket{kind=\"cpu\",le=\"+Inf\"}"), 8.0);
+    double fp = sample_value(text, "marauder_bloom_false_positive_ratio");
+    CHECK(fp >= 0 && fp < 0.01);
+    // The scan's gauges are gone once it returns.
+    CHECK(text.find("marauder_units_unassigned") == std::string::npos);
+
+    // A second scan keeps adding to the same workers.
+    scan_range(start, U256::from_hex("0x31000"), cfg, [](const ScanHit&) {});
+    text = metrics.render();
+    CHECK_EQ(sample_value(text, "marauder_unit_seconds_count{kind=\"cpu\"}"), 9.0);
+
+    MetricsServer server(metrics, "127.0.0.1", 0);
+    std::string reply = http_get(server.port(), "/metrics");
+    CHECK(reply.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+    CHECK(reply.find("text/plain; version=0.0.4") != std::string::npos);
+    CHECK(reply.find(text.substr(0, 200)) != std::string::npos);
+    CHECK(http_get(server.port(), "/other").rfind("HTTP/1.0 404", 0) == 0);
+}
+
+// Gauges registered during a scan are visible to a scrape while it runs.
+TEST(metrics_gauges_come_and_go) {
+    Metrics metrics;
+    uint64_t a = metrics.add_gauge("marauder_test_depth", "Test gauge.", "worker=\"x\"", [] { return 3.0; });
+    metrics.add_gauge("marauder_test_depth", "Test gauge.", "worker=\"y\"", [] { return 4.0; });
+    std::string text = metrics.render();
+    CHECK_EQ(sample_value(text, "marauder_test_depth{worker=\"x\"}"), 3.0);
+    CHECK_EQ(sample_value(text, "marauder_test_depth{worker=\"y\"}"), 4.0);
+    size_t first = text.find("# TYPE marauder_test_depth gauge");
+    CHECK(first != std::string::npos && text.find("# TYPE marauder_test_depth", first + 1) == std::string::npos);
+    metrics.remove_gauge(a);
+    CHECK_EQ(sample_value(metrics.render(), "marauder_test_depth{worker=\"x\"}"), -1.0);
+}
+
+// Profiling builds account every candidate to the loop's stages, in the
+// stats and per worker on the endpoint; other builds leave both empty.
+TEST(scan_profile_covers_every_stage) {
+    uint8_t pub[33];
+    serialize_compressed(point_mul_g(Scalar::from_u64(0x41234)), pub);
+    std::vector<Hash160> digests(1);
+    hash160(pub, sizeof(pub), digests[0].data());
+    TargetSet targets(TargetTable::from_digests(digests));
+
+    Metrics metrics;
+    ScanConfig cfg;
+    cfg.threads = 2;
+    cfg.unit_bits = 12;
+    cfg.endomorphism = true;
+    cfg.targets = &targets;
+    cfg.metrics = &metrics;
+    ScanStats stats = scan_range(U256::from_hex("0x40000"), U256::from_hex("0x44000"), cfg, [](const ScanHit&) {});
+    CHECK_EQ(stats.hits, uint64_t(1));
+    std::string text = metrics.render();
+    const ScanProfile& p = stats.profile;
+    test_log() << format_profile(p);
+    if (!kProfiling) {
+        CHECK_EQ(p.ticks(), uint64_t(0));
+        CHECK_EQ(p.keys, uint64_t(0));
+        CHECK(text.find("marauder_stage_") == std::string::npos);
+        return;
+    }
+    CHECK_EQ(p.workers, 2u);
+    CHECK_EQ(p.keys, stats.keys);
+    CHECK_EQ(p.blocks * kBlockLanes * kEndoCandidates, stats.keys);
+    for (ScanStage s : {ScanStage::Walk, ScanStage::Endomorphism, ScanStage::Hash, ScanStage::Bloom}) {
+        CHECK(p[s].ticks > 0);
+    }
+    double ticks = 0;
+    for (int w = 0; w < 2; ++w) {
+        for (size_t s = 0; s < kScanStages; ++s) {
+            ticks += sample_value(text, "marauder_stage_ticks_total{worker=\"cpu" + std::to_string(w) +
+                                            "\",kind=\"cpu\",stage=\"" + scan_stage_name(ScanStage(s)) + "\"}");
+        }
+    }
+    CHECK_EQ(ticks, double(p.ticks()));
+}
@@ -0,0 +1,455 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/arena.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/endomorphism.hpp"
+#include "marauder/hash.hpp"
+#include "marauder/hit_reporter.hpp"
+#include "marauder/partitioner.hpp"
+#include "marauder/reference.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/spsc_ring.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/topology.hpp"
+#include "marauder/work_deque.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+TEST(work_deque_owner_and_thief_ends) {
+    WorkDeque dq;
+    UnitSpan s{0, 0};
+    CHECK(!dq.pop(s));
+    CHECK(!dq.steal(s));
+    for (uint64_t i = 0; i < 5; ++i) dq.push(UnitSpan{i, i + 1});
+    CHECK(dq.steal(s));
+    CHECK_EQ(s.lo, uint64_t(0));
+    CHECK(dq.pop(s));
+    CHECK_EQ(s.lo, uint64_t(4));
+    CHECK(dq.pop(s) && dq.pop(s) && dq.pop(s));
+    CHECK_EQ(s.lo, uint64_t(1));
+    CHECK(!dq.pop(s));
+    CHECK(dq.empty());
+
+    // Slots wrap around the fixed buffer.
+    for (size_t i = 0; i < 3 * kWorkDequeCapacity; ++i) {
+        dq.push(UnitSpan{i, i + 1});
+        CHECK(dq.pop(s));
+        CHECK_EQ(s.lo, uint64_t(i));
+    }
+}
+
+// Every unit is handed out exactly once and the units tile the range, even
+// when one worker is much slower than the rest and the others steal from it.
+TEST(partitioner_covers_range_exactly) {
+    const U256 start = U256::from_hex("0x1234");
+    const U256 end = U256::from_hex("0x7a3e5");  // not a multiple of the unit size
+    const unsigned workers = 8;
+    RangePartitioner part(start, end, workers, 6);
+    test_log() << part.unit_count() << " units over " << workers << " workers\n";
+
+    std::vector<std::vector<WorkUnit>> got(workers);
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            WorkUnit u;
+            while (part.next(w, u)) {
+                got[w].push_back(u);
+                if (w == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+
+    std::vector<WorkUnit> all;
+    uint64_t steals = 0;
+    for (unsigned w = 0; w < workers; ++w) {
+        all.insert(all.end(), got[w].begin(), got[w].end());
+        steals += part.steals(w);
+        test_log() << "worker " << w << ": " << got[w].size() << " units, " << part.steals(w) << " steals\n";
+    }
+    CHECK(steals > 0);
+    CHECK_EQ(all.size(), part.unit_count());
+    std::sort(all.begin(), all.end(), [](const WorkUnit& a, const WorkUnit& b) { return a.index < b.index; });
+    U256 next = start;
+    for (size_t i = 0; i < all.size(); ++i) {
+        CHECK_EQ(all[i].index, uint64_t(i));
+        CHECK(all[i].start == next);
+        CHECK(all[i].start < all[i].end);
+        next = all[i].end;
+    }
+    CHECK(next == end);
+}
+
+TEST(partitioner_rejects_bad_input) {
+    auto throws = [](const U256& s, const U256& e, unsigned workers, unsigned bits) {
+        try {
+            RangePartitioner p(s, e, workers, bits);
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws(U256::from_u64(5), U256::from_u64(4), 1, 4));
+    CHECK(throws(U256::from_u64(1), U256::from_u64(9), 0, 4));
+    CHECK(throws(U256::from_u64(1), U256::from_hex("0x1000000000000000000000000"), 1, 16));
+    CHECK(!throws(U256::from_u64(1), U256::from_hex("0x1000000000000000000000000"), 1, 40));
+
+    // An empty range has no units.
+    RangePartitioner empty(U256::from_u64(7), U256::from_u64(7), 2, 4);
+    WorkUnit u;
+    CHECK(!empty.next(1, u));
+}
+
+TEST(cpu_topology_parsing_and_placement) {
+    CHECK(parse_cpu_list("0-3,8,10-11\n") == std::vector<unsigned>({0, 1, 2, 3, 8, 10, 11}));
+    CHECK(parse_cpu_list("5") == std::vector<unsigned>({5}));
+    bool threw = false;
+    try {
+        parse_cpu_list("3-1");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // A fake two-node sysfs tree; node1 sorts after node0 numerically, and
+    // CPUs outside the affinity mask are dropped.
+    const std::string dir = "test_sysfs.tmp";
+    ::mkdir(dir.c_str(), 0755);
+    for (const char* n : {"node0", "node1", "possible"}) ::mkdir((dir + "/" + n).c_str(), 0755);
+    std::ofstream(dir + "/node0/cpulist") << "0-3,8-11\n";
+    std::ofstream(dir + "/node1/cpulist") << "4-7,12-15\n";
+    CpuTopology topo = read_cpu_topology(dir, {0, 1, 2, 4, 5, 12, 20});
+    CHECK_EQ(topo.nodes.size(), size_t(2));
+    CHECK(topo.nodes[0] == std::vector<unsigned>({0, 1, 2, 20}));  // 20 is on no node
+    CHECK(topo.nodes[1] == std::vector<unsigned>({4, 5, 12}));
+    for (const char* f : {"/node0/cpulist", "/node1/cpulist"}) std::remove((dir + f).c_str());
+    for (const char* n : {"/node0", "/node1", "/possible", ""}) ::rmdir((dir + n).c_str());
+
+    std::vector<WorkerPlacement> p = place_workers(topo, 5);
+    CHECK(p[0].cpu == 0 && p[0].node == 0);
+    CHECK(p[1].cpu == 4 && p[1].node == 1);
+    CHECK(p[2].cpu == 1 && p[3].cpu == 5 && p[4].cpu == 2);
+
+    // Without sysfs every allowed CPU is on node 0.
+    CpuTopology flat = read_cpu_topology("test_no_such_dir.tmp", {3, 1});
+    CHECK_EQ(flat.nodes.size(), size_t(1));
+    CHECK(flat.nodes[0] == std::vector<unsigned>({1, 3}));
+    CHECK(!cpu_topology().nodes.empty());
+}
+
+// A thief drains its own node before it steals across nodes.
+TEST(partitioner_steals_within_node_first) {
+    RangePartitioner part(U256::from_u64(1), U256::from_u64(1 + 64 * 100), 4, 6);
+    part.set_worker_nodes({0, 1, 0, 1});
+    // Worker 0 runs alone, so everything it finishes beyond its own share
+    // comes from a thief's visit: first worker 2's share, then the others'.
+    WorkUnit u;
+    for (int i = 0; i < 50; ++i) CHECK(part.next(0, u));
+    CHECK_EQ(part.remote_steals(0), uint64_t(0));
+    CHECK(part.steals(0) > 0);
+    while (part.next(0, u)) {
+    }
+    CHECK(part.remote_steals(0) > 0);
+}
+
+// A threaded scan reports the same candidates as the oracle, whatever the
+// thread count and unit size.
+TEST(scan_range_threads_agree) {
+    const U256 start = U256::from_hex("0x50000");
+    const U256 end = U256::from_hex("0x53000");
+    ScanConfig cfg;
+    cfg.walker.batch_size = 256;
+    cfg.report_all = true;
+    cfg.endomorphism = true;
+
+    auto run = [&](unsigned threads, unsigned unit_bits) {
+        cfg.threads = threads;
+        cfg.unit_bits = unit_bits;
+        std::set<std::string> seen;
+        ScanStats stats = scan_range(start, end, cfg, [&](const ScanHit& h) {
+            seen.insert(h.key.to_hex() + bytes_to_hex(h.pubkey, 33));
+        });
+        CHECK_EQ(stats.keys, uint64_t(0x3000 * kEndoCandidates));
+        CHECK_EQ(stats.hits, stats.keys);
+        return seen;
+    };
+    std::set<std::string> one = run(1, 32);
+    CHECK_EQ(one.size(), size_t(0x3000 * kEndoCandidates));
+    CHECK(run(4, 9) == one);
+    CHECK(run(7, 10) == one);
+    cfg.pin_threads = true;
+    CHECK(run(3, 9) == one);
+    cfg.pin_threads = false;
+
+    // Spot-check candidate keys against the reference.
+    size_t i = 0;
+    for (const std::string& s : one) {
+        if (i++ % 997) continue;
+        U256 k = U256::from_hex(s.substr(0, 64));
+        uint8_t pub[33];
+        serialize_compressed(reference_pubkey(k), pub);
+        CHECK_EQ(s.substr(64), bytes_to_hex(pub, 33));
+    }
+}
+
+// Uncompressed targets are only matched when asked for, including those
+// reached through an endomorphism pass, and the hit says which encoding.
+TEST(scan_range_matches_uncompressed_targets) {
+    const U256 start = U256::from_hex("0x70000");
+    const U256 end = U256::from_hex("0x72000");
+    auto digest = [](const U256& key, bool uncompressed) {
+        uint8_t ser[65];
+        Hash160 d;
+        if (uncompressed) {
+            serialize_uncompressed(reference_pubkey(key), ser);
+            hash160(ser, 65, d.data());
+        } else {
+            serialize_compressed(reference_pubkey(key), ser);
+            hash160(ser, 33, d.data());
+        }
+        return d;
+    };
+    const U256 kc = U256::from_hex("0x70123"), ku = U256::from_hex("0x71abc");
+    const U256 ke = endo_candidate_key(Scalar::from_u256(U256::from_hex("0x71000")), 5).to_u256();
+    TargetSet targets(TargetTable::from_digests({digest(kc, false), digest(ku, true), digest(ke, true)}));
+    ScanConfig cfg;
+    cfg.threads = 2;
+    cfg.unit_bits = 11;
+    cfg.walker.batch_size = 256;
+    cfg.endomorphism = true;
+    cfg.targets = &targets;
+
+    auto run = [&] {
+        std::vector<ScanHit> hits;
+        ScanStats stats = scan_range(start, end, cfg, [&](const ScanHit& h) { hits.push_back(h); });
+        CHECK_EQ(stats.hits, uint64_t(hits.size()));
+        std::sort(hits.begin(), hits.end(), [](const ScanHit& a, const ScanHit& b) { return a.key < b.key; });
+        return hits;
+    };
+    std::vector<ScanHit> compressed = run();
+    CHECK_EQ(compressed.size(), size_t(1));
+    CHECK(compressed[0].key == kc && !compressed[0].uncompressed);
+
+    cfg.uncompressed = true;
+    std::vector<ScanHit> both = run();
+    CHECK_EQ(both.size(), size_t(3));
+    size_t flagged = 0;
+    for (const ScanHit& h : both) {
+        CHECK(h.key == kc || h.key == ku || h.key == ke);
+        CHECK(h.uncompressed == (h.key != kc));
+        CHECK(h.digest == digest(h.key, h.uncompressed));
+        flagged += h.uncompressed;
+    }
+    CHECK_EQ(flagged, size_t(2));
+
+    cfg.report_all = true;
+    bool threw = false;
+    try {
+        run();
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(spsc_ring_keeps_order_across_threads) {
+    auto ring = std::make_unique<SpscRing<uint64_t, 64>>();
+    CHECK(ring->drained());
+    const uint64_t n = 200000;
+    std::thread consumer([&] {
+        for (uint64_t want = 0; want < n;) {
+            const uint64_t* v = ring->front();
+            if (!v) continue;
+            if (*v != want) break;
+            ring->pop();
+            ++want;
+        }
+    });
+    for (uint64_t i = 0; i < n; ++i) {
+        while (!ring->try_push(i)) std::this_thread::yield();
+    }
+    consumer.join();
+    CHECK(ring->drained());
+    for (uint64_t i = 0; i < 64; ++i) CHECK(ring->try_push(i));
+    CHECK(!ring->try_push(64));
+}
+
+// The reporter drops Bloom false positives, fills in the reference public
+// key of real hits and refuses a hit whose key does not hash to its digest.
+TEST(hit_reporter_verifies_hits) {
+    auto candidate = [](uint64_t key, uint64_t digest_key) {
+        ScanHit c{};
+        c.key = U256::from_u64(key);
+        uint8_t pub[33];
+        serialize_compressed(reference_pubkey(U256::from_u64(digest_key)), pub);
+        hash160(pub, sizeof(pub), c.digest.data());
+        return c;
+    };
+    TargetSet targets(TargetTable::from_digests({candidate(7, 7).digest, candidate(9, 9).digest}));
+    std::vector<ScanHit> seen;
+    {
+        HitReporter reporter(2, &targets, [&](const ScanHit& h) { seen.push_back(h); });
+        CHECK(reporter.push(0, candidate(7, 7)));
+        CHECK(reporter.push(1, candidate(8, 8)));  // not a target
+        CHECK(reporter.push(1, candidate(9, 9)));
+        CHECK(reporter.flush(0) && reporter.flush(1));
+        CHECK_EQ(seen.size(), size_t(2));
+        reporter.finish();
+        CHECK_EQ(reporter.hits(0), uint64_t(1));
+        CHECK_EQ(reporter.hits(1), uint64_t(1));
+    }
+    uint8_t pub[33];
+    serialize_compressed(reference_pubkey(U256::from_u64(9)), pub);
+    CHECK(std::equal(pub, pub + 33, seen.back().pubkey));
+
+    HitReporter bad(1, &targets, [&](const ScanHit& h) { seen.push_back(h); });
+    CHECK(bad.push(0, candidate(6, 7)));
+    CHECK(!bad.flush(0));
+    CHECK(!bad.push(0, candidate(7, 7)));
+    bool threw = false;
+    try {
+        bad.finish();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQ(seen.size(), size_t(2));
+}
+
+TEST(arena_slices_and_allocation_counter) {
+    Arena arena(100000);
+    CHECK(arena.capacity() >= 100000);
+    uint8_t* a = arena.alloc<uint8_t>(3);
+    uint64_t* b = arena.alloc<uint64_t>(10);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(a) % Arena::kAlign, uintptr_t(0));
+    CHECK_EQ(reinterpret_cast<uint8_t*>(b) - a, std::ptrdiff_t(64));
+    CHECK_EQ(arena.used(), size_t(64 + 128));
+    CHECK_EQ(b[9], uint64_t(0));  // fresh pages
+    bool threw = false;
+    try {
+        arena.alloc<uint8_t>(arena.capacity());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    test_log() << "arena of " << arena.capacity() << " bytes, huge pages: " << arena.huge_pages() << "\n";
+
+    // tests/alloc_counter.cpp counts for the whole suite.
+    CHECK(counting_allocations());
+    uint64_t before = thread_allocations();
+    auto p = std::make_unique<int>(1);
+    CHECK_EQ(thread_allocations() - before, uint64_t(1));
+
+    // A walker working in carved scratch allocates nothing, even the first.
+    WalkerConfig config;
+    config.batch_size = 128;
+    Arena work(WalkerScratch::arena_bytes(128) + Arena::slice_bytes<DefaultPointBlock>(1));
+    WalkerScratch scratch = WalkerScratch::carve(work, 128);
+    DefaultPointBlock* blk = work.make<DefaultPointBlock>();
+    RangeWalker warmup(U256::from_u64(1), U256::from_u64(1000), config, &scratch);
+    warmup.next_block(*blk);
+    before = thread_allocations();
+    size_t n;
+    {
+        RangeWalker walker(U256::from_u64(5000), U256::from_u64(9000), config, &scratch);
+        n = walker.next_block(*blk, true);
+    }
+    CHECK_EQ(thread_allocations(), before);
+    CHECK_EQ(n, kBlockLanes < 4000 ? kBlockLanes : size_t(4000));
+    CHECK(blk->point(n - 1) == reference_pubkey(blk->key(n - 1)));
+
+    config.batch_size = 256;
+    threw = false;
+    try {
+        RangeWalker walker(U256::from_u64(1), U256::from_u64(1000), config, &scratch);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Every order visits each unit exactly once, and a partitioner hands out
+// each position once with the unit the order puts there.
+TEST(unit_orders_are_permutations) {
+    for (uint64_t units : {0, 1, 2, 3, 5, 64, 1000, 4097}) {
+        for (uint64_t seed : {1, 2}) {
+            UnitPermutation perm(UnitOrder::random(seed), units);
+            CHECK_EQ(perm.size(), units);
+            std::set<uint64_t> seen;
+            uint64_t fixed = 0;
+            for (uint64_t p = 0; p < units; ++p) {
+                uint64_t u = perm(p);
+                CHECK(u < units);
+                seen.insert(u);
+                fixed += u == p;
+            }
+            CHECK_EQ(seen.size(), size_t(units));
+            if (units >= 64) CHECK(fixed < units / 8);
+        }
+        std::set<uint64_t> strided;
+        uint64_t total = 0;
+        for (uint64_t node = 0; node < 3; ++node) {
+            UnitPermutation perm(UnitOrder::strided(node, 3), units);
+            total += perm.size();
+            for (uint64_t p = 0; p < perm.size(); ++p) {
+                CHECK_EQ(perm(p) % 3, node);
+                strided.insert(perm(p));
+            }
+        }
+        CHECK_EQ(total, units);
+        CHECK_EQ(strided.size(), size_t(units));
+    }
+    CHECK(UnitPermutation(UnitOrder::random(1), 1000)(7) != UnitPermutation(UnitOrder::random(2), 1000)(7) ||
+          UnitPermutation(UnitOrder::random(1), 1000)(8) != UnitPermutation(UnitOrder::random(2), 1000)(8));
+
+    for (const UnitOrder& o : {UnitOrder(), UnitOrder::random(0xabc), UnitOrder::strided(2, 5)}) {
+        CHECK(parse_unit_order(o.name()) == o);
+    }
+    CHECK(parse_unit_order("random:0xABC") == UnitOrder::random(0xabc));
+    for (const char* bad : {"random", "random:xyz", "strided:3/3", "strided:1", "shuffled"}) {
+        bool threw = false;
+        try {
+            parse_unit_order(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    const U256 start = U256::from_u64(1), end = U256::from_u64(1 + 64 * 300);
+    const UnitOrder order = UnitOrder::random(99);
+    RangePartitioner part(start, end, 3, 6, nullptr, order);
+    UnitPermutation perm(order, part.unit_count());
+    std::set<uint64_t> positions, indexes;
+    for (unsigned w = 0; w < 3; ++w) {
+        WorkUnit u;
+        while (part.next(w, u)) {
+            CHECK_EQ(u.index, perm(u.position));
+            positions.insert(u.position);
+            indexes.insert(u.index);
+        }
+    }
+    CHECK_EQ(positions.size(), size_t(300));
+    CHECK_EQ(indexes.size(), size_t(300));
+    test_log() << order.name() << " visits unit " << perm(0) << " first of " << part.unit_count() << "\n";
+
+    RangePartitioner node(start, end, 2, 6, nullptr, UnitOrder::strided(1, 4));
+    CHECK_EQ(node.position_count(), uint64_t(75));
+    WorkUnit u;
+    CHECK(node.next(0, u));
+    CHECK_EQ(u.index % 4, uint64_t(1));
+}
@@ -0,0 +1,302 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/batch_inverse.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/fixed_base.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/reference.hpp"
+#include "marauder/scalar.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+std::string compressed_hex(const Point& p) {
+    uint8_t buf[33];
+    serialize_compressed(p, buf);
+    return bytes_to_hex(buf, sizeof(buf));
+}
+
+// Walks [start, end) and checks every key against the reference, logging
+// "key pubkey" oracle lines to test_output.txt.
+void check_range(const U256& start, const U256& end, size_t batch_size = WalkerConfig().batch_size,
+                 WalkMode mode = WalkMode::Sequential) {
+    WalkerConfig config;
+    config.batch_size = batch_size;
+    config.mode = mode;
+    RangeWalker walker(start, end, config);
+    Point pub;
+    U256 expected_key = start;
+    while (walker.next(pub)) {
+        CHECK(walker.key() == expected_key);
+        Point ref = reference_pubkey(walker.key());
+        CHECK(pub == ref);
+        test_log() << walker.key().to_hex() << " " << compressed_hex(ref) << "\n";
+        u256_add_u64(expected_key, expected_key, 1);
+    }
+    CHECK(expected_key == end);
+    CHECK(walker.remaining().is_zero());
+}
+
+U256 order_minus(uint64_t v) {
+    U256 r;
+    u256_sub(r, kOrderN, U256::from_u64(v));
+    return r;
+}
+
+}  // namespace
+
+TEST(reference_known_vectors) {
+    CHECK_EQ(compressed_hex(reference_pubkey(U256::from_u64(1))),
+             std::string("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"));
+    CHECK_EQ(compressed_hex(reference_pubkey(U256::from_u64(2))),
+             std::string("02c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee5"));
+    CHECK_EQ(compressed_hex(reference_pubkey(U256::from_u64(3))),
+             std::string("02f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9"));
+
+    Point minus_g;
+    point_neg(minus_g, kGenerator);
+    CHECK(reference_pubkey(order_minus(1)) == minus_g);
+}
+
+TEST(point_mul_matches_reference) {
+    U256 k = U256::from_hex("0x2832ed74f2b5e35ee");  // puzzle #66 range magnitude
+    for (int i = 0; i < 16; ++i) {
+        CHECK(point_mul_g(Scalar::from_u256(k)) == reference_pubkey(k));
+        u256_mul_u64(k, k, 0x9E3779B97F4A7C15ULL);
+        if (k >= kOrderN || k.is_zero()) k = U256::from_u64(i + 1);
+    }
+}
+
+// The table path against double-and-add, at the digit recoding edges:
+// bytes 0x80/0x81 (largest positive digit, first carry), 0xFF runs that
+// carry through every window, and the top of the group.
+TEST(fixed_base_matches_double_and_add) {
+    CHECK(point_mul_g(Scalar::zero()).infinity);
+    std::vector<U256> keys;
+    for (uint64_t v : {1ULL, 2ULL, 127ULL, 128ULL, 129ULL, 255ULL, 256ULL, 0x8080ULL, 0x8181ULL, 0xFFFFULL}) {
+        keys.push_back(U256::from_u64(v));
+    }
+    keys.push_back(U256::from_hex("0x8080808080808080808080808080808080808080808080808080808080808080"));
+    keys.push_back(U256::from_hex("0x8181818181818181818181818181818181818181818181818181818181818181"));
+    keys.push_back(U256::from_hex("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140"));  // n - 1
+    keys.push_back(U256::from_hex("0x7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0"));  // n / 2
+    U256 k = U256::from_hex("0x9e3779b97f4a7c15f39cc0605cedc834");
+    for (int i = 0; i < 64; ++i) {
+        u256_mul_u64(k, k, 0xBF58476D1CE4E5B9ULL);
+        u256_add_u64(k, k, i);
+        keys.push_back(Scalar::from_u256(k).to_u256());
+    }
+    for (const U256& key : keys) {
+        const Scalar s = Scalar::from_u256(key);
+        CHECK(point_mul_g(s) == point_mul(s, kGenerator));
+    }
+    CHECK(GTable::get().entry(1, 1) == point_mul_g(Scalar::from_u256(U256::from_u64(256))));
+}
+
+TEST(parse_pubkey_round_trip) {
+    Point p = reference_pubkey(U256::from_hex("deadbeef"));
+    uint8_t comp[33], uncomp[65];
+    serialize_compressed(p, comp);
+    serialize_uncompressed(p, uncomp);
+    Point q;
+    CHECK(parse_pubkey(q, comp, sizeof(comp)) && q == p);
+    CHECK(parse_pubkey(q, uncomp, sizeof(uncomp)) && q == p);
+    uncomp[64] ^= 1;
+    CHECK(!parse_pubkey(q, uncomp, sizeof(uncomp)));
+}
+
+TEST(batch_inverse_matches_single) {
+    Fe elems[37], expect[37], scratch[37];
+    U256 v = U256::from_hex("0x123456789abcdef0fedcba9876543210");
+    for (int i = 0; i < 37; ++i) {
+        u256_mul_u64(v, v, 0x9E3779B97F4A7C15ULL);
+        elems[i] = (i % 11 == 5) ? Fe::zero() : Fe::from_u256(v);
+        fe_inv(expect[i], elems[i]);
+    }
+    fe_batch_inv(elems, 37, scratch);
+    for (int i = 0; i < 37; ++i) CHECK(elems[i] == expect[i]);
+}
+
+TEST(batch_to_affine_matches_single) {
+    JPoint jac[9];
+    JPoint acc = JPoint::from_affine(kGenerator);
+    for (int i = 0; i < 9; ++i) {
+        jac[i] = acc;
+        jpoint_double(acc, acc);
+    }
+    jac[4] = JPoint::at_infinity();
+    Point out[9];
+    Fe scratch[18];
+    jpoint_batch_to_affine(out, jac, 9, scratch);
+    for (int i = 0; i < 9; ++i) {
+        Point expect;
+        jpoint_to_affine(expect, jac[i]);
+        CHECK(out[i] == expect);
+    }
+}
+
+// Keys 1..B hit the doubling and infinity lanes of the first batches.
+TEST(range_walker_low_keys) {
+    for (size_t batch : {1, 2, 3, 16, 1024}) check_range(U256::from_u64(1), U256::from_u64(64), batch);
+}
+
+TEST(range_walker_puzzle_range) {
+    check_range(U256::from_hex("0x80000000"), U256::from_hex("0x80000040"));
+    check_range(U256::from_hex("0x80000000"), U256::from_hex("0x80000123"), 32);
+}
+
+TEST(range_walker_top_of_group) {
+    check_range(order_minus(8), kOrderN);
+    check_range(order_minus(21), kOrderN, 4);
+}
+
+TEST(center_walker_matches_reference) {
+    for (size_t batch : {1, 2, 5, 16, 1024}) {
+        check_range(U256::from_u64(1), U256::from_u64(70), batch, WalkMode::Center);
+    }
+    check_range(U256::from_hex("0x80000000"), U256::from_hex("0x80000123"), 64, WalkMode::Center);
+    // The centre of the last batch lands on or past n here.
+    check_range(order_minus(21), kOrderN, 8, WalkMode::Center);
+    check_range(order_minus(4), kOrderN, 8, WalkMode::Center);
+}
+
+TEST(range_walker_batches_cover_range) {
+    WalkerConfig config;
+    config.batch_size = 512;
+    U256 start = U256::from_hex("0x20000000000000000");
+    U256 end;
+    u256_add_u64(end, start, 512 * 3 + 7);
+    RangeWalker walker(start, end, config);
+    const Point* points;
+    U256 first, expected = start;
+    size_t total = 0, n;
+    while ((n = walker.next_batch(points, first)) != 0) {
+        CHECK(first == expected);
+        CHECK(points[0] == reference_pubkey(first));
+        U256 last;
+        u256_add_u64(last, first, n - 1);
+        CHECK(points[n - 1] == reference_pubkey(last));
+        u256_add_u64(expected, expected, n);
+        total += n;
+    }
+    CHECK_EQ(total, size_t(512 * 3 + 7));
+    CHECK(expected == end);
+}
+
+TEST(range_walker_rejects_bad_ranges) {
+    bool threw = false;
+    try {
+        RangeWalker w(U256::zero(), U256::from_u64(10));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try {
+        RangeWalker w(U256::from_u64(10), U256::from_u64(9));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    RangeWalker empty(U256::from_u64(5), U256::from_u64(5));
+    Point p;
+    CHECK(!empty.next(p));
+}
+
+TEST(range_walker_fills_point_blocks) {
+    for (WalkMode mode : {WalkMode::Sequential, WalkMode::Center}) {
+        WalkerConfig config;
+        config.mode = mode;
+        config.batch_size = 32;
+        U256 start = U256::from_hex("0x4000000000"), end;
+        u256_add_u64(end, start, 128 * 2 + 45);
+        RangeWalker walker(start, end, config);
+        auto blk = std::make_unique<PointBlock<128>>();
+        U256 expected = start;
+        size_t blocks = 0, n;
+        while ((n = walker.next_block(*blk, true)) != 0) {
+            ++blocks;
+            CHECK(blk->first_key == expected);
+            CHECK(blk->has_y);
+            for (size_t i = 0; i < n; ++i) {
+                Point ref = reference_pubkey(blk->key(i));
+                CHECK(blk->point(i) == ref);
+                CHECK_EQ((int)blk->y_odd[i], (int)ref.y.is_odd());
+            }
+            u256_add_u64(expected, expected, n);
+        }
+        CHECK_EQ(blocks, size_t(3));
+        CHECK(expected == end);
+    }
+
+    WalkerConfig odd;
+    odd.batch_size = 48;
+    RangeWalker walker(U256::from_u64(1), U256::from_u64(1000), odd);
+    auto blk = std::make_unique<PointBlock<128>>();
+    bool threw = false;
+    try {
+        walker.next_block(*blk);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(narrow_walkers_match_full_width) {
+    CHECK_EQ(walker_key_limbs(U256::from_u64(1000)), 1u);
+    CHECK_EQ(walker_key_limbs(U256::from_hex("0xffffffffffffffff")), 1u);
+    CHECK_EQ(walker_key_limbs(U256::from_hex("0x10000000000000000")), 2u);
+    CHECK_EQ(walker_key_limbs(kOrderN), 4u);
+
+    // Ranges ending just below each narrow width, and one carrying across a limb.
+    U256 end64 = U256::from_hex("0xffffffffffffffff"), start64, start128, end128;
+    end128 = U256::from_hex("0x100000000000000000000000000000000");
+    u256_sub(end128, end128, U256::from_u64(1));
+    u256_sub(start64, end64, U256::from_u64(300));
+    u256_sub(start128, end128, U256::from_u64(300));
+    U256 mid = U256::from_hex("0x1ffffffffffffff00");
+    U256 mid_end;
+    u256_add_u64(mid_end, mid, 500);
+    for (WalkMode mode : {WalkMode::Sequential, WalkMode::Center}) {
+        WalkerConfig config;
+        config.mode = mode;
+        config.batch_size = 64;
+        auto same = [&](auto& narrow, const U256& start, const U256& end) {
+            RangeWalker full(start, end, config);
+            Point a, b;
+            uint64_t n = 0;
+            for (;;) {
+                bool more = narrow.next(a);
+                CHECK_EQ(more, full.next(b));
+                if (!more) break;
+                CHECK(narrow.key() == full.key());
+                CHECK(a == b);
+                ++n;
+            }
+            CHECK(narrow.remaining().is_zero());
+            CHECK(n > 0);
+        };
+        BasicRangeWalker<1> w64(start64, end64, config);
+        same(w64, start64, end64);
+        BasicRangeWalker<2> w128(start128, end128, config);
+        same(w128, start128, end128);
+        BasicRangeWalker<2> wmid(mid, mid_end, config);
+        same(wmid, mid, mid_end);
+    }
+
+    bool threw = false;
+    try {
+        BasicRangeWalker<1> w(U256::from_u64(1), U256::from_hex("0x10000000000000000"));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "marauder/bloom.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/target_index.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/target_table.hpp"
+
+using namespace marauder;
+using marauder_test::test_log;
+
+namespace {
+
+std::vector<Hash160> random_digests(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Hash160> out(n);
+    for (Hash160& h : out) {
+        for (uint8_t& b : h) b = static_cast<uint8_t>(rng());
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(bloom_has_no_false_negatives) {
+    std::vector<Hash160> keys = random_digests(100000, 1);
+    BloomFilter bloom(keys.size());
+    for (const Hash160& h : keys) bloom.insert(h.data());
+    for (const Hash160& h : keys) CHECK(bloom.maybe_contains(h.data()));
+
+    size_t fp = 0, probes = 1000000;
+    for (const Hash160& h : random_digests(probes, 2)) fp += bloom.maybe_contains(h.data());
+    test_log() << "bloom " << bloom.size_bytes() << " bytes, false positives " << fp << "/" << probes << "\n";
+    // Expected about 1e-4 at the default sizing.
+    CHECK(fp < probes / 2000);
+}
+
+// A clone (the per-node replica) is a deep copy, also of a view.
+TEST(bloom_clone_is_independent) {
+    std::vector<Hash160> keys = random_digests(1000, 5);
+    BloomFilter bloom(keys.size());
+    for (const Hash160& h : keys) bloom.insert(h.data());
+    BloomFilter view = BloomFilter::view(bloom.data(), bloom.lines());
+    BloomFilter copy = view.clone();
+    CHECK(copy.data() != bloom.data());
+    CHECK_EQ(copy.lines(), bloom.lines());
+    for (const Hash160& h : keys) CHECK(copy.maybe_contains(h.data()));
+    copy.insert(random_digests(1, 6)[0].data());  // owned, so insert is allowed
+}
+
+TEST(target_table_lookup) {
+    std::vector<Hash160> keys = random_digests(5000, 3);
+    // Records sharing an 8-byte prefix must all be found.
+    for (int i = 0; i < 4; ++i) {
+        Hash160 h = keys[0];
+        h[19] = static_cast<uint8_t>(i);
+        keys.push_back(h);
+    }
+    keys.push_back(Hash160{});
+    Hash160 top;
+    top.fill(0xff);
+    keys.push_back(top);
+    keys.push_back(keys[7]);  // duplicate
+
+    std::set<Hash160> expect(keys.begin(), keys.end());
+    TargetTable table = TargetTable::from_digests(keys);
+    CHECK_EQ(table.size(), expect.size());
+    for (const Hash160& h : keys) CHECK(table.contains(h.data()));
+    for (const Hash160& h : random_digests(20000, 4)) CHECK_EQ(table.contains(h.data()), expect.count(h) != 0);
+    Hash160 near = keys[0];
+    near[19] = 0x80;
+    CHECK(!table.contains(near.data()));
+
+    CHECK(!TargetTable().contains(top.data()));
+    TargetTable one = TargetTable::from_digests({keys[1]});
+    CHECK(one.contains(keys[1].data()));
+    CHECK(!one.contains(keys[2].data()));
+}
+
+TEST(target_table_maps_written_file) {
+    const std::string path = "test_targets.tmp";
+    std::vector<Hash160> keys = random_digests(3000, 5);
+    TargetTable::from_digests(keys).write(path);
+    {
+        TargetTable mapped = TargetTable::map(path);
+        CHECK_EQ(mapped.size(), keys.size());
+        for (const Hash160& h : keys) CHECK(mapped.contains(h.data()));
+    }
+    std::remove(path.c_str());
+
+    bool threw = false;
+    try {
+        TargetTable::map(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Walk a range, hash it and match against a set that holds a few of its
+// keys among many decoys: exactly the planted lanes come back.
+TEST(target_set_matches_walked_keys) {
+    const U256 start = U256::from_hex("0x2000000000");
+    const size_t n = 256;
+    U256 end;
+    u256_add_u64(end, start, n);
+
+    WalkerConfig config;
+    config.batch_size = 128;
+    RangeWalker walker(start, end, config);
+    auto blk = std::make_unique<PointBlock<256>>();
+    CHECK_EQ(walker.next_block(*blk), n);
+    blk->hash_compressed(hash160_best());
+
+    std::vector<Hash160> targets = random_digests(50000, 6);
+    const size_t planted[] = {0, 17, 128, 255};
+    for (size_t lane : planted) {
+        Hash160 h;
+        std::copy(blk->digest[lane], blk->digest[lane] + 20, h.begin());
+        targets.push_back(h);
+    }
+    TargetSet set(TargetTable::from_digests(targets));
+
+    uint32_t hits[256];
+    size_t found = set.match(blk->digest, blk->count, hits);
+    CHECK_EQ(found, sizeof(planted) / sizeof(planted[0]));
+    for (size_t i = 0; i < found && i < 4; ++i) CHECK_EQ(hits[i], planted[i]);
+    // The puzzle-style case: a single target.
+    TargetSet single(TargetTable::from_digests({targets.back()}));
+    CHECK_EQ(single.match(blk->digest, blk->count, hits), size_t(1));
+    CHECK_EQ(hits[0], uint32_t(255));
+}
+
+TEST(decode_address_vectors) {
+    auto decode = [](const char* text, Hash160& h) { return decode_address(text, std::strlen(text), h.data()); };
+    Hash160 h;
+    CHECK(decode("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", h) == AddressStatus::Hash160);
+    CHECK_EQ(bytes_to_hex(h.data(), h.size()), std::string("62e907b15cbf27d5425399ebf6f0fb50ebb88f18"));
+    // BIP 173: either case, never mixed.
+    CHECK(decode("BC1QW508D6QEJXTDG4Y5R3ZARVARY0C5XW7KV8F3T4", h) == AddressStatus::Hash160);
+    CHECK_EQ(bytes_to_hex(h.data(), h.size()), std::string("751e76e8199196d454941c45d1b3a323f1433bd6"));
+    CHECK(decode("bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4", h) == AddressStatus::Hash160);
+    CHECK(decode("bc1qw508d6qejxtdg4y5r3zarvary0c5xW7kv8f3t4", h) == AddressStatus::Invalid);
+
+    // Well formed, but no hash160 of a key: P2SH, P2WSH, Taproot, testnet.
+    CHECK(decode("3J98t1WpEZ73CNmQviecrnyiWrnqRhWNLy", h) == AddressStatus::Unsupported);
+    CHECK(decode("bc1qrp33g0q5c5txsp9arysrx4k6zdkfs4nce4xj0gdcccefvpysxf3qccfmv3", h) == AddressStatus::Unsupported);
+    CHECK(decode("bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqzk5jj0", h) == AddressStatus::Unsupported);
+    CHECK(decode("tb1qw508d6qejxtdg4y5r3zarvary0c5xw7kxpjzsx", h) == AddressStatus::Unsupported);
+
+    CHECK(decode("1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNb", h) == AddressStatus::Invalid);  // checksum
+    CHECK(decode("11A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa", h) == AddressStatus::Invalid);  // extra '1'
+    CHECK(decode("1A1zP1eP5QGefi2DMPTfTL5SLmv7Divf0a", h) == AddressStatus::Invalid);  // not Base58
+    CHECK(decode("bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t5", h) == AddressStatus::Invalid);
+    CHECK(decode("", h) == AddressStatus::Invalid);
+
+    CHECK(parse_target_line("  1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa\t5000000000\r", 48, h) == TargetLine::Digest);
+    CHECK(parse_target_line("62E907B15CBF27D5425399EBF6F0FB50EBB88F18,1", 42, h) == TargetLine::Digest);
+    CHECK_EQ(bytes_to_hex(h.data(), h.size()), std::string("62e907b15cbf27d5425399ebf6f0fb50ebb88f18"));
+    CHECK(parse_target_line(" # header", 9, h) == TargetLine::Blank);
+    CHECK(parse_target_line("address", 7, h) == TargetLine::Invalid);
+}
+
+// Spilled runs merge into the same bytes as a build that fits in memory,
+// and the mapped result answers like the table it was built from.
+TEST(target_index_external_sort) {
+    const std::string spilled = "test_index_spilled.tmp", in_memory = "test_index_memory.tmp";
+    std::vector<Hash160> keys = random_digests(20000, 7);
+    std::vector<Hash160> input = keys;
+    input.insert(input.end(), keys.begin(), keys.begin() + 5000);  // duplicates, some across runs
+    std::shuffle(input.begin(), input.end(), std::mt19937_64(8));
+
+    TargetIndexBuilder small(".", 3000 * sizeof(Hash160));
+    TargetIndexBuilder large(".", input.size() * sizeof(Hash160));
+    for (const Hash160& h : input) {
+        small.add(h);
+        large.add(h);
+    }
+    CHECK(small.runs() > 1);
+    CHECK_EQ(large.runs(), size_t(0));
+    CHECK_EQ(small.finish(spilled), uint64_t(keys.size()));
+    CHECK_EQ(large.finish(in_memory), uint64_t(keys.size()));
+    auto slurp = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    CHECK(slurp(spilled) == slurp(in_memory));
+
+    {
+        TargetSet set = map_target_index(spilled);
+        CHECK_EQ(set.size(), keys.size());
+        for (const Hash160& h : keys) CHECK(set.contains(h.data()));
+        size_t fp = 0;
+        for (const Hash160& h : random_digests(100000, 9)) fp += set.bloom().maybe_contains(h.data());
+        CHECK(fp < 100);
+    }
+    std::remove(in_memory.c_str());
+
+    // Anything but a whole index is refused.
+    const std::string truncated = slurp(spilled).substr(0, 1000);
+    std::remove(spilled.c_str());
+    for (const std::string& bytes : {truncated, std::string("not an index")}) {
+        std::ofstream(spilled, std::ios::binary) << bytes;
+        bool threw = false;
+        try {
+            map_target_index(spilled);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+    std::remove(spilled.c_str());
+}
@@ -0,0 +1,499 @@
+// marauder-bench: micro-benchmarks of the hot kernels.
+//
+// Each result is appended to bench_output.txt as one JSON object per line
+// so runs from different builds and hosts can be compared side by side.
+// Every line starts with the commit the binary was configured from and the
+// CPU model it ran on.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "marauder/batch_inverse.hpp"
+#include "marauder/bloom_kernel.hpp"
+#include "marauder/field_kernel.hpp"
+#include "marauder/fixed_base.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/point_block.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/u256.hpp"
+
+#ifndef MARAUDER_GIT_COMMIT
+#define MARAUDER_GIT_COMMIT "unknown"
+#endif
+
+using namespace marauder;
+
+namespace {
+
+struct Options {
+    std::string out = "bench_output.txt";
+    std::string filter;
+    uint64_t keys = uint64_t(1) << 22;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+std::string json_escape(const std::string& s) {
+    std::string r;
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) r += c;
+    }
+    return r;
+}
+
+// The "model name" line of /proc/cpuinfo (x86), or failing that its
+// "Hardware" or "CPU part" line (ARM).
+std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line, fallback;
+    while (std::getline(in, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        size_t v = line.find_first_not_of(" \t", colon + 1);
+        std::string value = v == std::string::npos ? "" : line.substr(v);
+        if (key == "model name") return value;
+        if (fallback.empty() && (key == "Hardware" || key == "CPU part")) fallback = value;
+    }
+    return fallback.empty() ? "unknown" : fallback;
+}
+
+class Reporter {
+public:
+    explicit Reporter(const std::string& path)
+        : f_(std::fopen(path.c_str(), "a")),
+          host_("\"commit\":\"" + json_escape(MARAUDER_GIT_COMMIT) + "\",\"cpu\":\"" + json_escape(cpu_model()) +
+                "\",") {
+        if (!f_) throw std::runtime_error("cannot open " + path);
+    }
+    ~Reporter() { std::fclose(f_); }
+
+    // fields is the body of a JSON object without the braces.
+    void emit(const std::string& fields) {
+        std::fprintf(f_, "{%s%s}\n", host_.c_str(), fields.c_str());
+        std::fflush(f_);
+        std::printf("%s\n", fields.c_str());
+    }
+
+private:
+    std::FILE* f_;
+    std::string host_;  // leading fields shared by every line
+};
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void bench_walker(Reporter& out, const Options& opt, WalkMode mode, size_t batch) {
+    WalkerConfig config;
+    config.mode = mode;
+    config.batch_size = batch;
+    U256 start = U256::from_hex("0x100000000");
+    U256 end;
+    u256_add_u64(end, start, opt.keys);
+    RangeWalker walker(start, end, config);
+
+    auto t0 = std::chrono::steady_clock::now();
+    const Point* points;
+    U256 first;
+    uint64_t keys = 0;
+    size_t n;
+    while ((n = walker.next_batch(points, first)) != 0) {
+        keys += n;
+    }
+    double secs = seconds_since(t0);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"walker\",\"mode\":\"%s\",\"batch\":%zu,\"keys\":%llu,\"seconds\":%.6f,"
+                  "\"mkeys_per_s\":%.3f",
+                  walk_mode_name(mode), batch, (unsigned long long)keys, secs, keys / secs / 1e6);
+    out.emit(buf);
+}
+
+// Hashes one walker batch worth of pubkeys repeatedly with a single kernel.
+// pubkey is "compressed", "uncompressed" or "both"; both counts two hashes
+// per lane, so its rate compares with the other two run back to back.
+void bench_hash160(Reporter& out, const Options& opt, const Hash160Kernel& kernel, const std::string& pubkey) {
+    const size_t lanes = 4096;
+    std::vector<uint64_t> limbs[8];
+    std::vector<uint8_t> odd(lanes);
+    std::vector<uint8_t> digests(20 * lanes), second(20 * lanes);
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto& l : limbs) {
+        l.resize(lanes);
+        for (auto& v : l) v = seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    for (size_t i = 0; i < lanes; ++i) odd[i] = limbs[0][i] & 1;
+    PubkeyBatchView view{{limbs[0].data(), limbs[1].data(), limbs[2].data(), limbs[3].data()},
+                         {limbs[4].data(), limbs[5].data(), limbs[6].data(), limbs[7].data()},
+                         odd.data(),
+                         lanes};
+    const bool both = pubkey == "both";
+    Hash160Fn fn = pubkey == "compressed" ? kernel.compressed : kernel.uncompressed;
+
+    // Aim for roughly a quarter of the walker's key count.
+    uint64_t rounds = opt.keys / 4 / lanes + 1;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        if (both) {
+            kernel.both(view, (uint8_t(*)[20])digests.data(), (uint8_t(*)[20])second.data());
+        } else {
+            fn(view, (uint8_t(*)[20])digests.data());
+        }
+    }
+    double secs = seconds_since(t0);
+    uint64_t hashes = rounds * lanes * (both ? 2 : 1);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"hash160\",\"kernel\":\"%s\",\"lanes\":%u,\"pubkey\":\"%s\",\"hashes\":%llu,"
+                  "\"seconds\":%.6f,\"mhash_per_s\":%.3f",
+                  kernel.name, kernel.lanes, pubkey.c_str(), (unsigned long long)hashes,
+                  secs, hashes / secs / 1e6);
+    out.emit(buf);
+}
+
+// Walker straight into a PointBlock and through the best hash160 kernel:
+// the single-thread keys/s the scan loop can reach before matching.
+void bench_pipeline(Reporter& out, const Options& opt, WalkMode mode) {
+    WalkerConfig config;
+    config.mode = mode;
+    U256 start = U256::from_hex("0x100000000");
+    U256 end;
+    u256_add_u64(end, start, opt.keys);
+    RangeWalker walker(start, end, config);
+    const Hash160Kernel& kernel = hash160_best();
+    auto blk = std::make_unique<DefaultPointBlock>();
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t keys = 0;
+    while (walker.next_block(*blk) != 0) {
+        blk->hash_compressed(kernel);
+        keys += blk->count;
+    }
+    double secs = seconds_since(t0);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"pipeline\",\"mode\":\"%s\",\"batch\":%zu,\"kernel\":\"%s\",\"keys\":%llu,"
+                  "\"seconds\":%.6f,\"mkeys_per_s\":%.3f",
+                  walk_mode_name(mode), config.batch_size, kernel.name, (unsigned long long)keys, secs,
+                  keys / secs / 1e6);
+    out.emit(buf);
+}
+
+// Candidate lookups against a target set of the given size. Candidates are
+// random, so nearly all of them are answered by the Bloom filter.
+void bench_targets(Reporter& out, const Options& opt, size_t targets) {
+    uint64_t seed = 0xD1B54A32D192ED03ULL ^ targets;
+    auto fill = [&](Hash160& h) {
+        for (size_t i = 0; i < h.size(); i += 8) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            for (size_t j = i; j < i + 8 && j < h.size(); ++j) h[j] = static_cast<uint8_t>(seed >> (8 * (j - i)));
+        }
+    };
+    std::vector<Hash160> list(targets);
+    for (Hash160& h : list) fill(h);
+    TargetSet set(TargetTable::from_digests(std::move(list)));
+
+    const size_t lanes = 4096;
+    std::vector<Hash160> cand(lanes);
+    for (Hash160& h : cand) fill(h);
+    std::vector<uint32_t> hits(lanes);
+    uint64_t rounds = opt.keys / lanes + 1, found = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        // Perturb one byte per round so every pass looks up fresh digests.
+        for (Hash160& h : cand) h[0] += 1;
+        found += set.match(reinterpret_cast<const uint8_t(*)[20]>(cand.data()), lanes, hits.data());
+    }
+    double secs = seconds_since(t0);
+    uint64_t lookups = rounds * lanes;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"targets\",\"targets\":%zu,\"bloom_bytes\":%zu,\"lookups\":%llu,\"hits\":%llu,"
+                  "\"seconds\":%.6f,\"mlookups_per_s\":%.3f",
+                  set.size(), set.bloom().size_bytes(), (unsigned long long)lookups, (unsigned long long)found, secs,
+                  lookups / secs / 1e6);
+    out.emit(buf);
+}
+
+// Full k * G multiplications, as every work unit and batch restart needs,
+// through the fixed-base table and through double-and-add.
+void bench_point_mul(Reporter& out, const Options& opt, bool table) {
+    const uint64_t count = opt.keys / 4096 + 16;
+    U256 k = U256::from_hex("0x2832ed74f2b5e35ee");
+    GTable::get();  // keep the one-off build out of the timing
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        u256_add_u64(k, k, 0x9E3779B97F4A7C15ULL);
+        Scalar s = Scalar::from_u256(k);
+        Point p = table ? point_mul_g(s) : point_mul(s, kGenerator);
+        sink += p.x.d[0];
+    }
+    double secs = seconds_since(t0);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"point_mul_g\",\"method\":\"%s\",\"mults\":%llu,\"seconds\":%.6f,\"kmults_per_s\":%.3f,"
+                  "\"check\":%llu",
+                  table ? "fixed_base" : "double_and_add", (unsigned long long)count, secs, count / secs / 1e3,
+                  (unsigned long long)(sink & 0xFFFF));
+    out.emit(buf);
+}
+
+// A dependent chain of one field operation, so the figure is latency, as
+// in the inversion and the walker's lane-serial additions.
+void bench_field_op(Reporter& out, const Options& opt, const char* op) {
+    const std::string name = op;
+    Fe a = Fe::from_u64(0x123456789ABCDEFULL), b = kGenerator.x;
+    uint64_t count = name == "inv" ? opt.keys / 256 + 1 : opt.keys;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        if (name == "mul") {
+            fe_mul(a, a, b);
+        } else if (name == "sqr") {
+            fe_sqr(a, a);
+        } else {
+            fe_inv(a, a);
+            a.d[0] |= 1;  // never zero
+        }
+    }
+    double secs = seconds_since(t0);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"field_op\",\"op\":\"%s\",\"ops\":%llu,\"seconds\":%.6f,\"ns_per_op\":%.3f,"
+                  "\"check\":%llu",
+                  op, (unsigned long long)count, secs, secs * 1e9 / count, (unsigned long long)(a.d[0] & 0xFFFF));
+    out.emit(buf);
+}
+
+// Point additions: Jacobian mixed addition (no inversion) and the affine
+// group law with its inversion.
+void bench_point_add(Reporter& out, const Options& opt, bool affine) {
+    uint64_t count = affine ? opt.keys / 256 + 1 : opt.keys / 4;
+    const Point step = point_mul_g(Scalar::from_u64(0xC0FFEE));
+    Point p = kGenerator;
+    JPoint j = JPoint::from_affine(kGenerator);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        if (affine) {
+            point_add(p, p, step);
+        } else {
+            jpoint_add_affine(j, j, step);
+        }
+    }
+    double secs = seconds_since(t0);
+    if (!affine) jpoint_to_affine(p, j);
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"point_add\",\"method\":\"%s\",\"adds\":%llu,\"seconds\":%.6f,"
+                  "\"ns_per_add\":%.3f,\"check\":%llu",
+                  affine ? "affine" : "jacobian_mixed", (unsigned long long)count, secs, secs * 1e9 / count,
+                  (unsigned long long)(p.x.d[0] & 0xFFFF));
+    out.emit(buf);
+}
+
+// fe_batch_inv over batches of the given size: one inversion plus three
+// multiplications per element.
+void bench_batch_inverse(Reporter& out, const Options& opt, size_t batch) {
+    std::vector<Fe> elems(batch), scratch(batch);
+    Fe v = kGenerator.y;
+    for (Fe& e : elems) {
+        fe_mul(v, v, kGenerator.x);
+        e = v;
+    }
+    uint64_t rounds = opt.keys / 4 / batch + 1;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) fe_batch_inv(elems.data(), batch, scratch.data());
+    double secs = seconds_since(t0);
+    uint64_t count = rounds * batch;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"batch_inverse\",\"batch\":%zu,\"elements\":%llu,\"seconds\":%.6f,"
+                  "\"ns_per_element\":%.3f,\"check\":%llu",
+                  batch, (unsigned long long)count, secs, secs * 1e9 / count,
+                  (unsigned long long)(elems[0].d[0] & 0xFFFF));
+    out.emit(buf);
+}
+
+// scan_range end to end against one target that is never found: walker,
+// hash160 and matching on every worker thread.
+void bench_scan(Reporter& out, const Options& opt, unsigned threads) {
+    std::vector<Hash160> target(1);
+    target[0].fill(0xA5);
+    TargetSet set(TargetTable::from_digests(std::move(target)));
+    ScanConfig cfg;
+    cfg.threads = threads;
+    cfg.targets = &set;
+    cfg.unit_bits = 16;
+    U256 start = U256::from_hex("0x100000000");
+    U256 end;
+    u256_add_u64(end, start, opt.keys * threads);
+    ScanStats stats = scan_range(start, end, cfg, [](const ScanHit&) {});
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"scan\",\"threads\":%u,\"kernel\":\"%s\",\"field\":\"%s\",\"keys\":%llu,"
+                  "\"seconds\":%.6f,\"mkeys_per_s\":%.3f,\"mkeys_per_s_per_thread\":%.3f",
+                  threads, hash160_best().name, field_best().name, (unsigned long long)stats.keys, stats.seconds,
+                  stats.keys / stats.seconds / 1e6, stats.keys / stats.seconds / 1e6 / threads);
+    out.emit(buf);
+}
+
+// 1, 2, 4, ... up to max_threads, and max_threads itself.
+std::vector<unsigned> thread_counts(const Options& opt) {
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < opt.max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(opt.max_threads);
+    return counts;
+}
+
+// One walker batch of field work through a single kernel: the batch
+// inversion of B differences and the B affine additions that use them.
+void bench_field(Reporter& out, const Options& opt, const FieldKernel& kernel) {
+    const size_t batch = 1024;
+    std::vector<Point> steps(batch), sums(batch);
+    std::vector<Fe> dx(batch), scratch(2 * batch);
+    Point base = point_mul_g(Scalar::from_u64(0x123456789ULL));
+    for (size_t i = 0; i < batch; ++i) steps[i] = point_mul_g(Scalar::from_u64(i + 1));
+
+    uint64_t rounds = opt.keys / batch + 1, sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < batch; ++i) fe_sub(dx[i], steps[i].x, base.x);
+        kernel.batch_inv(dx.data(), batch, scratch.data());
+        kernel.add_batch(sums.data(), base, steps.data(), dx.data(), batch, false);
+        base = sums[batch - 1];
+        sink += base.x.d[0];
+    }
+    double secs = seconds_since(t0);
+    uint64_t keys = rounds * batch;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"field_kernel\",\"kernel\":\"%s\",\"batch\":%zu,\"keys\":%llu,\"seconds\":%.6f,"
+                  "\"mkeys_per_s\":%.3f,\"check\":%llu",
+                  kernel.name, batch, (unsigned long long)keys, secs, keys / secs / 1e6,
+                  (unsigned long long)(sink & 0xFFFF));
+    out.emit(buf);
+}
+
+// The Bloom prefilter alone through a single kernel, on a filter of the
+// given target count and random candidates.
+void bench_bloom(Reporter& out, const Options& opt, const BloomKernel& kernel, size_t targets) {
+    uint64_t seed = 0xA4093822299F31D0ULL ^ targets;
+    auto next = [&] { return seed = seed * 6364136223846793005ULL + 1442695040888963407ULL; };
+    BloomFilter bloom(targets);
+    uint8_t digest[20];
+    for (size_t i = 0; i < targets; ++i) {
+        for (uint8_t& b : digest) b = static_cast<uint8_t>(next() >> 56);
+        bloom.insert(digest);
+    }
+    const size_t lanes = 4096;
+    std::vector<uint8_t> cand(20 * lanes);
+    for (uint8_t& b : cand) b = static_cast<uint8_t>(next() >> 56);
+    auto* digests = reinterpret_cast<uint8_t(*)[20]>(cand.data());
+    std::vector<uint32_t> hits(lanes);
+    uint64_t rounds = opt.keys / lanes + 1, found = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < lanes; ++i) digests[i][0] += 1;
+        found += kernel.filter(bloom, digests, lanes, hits.data());
+    }
+    double secs = seconds_since(t0);
+    uint64_t lookups = rounds * lanes;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "\"bench\":\"bloom\",\"kernel\":\"%s\",\"targets\":%zu,\"lookups\":%llu,\"passed\":%llu,"
+                  "\"seconds\":%.6f,\"mlookups_per_s\":%.3f",
+                  kernel.name, targets, (unsigned long long)lookups, (unsigned long long)found, secs,
+                  lookups / secs / 1e6);
+    out.emit(buf);
+}
+
+bool selected(const Options& opt, const std::string& name) {
+    return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+}
+
+Options parse_args(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--out") {
+            opt.out = value();
+        } else if (arg == "--filter") {
+            opt.filter = value();
+        } else if (arg == "--keys") {
+            opt.keys = std::stoull(value());
+        } else if (arg == "--max-threads") {
+            opt.max_threads = std::max(1ul, std::stoul(value()));
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return opt;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parse_args(argc, argv);
+        Reporter out(opt.out);
+        if (selected(opt, "walker")) {
+            for (WalkMode mode : {WalkMode::Sequential, WalkMode::Center}) {
+                for (size_t batch : {512, 1024, 4096}) bench_walker(out, opt, mode, batch);
+            }
+        }
+        if (selected(opt, "pipeline")) {
+            for (WalkMode mode : {WalkMode::Sequential, WalkMode::Center}) bench_pipeline(out, opt, mode);
+        }
+        if (selected(opt, "scan")) {
+            for (unsigned t : thread_counts(opt)) bench_scan(out, opt, t);
+        }
+        if (selected(opt, "field_op")) {
+            for (const char* op : {"mul", "sqr", "inv"}) bench_field_op(out, opt, op);
+        }
+        if (selected(opt, "point_add")) {
+            for (bool affine : {false, true}) bench_point_add(out, opt, affine);
+        }
+        if (selected(opt, "batch_inverse")) {
+            for (size_t batch : {16, 64, 256, 1024, 4096}) bench_batch_inverse(out, opt, batch);
+        }
+        if (selected(opt, "targets")) {
+            for (size_t n : {size_t(1), size_t(1) << 20, size_t(10) << 20}) bench_targets(out, opt, n);
+        }
+        if (selected(opt, "point_mul_g")) {
+            for (bool table : {true, false}) bench_point_mul(out, opt, table);
+        }
+        if (selected(opt, "field_kernel")) {
+            for (const FieldKernel* k : field_available()) bench_field(out, opt, *k);
+        }
+        if (selected(opt, "bloom")) {
+            for (size_t n : {size_t(1000), size_t(1) << 20, size_t(10) << 20}) {
+                for (const BloomKernel* k : bloom_available()) bench_bloom(out, opt, *k, n);
+            }
+        }
+        if (selected(opt, "hash160")) {
+            for (const Hash160Kernel* k : hash160_available()) {
+                for (const char* pubkey : {"compressed", "uncompressed", "both"}) bench_hash160(out, opt, *k, pubkey);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder-bench: %s\n", e.what());
+        std::fprintf(stderr, "usage: marauder-bench [--out FILE] [--filter NAME] [--keys N] [--max-threads N]\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+// marauder-coordinator: hands out work units of one range to marauder workers.
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "marauder/checkpoint.hpp"
+#include "marauder/coord_client.hpp"
+#include "marauder/coord_server.hpp"
+#include "marauder/coordinator.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/u256.hpp"
+
+using namespace marauder;
+
+namespace {
+
+struct Options {
+    U256 start = U256::from_u64(1);
+    U256 end = U256::from_u64(1);
+    CoordinatorConfig coord;
+    CoordServerConfig server;
+    bool allow_out_of_range = false;
+    std::string checkpoint_path;  // --checkpoint
+    unsigned checkpoint_seconds = 60;
+    unsigned heartbeat_seconds = 0;  // 0: a quarter of the lease time
+};
+
+CoordServer* g_server = nullptr;
+
+void on_signal(int) {
+    if (g_server) g_server->stop();
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: marauder-coordinator --range START:END --listen [HOST:]PORT [options]\n"
+                 "  --range START:END     hex private-key range, END exclusive\n"
+                 "  --listen [HOST:]PORT  address to accept workers on (all interfaces if no HOST)\n"
+                 "  --unit-bits B         work unit size 2^B keys (default 32)\n"
+                 "  --lease-seconds S     a lease not heartbeated for S seconds is reassigned\n"
+                 "                        (default 300)\n"
+                 "  --heartbeat-seconds S how often workers heartbeat (default: lease time / 4)\n"
+                 "  --max-lease-units N   cap on the units of one lease (default 65536)\n"
+                 "  --checkpoint FILE     record completed units in FILE and skip them on restart\n"
+                 "  --checkpoint-interval S\n"
+                 "                        seconds between checkpoint writes (default 60)\n"
+                 "  --endomorphism        have workers try lambda and negated keys too; 5 of 6\n"
+                 "                        lie outside --range, see --allow-out-of-range\n"
+                 "  --allow-out-of-range  accept candidate keys outside --range\n");
+}
+
+void parse_range(const std::string& arg, Options& opt) {
+    size_t colon = arg.find(':');
+    if (colon == std::string::npos) throw std::invalid_argument("--range expects START:END");
+    opt.start = U256::from_hex(arg.substr(0, colon));
+    opt.end = U256::from_hex(arg.substr(colon + 1));
+}
+
+void parse_listen(const std::string& arg, Options& opt) {
+    if (arg.find(':') == std::string::npos) {
+        // A bare port: parse it through the HOST:PORT path.
+        opt.server.port = parse_coord_endpoint("any:" + arg).port;
+        return;
+    }
+    if (arg.front() == ':') {
+        opt.server.port = parse_coord_endpoint("any" + arg).port;
+        return;
+    }
+    CoordEndpoint at = parse_coord_endpoint(arg);
+    opt.server.host = at.host;
+    opt.server.port = at.port;
+}
+
+Options parse_args(int argc, char** argv) {
+    Options opt;
+    bool have_range = false, have_listen = false;
+    unsigned lease_seconds = 300;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--range") {
+            parse_range(value(), opt);
+            have_range = true;
+        } else if (arg == "--listen") {
+            parse_listen(value(), opt);
+            have_listen = true;
+        } else if (arg == "--unit-bits") {
+            opt.coord.unit_bits = std::stoul(value());
+        } else if (arg == "--lease-seconds") {
+            lease_seconds = std::stoul(value());
+        } else if (arg == "--heartbeat-seconds") {
+            opt.heartbeat_seconds = std::stoul(value());
+        } else if (arg == "--max-lease-units") {
+            opt.coord.max_lease_units = std::stoul(value());
+        } else if (arg == "--checkpoint") {
+            opt.checkpoint_path = value();
+        } else if (arg == "--checkpoint-interval") {
+            opt.checkpoint_seconds = std::stoul(value());
+        } else if (arg == "--endomorphism") {
+            opt.server.endomorphism = true;
+        } else if (arg == "--allow-out-of-range") {
+            opt.allow_out_of_range = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    if (!have_range) throw std::invalid_argument("--range is required");
+    if (!have_listen) throw std::invalid_argument("--listen is required");
+    if (lease_seconds == 0) throw std::invalid_argument("--lease-seconds must be positive");
+    if (opt.server.endomorphism && !opt.allow_out_of_range) {
+        throw std::invalid_argument("--endomorphism generates keys outside --range; pass --allow-out-of-range");
+    }
+    opt.coord.lease_time = std::chrono::seconds(lease_seconds);
+    opt.server.heartbeat = opt.heartbeat_seconds ? std::chrono::milliseconds(opt.heartbeat_seconds * 1000ull)
+                                                 : std::chrono::milliseconds(lease_seconds * 250ull);
+    if (opt.server.heartbeat >= opt.coord.lease_time) {
+        throw std::invalid_argument("--heartbeat-seconds must be below --lease-seconds");
+    }
+    return opt;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder-coordinator: %s\n", e.what());
+        usage();
+        return 2;
+    }
+
+    try {
+        std::unique_ptr<Checkpoint> checkpoint;
+        if (!opt.checkpoint_path.empty()) {
+            checkpoint = std::make_unique<Checkpoint>(opt.checkpoint_path, opt.start, opt.end, opt.coord.unit_bits,
+                                                      std::chrono::seconds(opt.checkpoint_seconds));
+        }
+        Coordinator coord(opt.start, opt.end, opt.coord, checkpoint.get());
+        uint64_t hits = 0;
+        CoordServer server(coord, opt.server, [&](const ScanHit& hit, const std::string& worker) {
+            std::printf("hit %s %s %s %s\n", hit.key.to_hex().c_str(), hit_pubkey_hex(hit).c_str(),
+                        bytes_to_hex(hit.digest.data(), hit.digest.size()).c_str(), worker.c_str());
+            // The worker completes the unit once we acknowledge; the hit must be out first.
+            std::fflush(stdout);
+            ++hits;
+        });
+        std::fprintf(stderr, "listening on port %u: %llu units, %llu already done\n", server.port(),
+                     (unsigned long long)coord.unit_count(), (unsigned long long)coord.done_units());
+
+        g_server = &server;
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        server.run();
+        g_server = nullptr;
+
+        if (checkpoint) checkpoint->close();
+        std::fprintf(stderr, "%s: %llu of %llu units done, %llu reassigned, %llu rejected, %llu hits\n",
+                     coord.finished() ? "finished" : "stopped", (unsigned long long)coord.done_units(),
+                     (unsigned long long)coord.unit_count(), (unsigned long long)coord.reassigned_units(),
+                     (unsigned long long)coord.rejected_units(), (unsigned long long)hits);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder-coordinator: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
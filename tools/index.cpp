@@ -0,0 +1,197 @@
+// marauder-index: builds a target index from address lists, once, so scans
+// can map it instead of parsing the lists on every run.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "marauder/bloom.hpp"
+#include "marauder/target_index.hpp"
+
+using namespace marauder;
+
+namespace {
+
+struct Options {
+    std::string out;
+    std::vector<std::string> inputs;  // "-" is stdin
+    std::string tmp_dir;              // default: the directory of out
+    size_t memory = kDefaultIndexMemory;
+    unsigned bloom_bits = kBloomBitsPerKey;
+    bool strict = false;
+};
+
+struct Counts {
+    uint64_t lines = 0, digests = 0, unsupported = 0, invalid = 0;
+};
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: marauder-index [options] OUT [LIST...]\n"
+                 "  Reads address lists (stdin if none, or '-'), one entry per line: a P2PKH\n"
+                 "  (1...) or P2WPKH (bc1q...) address or a hex hash160, optionally followed\n"
+                 "  by other columns. Writes the index OUT for marauder --index.\n"
+                 "  --memory MB           digests held in RAM before spilling a sorted run\n"
+                 "                        (default 1024)\n"
+                 "  --tmp DIR             directory for the runs (default: that of OUT)\n"
+                 "  --bloom-bits N        Bloom filter bits per target (default 24)\n"
+                 "  --strict              fail on the first line that is not an address;\n"
+                 "                        by default such lines are counted and skipped\n");
+}
+
+Options parse_args(int argc, char** argv) {
+    Options opt;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--memory") {
+            opt.memory = static_cast<size_t>(std::stoull(value())) << 20;
+        } else if (arg == "--tmp") {
+            opt.tmp_dir = value();
+        } else if (arg == "--bloom-bits") {
+            opt.bloom_bits = std::stoul(value());
+        } else if (arg == "--strict") {
+            opt.strict = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            std::exit(0);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.empty()) throw std::invalid_argument("no output file");
+    if (opt.memory == 0) throw std::invalid_argument("--memory must be positive");
+    if (opt.bloom_bits == 0) throw std::invalid_argument("--bloom-bits must be positive");
+    opt.out = positional[0];
+    opt.inputs.assign(positional.begin() + 1, positional.end());
+    if (opt.inputs.empty()) opt.inputs.push_back("-");
+    if (opt.tmp_dir.empty()) {
+        size_t slash = opt.out.rfind('/');
+        opt.tmp_dir = slash == std::string::npos ? "." : opt.out.substr(0, slash ? slash : 1);
+    }
+    return opt;
+}
+
+// Streams one list through the builder in large blocks; lines are parsed
+// in place, never copied into strings.
+void ingest(const std::string& name, const Options& opt, TargetIndexBuilder& builder, Counts& counts) {
+    std::FILE* in = name == "-" ? stdin : std::fopen(name.c_str(), "rb");
+    if (!in) throw std::runtime_error("cannot open " + name);
+    std::vector<char> buf(size_t(1) << 20);
+    size_t have = 0;
+    uint64_t lineno = 0;
+    bool skipping = false;  // inside a line too long for the buffer
+    auto invalid = [&](const char* p, size_t n) {
+        if (opt.strict) {
+            throw std::invalid_argument(name + ":" + std::to_string(lineno) + ": not an address: " +
+                                        std::string(p, std::min<size_t>(n, 100)));
+        }
+        ++counts.invalid;
+    };
+    auto line = [&](const char* p, size_t n) {
+        ++lineno;
+        ++counts.lines;
+        Hash160 h;
+        switch (parse_target_line(p, n, h)) {
+        case TargetLine::Digest:
+            builder.add(h);
+            ++counts.digests;
+            break;
+        case TargetLine::Blank:
+            break;
+        case TargetLine::Unsupported:
+            ++counts.unsupported;
+            break;
+        case TargetLine::Invalid:
+            invalid(p, n);
+            break;
+        }
+    };
+    try {
+        for (;;) {
+            size_t got = std::fread(buf.data() + have, 1, buf.size() - have, in);
+            if (got == 0) {
+                if (std::ferror(in)) throw std::runtime_error("cannot read " + name);
+                if (have) line(buf.data(), have);
+                break;
+            }
+            have += got;
+            size_t start = 0;
+            if (skipping) {
+                const void* nl = std::memchr(buf.data(), '\n', have);
+                if (!nl) {
+                    have = 0;
+                    continue;
+                }
+                start = static_cast<const char*>(nl) - buf.data() + 1;
+                skipping = false;
+            }
+            for (;;) {
+                const void* nl = std::memchr(buf.data() + start, '\n', have - start);
+                if (!nl) break;
+                size_t end = static_cast<const char*>(nl) - buf.data();
+                line(buf.data() + start, end - start);
+                start = end + 1;
+            }
+            // A line that fills the buffer is not an address: count it once
+            // and drop the rest of it, up to and including its newline.
+            if (start == 0 && have == buf.size()) {
+                ++lineno;
+                ++counts.lines;
+                invalid(buf.data(), have);
+                skipping = true;
+                start = have;
+            }
+            std::memmove(buf.data(), buf.data() + start, have - start);
+            have -= start;
+        }
+    } catch (...) {
+        if (in != stdin) std::fclose(in);
+        throw;
+    }
+    if (in != stdin) std::fclose(in);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder-index: %s\n", e.what());
+        usage();
+        return 2;
+    }
+
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+        TargetIndexBuilder builder(opt.tmp_dir, opt.memory);
+        Counts counts;
+        for (const std::string& name : opt.inputs) ingest(name, opt, builder, counts);
+        size_t runs = builder.runs();
+        uint64_t records = builder.finish(opt.out, opt.bloom_bits);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::fprintf(stderr,
+                     "%llu lines: %llu digests, %llu unique; %llu unsupported and %llu invalid skipped;"
+                     " %zu runs spilled; wrote %s in %.1f s\n",
+                     (unsigned long long)counts.lines, (unsigned long long)counts.digests,
+                     (unsigned long long)records, (unsigned long long)counts.unsupported,
+                     (unsigned long long)counts.invalid, runs, opt.out.c_str(), seconds);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder-index: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
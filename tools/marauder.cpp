@@ -0,0 +1,440 @@
+// marauder: private-key range searcher.
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "marauder/bsgs.hpp"
+#include "marauder/checkpoint.hpp"
+#include "marauder/coord_client.hpp"
+#include "marauder/dp_store.hpp"
+#include "marauder/encoding.hpp"
+#include "marauder/gpu_backend.hpp"
+#include "marauder/hash160.hpp"
+#include "marauder/isa.hpp"
+#include "marauder/kangaroo.hpp"
+#include "marauder/metrics_server.hpp"
+#include "marauder/profile.hpp"
+#include "marauder/range_walker.hpp"
+#include "marauder/scan.hpp"
+#include "marauder/target_index.hpp"
+#include "marauder/target_set.hpp"
+#include "marauder/u256.hpp"
+
+using namespace marauder;
+
+namespace {
+
+struct Options {
+    U256 start = U256::from_u64(1);
+    U256 end = U256::from_u64(1);
+    ScanConfig scan;
+    bool allow_out_of_range = false;
+    std::vector<Hash160> targets;  // from --target and --targets
+    std::string table_path;        // --table
+    std::string index_path;        // --index
+    std::string gpu_plugin;        // --gpu
+    std::string checkpoint_path;   // --checkpoint
+    unsigned checkpoint_seconds = 60;
+    std::string coordinator;  // --coordinator HOST:PORT
+    uint32_t lease_units = 0;  // 0: 16 per worker
+    std::string kangaroo_pubkey;  // --kangaroo
+    KangarooConfig kangaroo;
+    std::vector<std::string> merge_work;  // --merge-work A B OUT
+    std::string bsgs_pubkey;  // --bsgs
+    std::string bsgs_table;   // --bsgs-table
+    uint64_t baby_steps = 0;  // --baby-steps: build the table if it is missing
+    std::string metrics;      // --metrics [HOST:]PORT
+    std::string hits_path;    // --hits
+};
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: marauder --range START:END [options]\n"
+                 "       marauder --coordinator HOST:PORT [options]\n"
+                 "  --range START:END     hex private-key range, END exclusive\n"
+                 "  --batch N             keys per batch inversion (default 1024)\n"
+                 "  --mode MODE           walker mode: sequential (default) or center\n"
+                 "  --threads N           CPU worker threads (default: all hardware threads)\n"
+                 "  --gpu PLUGIN          also scan on every device of a GPU plugin .so\n"
+                 "  --gpu-depth N         chunks queued per device (default 3, at most 16)\n"
+                 "  --pin                 pin CPU threads to cores across NUMA nodes, with a Bloom\n"
+                 "                        filter copy per node and node-local work stealing\n"
+                 "  --unit-bits B         work unit size 2^B keys (default 32)\n"
+                 "  --order ORDER         unit visit order: sequential (default), random[:SEED]\n"
+                 "                        (a fresh seed is printed; pass it again to resume a\n"
+                 "                        checkpoint) or strided:K/N (node K of N interleaved)\n"
+                 "  --endomorphism        also try lambda and negated keys (6 per point); 5 of\n"
+                 "                        them lie outside --range, see --allow-out-of-range\n"
+                 "  --allow-out-of-range  accept candidate keys outside --range\n"
+                 "  --uncompressed        also match the 65-byte uncompressed key of every\n"
+                 "                        candidate (legacy addresses); CPU only\n"
+                 "  --target HASH160      report candidates with this hash160 (repeatable)\n"
+                 "  --targets FILE        report candidates in a file of hex hash160s, one per line\n"
+                 "  --table FILE          report candidates in a sorted binary hash160 table\n"
+                 "  --index FILE          report candidates in a target index from marauder-index\n"
+                 "  --hits FILE           also append hits to FILE, synced to disk before their\n"
+                 "                        unit counts as done\n"
+                 "  --checkpoint FILE     record completed units in FILE and skip them on restart\n"
+                 "  --checkpoint-interval S\n"
+                 "                        seconds between checkpoint writes (default 60)\n"
+                 "  --coordinator HOST:PORT\n"
+                 "                        scan units leased from marauder-coordinator instead of\n"
+                 "                        --range; range, unit size and endomorphism come from it\n"
+                 "  --lease-units N       units per lease (default 16 per thread and GPU)\n"
+                 "  --kangaroo PUBKEY     solve for the key of a hex SEC1 public key in --range\n"
+                 "                        with Pollard's kangaroo instead of scanning\n"
+                 "  --herd N              kangaroos per thread (default 1024)\n"
+                 "  --dp-bits B           distinguished-point bits (default: from range and herd)\n"
+                 "  --jump-bits B         log2 of the mean kangaroo jump (default: from range and\n"
+                 "                        kangaroo count; runs sharing work files must agree)\n"
+                 "  --work-file PREFIX    spill distinguished points to PREFIX.N.dp and pick them\n"
+                 "                        up again on the next run with the same key and range\n"
+                 "  --dp-memory N         distinguished points held in RAM between spills\n"
+                 "                        (default 4194304)\n"
+                 "  --merge-work A B OUT  stream two work files into OUT and report points in\n"
+                 "                        both; with --kangaroo and --range, print the key they give\n"
+                 "  --bsgs PUBKEY         solve for the key of a hex public key in --range with\n"
+                 "                        baby-step giant-step against --bsgs-table\n"
+                 "  --bsgs-table FILE     baby-step table to map (built first if missing and\n"
+                 "                        --baby-steps is given)\n"
+                 "  --baby-steps M        baby steps of a table to build (each giant step covers 2M+1)\n"
+                 "  --dump                print \"key pubkey hash160\" for every candidate\n"
+                 "  --metrics [HOST:]PORT serve Prometheus metrics at http://HOST:PORT/metrics\n"
+                 "  --print-isa           print the CPU features and the kernels chosen for them\n");
+}
+
+void parse_range(const std::string& arg, Options& opt) {
+    size_t colon = arg.find(':');
+    if (colon == std::string::npos) throw std::invalid_argument("--range expects START:END");
+    opt.start = U256::from_hex(arg.substr(0, colon));
+    opt.end = U256::from_hex(arg.substr(colon + 1));
+}
+
+Options parse_args(int argc, char** argv) {
+    Options opt;
+    opt.scan.threads = std::max(1u, std::thread::hardware_concurrency());
+    bool have_range = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--range") {
+            parse_range(value(), opt);
+            have_range = true;
+        } else if (arg == "--batch") {
+            opt.scan.walker.batch_size = std::stoul(value());
+        } else if (arg == "--mode") {
+            opt.scan.walker.mode = parse_walk_mode(value());
+        } else if (arg == "--threads") {
+            opt.scan.threads = std::stoul(value());
+        } else if (arg == "--gpu") {
+            opt.gpu_plugin = value();
+        } else if (arg == "--gpu-depth") {
+            opt.scan.gpu_depth = std::stoul(value());
+        } else if (arg == "--unit-bits") {
+            opt.scan.unit_bits = std::stoul(value());
+        } else if (arg == "--order") {
+            std::string order = value();
+            opt.scan.order = order == "random"
+                                 ? UnitOrder::random((uint64_t(std::random_device()()) << 32) | std::random_device()())
+                                 : parse_unit_order(order);
+        } else if (arg == "--endomorphism") {
+            opt.scan.endomorphism = true;
+        } else if (arg == "--uncompressed") {
+            opt.scan.uncompressed = true;
+        } else if (arg == "--allow-out-of-range") {
+            opt.allow_out_of_range = true;
+        } else if (arg == "--target") {
+            Hash160 h;
+            hex_to_bytes(value(), h.data(), h.size());
+            opt.targets.push_back(h);
+        } else if (arg == "--targets") {
+            std::vector<Hash160> list = read_hash160_list(value());
+            opt.targets.insert(opt.targets.end(), list.begin(), list.end());
+        } else if (arg == "--table") {
+            opt.table_path = value();
+        } else if (arg == "--index") {
+            opt.index_path = value();
+        } else if (arg == "--checkpoint") {
+            opt.checkpoint_path = value();
+        } else if (arg == "--checkpoint-interval") {
+            opt.checkpoint_seconds = std::stoul(value());
+        } else if (arg == "--coordinator") {
+            opt.coordinator = value();
+        } else if (arg == "--lease-units") {
+            opt.lease_units = std::stoul(value());
+        } else if (arg == "--kangaroo") {
+            opt.kangaroo_pubkey = value();
+        } else if (arg == "--herd") {
+            opt.kangaroo.herd = std::stoul(value());
+        } else if (arg == "--dp-bits") {
+            opt.kangaroo.dp_bits = std::stoul(value());
+        } else if (arg == "--jump-bits") {
+            opt.kangaroo.jump_bits = std::stoul(value());
+        } else if (arg == "--work-file") {
+            opt.kangaroo.work_file = value();
+        } else if (arg == "--dp-memory") {
+            opt.kangaroo.dp_memory = std::stoull(value());
+        } else if (arg == "--merge-work") {
+            for (int k = 0; k < 3; ++k) opt.merge_work.push_back(value());
+        } else if (arg == "--bsgs") {
+            opt.bsgs_pubkey = value();
+        } else if (arg == "--bsgs-table") {
+            opt.bsgs_table = value();
+        } else if (arg == "--baby-steps") {
+            opt.baby_steps = std::stoull(value());
+        } else if (arg == "--hits") {
+            opt.hits_path = value();
+        } else if (arg == "--dump") {
+            opt.scan.report_all = true;
+        } else if (arg == "--pin") {
+            opt.scan.pin_threads = true;
+        } else if (arg == "--metrics") {
+            opt.metrics = value();
+        } else if (arg == "--print-isa") {
+            std::fputs(isa_report().c_str(), stdout);
+            std::exit(0);
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    if (!opt.merge_work.empty()) {
+        if (!opt.kangaroo_pubkey.empty() && !have_range) throw std::invalid_argument("--merge-work needs --range");
+    } else if (!opt.coordinator.empty()) {
+        if (have_range || !opt.checkpoint_path.empty() || opt.scan.endomorphism ||
+            opt.scan.order != UnitOrder()) {
+            throw std::invalid_argument("--coordinator decides the range, checkpoint, order and endomorphism");
+        }
+        if (opt.scan.report_all) throw std::invalid_argument("--dump cannot be combined with --coordinator");
+        if (!opt.kangaroo_pubkey.empty()) throw std::invalid_argument("--kangaroo needs --range");
+        if (!opt.bsgs_pubkey.empty()) throw std::invalid_argument("--bsgs needs --range");
+    } else if (!have_range) {
+        throw std::invalid_argument("--range is required");
+    }
+    if ((!opt.table_path.empty()) + (!opt.index_path.empty()) + (!opt.targets.empty()) > 1) {
+        throw std::invalid_argument("use one of --table, --index and --target/--targets");
+    }
+    if (!opt.hits_path.empty() && opt.scan.report_all) throw std::invalid_argument("--hits cannot be combined with --dump");
+    if (!opt.bsgs_pubkey.empty() && opt.bsgs_table.empty()) throw std::invalid_argument("--bsgs needs --bsgs-table");
+    if (opt.scan.endomorphism && !opt.allow_out_of_range) {
+        throw std::invalid_argument("--endomorphism generates keys outside --range; pass --allow-out-of-range");
+    }
+    return opt;
+}
+
+Point parse_pubkey_hex(const std::string& hex) {
+    uint8_t raw[65];
+    size_t len = hex.size() / 2;
+    if (hex.size() % 2 != 0 || (len != 33 && len != 65)) {
+        throw std::invalid_argument("expected a 33- or 65-byte hex public key");
+    }
+    hex_to_bytes(hex, raw, len);
+    Point p;
+    if (!parse_pubkey(p, raw, len)) throw std::invalid_argument("not a valid public key: " + hex);
+    return p;
+}
+
+int run_kangaroo(const Options& opt) {
+    KangarooConfig cfg = opt.kangaroo;
+    cfg.threads = opt.scan.threads;
+    // A resumed run must not retrace the kangaroos of the runs before it.
+    if (!cfg.work_file.empty()) cfg.start_seed = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+    KangarooResult r = kangaroo_solve(parse_pubkey_hex(opt.kangaroo_pubkey), opt.start, opt.end, cfg);
+    if (r.found) std::printf("key %s\n", r.key.to_hex().c_str());
+    std::fprintf(stderr,
+                 "%s after %llu jumps in %.3f s (%.3f Mjumps/s, expected %.3g jumps, %u dp bits, %u jump bits, "
+                 "%llu DPs, %llu restarts)\n",
+                 r.found ? "solved" : "not found", (unsigned long long)r.jumps, r.seconds,
+                 r.seconds > 0 ? r.jumps / r.seconds / 1e6 : 0.0, r.expected_jumps, r.dp_bits, r.jump_bits,
+                 (unsigned long long)r.dps, (unsigned long long)r.restarts);
+    return r.found ? 0 : 1;
+}
+
+int run_merge(const Options& opt) {
+    const bool solve = !opt.kangaroo_pubkey.empty();
+    const Point pub = solve ? parse_pubkey_hex(opt.kangaroo_pubkey) : Point();
+    uint64_t collisions = 0, mixed = 0;
+    bool found = false;
+    uint64_t n = DpStore::merge_work_files(
+        opt.merge_work[0], opt.merge_work[1], opt.merge_work[2], [&](const DpRecord& a, const DpRecord& b) {
+            ++collisions;
+            if (a.kind == b.kind) return;
+            ++mixed;
+            U256 key;
+            if (!found && solve && kangaroo_key_from_collision(pub, opt.start, opt.end, a, b, key)) {
+                std::printf("key %s\n", key.to_hex().c_str());
+                found = true;
+            }
+        });
+    std::fprintf(stderr, "merged %llu distinguished points into %s, %llu in both files (%llu tame/wild)\n",
+                 (unsigned long long)n, opt.merge_work[2].c_str(), (unsigned long long)collisions,
+                 (unsigned long long)mixed);
+    return solve && !found ? 1 : 0;
+}
+
+int run_bsgs(const Options& opt) {
+    const Point pub = parse_pubkey_hex(opt.bsgs_pubkey);
+    if (opt.baby_steps && !std::ifstream(opt.bsgs_table).good()) {
+        auto t0 = std::chrono::steady_clock::now();
+        BsgsTable::build(opt.bsgs_table, opt.baby_steps, opt.scan.threads);
+        std::fprintf(stderr, "built %s: %llu baby steps in %.3f s\n", opt.bsgs_table.c_str(),
+                     (unsigned long long)opt.baby_steps,
+                     std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    BsgsTable table = BsgsTable::map(opt.bsgs_table);
+    BsgsConfig cfg;
+    cfg.threads = opt.scan.threads;
+    BsgsResult r = bsgs_solve(pub, opt.start, opt.end, table, cfg);
+    if (r.found) std::printf("key %s\n", r.key.to_hex().c_str());
+    std::fprintf(stderr, "%s after %llu giant steps of %llu keys in %.3f s (%.3f Mkeys/s, %llu Bloom passes)\n",
+                 r.found ? "solved" : "not found", (unsigned long long)r.giant_steps,
+                 (unsigned long long)(2 * table.baby_steps() + 1), r.seconds,
+                 r.seconds > 0 ? r.giant_steps * (2.0 * table.baby_steps() + 1) / r.seconds / 1e6 : 0.0,
+                 (unsigned long long)r.bloom_passes);
+    return r.found ? 0 : 1;
+}
+
+// [HOST:]PORT; without a host the endpoint listens on every interface.
+CoordEndpoint parse_metrics_endpoint(const std::string& text) {
+    size_t colon = text.rfind(':');
+    std::string host = colon == std::string::npos ? "" : text.substr(0, colon);
+    std::string port = colon == std::string::npos ? text : text.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+    size_t used = 0;
+    unsigned long p = 0;
+    try {
+        p = std::stoul(port, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (port.empty() || used != port.size() || p > 65535) throw std::invalid_argument("--metrics expects [HOST:]PORT");
+    return CoordEndpoint{host, static_cast<uint16_t>(p)};
+}
+
+std::unique_ptr<TargetSet> load_targets(Options& opt) {
+    if (!opt.table_path.empty()) return std::make_unique<TargetSet>(TargetTable::map(opt.table_path));
+    if (!opt.index_path.empty()) return std::make_unique<TargetSet>(map_target_index(opt.index_path));
+    if (opt.targets.empty()) return nullptr;
+    return std::make_unique<TargetSet>(TargetTable::from_digests(std::move(opt.targets)));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder: %s\n", e.what());
+        usage();
+        return 2;
+    }
+
+    try {
+        if (!opt.merge_work.empty()) return run_merge(opt);
+        if (!opt.kangaroo_pubkey.empty()) return run_kangaroo(opt);
+        if (!opt.bsgs_pubkey.empty()) return run_bsgs(opt);
+        std::unique_ptr<TargetSet> targets = load_targets(opt);
+        opt.scan.targets = targets.get();
+        std::unique_ptr<GpuBackend> gpu;
+        if (!opt.gpu_plugin.empty()) {
+            gpu = GpuBackend::load(opt.gpu_plugin);
+            opt.scan.gpu = gpu.get();
+            std::fprintf(stderr, "GPU plugin %s: %d devices\n", gpu->name().c_str(), gpu->device_count());
+        }
+        // Declared before the checkpoint, whose writes it records, so it
+        // outlives them.
+        std::unique_ptr<Metrics> metrics;
+        std::unique_ptr<MetricsServer> metrics_server;
+        if (!opt.metrics.empty()) {
+            CoordEndpoint at = parse_metrics_endpoint(opt.metrics);
+            metrics = std::make_unique<Metrics>();
+            metrics_server = std::make_unique<MetricsServer>(*metrics, at.host, at.port);
+            opt.scan.metrics = metrics.get();
+            std::fprintf(stderr, "metrics on port %u\n", metrics_server->port());
+        }
+        std::unique_ptr<Checkpoint> checkpoint;
+        if (!opt.checkpoint_path.empty()) {
+            checkpoint = std::make_unique<Checkpoint>(opt.checkpoint_path, opt.start, opt.end, opt.scan.unit_bits,
+                                                      std::chrono::seconds(opt.checkpoint_seconds), opt.scan.order);
+            opt.scan.checkpoint = checkpoint.get();
+            if (metrics) checkpoint->observe_writes(&metrics->checkpoint_flush_seconds());
+        }
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> hit_log(nullptr, std::fclose);
+        if (!opt.hits_path.empty()) {
+            hit_log.reset(std::fopen(opt.hits_path.c_str(), "a"));
+            if (!hit_log) throw std::runtime_error("cannot open " + opt.hits_path);
+        }
+        // Runs on the scan's reporter thread, so blocking here never stalls a worker.
+        const ScanHitFn print = [&](const ScanHit& hit) {
+            const std::string pubkey = hit_pubkey_hex(hit);
+            std::printf("%s%s %s %s\n", opt.scan.report_all ? "" : "hit ", hit.key.to_hex().c_str(), pubkey.c_str(),
+                        bytes_to_hex(hit.digest.data(), hit.digest.size()).c_str());
+            // A unit only counts as done once its hits are out of our buffers.
+            if (!opt.scan.report_all) std::fflush(stdout);
+            if (hit_log) {
+                std::fprintf(hit_log.get(), "hit %s %s %s\n", hit.key.to_hex().c_str(), pubkey.c_str(),
+                             bytes_to_hex(hit.digest.data(), hit.digest.size()).c_str());
+                if (std::fflush(hit_log.get()) != 0 || ::fsync(fileno(hit_log.get())) != 0) {
+                    throw std::runtime_error("cannot write " + opt.hits_path);
+                }
+            }
+        };
+        ScanStats stats;
+        U256 scanned_end = opt.end;  // picks the walker's key width
+        if (!opt.coordinator.empty()) {
+            unsigned slots = opt.scan.threads + (gpu ? gpu->device_count() : 0);
+            char host[256] = "worker";
+            ::gethostname(host, sizeof(host) - 1);
+            CoordClient client(parse_coord_endpoint(opt.coordinator), HelloMsg{slots, host});
+            const WelcomeMsg& job = client.welcome();
+            std::fprintf(stderr, "coordinator %s: range %s:%s, unit bits %u, worker %llu\n",
+                         opt.coordinator.c_str(), job.start.to_hex().c_str(), job.end.to_hex().c_str(),
+                         job.unit_bits, (unsigned long long)job.worker_id);
+            scanned_end = job.end;
+            uint32_t lease_units = opt.lease_units ? opt.lease_units : 16 * std::max(1u, slots);
+            stats = scan_coordinated(client, opt.scan, print, lease_units);
+        } else {
+            if (opt.scan.order != UnitOrder()) {
+                std::fprintf(stderr, "visiting units in order %s\n", opt.scan.order.name().c_str());
+            }
+            stats = scan_range(opt.start, opt.end, opt.scan, print);
+        }
+        std::fflush(stdout);
+        if (checkpoint) checkpoint->close();
+        if (stats.skipped) {
+            std::fprintf(stderr, "skipped %llu units completed in earlier runs\n", (unsigned long long)stats.skipped);
+        }
+        std::fprintf(stderr,
+                     "hashed %llu candidate keys in %.3f s (%.3f Mkeys/s, %u threads, %llu units, %llu steals, "
+                     "hash160 kernel %s, %u-bit key walker)\n",
+                     (unsigned long long)stats.keys, stats.seconds,
+                     stats.seconds > 0 ? stats.keys / stats.seconds / 1e6 : 0.0, opt.scan.threads,
+                     (unsigned long long)stats.units, (unsigned long long)stats.steals, hash160_best().name,
+                     64 * walker_key_limbs(scanned_end));
+        if (targets) {
+            std::fprintf(stderr, "%llu hits against %zu targets\n", (unsigned long long)stats.hits, targets->size());
+        }
+        if (kProfiling) std::fputs(format_profile(stats.profile).c_str(), stderr);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "marauder: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}